@@ -0,0 +1,108 @@
+/**
+ ******************************************************************************
+ * @file    aiTestCacheSim.h
+ * @author  MCD Vertical Application Team
+ * @brief   Data cache simulation of the inferences (host build)
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef __AI_TEST_CACHE_SIM_H__
+#define __AI_TEST_CACHE_SIM_H__
+
+/*
+ * Host build only (AI_TEST_HOST=1 and AI_TEST_HOST_CACHE_SIM=1). The loads
+ * and the stores of the kernels are fed to a set-associative data cache
+ * model (LRU, write-back, write-allocate, Cortex-M7 like 16KB/4-way/32B by
+ * default).
+ *
+ * The accessor hooks are generated by the compiler: the sources of the
+ * TFLM library (kernels, CMSIS-NN, interpreter) are built with
+ *
+ *   -fsanitize=kernel-address
+ *   --param asan-instrumentation-with-call-threshold=0
+ *   --param asan-stack=0 --param asan-globals=0
+ *
+ * each access calls __asan_{load,store}{1,2,4,8,16,N}_noabort(), these
+ * functions are provided by aiTestCacheSim_host.c (no sanitizer run-time
+ * is linked). The block copies (memcpy/memmove/memset) are seen with the
+ * link options -Wl,--wrap=memcpy,--wrap=memmove,--wrap=memset, they are
+ * required. The application sources are built without these options.
+ *
+ * Only the accesses to the registered regions (tensor arena, model) and
+ * between aiCacheSimEnable(true) and aiCacheSimEnable(false) are simulated.
+ * They are attributed to the node which is ended by the next call of
+ * aiCacheSimNode() (observer callback). The addresses are the host ones,
+ * the set mapping of a region depends on its alignment.
+ *
+ * For each node: number of accesses (by cache line), hits and misses, split
+ * of the misses (cold: first access to the line, capacity: reuse distance
+ * above the number of lines of the cache, conflict: the others), dirty lines
+ * written back and the reuse distance (number of distinct lines accessed
+ * between two accesses to a same line).
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef AI_TEST_HOST_CACHE_SIM
+#define AI_TEST_HOST_CACHE_SIM 0
+#endif
+
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1) && \
+    defined(AI_TEST_HOST_CACHE_SIM) && (AI_TEST_HOST_CACHE_SIM == 1)
+
+/* default geometry */
+#ifndef AI_CACHE_SIM_SIZE
+#define AI_CACHE_SIM_SIZE       (16 * 1024)
+#endif
+#ifndef AI_CACHE_SIM_WAYS
+#define AI_CACHE_SIM_WAYS       (4)
+#endif
+#ifndef AI_CACHE_SIM_LINE
+#define AI_CACHE_SIM_LINE       (32)
+#endif
+
+#define AI_CACHE_SIM_MAX_REGIONS  (4)
+#define AI_CACHE_SIM_MAX_NODES    (512)
+
+/* Set the geometry: "<size in KB>:<ways>:<line size>" (i.e. "16:4:32"),
+ * the sizes are powers of 2. Returns 0 if valid. */
+int aiCacheSimConfig(const char *desc);
+
+/* Simulated region */
+int aiCacheSimRegion(const void *base, uint32_t size, const char *name);
+
+/* Invalidate the cache and discard the counters (regions are kept) */
+void aiCacheSimReset(void);
+
+void aiCacheSimEnable(bool enable);
+
+/* End of the node idx, the accesses since the previous call are
+ * attributed to it */
+void aiCacheSimNode(int idx, const char *name);
+
+/* Print the counters by node, averaged on n_invoks inferences */
+void aiCacheSimReport(uint32_t n_invoks);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AI_TEST_CACHE_SIM_H__ */
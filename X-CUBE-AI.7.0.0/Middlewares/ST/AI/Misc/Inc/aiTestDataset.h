@@ -0,0 +1,133 @@
+/**
+ ******************************************************************************
+ * @file    aiTestDataset.h
+ * @author  MCD Vertical Application Team
+ * @brief   Input samples and duration statistics for the AI system perf.
+ *          applications (dataset-driven runs)
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef __AI_TEST_DATASET_H__
+#define __AI_TEST_DATASET_H__
+
+/*
+ * The input samples are stored in a blob (little-endian uint32 fields):
+ *
+ *   header  magic (AI_TEST_DATASET_MAGIC), version, n_samples, n_inputs,
+ *           n_classes, size in bytes of each input (n_inputs fields)
+ *   samples label, then the data of each input (raw, format of the
+ *           input tensor), n_samples times
+ *
+ * The blob is generated by gen_perf_dataset.py. On target, it is linked with
+ * the application (generated ai_test_dataset.c file, AI_TEST_DATASET=1). On
+ * host, it is loaded from a file (-i option, see aiSystemPerformance_host.c).
+ * The samples are used in place, they are copied in the input tensors
+ * before each inference (outside the measured time).
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* AI_TEST_DATASET - enable the dataset-driven runs (always available on host) */
+#ifndef AI_TEST_DATASET
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+#define AI_TEST_DATASET 1
+#else
+#define AI_TEST_DATASET 0
+#endif
+#endif
+
+#define AI_TEST_DATASET_MAGIC       (0x53444941U)  /* "AIDS" */
+#define AI_TEST_DATASET_VERSION     (1U)
+
+#ifndef AI_TEST_DATASET_MAX_INPUTS
+#define AI_TEST_DATASET_MAX_INPUTS  (8)
+#endif
+
+/* max number of classes (labels), the extra labels are reported together */
+#ifndef AI_TEST_DATASET_MAX_CLASSES
+#define AI_TEST_DATASET_MAX_CLASSES (16)
+#endif
+
+/* max number of durations kept for the distribution (percentiles) */
+#ifndef AI_TEST_DATASET_MAX_RECORDS
+#define AI_TEST_DATASET_MAX_RECORDS (128)
+#endif
+
+/* Blob of the samples, NULL if no dataset is available */
+extern const uint8_t *g_ai_test_dataset;
+extern uint32_t g_ai_test_dataset_len;
+
+struct aiTestDataset {
+  const uint8_t *samples;    /* first sample */
+  uint32_t n_samples;
+  uint32_t n_inputs;
+  uint32_t n_classes;
+  uint32_t sample_size;      /* label + inputs, in bytes */
+  uint32_t in_size[AI_TEST_DATASET_MAX_INPUTS];
+};
+
+/* Check the blob and initialize the dataset, 0 if OK */
+int aiTestDatasetInit(struct aiTestDataset *ds, const uint8_t *blob,
+    uint32_t size);
+
+uint32_t aiTestDatasetLabel(const struct aiTestDataset *ds, uint32_t idx);
+
+const uint8_t *aiTestDatasetInput(const struct aiTestDataset *ds,
+    uint32_t idx, uint32_t in);
+
+/* -----------------------------------------------------------------------------
+ * Duration statistics (per class and distribution)
+ * -----------------------------------------------------------------------------
+ */
+
+struct aiTestDatasetClassStats {
+  uint32_t n;
+  uint64_t sum;
+  uint64_t min;
+  uint64_t max;
+};
+
+struct aiTestDatasetStats {
+  uint32_t n;                /* number of inferences */
+  uint64_t sum;
+  uint64_t min;
+  uint64_t max;
+  double mean;               /* Welford update, std deviation */
+  double m2;
+  uint32_t n_records;        /* first durations, for the percentiles */
+  uint64_t records[AI_TEST_DATASET_MAX_RECORDS];
+  struct aiTestDatasetClassStats cls[AI_TEST_DATASET_MAX_CLASSES];
+};
+
+void aiTestDatasetStatsReset(struct aiTestDatasetStats *stats);
+
+/* Add the duration (in cycles) of an inference of a sample */
+void aiTestDatasetStatsAdd(struct aiTestDatasetStats *stats, uint32_t label,
+    uint64_t cycles);
+
+/* Print the distribution and the per class durations, the records are
+ * sorted in place */
+void aiTestDatasetStatsReport(struct aiTestDatasetStats *stats,
+    const struct aiTestDataset *ds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AI_TEST_DATASET_H__ */
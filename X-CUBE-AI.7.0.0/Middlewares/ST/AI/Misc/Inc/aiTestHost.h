@@ -0,0 +1,138 @@
+/**
+ ******************************************************************************
+ * @file    aiTestHost.h
+ * @author  MCD Vertical Application Team
+ * @brief   Linux stand-in of the STM32 HAL services for the AI test
+ *          applications (host build, AI_TEST_HOST=1)
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef __AI_TEST_HOST_H__
+#define __AI_TEST_HOST_H__
+
+/*
+ * Included by aiTestUtility.h in place of the generated bsp_ai.h file when
+ * AI_TEST_HOST=1. Only the HAL services used by the test applications are
+ * provided, they are implemented in aiTestUtility_host.c with the Linux API.
+ *
+ *  - HAL_UART_Transmit() writes to the standard output (printf/log channel)
+ *  - the DWT cycle counter is emulated with CLOCK_MONOTONIC, counting at
+ *    AI_TEST_HOST_CORE_CLOCK Hz
+ *  - the protocol channel is a registered transport (see ioRawSetTransport()),
+ *    a pseudo-terminal or a Unix domain socket
+ *  - the console (ioRawGetUint8()) reads the standard input
+ *  - the heap monitor (MON_ALLOC_XXX) is supported if the allocation
+ *    functions are wrapped at link time (AI_TEST_HOST_HEAP_MONITOR=1 and
+ *    -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free)
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE static inline
+#endif
+
+#ifndef UNUSED
+#define UNUSED(X) (void)X
+#endif
+
+/* Heap monitor, requires the --wrap link options */
+#ifndef AI_TEST_HOST_HEAP_MONITOR
+#define AI_TEST_HOST_HEAP_MONITOR 0
+#endif
+
+/* Frequency of the emulated core clock (DWT cycle counter) */
+#ifndef AI_TEST_HOST_CORE_CLOCK
+#define AI_TEST_HOST_CORE_CLOCK (1000000000UL)
+#endif
+
+/* -----------------------------------------------------------------------------
+ * HAL services
+ * -----------------------------------------------------------------------------
+ */
+
+typedef enum {
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY      0xFFFFFFFFU
+
+typedef struct {
+  int fd;
+} UART_HandleTypeDef;
+
+extern UART_HandleTypeDef UartHandle;
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData,
+    uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData,
+    uint16_t Size, uint32_t Timeout);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetHalVersion(void);
+uint32_t HAL_GetREVID(void);
+uint32_t HAL_GetDEVID(void);
+uint32_t HAL_RCC_GetSysClockFreq(void);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+
+/* -----------------------------------------------------------------------------
+ * Emulated DWT cycle counter
+ * -----------------------------------------------------------------------------
+ */
+
+void hostCyclesReset(void);
+uint32_t hostGetCycles(void);
+
+/* -----------------------------------------------------------------------------
+ * Linux transports (see ioRawSetTransport())
+ * -----------------------------------------------------------------------------
+ */
+
+struct ioTransport;
+
+/* Create a pseudo-terminal, name (if not NULL) receives the path of the
+ * slave side to be opened by the host tools (i.e. /dev/pts/N). */
+int ioHostOpenPty(struct ioTransport *transport, char *name, size_t size);
+
+/* Listen on a Unix domain socket. The first client is accepted when the
+ * transport is used, a new client is accepted when the current one
+ * disconnects. */
+int ioHostOpenUnixSocket(struct ioTransport *transport, const char *path);
+
+void ioHostClose(struct ioTransport *transport);
+
+/* -----------------------------------------------------------------------------
+ * Model file
+ * -----------------------------------------------------------------------------
+ */
+
+/* Load a file in a 16-bytes aligned buffer (to be released with free()),
+ * NULL if the file can not be read. */
+void *hostLoadFile(const char *path, int *size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AI_TEST_HOST_H__ */
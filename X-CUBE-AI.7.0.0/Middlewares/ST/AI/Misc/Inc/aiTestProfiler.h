@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ * @file    aiTestProfiler.h
+ * @author  MCD Vertical Application Team
+ * @brief   Scoped-label profiler (intra-kernel phases) for the AI test
+ *          applications
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef __AI_TEST_PROFILER_H__
+#define __AI_TEST_PROFILER_H__
+
+/*
+ * Back-end of the scoped labels of the kernels, enabled when all the sources
+ * (TFLM, CMSIS-NN and application) are built with RUY_PROFILER_LITE defined:
+ *
+ *  - TFLM kernels: ruy::profiler::ScopeLabel (third_party/ruy/ruy/profiler/
+ *    instrumentation.h)
+ *  - CMSIS-NN functions: ARM_NN_PROFILE_BEGIN()/ARM_NN_PROFILE_END()
+ *    (arm_nnsupportfunctions.h)
+ *
+ * Both call ruy_profiler_lite_push()/ruy_profiler_lite_pop(). The number of
+ * calls, the cycles (DWT counter) including the nested labels and the self
+ * cycles are accumulated by label. The cost of a label (calibrated by
+ * aiProfilerReset()) is removed from the self cycles of the parent label, it
+ * is included in the cycles of the node (observer). Without
+ * RUY_PROFILER_LITE, the labels are compiled out.
+ *
+ * The labels should be literal strings (the pointer is kept). The
+ * functions are not re-entrant.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(RUY_PROFILER_LITE)
+
+#ifndef AI_PROFILER_MAX_LABELS
+#define AI_PROFILER_MAX_LABELS  (32)
+#endif
+
+#ifndef AI_PROFILER_MAX_DEPTH
+#define AI_PROFILER_MAX_DEPTH   (8)
+#endif
+
+/* Hooks called by the instrumented code */
+void ruy_profiler_lite_push(const char *label);
+void ruy_profiler_lite_pop(void);
+
+/* Discard the accumulated values and calibrate the cost of a label */
+void aiProfilerReset(void);
+
+/* Print the values by label, averaged on n_invoks inferences */
+void aiProfilerReport(uint32_t n_invoks);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AI_TEST_PROFILER_H__ */
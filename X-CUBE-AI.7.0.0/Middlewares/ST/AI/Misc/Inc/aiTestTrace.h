@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * @file    aiTestTrace.h
+ * @author  MCD Vertical Application Team
+ * @brief   Compact binary trace of the inferences (node timeline) for the
+ *          AI test applications
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+#ifndef __AI_TEST_TRACE_H__
+#define __AI_TEST_TRACE_H__
+
+/*
+ * The events are recorded in a static buffer (little-endian fields):
+ *
+ *   header  magic (AI_TRACE_MAGIC), version, record size, core clock (Hz),
+ *           number of dropped records (buffer full)
+ *   records struct aiTraceRec, a AI_TRACE_REC_NAME record is followed by
+ *           the string (NUL terminated, padded to the record alignment)
+ *
+ * The timestamps are absolute core clock cycles. The node timestamps are
+ * relative to the start of the inference (DWT counter), the start of an
+ * inference and the application events are based on HAL_GetTick() (ms
+ * resolution), kept monotonic.
+ *
+ * The buffer is converted to the Chrome trace-event JSON format by the
+ * gen_chrome_trace.py script. It is written to a file by the host
+ * applications, on target aiTraceDump() prints it in the log ("#trace"
+ * lines).
+ *
+ * The application events (AI_TRACE_APP_TRACK..) can be used to record the
+ * activity of the other threads (i.e. RT-Thread application) in the same
+ * timeline. The functions are not re-entrant, the caller should serialize
+ * the calls.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* AI_TEST_TRACE - enable the trace (always available on host) */
+#ifndef AI_TEST_TRACE
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+#define AI_TEST_TRACE 1
+#else
+#define AI_TEST_TRACE 0
+#endif
+#endif
+
+/* AI_TEST_TRACE_SIZE - size in bytes of the trace buffer */
+#ifndef AI_TEST_TRACE_SIZE
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+#define AI_TEST_TRACE_SIZE (1024 * 1024)
+#else
+#define AI_TEST_TRACE_SIZE (4 * 1024)
+#endif
+#endif
+
+#define AI_TRACE_MAGIC          (0x52544941U)  /* "AITR" */
+#define AI_TRACE_VERSION        (1U)
+
+/* record types */
+#define AI_TRACE_REC_NAME       (1U)  /* name of (track, id), dur: string length */
+#define AI_TRACE_REC_INFERENCE  (2U)  /* id: inference index */
+#define AI_TRACE_REC_NODE       (3U)  /* id: node index, arg0: op type, arg1: output bytes */
+#define AI_TRACE_REC_BEGIN      (4U)  /* application events */
+#define AI_TRACE_REC_END        (5U)
+#define AI_TRACE_REC_INSTANT    (6U)
+
+/* tracks below AI_TRACE_APP_TRACK are used by the networks */
+#define AI_TRACE_APP_TRACK      (128U)
+
+/* id of the name of a track (AI_TRACE_REC_NAME record) */
+#define AI_TRACE_TRACK_ID       (0xFFFFU)
+
+struct aiTraceRec {
+  uint8_t type;
+  uint8_t track;
+  uint16_t id;
+  uint32_t dur;     /* cycles */
+  uint64_t ts;      /* cycles */
+  uint32_t arg0;
+  uint32_t arg1;
+};
+
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+
+/* Reset the buffer, the previous records are discarded */
+void aiTraceReset(void);
+
+bool aiTraceIsEmpty(void);
+
+/* Name of an id (node, application event) of a track */
+void aiTraceName(uint8_t track, uint16_t id, const char *name);
+
+/* Inference: aiTraceInferenceBegin() before the start of the cycle
+ * counter, aiTraceInferenceEnd() with its value after the inference */
+void aiTraceInferenceBegin(void);
+void aiTraceInferenceEnd(uint8_t track, uint16_t id, uint64_t cycles);
+
+/* Node of the current inference, begin/end are the values of the cycle
+ * counter (relative to the start of the inference) */
+void aiTraceNode(uint8_t track, uint16_t id, uint64_t begin, uint64_t end,
+    uint32_t op_type, uint32_t out_bytes);
+
+/* Application events */
+void aiTraceBegin(uint8_t track, uint16_t id);
+void aiTraceEnd(uint8_t track, uint16_t id);
+void aiTraceInstant(uint8_t track, uint16_t id);
+
+/* Recorded buffer (header + records) */
+const uint8_t *aiTraceGet(uint32_t *size);
+
+/* Print the buffer in the log (hex, "#trace" lines) */
+void aiTraceDump(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AI_TEST_TRACE_H__ */
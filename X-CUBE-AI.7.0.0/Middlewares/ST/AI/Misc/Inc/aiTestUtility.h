@@ -23,14 +23,22 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+#include <aiTestHost.h>  /* Linux stand-in of the HAL services (host build) */
+#else
 #include <bsp_ai.h>  /* generated STM32 platform file to import the HAL and the UART definition */
+#endif
 
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#if defined (__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050) /* Keil ARM Compiler 6 toolchain */
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1) /* Linux host process */
+#define _APP_STACK_MONITOR_ 0   /* not supported */
+#define _APP_HEAP_MONITOR_  AI_TEST_HOST_HEAP_MONITOR
+#define _ARM_TOOLS_ID       1   /* proto msg 2.2 definition GCC */
+#elif defined (__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050) /* Keil ARM Compiler 6 toolchain */
 #define _APP_STACK_MONITOR_ 0   /* not yet supported */
 #define _APP_HEAP_MONITOR_  0   /* not yet supported */	
 #define _ARM_TOOLS_ID       4   /* proto msg 2.2 definition AC6 */
@@ -97,6 +105,7 @@ struct io_malloc {
   uint32_t free_req;      /* number of requested free */
   uint32_t max;           /* maximum allocated memory */
   uint32_t used;          /* current allocated memory */
+  uint32_t node_max;      /* maximum allocated memory since MON_ALLOC_NODE_RESET() */
 #if _IO_MALLOC_TRACK_MODE == 1
   void* a_ptr[_IO_MALLOC_TRACK_DEPTH_SIZE];
   size_t a_s[_IO_MALLOC_TRACK_DEPTH_SIZE];
@@ -127,14 +136,18 @@ extern struct io_malloc io_malloc;
 
 #define MON_ALLOC_REPORT() \
     printf(" used heap    : %ld:%ld %ld:%ld (req:allocated,req:released) max=%ld cur=%ld (cfg=%ld)\r\n", \
-        io_malloc.alloc_req, io_malloc.alloc, \
-        io_malloc.free_req, io_malloc.free, \
-        io_malloc.max, io_malloc.used, \
-        (io_malloc.cfg & (3 << 1)) >> 1)
+        (long)io_malloc.alloc_req, (long)io_malloc.alloc, \
+        (long)io_malloc.free_req, (long)io_malloc.free, \
+        (long)io_malloc.max, (long)io_malloc.used, \
+        (long)((io_malloc.cfg & (3 << 1)) >> 1))
 
 #define MON_ALLOC_MAX_USED() (int)io_malloc.max
 #define MON_ALLOC_USED() (int)io_malloc.used
 
+/* per-node peak (observer callbacks), the global one is not impacted */
+#define MON_ALLOC_NODE_RESET() io_malloc.node_max = io_malloc.used
+#define MON_ALLOC_NODE_MAX_USED() (int)io_malloc.node_max
+
 #else
 
 #define MON_ALLOC_ENABLE()
@@ -146,6 +159,9 @@ extern struct io_malloc io_malloc;
 #define MON_ALLOC_MAX_USED() (-1)
 #define MON_ALLOC_USED() (-1)
 
+#define MON_ALLOC_NODE_RESET()
+#define MON_ALLOC_NODE_MAX_USED() (-1)
+
 #endif
 
 
@@ -164,12 +180,19 @@ struct io_stack {
   uint32_t mstack_size; /* minimal master stack size */
   uint32_t cstack;      /* current stack @ */
   uint32_t bstack;      /* base stack @ */
+  int32_t  node_max;    /* max depth sampled by stackMonNodeSample() */
 };
 
 extern struct io_stack io_stack;
 
 void stackMonInit(uint32_t ctrl, uint32_t cstack, uint32_t msize);
 
+/* Stack depth (from the stack @ of MON_STACK_INIT()) reached since the
+ * previous call or MON_STACK_MARK(), the free area below the current stack
+ * pointer is painted again. Called by the observer callbacks at each node
+ * boundary, so the depth includes the frame of the callback. */
+int32_t stackMonNodeSample(void);
+
 #if defined(_APP_STACK_MONITOR_) && _APP_STACK_MONITOR_ == 1
 
 #define MON_STACK_INIT() stackMonInit(__get_CONTROL(), __get_MSP(), MIN_STACK_SIZE)
@@ -207,6 +230,9 @@ void stackMonInit(uint32_t ctrl, uint32_t cstack, uint32_t msize);
       io_stack.susage = 8*4;\
       while ((*pr == 0xDEDEDEDE) && ((uint32_t)pr < io_stack.cstack)) { pr++; io_stack.susage += 4; }\
       io_stack.susage = rstack - io_stack.susage;\
+      /* the area used by the previous nodes was painted again */\
+      if (io_stack.node_max > io_stack.susage)\
+        io_stack.susage = io_stack.node_max;\
     } else {\
       io_stack.susage = -1;\
       printf("E: !stack overflow detected > %ld\r\n", rstack);\
@@ -224,6 +250,8 @@ void stackMonInit(uint32_t ctrl, uint32_t cstack, uint32_t msize);
     printf("D: %s (0x%08lx-0x%08lx %ld/%ld ctrl=0x%08lx\r\n",msg,\
         io_stack.estack, io_stack.cstack, io_stack.ustack_size, io_stack.mstack_size, io_stack.ctrl)
 
+#define MON_STACK_NODE_SAMPLE() stackMonNodeSample()
+
 #else
 
 #define MON_STACK_INIT()
@@ -236,6 +264,8 @@ void stackMonInit(uint32_t ctrl, uint32_t cstack, uint32_t msize);
 
 #define MON_STACK_STATE(msg);
 
+#define MON_STACK_NODE_SAMPLE() (-1)
+
 #endif
 
 
@@ -253,6 +283,18 @@ struct dwtTime {
 
 void dwtIpInit(void);
 
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+
+__STATIC_INLINE void dwtReset(void) {
+  hostCyclesReset();
+}
+
+__STATIC_INLINE  uint32_t dwtGetCycles(void) {
+  return hostGetCycles();
+}
+
+#else
+
 __STATIC_INLINE void dwtReset(void) {
   DWT->CYCCNT = 0; /* Clear DWT cycle counter */
 }
@@ -261,6 +303,8 @@ __STATIC_INLINE  uint32_t dwtGetCycles(void) {
   return DWT->CYCCNT;
 }
 
+#endif
+
 uint32_t systemCoreClock(void);
 int dwtCyclesToTime(uint64_t clks, struct dwtTime *t);
 float dwtCyclesToFloatMs(uint64_t clks);
@@ -318,11 +362,38 @@ void ioRawDisableLLWrite(void);
 bool ioRawWriteBuffer(uint8_t *buff, int count);
 bool ioRawReadBuffer(uint8_t *buff, int count);
 
+/*
+ * Low-level transport used by ioRawWriteBuffer()/ioRawReadBuffer(). By
+ * default (no registered transport), the UART or the USB CDC is used.
+ * read() should block until count bytes are received.
+ */
+struct ioTransport {
+  bool (*write)(void *ctx, const uint8_t *buff, int count);
+  bool (*read)(void *ctx, uint8_t *buff, int count);
+  void *ctx;
+};
+
+void ioRawSetTransport(const struct ioTransport *transport);
+
 /* -----------------------------------------------------------------------------
  * System services
  * -----------------------------------------------------------------------------
  */
 
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+
+__STATIC_INLINE uint32_t disableInts(void)
+{
+  return 0;
+}
+
+__STATIC_INLINE void restoreInts(uint32_t state)
+{
+  (void)state;
+}
+
+#else
+
 __STATIC_INLINE uint32_t disableInts(void)
 {
   uint32_t state;
@@ -338,6 +409,8 @@ __STATIC_INLINE void restoreInts(uint32_t state)
   __set_PRIMASK(state);
 }
 
+#endif
+
 void systemSettingLog(void);
 uint32_t getFlashCacheConf(void);
 
@@ -0,0 +1,503 @@
+/**
+ ******************************************************************************
+ * @file    aiTestCacheSim_host.c
+ * @author  MCD Vertical Application Team
+ * @brief   Data cache simulation of the inferences (host build)
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/*
+ * Description:
+ *
+ * - Set-associative cache model, LRU replacement, write-back and
+ *   write-allocate (see aiTestCacheSim.h)
+ * - The reuse distance is the number of markers (last access of each line)
+ *   after the previous access of the line, counted with a Fenwick tree
+ *   indexed by the access events. The events are renumbered when the tree
+ *   is full. The consecutive accesses to a same line are a single event.
+ * - This file should be built without the instrumentation options.
+ *
+ * History:
+ *  - v1.0 - initial version
+ */
+
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <aiTestCacheSim.h>
+
+#if defined(AI_TEST_HOST_CACHE_SIM) && (AI_TEST_HOST_CACHE_SIM == 1)
+
+#define _CSIM_MAX_BLOCKS    (8192)
+#define _CSIM_MAX_LINES     (1 << 20)   /* lines of the regions */
+#define _CSIM_MAX_EVENTS    (1 << 21)
+#define _CSIM_RD_BUCKETS    (24)        /* 0, [1, 2), [2, 4).. */
+
+struct _csim_stats {
+  uint64_t loads;       /* by cache line */
+  uint64_t stores;
+  uint64_t misses;
+  uint64_t cold;
+  uint64_t capacity;
+  uint64_t writebacks;
+  uint64_t rd[_CSIM_RD_BUCKETS];
+};
+
+struct _csim_block {
+  uintptr_t tag;        /* line number */
+  uint32_t stamp;       /* last access (LRU) */
+  uint8_t valid;
+  uint8_t dirty;
+};
+
+struct _csim_region {
+  uintptr_t base;
+  uintptr_t end;
+  const char *name;
+  uintptr_t first;      /* first line */
+  uintptr_t last;       /* last line + 1 */
+  uint32_t line0;       /* index of the first line (reuse distance) */
+  uint64_t accesses;
+  uint64_t misses;
+};
+
+static struct _csim_ctx {
+  uint32_t size;
+  uint32_t ways;
+  uint32_t line;
+  uint32_t shift;
+  uint32_t sets;
+  volatile int active;
+  uint32_t stamp;
+  struct _csim_block blocks[_CSIM_MAX_BLOCKS];
+  struct _csim_region regions[AI_CACHE_SIM_MAX_REGIONS];
+  int n_regions;
+  uintptr_t last_line;
+  uint32_t now;
+  struct _csim_stats cur;
+  struct _csim_stats nodes[AI_CACHE_SIM_MAX_NODES];
+  const char *names[AI_CACHE_SIM_MAX_NODES];
+  int n_nodes;
+} csim = {
+  .size = AI_CACHE_SIM_SIZE,
+  .ways = AI_CACHE_SIM_WAYS,
+  .line = AI_CACHE_SIM_LINE,
+};
+
+static uint32_t csim_last[_CSIM_MAX_LINES];         /* event, 0: never */
+static uint32_t csim_line_at[_CSIM_MAX_EVENTS + 1];
+static int32_t csim_bit[_CSIM_MAX_EVENTS + 1];
+
+/* -----------------------------------------------------------------------------
+ * Reuse distance
+ * -----------------------------------------------------------------------------
+ */
+
+static void _bit_add(uint32_t i, int32_t val)
+{
+  for (; i <= _CSIM_MAX_EVENTS; i += i & (~i + 1))
+    csim_bit[i] += val;
+}
+
+static int32_t _bit_sum(uint32_t i)
+{
+  int32_t sum = 0;
+  for (; i; i -= i & (~i + 1))
+    sum += csim_bit[i];
+  return sum;
+}
+
+/* Renumber the last access of the lines (1..n) */
+static void _csim_rebase(void)
+{
+  uint32_t n = 0;
+
+  for (uint32_t t = 1; t <= csim.now; t++) {
+    const uint32_t idx = csim_line_at[t];
+    if (csim_last[idx] == t) {
+      csim_last[idx] = ++n;
+      csim_line_at[n] = idx;
+    }
+  }
+
+  memset(csim_bit, 0, sizeof(csim_bit));
+  for (uint32_t i = 1; i <= n; i++) {
+    const uint32_t j = i + (i & (~i + 1));
+    csim_bit[i] += 1;
+    if (j <= _CSIM_MAX_EVENTS)
+      csim_bit[j] += csim_bit[i];
+  }
+  csim.now = n;
+}
+
+/* Distance since the previous access of the line, -1 if first access */
+static int32_t _csim_reuse(uint32_t idx)
+{
+  const uint32_t t = csim_last[idx];
+  int32_t rd = -1;
+
+  if (t) {
+    rd = _bit_sum(csim.now) - _bit_sum(t);
+    _bit_add(t, -1);
+  }
+
+  if (csim.now == _CSIM_MAX_EVENTS)
+    _csim_rebase();
+
+  csim.now++;
+  csim_last[idx] = csim.now;
+  csim_line_at[csim.now] = idx;
+  _bit_add(csim.now, 1);
+  return rd;
+}
+
+static int _csim_bucket(int32_t rd)
+{
+  int b = 0;
+  while (rd && b < _CSIM_RD_BUCKETS - 1) {
+    rd >>= 1;
+    b++;
+  }
+  return b;
+}
+
+/* -----------------------------------------------------------------------------
+ * Cache model
+ * -----------------------------------------------------------------------------
+ */
+
+static void _csim_line(uintptr_t line, int store)
+{
+  struct _csim_region *reg = NULL;
+  struct _csim_stats *st = &csim.cur;
+  struct _csim_block *set, *victim;
+  int32_t rd = 0;
+
+  for (int i = 0; i < csim.n_regions; i++) {
+    if (line >= csim.regions[i].first && line < csim.regions[i].last) {
+      reg = &csim.regions[i];
+      break;
+    }
+  }
+  if (!reg)
+    return;
+
+  if (store)
+    st->stores++;
+  else
+    st->loads++;
+  reg->accesses++;
+
+  if (line != csim.last_line) {
+    rd = _csim_reuse(reg->line0 + (uint32_t)(line - reg->first));
+    csim.last_line = line;
+  }
+  if (rd >= 0)
+    st->rd[_csim_bucket(rd)]++;
+
+  csim.stamp++;
+  set = &csim.blocks[(line & (csim.sets - 1)) * csim.ways];
+  victim = set;
+  for (uint32_t w = 0; w < csim.ways; w++) {
+    if (set[w].valid && set[w].tag == line) {
+      set[w].stamp = csim.stamp;
+      set[w].dirty |= (uint8_t)store;
+      return;
+    }
+    if (!set[w].valid)
+      victim = &set[w];
+    else if (victim->valid && set[w].stamp < victim->stamp)
+      victim = &set[w];
+  }
+
+  st->misses++;
+  reg->misses++;
+  if (rd < 0)
+    st->cold++;
+  else if ((uint32_t)rd >= csim.sets * csim.ways)
+    st->capacity++;
+  if (victim->valid && victim->dirty)
+    st->writebacks++;
+
+  victim->tag = line;
+  victim->stamp = csim.stamp;
+  victim->valid = 1;
+  victim->dirty = (uint8_t)store;
+}
+
+static void _csim_access(uintptr_t addr, size_t size, int store)
+{
+  uintptr_t line, last;
+
+  if (!size)
+    return;
+
+  last = (addr + size - 1) >> csim.shift;
+  for (line = addr >> csim.shift; line <= last; line++)
+    _csim_line(line, store);
+}
+
+/* -----------------------------------------------------------------------------
+ * Accessor hooks (compiler instrumentation, wrapped functions)
+ * -----------------------------------------------------------------------------
+ */
+
+#define _CSIM_HOOKS(n) \
+  void __asan_load##n##_noabort(uintptr_t addr) \
+  { if (csim.active) _csim_access(addr, n, 0); } \
+  void __asan_store##n##_noabort(uintptr_t addr) \
+  { if (csim.active) _csim_access(addr, n, 1); }
+
+_CSIM_HOOKS(1)
+_CSIM_HOOKS(2)
+_CSIM_HOOKS(4)
+_CSIM_HOOKS(8)
+_CSIM_HOOKS(16)
+
+void __asan_loadN_noabort(uintptr_t addr, size_t size)
+{
+  if (csim.active)
+    _csim_access(addr, size, 0);
+}
+
+void __asan_storeN_noabort(uintptr_t addr, size_t size)
+{
+  if (csim.active)
+    _csim_access(addr, size, 1);
+}
+
+void __asan_handle_no_return(void)
+{
+}
+
+void *__real_memcpy(void *dst, const void *src, size_t n);
+void *__real_memmove(void *dst, const void *src, size_t n);
+void *__real_memset(void *dst, int c, size_t n);
+
+void *__wrap_memcpy(void *dst, const void *src, size_t n)
+{
+  if (csim.active) {
+    _csim_access((uintptr_t)src, n, 0);
+    _csim_access((uintptr_t)dst, n, 1);
+  }
+  return __real_memcpy(dst, src, n);
+}
+
+void *__wrap_memmove(void *dst, const void *src, size_t n)
+{
+  if (csim.active) {
+    _csim_access((uintptr_t)src, n, 0);
+    _csim_access((uintptr_t)dst, n, 1);
+  }
+  return __real_memmove(dst, src, n);
+}
+
+void *__wrap_memset(void *dst, int c, size_t n)
+{
+  if (csim.active)
+    _csim_access((uintptr_t)dst, n, 1);
+  return __real_memset(dst, c, n);
+}
+
+/* -----------------------------------------------------------------------------
+ * API
+ * -----------------------------------------------------------------------------
+ */
+
+static int _is_pow2(uint32_t val)
+{
+  return val && !(val & (val - 1));
+}
+
+/* Line numbers of the regions, called when the line size is changed */
+static int _csim_map_regions(void)
+{
+  uint32_t line0 = 0;
+
+  csim.shift = 0;
+  while ((1U << csim.shift) < csim.line)
+    csim.shift++;
+
+  for (int i = 0; i < csim.n_regions; i++) {
+    struct _csim_region *reg = &csim.regions[i];
+    reg->first = reg->base >> csim.shift;
+    reg->last = ((reg->end - 1) >> csim.shift) + 1;
+    reg->line0 = line0;
+    if (reg->last - reg->first > _CSIM_MAX_LINES - line0)
+      return -1;
+    line0 += (uint32_t)(reg->last - reg->first);
+  }
+  return 0;
+}
+
+int aiCacheSimConfig(const char *desc)
+{
+  unsigned int size_kb, ways, line;
+
+  if (sscanf(desc, "%u:%u:%u", &size_kb, &ways, &line) != 3)
+    return -1;
+
+  if (!_is_pow2(size_kb) || !_is_pow2(ways) || !_is_pow2(line) ||
+      (size_kb * 1024 / line > _CSIM_MAX_BLOCKS) ||
+      (size_kb * 1024 < ways * line))
+    return -1;
+
+  csim.size = size_kb * 1024;
+  csim.ways = ways;
+  csim.line = line;
+  aiCacheSimReset();
+  return _csim_map_regions();
+}
+
+int aiCacheSimRegion(const void *base, uint32_t size, const char *name)
+{
+  struct _csim_region *reg;
+
+  if (!size || csim.n_regions >= AI_CACHE_SIM_MAX_REGIONS)
+    return -1;
+
+  reg = &csim.regions[csim.n_regions++];
+  memset(reg, 0, sizeof(*reg));
+  reg->base = (uintptr_t)base;
+  reg->end = (uintptr_t)base + size;
+  reg->name = name;
+
+  if (_csim_map_regions()) {
+    csim.n_regions--;
+    return -1;
+  }
+  aiCacheSimReset();
+  return 0;
+}
+
+void aiCacheSimReset(void)
+{
+  csim.active = 0;
+  csim.sets = csim.size / (csim.ways * csim.line);
+  csim.stamp = 0;
+  csim.last_line = UINTPTR_MAX;
+  csim.now = 0;
+  csim.n_nodes = 0;
+  memset(csim.blocks, 0, sizeof(csim.blocks));
+  memset(&csim.cur, 0, sizeof(csim.cur));
+  memset(csim.nodes, 0, sizeof(csim.nodes));
+  memset(csim.names, 0, sizeof(csim.names));
+  for (int i = 0; i < csim.n_regions; i++) {
+    csim.regions[i].accesses = 0;
+    csim.regions[i].misses = 0;
+  }
+  memset(csim_last, 0, sizeof(csim_last));
+  memset(csim_bit, 0, sizeof(csim_bit));
+  _csim_map_regions();
+}
+
+void aiCacheSimEnable(bool enable)
+{
+  csim.active = enable ? 1 : 0;
+}
+
+void aiCacheSimNode(int idx, const char *name)
+{
+  struct _csim_stats *st;
+
+  if (idx < 0 || idx >= AI_CACHE_SIM_MAX_NODES)
+    return;
+
+  st = &csim.nodes[idx];
+  st->loads += csim.cur.loads;
+  st->stores += csim.cur.stores;
+  st->misses += csim.cur.misses;
+  st->cold += csim.cur.cold;
+  st->capacity += csim.cur.capacity;
+  st->writebacks += csim.cur.writebacks;
+  for (int i = 0; i < _CSIM_RD_BUCKETS; i++)
+    st->rd[i] += csim.cur.rd[i];
+  memset(&csim.cur, 0, sizeof(csim.cur));
+
+  csim.names[idx] = name;
+  if (idx >= csim.n_nodes)
+    csim.n_nodes = idx + 1;
+}
+
+/* upper bound of the bucket of the median reuse distance */
+static uint32_t _csim_rd_median(const struct _csim_stats *st)
+{
+  uint64_t total = 0, cumul = 0;
+
+  for (int i = 0; i < _CSIM_RD_BUCKETS; i++)
+    total += st->rd[i];
+  for (int i = 0; i < _CSIM_RD_BUCKETS; i++) {
+    cumul += st->rd[i];
+    if (total && cumul * 2 >= total)
+      return i ? (1U << i) - 1 : 0;
+  }
+  return 0;
+}
+
+void aiCacheSimReport(uint32_t n_invoks)
+{
+  struct _csim_stats total;
+
+  if (!n_invoks)
+    n_invoks = 1;
+
+  printf("\r\n Data cache simulation (%dKB, %d-way, %dB lines, LRU, write-back)\r\n",
+      (int)(csim.size / 1024), (int)csim.ways, (int)csim.line);
+  for (int i = 0; i < csim.n_regions; i++) {
+    const struct _csim_region *reg = &csim.regions[i];
+    printf("  %-8s: %d bytes, %d accesses, %d misses (by inference)\r\n",
+        reg->name, (int)(reg->end - reg->base),
+        (int)(reg->accesses / n_invoks), (int)(reg->misses / n_invoks));
+  }
+
+  printf("\r\n %-6s%-25s %9s %7s %8s %8s %8s %8s %6s\r\n", "idx", "name",
+      "access", "miss", "cold", "capacity", "conflict", "w-back", "rd");
+  printf(" ------------------------------------------------------------------------------------------\r\n");
+
+  memset(&total, 0, sizeof(total));
+  for (int i = 0; i < csim.n_nodes; i++) {
+    const struct _csim_stats *st = &csim.nodes[i];
+    const uint64_t access = st->loads + st->stores;
+    const uint64_t conflict = st->misses - st->cold - st->capacity;
+
+    printf(" %-6d%-25s %9d %6.02f%c %8d %8d %8d %8d %6d\r\n", i,
+        csim.names[i] ? csim.names[i] : "",
+        (int)(access / n_invoks),
+        access ? ((float)st->misses * 100.0f) / (float)access : 0.0f, '%',
+        (int)(st->cold / n_invoks), (int)(st->capacity / n_invoks),
+        (int)(conflict / n_invoks), (int)(st->writebacks / n_invoks),
+        (int)_csim_rd_median(st));
+
+    total.loads += st->loads;
+    total.stores += st->stores;
+    total.misses += st->misses;
+    total.writebacks += st->writebacks;
+  }
+  printf(" ------------------------------------------------------------------------------------------\r\n");
+  printf(" %31s %9d %6.02f%c %35d\r\n", "",
+      (int)((total.loads + total.stores) / n_invoks),
+      (total.loads + total.stores) ?
+          ((float)total.misses * 100.0f) / (float)(total.loads + total.stores) : 0.0f,
+      '%', (int)(total.writebacks / n_invoks));
+  printf("  rd: median reuse distance (distinct lines, upper bound of the log2 bucket)\r\n");
+}
+
+#endif /* AI_TEST_HOST_CACHE_SIM */
+
+#endif /* AI_TEST_HOST */
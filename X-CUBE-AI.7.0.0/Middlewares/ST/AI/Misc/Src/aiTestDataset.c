@@ -0,0 +1,231 @@
+/**
+ ******************************************************************************
+ * @file    aiTestDataset.c
+ * @author  MCD Vertical Application Team
+ * @brief   Input samples and duration statistics for the AI system perf.
+ *          applications (dataset-driven runs)
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/*
+ * Description:
+ *
+ * - Accessors of the blob of the input samples (format, see aiTestDataset.h)
+ * - Durations by class and overall distribution (min, percentiles, max,
+ *   mean and standard deviation). Memory is fixed, only the first
+ *   AI_TEST_DATASET_MAX_RECORDS durations are used for the percentiles.
+ *
+ * History:
+ *  - v1.0 - initial version
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <aiTestUtility.h>
+#include <aiTestDataset.h>
+
+
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+/* loaded from a file by the host application */
+const uint8_t *g_ai_test_dataset = NULL;
+uint32_t g_ai_test_dataset_len = 0;
+#endif
+
+#define _DS_HEADER_FIELDS (5)  /* magic, version, n_samples, n_inputs, n_classes */
+
+static uint32_t _ds_get_u32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+      ((uint32_t)p[3] << 24);
+}
+
+int aiTestDatasetInit(struct aiTestDataset *ds, const uint8_t *blob,
+    uint32_t size)
+{
+  uint32_t hdr_size;
+  uint32_t n;
+
+  if (!ds)
+    return -1;
+
+  memset(ds, 0, sizeof(struct aiTestDataset));
+
+  if (!blob || (size < _DS_HEADER_FIELDS * 4))
+    return -1;
+
+  if ((_ds_get_u32(blob) != AI_TEST_DATASET_MAGIC) ||
+      (_ds_get_u32(blob + 4) != AI_TEST_DATASET_VERSION))
+    return -1;
+
+  ds->n_samples = _ds_get_u32(blob + 8);
+  ds->n_inputs = _ds_get_u32(blob + 12);
+  ds->n_classes = _ds_get_u32(blob + 16);
+
+  if (!ds->n_samples || !ds->n_inputs ||
+      (ds->n_inputs > AI_TEST_DATASET_MAX_INPUTS))
+    return -1;
+
+  hdr_size = (_DS_HEADER_FIELDS + ds->n_inputs) * 4;
+  if (size < hdr_size)
+    return -1;
+
+  ds->sample_size = 4;
+  for (n = 0; n < ds->n_inputs; n++) {
+    ds->in_size[n] = _ds_get_u32(blob + (_DS_HEADER_FIELDS + n) * 4);
+    ds->sample_size += ds->in_size[n];
+  }
+
+  if ((size - hdr_size) / ds->sample_size < ds->n_samples)
+    return -1;
+
+  ds->samples = blob + hdr_size;
+
+  return 0;
+}
+
+uint32_t aiTestDatasetLabel(const struct aiTestDataset *ds, uint32_t idx)
+{
+  return _ds_get_u32(ds->samples + (idx % ds->n_samples) * ds->sample_size);
+}
+
+const uint8_t *aiTestDatasetInput(const struct aiTestDataset *ds,
+    uint32_t idx, uint32_t in)
+{
+  const uint8_t *p = ds->samples + (idx % ds->n_samples) * ds->sample_size + 4;
+
+  for (uint32_t n = 0; n < in; n++)
+    p += ds->in_size[n];
+
+  return p;
+}
+
+/* -----------------------------------------------------------------------------
+ * Duration statistics
+ * -----------------------------------------------------------------------------
+ */
+
+void aiTestDatasetStatsReset(struct aiTestDatasetStats *stats)
+{
+  memset(stats, 0, sizeof(struct aiTestDatasetStats));
+  stats->min = UINT64_MAX;
+  for (int i = 0; i < AI_TEST_DATASET_MAX_CLASSES; i++)
+    stats->cls[i].min = UINT64_MAX;
+}
+
+void aiTestDatasetStatsAdd(struct aiTestDatasetStats *stats, uint32_t label,
+    uint64_t cycles)
+{
+  struct aiTestDatasetClassStats *cls;
+  double delta;
+
+  if (label >= AI_TEST_DATASET_MAX_CLASSES)
+    label = AI_TEST_DATASET_MAX_CLASSES - 1;
+  cls = &stats->cls[label];
+
+  cls->n++;
+  cls->sum += cycles;
+  if (cycles < cls->min)
+    cls->min = cycles;
+  if (cycles > cls->max)
+    cls->max = cycles;
+
+  stats->n++;
+  stats->sum += cycles;
+  if (cycles < stats->min)
+    stats->min = cycles;
+  if (cycles > stats->max)
+    stats->max = cycles;
+
+  delta = (double)cycles - stats->mean;
+  stats->mean += delta / (double)stats->n;
+  stats->m2 += delta * ((double)cycles - stats->mean);
+
+  if (stats->n_records < AI_TEST_DATASET_MAX_RECORDS)
+    stats->records[stats->n_records++] = cycles;
+}
+
+static void _ds_sort(uint64_t *vals, uint32_t n)
+{
+  /* insertion sort, n <= AI_TEST_DATASET_MAX_RECORDS */
+  for (uint32_t i = 1; i < n; i++) {
+    uint64_t v = vals[i];
+    uint32_t j = i;
+    while ((j > 0) && (vals[j - 1] > v)) {
+      vals[j] = vals[j - 1];
+      j--;
+    }
+    vals[j] = v;
+  }
+}
+
+/* nearest-rank percentile of the sorted records */
+static uint64_t _ds_percentile(const struct aiTestDatasetStats *stats, int p)
+{
+  uint32_t rank = (stats->n_records * (uint32_t)p + 99) / 100;
+  return stats->records[rank ? rank - 1 : 0];
+}
+
+static void _ds_print_ms(const char *fmt, uint64_t cycles)
+{
+  struct dwtTime t;
+  dwtCyclesToTime(cycles, &t);
+  printf(fmt, t.s * 1000 + t.ms, t.us);
+}
+
+void aiTestDatasetStatsReport(struct aiTestDatasetStats *stats,
+    const struct aiTestDataset *ds)
+{
+  uint64_t std;
+
+  if (!stats->n)
+    return;
+
+  _ds_sort(stats->records, stats->n_records);
+  std = (stats->n > 1) ? (uint64_t)sqrt(stats->m2 / (double)(stats->n - 1)) : 0;
+
+  printf(" dataset      : %d samples, %d classes, %d inputs\r\n",
+      (int)ds->n_samples, (int)ds->n_classes, (int)ds->n_inputs);
+
+  printf(" distribution :");
+  _ds_print_ms(" min=%d.%03d", stats->min);
+  _ds_print_ms(" p50=%d.%03d", _ds_percentile(stats, 50));
+  _ds_print_ms(" p90=%d.%03d", _ds_percentile(stats, 90));
+  _ds_print_ms(" p99=%d.%03d", _ds_percentile(stats, 99));
+  _ds_print_ms(" max=%d.%03d", stats->max);
+  _ds_print_ms(" std=%d.%03d ms", std);
+  if (stats->n_records < stats->n)
+    printf(" (percentiles: %d first)", (int)stats->n_records);
+  printf("\r\n");
+
+  printf("\r\n %-6s %6s %10s %10s %10s\r\n", "class", "n", "avg (ms)",
+      "min (ms)", "max (ms)");
+  printf(" ---------------------------------------------\r\n");
+  for (int i = 0; i < AI_TEST_DATASET_MAX_CLASSES; i++) {
+    const struct aiTestDatasetClassStats *cls = &stats->cls[i];
+    if (!cls->n)
+      continue;
+    if ((i == AI_TEST_DATASET_MAX_CLASSES - 1) &&
+        (ds->n_classes > AI_TEST_DATASET_MAX_CLASSES))
+      printf(" >=%-4d %6d", i, (int)cls->n);
+    else
+      printf(" %-6d %6d", i, (int)cls->n);
+    _ds_print_ms(" %6d.%03d", cls->sum / cls->n);
+    _ds_print_ms(" %6d.%03d", cls->min);
+    _ds_print_ms(" %6d.%03d\r\n", cls->max);
+  }
+  printf(" ---------------------------------------------\r\n");
+}
@@ -0,0 +1,191 @@
+/**
+ ******************************************************************************
+ * @file    aiTestProfiler.c
+ * @author  MCD Vertical Application Team
+ * @brief   Scoped-label profiler (intra-kernel phases) for the AI test
+ *          applications
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/*
+ * Description:
+ *
+ * - Accumulation of the cycles by label (see aiTestProfiler.h). A label is
+ *   identified by its pointer, the string is only compared when a label is
+ *   used for the first time from a given call site. The labels beyond
+ *   AI_PROFILER_MAX_LABELS or AI_PROFILER_MAX_DEPTH are dropped (counted).
+ *
+ * History:
+ *  - v1.0 - initial version
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <aiTestUtility.h>
+#include <aiTestProfiler.h>
+
+#if defined(RUY_PROFILER_LITE)
+
+#define _PROFILER_CALIB_LOOPS (16)
+
+struct aiProfilerLabel {
+  const char *name;
+  uint32_t count;
+  uint32_t depth;       /* nesting level of the first call */
+  uint64_t cycles;      /* including the nested labels */
+  uint64_t self;
+};
+
+struct aiProfilerFrame {
+  struct aiProfilerLabel *label;  /* NULL if dropped */
+  uint32_t start;
+  uint32_t nested;      /* cycles of the nested labels (including their cost) */
+};
+
+static struct aiProfilerCtx {
+  struct aiProfilerLabel labels[AI_PROFILER_MAX_LABELS];
+  uint32_t n_labels;
+  struct aiProfilerFrame stack[AI_PROFILER_MAX_DEPTH];
+  uint32_t depth;
+  uint32_t dropped;
+  uint32_t cost;        /* cycles of a push/pop pair */
+} prof_ctx;
+
+static struct aiProfilerLabel *_profiler_label(const char *name)
+{
+  struct aiProfilerLabel *label;
+  uint32_t i;
+
+  for (i = 0; i < prof_ctx.n_labels; i++)
+    if (prof_ctx.labels[i].name == name)
+      return &prof_ctx.labels[i];
+
+  /* same label, other call site (or compilation unit) */
+  for (i = 0; i < prof_ctx.n_labels; i++)
+    if (strcmp(prof_ctx.labels[i].name, name) == 0)
+      return &prof_ctx.labels[i];
+
+  if (prof_ctx.n_labels >= AI_PROFILER_MAX_LABELS) {
+    prof_ctx.dropped++;
+    return NULL;
+  }
+
+  label = &prof_ctx.labels[prof_ctx.n_labels++];
+  label->name = name;
+  label->depth = prof_ctx.depth - 1;
+  return label;
+}
+
+void ruy_profiler_lite_push(const char *label)
+{
+  struct aiProfilerFrame *frame;
+
+  if (prof_ctx.depth++ >= AI_PROFILER_MAX_DEPTH) {
+    prof_ctx.dropped++;
+    return;
+  }
+
+  frame = &prof_ctx.stack[prof_ctx.depth - 1];
+  frame->label = _profiler_label(label);
+  frame->nested = 0;
+  frame->start = dwtGetCycles();
+}
+
+void ruy_profiler_lite_pop(void)
+{
+  const uint32_t end = dwtGetCycles();
+  struct aiProfilerFrame *frame;
+  uint32_t dur;
+
+  if (!prof_ctx.depth)
+    return;
+
+  if (prof_ctx.depth-- > AI_PROFILER_MAX_DEPTH)
+    return;
+
+  frame = &prof_ctx.stack[prof_ctx.depth];
+  dur = end - frame->start;
+
+  if (frame->label) {
+    frame->label->count++;
+    frame->label->cycles += dur;
+    frame->label->self += (dur > frame->nested) ? dur - frame->nested : 0;
+  }
+
+  if (prof_ctx.depth)
+    prof_ctx.stack[prof_ctx.depth - 1].nested += dur + prof_ctx.cost;
+}
+
+void aiProfilerReset(void)
+{
+  uint32_t start;
+
+  memset(&prof_ctx, 0, sizeof(prof_ctx));
+
+  start = dwtGetCycles();
+  for (int i = 0; i < _PROFILER_CALIB_LOOPS; i++) {
+    ruy_profiler_lite_push("calibration");
+    ruy_profiler_lite_pop();
+  }
+  prof_ctx.cost = (dwtGetCycles() - start) / _PROFILER_CALIB_LOOPS;
+
+  memset(prof_ctx.labels, 0, sizeof(prof_ctx.labels));
+  prof_ctx.n_labels = 0;
+}
+
+void aiProfilerReport(uint32_t n_invoks)
+{
+  struct dwtTime t;
+  uint64_t total = 0;
+  char name[45];
+
+  if (!prof_ctx.n_labels)
+    return;
+
+  if (!n_invoks)
+    n_invoks = 1;
+
+  for (uint32_t i = 0; i < prof_ctx.n_labels; i++)
+    total += prof_ctx.labels[i].self;
+
+  printf("\r\n Intra-kernel phases (scoped labels)\r\n");
+  printf("  label cost : %d cycles (removed from the self time of the parent)\r\n",
+      (int)prof_ctx.cost);
+  if (prof_ctx.dropped)
+    printf("  dropped    : %d labels (AI_PROFILER_MAX_LABELS/DEPTH)\r\n",
+        (int)prof_ctx.dropped);
+
+  printf("\r\n %-44s %7s %12s %12s\r\n", "label", "calls", "total (ms)", "self (ms)");
+  printf(" ---------------------------------------------------------------------------------\r\n");
+
+  for (uint32_t i = 0; i < prof_ctx.n_labels; i++) {
+    const struct aiProfilerLabel *label = &prof_ctx.labels[i];
+    snprintf(name, sizeof(name), "%*s%s", (int)(label->depth * 2), "",
+        label->name);
+    printf(" %-44s %7d", name, (int)(label->count / n_invoks));
+    dwtCyclesToTime(label->cycles / n_invoks, &t);
+    printf(" %8d.%03d", t.s * 1000 + t.ms, t.us);
+    dwtCyclesToTime(label->self / n_invoks, &t);
+    printf(" %8d.%03d %6.02f %c\r\n", t.s * 1000 + t.ms, t.us,
+        total ? ((float)label->self * 100.0f) / (float)total : 0.0f, '%');
+  }
+
+  printf(" ---------------------------------------------------------------------------------\r\n");
+  dwtCyclesToTime(total / n_invoks, &t);
+  printf(" %-44s %7s %12s %8d.%03d ms\r\n", "", "", "", t.s * 1000 + t.ms, t.us);
+}
+
+#endif /* RUY_PROFILER_LITE */
@@ -0,0 +1,205 @@
+/**
+ ******************************************************************************
+ * @file    aiTestTrace.c
+ * @author  MCD Vertical Application Team
+ * @brief   Compact binary trace of the inferences (node timeline) for the
+ *          AI test applications
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/*
+ * Description:
+ *
+ * - Recording of the trace events in a static buffer (format, see
+ *   aiTestTrace.h). When the buffer is full, the records are dropped
+ *   (counted in the header).
+ *
+ * History:
+ *  - v1.0 - initial version
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <aiTestUtility.h>
+#include <aiTestTrace.h>
+
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+
+struct aiTraceHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t rec_size;
+  uint32_t clock;
+  uint32_t dropped;
+};
+
+#define _TRACE_ALIGN(sz) (((sz) + 7) & ~7)
+
+MEM_ALIGNED(8)
+static uint8_t trace_buffer[AI_TEST_TRACE_SIZE];
+
+static struct aiTraceCtx {
+  uint32_t pos;             /* next record */
+  uint32_t cycles_per_ms;
+  uint64_t t_last;          /* last absolute timestamp */
+  uint64_t t_base;          /* start of the current inference */
+} trace_ctx;
+
+void aiTraceReset(void)
+{
+  struct aiTraceHeader *hdr = (struct aiTraceHeader *)trace_buffer;
+
+  memset(&trace_ctx, 0, sizeof(trace_ctx));
+  trace_ctx.cycles_per_ms = systemCoreClock() / 1000;
+  trace_ctx.pos = _TRACE_ALIGN(sizeof(struct aiTraceHeader));
+
+  hdr->magic = AI_TRACE_MAGIC;
+  hdr->version = AI_TRACE_VERSION;
+  hdr->rec_size = sizeof(struct aiTraceRec);
+  hdr->clock = systemCoreClock();
+  hdr->dropped = 0;
+}
+
+bool aiTraceIsEmpty(void)
+{
+  return trace_ctx.pos <= _TRACE_ALIGN(sizeof(struct aiTraceHeader));
+}
+
+static uint64_t _trace_now(void)
+{
+  uint64_t ts = (uint64_t)HAL_GetTick() * trace_ctx.cycles_per_ms;
+
+  if (ts < trace_ctx.t_last)
+    ts = trace_ctx.t_last;
+  trace_ctx.t_last = ts;
+  return ts;
+}
+
+/* Reserve a record (and its payload), NULL if the buffer is full */
+static struct aiTraceRec *_trace_alloc(uint32_t payload)
+{
+  const uint32_t sz = sizeof(struct aiTraceRec) + _TRACE_ALIGN(payload);
+  struct aiTraceRec *rec;
+
+  if (!trace_ctx.pos)
+    aiTraceReset();
+
+  if (trace_ctx.pos + sz > AI_TEST_TRACE_SIZE) {
+    ((struct aiTraceHeader *)trace_buffer)->dropped++;
+    return NULL;
+  }
+
+  rec = (struct aiTraceRec *)&trace_buffer[trace_ctx.pos];
+  memset(rec, 0, sz);
+  trace_ctx.pos += sz;
+  return rec;
+}
+
+static void _trace_event(uint8_t type, uint8_t track, uint16_t id,
+    uint64_t ts, uint32_t dur)
+{
+  struct aiTraceRec *rec = _trace_alloc(0);
+
+  if (rec) {
+    rec->type = type;
+    rec->track = track;
+    rec->id = id;
+    rec->ts = ts;
+    rec->dur = dur;
+  }
+}
+
+void aiTraceName(uint8_t track, uint16_t id, const char *name)
+{
+  const uint32_t len = (uint32_t)strlen(name) + 1;
+  struct aiTraceRec *rec = _trace_alloc(len);
+
+  if (rec) {
+    rec->type = AI_TRACE_REC_NAME;
+    rec->track = track;
+    rec->id = id;
+    rec->dur = len;
+    memcpy(rec + 1, name, len);
+  }
+}
+
+void aiTraceInferenceBegin(void)
+{
+  trace_ctx.t_base = _trace_now();
+}
+
+void aiTraceInferenceEnd(uint8_t track, uint16_t id, uint64_t cycles)
+{
+  _trace_event(AI_TRACE_REC_INFERENCE, track, id, trace_ctx.t_base,
+      (uint32_t)cycles);
+  trace_ctx.t_last = trace_ctx.t_base + cycles;
+}
+
+void aiTraceNode(uint8_t track, uint16_t id, uint64_t begin, uint64_t end,
+    uint32_t op_type, uint32_t out_bytes)
+{
+  struct aiTraceRec *rec = _trace_alloc(0);
+
+  if (rec) {
+    rec->type = AI_TRACE_REC_NODE;
+    rec->track = track;
+    rec->id = id;
+    rec->ts = trace_ctx.t_base + begin;
+    rec->dur = (uint32_t)(end - begin);
+    rec->arg0 = op_type;
+    rec->arg1 = out_bytes;
+  }
+}
+
+void aiTraceBegin(uint8_t track, uint16_t id)
+{
+  _trace_event(AI_TRACE_REC_BEGIN, track, id, _trace_now(), 0);
+}
+
+void aiTraceEnd(uint8_t track, uint16_t id)
+{
+  _trace_event(AI_TRACE_REC_END, track, id, _trace_now(), 0);
+}
+
+void aiTraceInstant(uint8_t track, uint16_t id)
+{
+  _trace_event(AI_TRACE_REC_INSTANT, track, id, _trace_now(), 0);
+}
+
+const uint8_t *aiTraceGet(uint32_t *size)
+{
+  if (!trace_ctx.pos)
+    aiTraceReset();
+  if (size)
+    *size = trace_ctx.pos;
+  return trace_buffer;
+}
+
+void aiTraceDump(void)
+{
+  uint32_t size;
+  const uint8_t *buf = aiTraceGet(&size);
+
+  for (uint32_t pos = 0; pos < size; pos += 32) {
+    printf("#trace ");
+    for (uint32_t i = pos; (i < pos + 32) && (i < size); i++)
+      printf("%02x", buf[i]);
+    printf("\r\n");
+  }
+  printf("#trace end\r\n");
+}
+
+#endif /* AI_TEST_TRACE */
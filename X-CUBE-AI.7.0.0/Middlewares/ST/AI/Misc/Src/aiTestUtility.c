@@ -26,6 +26,9 @@
  *  - v1.2 - add io low level code to manage a COM through the STM32 USB CDC profile
  *           enabled with the USE_USB_CDC_CLASS = 1 define.
  *  - v1.3 - Fix compilation issue for H7 dual core
+ *  - v1.4 - add pluggable low-level transport (ioRawSetTransport()), a Linux
+ *           implementation is provided by aiTestUtility_host.c
+ *  - v1.5 - add per-node heap peak and stack depth (stackMonNodeSample())
  */
 
 /*
@@ -155,6 +158,13 @@ extern UART_HandleTypeDef UartHandle;
 
 static bool _ioWriteAllowed = true;
 
+static const struct ioTransport *_ioTransport = NULL;
+
+void ioRawSetTransport(const struct ioTransport *transport)
+{
+  _ioTransport = transport;
+}
+
 int ioRawGetUint8(uint8_t *c, uint32_t timeout)
 {
   HAL_StatusTypeDef status;
@@ -187,6 +197,8 @@ void ioPushInUserUsb(uint8_t *pw, uint32_t *len)
 bool ioRawWriteBuffer(uint8_t *buff, int count)
 {
   HAL_StatusTypeDef status = HAL_OK;
+  if (_ioTransport)
+    return _ioTransport->write(_ioTransport->ctx, buff, count);
   while (USBD_BUSY == CDC_Transmit_FS(buff, count));
   // CDC_Transmit_FS(buff, count);
   return (status == HAL_OK);
@@ -195,6 +207,8 @@ bool ioRawWriteBuffer(uint8_t *buff, int count)
 bool ioRawReadBuffer(uint8_t *buff, int count)
 {
   HAL_StatusTypeDef status = HAL_OK;
+  if (_ioTransport)
+    return _ioTransport->read(_ioTransport->ctx, buff, count);
   while ((_usb_nb_w_item - _usb_nb_r_item) < count) {};
 
   uint8_t *pw = buff;
@@ -217,6 +231,9 @@ bool ioRawWriteBuffer(uint8_t *buff, int count)
 {
   HAL_StatusTypeDef status;
 
+  if (_ioTransport)
+    return _ioTransport->write(_ioTransport->ctx, buff, count);
+
   status = HAL_UART_Transmit(&UartHandle, buff, count, HAL_MAX_DELAY);
 
   return (status == HAL_OK);
@@ -226,6 +243,9 @@ bool ioRawReadBuffer(uint8_t *buff, int count)
 {
   HAL_StatusTypeDef status;
 
+  if (_ioTransport)
+    return _ioTransport->read(_ioTransport->ctx, buff, count);
+
   status = HAL_UART_Receive(&UartHandle, buff, count, HAL_MAX_DELAY);
 
   return (status == HAL_OK);
@@ -351,6 +371,9 @@ void* __wrap_malloc(size_t bytes)
     if (io_malloc.used > io_malloc.max) {
       io_malloc.max = io_malloc.used;
     }
+    if (io_malloc.used > io_malloc.node_max) {
+      io_malloc.node_max = io_malloc.used;
+    }
 
 #if _IO_MALLOC_TRACK_MODE == 1
     io_malloc.a_ptr[io_malloc.a_idx] = (ptr + 4);
@@ -450,6 +473,37 @@ void stackMonInit(uint32_t ctrl, uint32_t cstack, uint32_t msize)
   }
 }
 
+#if defined(_APP_STACK_MONITOR_) && _APP_STACK_MONITOR_ == 1
+
+int32_t stackMonNodeSample(void)
+{
+  uint32_t *pw, *pe;
+  int32_t depth;
+
+  if (!io_stack.stack_mon)
+    return -1;
+
+  /* lowest used word, the 8 last words are checked by MON_STACK_EVALUATE() */
+  pw = (uint32_t*)((io_stack.bstack + 3) & (~3)) + 8;
+  while ((*pw == 0xDEDEDEDE) && ((uint32_t)pw < io_stack.cstack))
+    pw++;
+
+  depth = (int32_t)(io_stack.cstack - (uint32_t)pw);
+  if (depth > io_stack.node_max)
+    io_stack.node_max = depth;
+
+  /* paint again the area which is not used */
+  pe = (uint32_t*)(__get_MSP() & (~3));
+  while (pw < pe) {
+    *pw = 0xDEDEDEDE;
+    pw++;
+  }
+
+  return depth;
+}
+
+#endif
+
 /* -----------------------------------------------------------------------------
  * HW-setting functions
  * -----------------------------------------------------------------------------
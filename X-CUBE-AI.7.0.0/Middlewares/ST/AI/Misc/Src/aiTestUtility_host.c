@@ -0,0 +1,622 @@
+/**
+ ******************************************************************************
+ * @file    aiTestUtility_host.c
+ * @author  MCD Vertical Application Team
+ * @brief   Linux implementation of the utility functions for the AI test
+ *          applications (host build, AI_TEST_HOST=1)
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/*
+ * Description:
+ *
+ * Replaces aiTestUtility.c when the test applications are built as a Linux
+ * process (see aiTestHost.h). The protocol channel is a pseudo-terminal or a
+ * Unix domain socket registered with ioRawSetTransport(), the standard
+ * output is used for the log.
+ *
+ * History:
+ *  - v1.0 - initial version
+ *  - v1.1 - heap monitor (wrapped allocation functions), hostLoadFile()
+ */
+
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* posix_openpt(), ptsname_r(), cfmakeraw() */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <aiTestUtility.h>
+
+
+/* -----------------------------------------------------------------------------
+ * HAL services
+ * -----------------------------------------------------------------------------
+ */
+
+UART_HandleTypeDef UartHandle = { STDOUT_FILENO };
+
+static uint64_t hostTimeNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData,
+    uint16_t Size, uint32_t Timeout)
+{
+  UNUSED(Timeout);
+
+  while (Size) {
+    ssize_t n = write(huart->fd, pData, Size);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return HAL_ERROR;
+    pData += n;
+    Size -= (uint16_t)n;
+  }
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData,
+    uint16_t Size, uint32_t Timeout)
+{
+  UNUSED(huart);
+
+  while (Size) {
+    struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+    int res = poll(&pfd, 1, (Timeout == HAL_MAX_DELAY) ? -1 : (int)Timeout);
+    if (res == 0)
+      return HAL_TIMEOUT;
+    if (res < 0 && errno == EINTR)
+      continue;
+    ssize_t n = (res < 0) ? -1 : read(STDIN_FILENO, pData, Size);
+    if (n <= 0)
+      return HAL_ERROR;
+    pData += n;
+    Size -= (uint16_t)n;
+  }
+  return HAL_OK;
+}
+
+static uint64_t _tick_origin;
+
+uint32_t HAL_GetTick(void)
+{
+  if (!_tick_origin)
+    _tick_origin = hostTimeNs();
+  return (uint32_t)((hostTimeNs() - _tick_origin) / 1000000ULL);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+  struct timespec ts = { Delay / 1000, (long)(Delay % 1000) * 1000000L };
+  while (nanosleep(&ts, &ts) && errno == EINTR);
+}
+
+uint32_t HAL_GetHalVersion(void)
+{
+  return 0;
+}
+
+uint32_t HAL_GetREVID(void)
+{
+  return 0;
+}
+
+uint32_t HAL_GetDEVID(void)
+{
+  return 0;
+}
+
+uint32_t HAL_RCC_GetSysClockFreq(void)
+{
+  return AI_TEST_HOST_CORE_CLOCK;
+}
+
+uint32_t HAL_RCC_GetHCLKFreq(void)
+{
+  return AI_TEST_HOST_CORE_CLOCK;
+}
+
+
+/* -----------------------------------------------------------------------------
+ * Emulated DWT cycle counter
+ * -----------------------------------------------------------------------------
+ */
+
+static uint64_t _cycles_origin;
+
+void hostCyclesReset(void)
+{
+  _cycles_origin = hostTimeNs();
+}
+
+uint32_t hostGetCycles(void)
+{
+  uint64_t ns = hostTimeNs() - _cycles_origin;
+#if AI_TEST_HOST_CORE_CLOCK == 1000000000UL
+  return (uint32_t)ns;
+#else
+  return (uint32_t)((ns * AI_TEST_HOST_CORE_CLOCK) / 1000000000ULL);
+#endif
+}
+
+
+/* -----------------------------------------------------------------------------
+ * IO functions
+ * -----------------------------------------------------------------------------
+ */
+
+static const struct ioTransport *_ioTransport = NULL;
+
+void ioRawSetTransport(const struct ioTransport *transport)
+{
+  _ioTransport = transport;
+}
+
+int ioRawGetUint8(uint8_t *c, uint32_t timeout)
+{
+  HAL_StatusTypeDef status;
+
+  if (!c)
+    return -1;
+
+  status = HAL_UART_Receive(&UartHandle, c, 1, timeout);
+
+  if (status == HAL_TIMEOUT)
+    return -1;
+
+  return (status == HAL_OK ? 1 : 0);
+}
+
+bool ioRawWriteBuffer(uint8_t *buff, int count)
+{
+  if (!_ioTransport)
+    return false;
+  return _ioTransport->write(_ioTransport->ctx, buff, count);
+}
+
+bool ioRawReadBuffer(uint8_t *buff, int count)
+{
+  if (!_ioTransport)
+    return false;
+  return _ioTransport->read(_ioTransport->ctx, buff, count);
+}
+
+void ioRawDisableLLWrite(void)
+{
+  /* log (stdout) and protocol channel are separated, nothing to do */
+}
+
+
+/* -----------------------------------------------------------------------------
+ * Linux transports
+ * -----------------------------------------------------------------------------
+ */
+
+struct ioHostLink {
+  int fd;       /* current data channel */
+  int lfd;      /* listening socket (-1 for a pty) */
+  int sfd;      /* slave side kept open (pty), avoids EIO without client */
+};
+
+static bool ioHostAccept(struct ioHostLink *link)
+{
+  if (link->fd >= 0)
+    close(link->fd);
+  do {
+    link->fd = accept(link->lfd, NULL, NULL);
+  } while (link->fd < 0 && errno == EINTR);
+  return (link->fd >= 0);
+}
+
+static bool ioHostWrite(void *ctx, const uint8_t *buff, int count)
+{
+  struct ioHostLink *link = (struct ioHostLink *)ctx;
+
+  if (link->fd < 0 && (link->lfd < 0 || !ioHostAccept(link)))
+    return false;
+
+  while (count > 0) {
+    ssize_t n = write(link->fd, buff, (size_t)count);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    buff += n;
+    count -= (int)n;
+  }
+  return true;
+}
+
+static bool ioHostRead(void *ctx, uint8_t *buff, int count)
+{
+  struct ioHostLink *link = (struct ioHostLink *)ctx;
+
+  if (link->fd < 0 && (link->lfd < 0 || !ioHostAccept(link)))
+    return false;
+
+  while (count > 0) {
+    ssize_t n = read(link->fd, buff, (size_t)count);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      /* client has gone: wait the next one, the on-going message is lost */
+      if (link->lfd >= 0)
+        ioHostAccept(link);
+      return false;
+    }
+    buff += n;
+    count -= (int)n;
+  }
+  return true;
+}
+
+static struct ioHostLink *ioHostNewLink(struct ioTransport *transport)
+{
+  struct ioHostLink *link;
+
+  if (!transport)
+    return NULL;
+
+  link = (struct ioHostLink *)malloc(sizeof(struct ioHostLink));
+  if (!link)
+    return NULL;
+
+  link->fd = link->lfd = link->sfd = -1;
+
+  transport->write = ioHostWrite;
+  transport->read = ioHostRead;
+  transport->ctx = link;
+
+  /* a client can disconnect at any time */
+  signal(SIGPIPE, SIG_IGN);
+
+  return link;
+}
+
+int ioHostOpenPty(struct ioTransport *transport, char *name, size_t size)
+{
+  struct termios tio;
+  char sname[64];
+  struct ioHostLink *link = ioHostNewLink(transport);
+
+  if (!link)
+    return -1;
+
+  link->fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((link->fd < 0) || grantpt(link->fd) || unlockpt(link->fd) ||
+      ptsname_r(link->fd, sname, sizeof(sname))) {
+    ioHostClose(transport);
+    return -1;
+  }
+
+  /* raw mode, the protocol is binary */
+  link->sfd = open(sname, O_RDWR | O_NOCTTY);
+  if ((link->sfd < 0) || tcgetattr(link->sfd, &tio)) {
+    ioHostClose(transport);
+    return -1;
+  }
+  cfmakeraw(&tio);
+  tcsetattr(link->sfd, TCSANOW, &tio);
+
+  if (name && size) {
+    strncpy(name, sname, size - 1);
+    name[size - 1] = 0;
+  }
+
+  return 0;
+}
+
+int ioHostOpenUnixSocket(struct ioTransport *transport, const char *path)
+{
+  struct sockaddr_un addr;
+  struct ioHostLink *link = ioHostNewLink(transport);
+
+  if (!link || !path || (strlen(path) >= sizeof(addr.sun_path))) {
+    ioHostClose(transport);
+    return -1;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  unlink(path);
+
+  link->lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if ((link->lfd < 0) ||
+      bind(link->lfd, (struct sockaddr *)&addr, sizeof(addr)) ||
+      listen(link->lfd, 1)) {
+    ioHostClose(transport);
+    return -1;
+  }
+
+  return 0;
+}
+
+void ioHostClose(struct ioTransport *transport)
+{
+  struct ioHostLink *link;
+
+  if (!transport || !transport->ctx)
+    return;
+
+  link = (struct ioHostLink *)transport->ctx;
+  if (link->fd >= 0)
+    close(link->fd);
+  if (link->lfd >= 0)
+    close(link->lfd);
+  if (link->sfd >= 0)
+    close(link->sfd);
+  free(link);
+
+  transport->ctx = NULL;
+}
+
+
+/* -----------------------------------------------------------------------------
+ * HEAP Monitor functions
+ * -----------------------------------------------------------------------------
+ */
+
+struct io_malloc io_malloc;
+
+#if defined(AI_TEST_HOST_HEAP_MONITOR) && (AI_TEST_HOST_HEAP_MONITOR == 1)
+
+#define MAGIC_MALLOC_NUMBER 0xefdcba98
+
+/* Placed before the returned block, the alignment of malloc() is kept
+ * (max_align_t is C11, the host apps are built with -std=gnu99) */
+union io_malloc_hdr {
+  struct {
+    size_t size;
+    uint32_t magic;
+  } h;
+  long long align_ll;
+  long double align_ld;
+  void *align_ptr;
+};
+
+void *__real_malloc(size_t bytes);
+void *__real_realloc(void *ptr, size_t bytes);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t bytes)
+{
+  union io_malloc_hdr *hdr;
+
+  io_malloc.cfg |= 1 << 1;
+
+  hdr = (union io_malloc_hdr *)__real_malloc(sizeof(*hdr) + bytes);
+  if (!hdr)
+    return NULL;
+
+  hdr->h.size = bytes;
+  hdr->h.magic = MAGIC_MALLOC_NUMBER;
+
+  if (io_malloc.cfg & 1UL) {
+    io_malloc.alloc_req++;
+    io_malloc.alloc += (uint32_t)bytes;
+    io_malloc.used += (uint32_t)bytes;
+    if (io_malloc.used > io_malloc.max)
+      io_malloc.max = io_malloc.used;
+    if (io_malloc.used > io_malloc.node_max)
+      io_malloc.node_max = io_malloc.used;
+  }
+  return hdr + 1;
+}
+
+void __wrap_free(void *ptr)
+{
+  union io_malloc_hdr *hdr;
+
+  io_malloc.cfg |= 1 << 2;
+
+  if (!ptr)
+    return;
+
+  hdr = (union io_malloc_hdr *)ptr - 1;
+  if (hdr->h.magic != MAGIC_MALLOC_NUMBER) {
+    /* not allocated by the wrappers, i.e. posix_memalign() */
+    __real_free(ptr);
+    return;
+  }
+  hdr->h.magic = 0;
+
+  if (io_malloc.cfg & 1UL) {
+    io_malloc.free_req++;
+    io_malloc.free += (uint32_t)hdr->h.size;
+    io_malloc.used -= (uint32_t)hdr->h.size;
+  }
+  __real_free(hdr);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+  void *ptr;
+
+  if (size && (n > (size_t)-1 / size))
+    return NULL;
+
+  ptr = __wrap_malloc(n * size);
+  if (ptr)
+    memset(ptr, 0, n * size);
+  return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t bytes)
+{
+  union io_malloc_hdr *hdr;
+  void *nptr;
+
+  if (!ptr)
+    return __wrap_malloc(bytes);
+
+  hdr = (union io_malloc_hdr *)ptr - 1;
+  if (hdr->h.magic != MAGIC_MALLOC_NUMBER)
+    return __real_realloc(ptr, bytes);
+
+  if (!bytes) {
+    __wrap_free(ptr);
+    return NULL;
+  }
+
+  nptr = __wrap_malloc(bytes);
+  if (nptr) {
+    memcpy(nptr, ptr, (hdr->h.size < bytes) ? hdr->h.size : bytes);
+    __wrap_free(ptr);
+  }
+  return nptr;
+}
+
+#endif
+
+
+/* -----------------------------------------------------------------------------
+ * STACK Monitor functions - not supported
+ * -----------------------------------------------------------------------------
+ */
+
+struct io_stack io_stack;
+
+void stackMonInit(uint32_t ctrl, uint32_t cstack, uint32_t msize)
+{
+  UNUSED(ctrl);
+  UNUSED(cstack);
+  UNUSED(msize);
+  memset(&io_stack, 0, sizeof(struct io_stack));
+}
+
+
+/* -----------------------------------------------------------------------------
+ * Model file
+ * -----------------------------------------------------------------------------
+ */
+
+void *hostLoadFile(const char *path, int *size)
+{
+  FILE *f = fopen(path, "rb");
+  void *data = NULL;
+  long len;
+
+  if (!f)
+    return NULL;
+
+  if ((fseek(f, 0, SEEK_END) == 0) && ((len = ftell(f)) > 0) &&
+      (fseek(f, 0, SEEK_SET) == 0)) {
+    /* flatbuffer fields are accessed in place, keep it aligned */
+    if (posix_memalign(&data, 16, (size_t)len) == 0) {
+      if (fread(data, 1, (size_t)len, f) != (size_t)len) {
+        free(data);
+        data = NULL;
+      } else
+        *size = (int)len;
+    }
+  }
+
+  fclose(f);
+  return data;
+}
+
+
+/* -----------------------------------------------------------------------------
+ * HW-setting functions
+ * -----------------------------------------------------------------------------
+ */
+
+struct cyclesCount cyclesCount;
+
+void dwtIpInit(void)
+{
+  hostCyclesReset();
+}
+
+uint32_t systemCoreClock(void)
+{
+  return HAL_RCC_GetSysClockFreq();
+}
+
+int dwtCyclesToTime(uint64_t clks, struct dwtTime *t)
+{
+  if (!t)
+    return -1;
+  uint32_t fcpu = systemCoreClock();
+  uint64_t s  = clks / fcpu;
+  uint64_t ms = (clks * 1000) / fcpu;
+  uint64_t us = (clks * 1000 * 1000) / fcpu;
+  ms -= (s * 1000);
+  us -= (ms * 1000 + s * 1000000);
+  t->fcpu = fcpu;
+  t->s = s;
+  t->ms = ms;
+  t->us = us;
+  return 0;
+}
+
+float dwtCyclesToFloatMs(uint64_t clks)
+{
+  float res;
+  float fcpu = (float)systemCoreClock();
+  res = ((float)clks * (float)1000.0) / fcpu;
+  return res;
+}
+
+uint32_t getFlashCacheConf(void)
+{
+  return 0;
+}
+
+void systemSettingLog(void)
+{
+  struct dwtTime t;
+  uint32_t st;
+
+  printf("Compiled with GCC %d.%d.%d\r\n", __GNUC__, __GNUC_MINOR__,
+      __GNUC_PATCHLEVEL__);
+
+  printf("Host Runtime configuration...\r\n");
+  printf(" Device       : Linux process (AI_TEST_HOST)\r\n");
+  printf(" system clock : %u MHz (emulated)\r\n",
+      (int)(systemCoreClock() / 1000000));
+
+  dwtIpInit();
+
+  /* Display HAL tick Calibration */
+  dwtReset();
+  HAL_Delay(100);
+  st = dwtGetCycles();
+  dwtCyclesToTime(st/100, &t);
+
+  printf(" Calibration  : HAL_Delay(1)=%d.%03d ms\r\n",
+      t.s * 100 + t.ms, t.us);
+}
+
+#endif /* AI_TEST_HOST */
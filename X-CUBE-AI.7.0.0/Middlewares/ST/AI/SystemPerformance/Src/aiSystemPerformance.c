@@ -26,6 +26,9 @@
  * - Random input values are injected in the NN to measure the inference time
  *   and to monitor the usage of the stack and/or the heap. Output value are
  *   skipped.
+ * - With AI_TEST_DATASET=1, the samples of a linked dataset are injected
+ *   instead (see aiTestDataset.h), the durations are also reported by class
+ *   and distribution.
  * - After N iterations (_APP_ITER_ C-define), results are reported through a
  *   re-target printf
  * - aiSystemPerformanceInit()/aiSystemPerformanceProcess() functions should
@@ -68,6 +71,10 @@
  *           Align aiBootstrap/aiInit/aiDeInit functions with aiValidation.c
  *           Adding support for outputs in activations buffer.
  *  - v5.2 - Use the fix cycle count overflow support for time per layer
+ *  - v5.3 - Add dataset-driven runs (AI_TEST_DATASET=1)
+ *  - v5.4 - Add stack depth and heap usage by node (observer)
+ *  - v5.5 - Add trace of the inferences and of the nodes (AI_TEST_TRACE=1),
+ *           see aiTestTrace.h
  */
 
 /* System headers */
@@ -96,10 +103,15 @@
 #include <aiSystemPerformance.h>
 #include <aiTestUtility.h>
 #include <aiTestHelper.h>
+#include <aiTestDataset.h>
+#include <aiTestTrace.h>
 
 
 /* AI Run-time header files */
 #include "ai_platform_interface.h"
+#include <ai_datatypes_internal.h>
+#include <core_common.h>      /* for GET_TENSOR_LIST_OUT().. definition */
+#include <core_private.h>
 
 /* AI x-cube-ai files */
 #include "app_x-cube-ai.h"
@@ -111,7 +123,7 @@
  */
 
 #define _APP_VERSION_MAJOR_     (0x05)
-#define _APP_VERSION_MINOR_     (0x02)
+#define _APP_VERSION_MINOR_     (0x05)
 #define _APP_VERSION_   ((_APP_VERSION_MAJOR_ << 8) | _APP_VERSION_MINOR_)
 
 #define _APP_NAME_      "AI system performance measurement"
@@ -123,6 +135,12 @@ static bool observer_mode = true;
 static bool profiling_mode = false;
 static int  profiling_factor = 5;
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+static bool dataset_mode = false;
+static struct aiTestDataset dataset;
+static struct aiTestDatasetStats dataset_stats;
+#endif
+
 
 /* -----------------------------------------------------------------------------
  * AI-related functions
@@ -267,6 +285,17 @@ static int aiInit(void)
     idx++;
   } while (nn_name);
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+  dataset_mode = false;
+  if (aiTestDatasetInit(&dataset, g_ai_test_dataset, g_ai_test_dataset_len)) {
+    printf("\r\nW: invalid dataset, random inputs are used\r\n");
+  } else {
+    printf("\r\nDataset: %d samples, %d classes\r\n",
+        (int)dataset.n_samples, (int)dataset.n_classes);
+    dataset_mode = true;
+  }
+#endif
+
   return res;
 }
 
@@ -296,6 +325,9 @@ static void aiDeInit(void)
 struct u_node_stat {
   uint64_t dur;
   uint32_t n_runs;
+  int32_t stack;      /* max stack depth, -1 if not monitored */
+  int32_t heap;       /* max used heap at the end of the node */
+  int32_t heap_peak;  /* max used heap during the node */
 };
 
 struct u_observer_ctx {
@@ -304,10 +336,58 @@ struct u_observer_ctx {
   uint64_t u_dur_t;
   uint64_t k_dur_t;
   struct u_node_stat *nodes;
+  int track;            /* trace track (network index) */
 };
 
 static struct u_observer_ctx u_observer_ctx;
 
+extern const char* ai_layer_type_name(const int type);
+
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+
+static void user_observer_trace(int track, const ai_observer_node *node,
+    uint64_t begin, uint64_t end, bool first)
+{
+  ai_tensor_list *tl = GET_TENSOR_LIST_OUT(node->tensors);
+  uint32_t bytes = 0;
+
+  AI_FOR_EACH_TENSOR_LIST_DO(i, t, tl) {
+    bytes += (uint32_t)AI_TENSOR_BYTE_SIZE(t);
+  }
+
+  if (first)
+    aiTraceName((uint8_t)track, node->c_idx,
+        ai_layer_type_name(node->type & (ai_u16)0x7FFF));
+  aiTraceNode((uint8_t)track, node->c_idx, begin, end,
+      node->type & (ai_u16)0x7FFF, bytes);
+}
+
+#endif
+
+/* Stack and heap usage since the PRE event of the node */
+static void user_observer_node_mon(struct u_node_stat *sn)
+{
+  int32_t val;
+
+  val = MON_STACK_NODE_SAMPLE();
+  if (val > sn->stack)
+    sn->stack = val;
+  val = MON_ALLOC_NODE_MAX_USED();
+  if (val > sn->heap_peak)
+    sn->heap_peak = val;
+  val = MON_ALLOC_USED();
+  if (val > sn->heap)
+    sn->heap = val;
+}
+
+static void user_observer_print_mon(int32_t val)
+{
+  if (val < 0)
+    printf(" %8s", "n.a.");
+  else
+    printf(" %8d", (int)val);
+}
+
 /* User callback */
 static ai_u32 user_observer_cb(const ai_handle cookie,
     const ai_u32 flags,
@@ -322,9 +402,18 @@ static ai_u32 user_observer_cb(const ai_handle cookie,
 
   if (flags & AI_OBSERVER_POST_EVT) {
     const uint64_t end_t = ts - u_obs->start_t;
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+    user_observer_trace(u_obs->track, node, u_obs->start_t, ts,
+        u_obs->nodes[node->c_idx].n_runs == 0);
+#endif
     u_obs->k_dur_t += end_t;
     u_obs->nodes[node->c_idx].dur += end_t;
     u_obs->nodes[node->c_idx].n_runs += 1;
+    user_observer_node_mon(&u_obs->nodes[node->c_idx]);
+  } else {
+    /* usage between two nodes is not attributed to the next one */
+    (void)MON_STACK_NODE_SAMPLE();
+    MON_ALLOC_NODE_RESET();
   }
 
   u_obs->start_t = cyclesCounterEnd();    /* time stamp exit */
@@ -348,6 +437,7 @@ void aiObserverInit(struct ai_network_exec_ctx *net_ctx)
   ai_mnetwork_get_private_handle(net_ctx->handle, &net_hdl, &net_params);
 
   memset((void *)&u_observer_ctx, 0, sizeof(struct u_observer_ctx));
+  u_observer_ctx.track = (int)(net_ctx - net_exec_ctx);
 
   /* allocate resources to store the state of the nodes */
   sz = net_ctx->report.n_nodes * sizeof(struct u_node_stat);
@@ -358,6 +448,11 @@ void aiObserverInit(struct ai_network_exec_ctx *net_ctx)
   }
 
   memset(u_observer_ctx.nodes, 0, sz);
+  for (int i = 0; i < net_ctx->report.n_nodes; i++) {
+    u_observer_ctx.nodes[i].stack = -1;
+    u_observer_ctx.nodes[i].heap = -1;
+    u_observer_ctx.nodes[i].heap_peak = -1;
+  }
 
   /* register the callback */
   res = ai_platform_observer_register(net_hdl, user_observer_cb,
@@ -370,8 +465,6 @@ void aiObserverInit(struct ai_network_exec_ctx *net_ctx)
   }
 }
 
-extern const char* ai_layer_type_name(const int type);
-
 void aiObserverDone(struct ai_network_exec_ctx *net_ctx)
 {
   ai_handle  net_hdl;
@@ -428,6 +521,23 @@ void aiObserverDone(struct ai_network_exec_ctx *net_ctx)
   dwtCyclesToTime(cumul, &t);
   printf(" %31s %6d.%03d ms\r\n", "", t.s * 1000 + t.ms, t.us);
 
+  printf("\r\n Stack and heap by c-node (max, bytes)\r\n");
+  printf("\r\n %-6s%-20s%-7s %8s %8s %8s\r\n", "c_id", "type", "id", "stack", "heap", "peak");
+  printf(" ---------------------------------------------------------\r\n");
+  node_info.c_idx = 0;
+  while (ai_platform_observer_node_info(net_hdl, &node_info)) {
+    struct u_node_stat *sn = &u_observer_ctx.nodes[node_info.c_idx];
+    printf(" %-6d%-20s%-5d ", node_info.c_idx,
+        ai_layer_type_name(node_info.type  & (ai_u16)0x7FFF),
+        (int)node_info.id);
+    user_observer_print_mon(sn->stack);
+    user_observer_print_mon(sn->heap);
+    user_observer_print_mon(sn->heap_peak);
+    printf("\r\n");
+    node_info.c_idx++;
+  }
+  printf(" ---------------------------------------------------------\r\n");
+
   free(u_observer_ctx.nodes);
   memset((void *)&u_observer_ctx, 0, sizeof(struct u_observer_ctx));
 
@@ -441,6 +551,38 @@ void aiObserverDone(struct ai_network_exec_ctx *net_ctx)
  * -----------------------------------------------------------------------------
  */
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+
+/* Check that the samples of the dataset can be used with the network */
+static bool aiDatasetIsCompatible(int idx)
+{
+  const ai_network_report *report = &net_exec_ctx[idx].report;
+
+  if (!dataset_mode)
+    return false;
+
+  if (dataset.n_inputs != (uint32_t)report->n_inputs) {
+    printf("W: dataset with %d inputs, random inputs are used\r\n",
+        (int)dataset.n_inputs);
+    return false;
+  }
+
+  for (int i = 0; i < report->n_inputs; i++) {
+    const ai_buffer *in = &report->inputs[i];
+    const uint32_t sz = AI_BUFFER_BYTE_SIZE(AI_BUFFER_SIZE(in),
+        AI_BUFFER_FORMAT(in));
+    if (dataset.in_size[i] != sz) {
+      printf("W: dataset input %d has %d bytes instead %d, random inputs are used\r\n",
+          i, (int)dataset.in_size[i], (int)sz);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+#endif
+
 static int aiTestPerformance(int idx)
 {
   int iter;
@@ -459,6 +601,11 @@ static int aiTestPerformance(int idx)
   ai_buffer ai_input[AI_MNETWORK_IN_NUM];
   ai_buffer ai_output[AI_MNETWORK_OUT_NUM];
 
+  bool use_dataset = false;
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+  uint64_t cb_dur = 0;
+#endif
+
   if (net_exec_ctx[idx].handle == AI_HANDLE_NULL) {
     printf("E: network handle is NULL\r\n");
     return -1;
@@ -471,8 +618,18 @@ static int aiTestPerformance(int idx)
   else
     niter = _APP_ITER_;
 
-  printf("\r\nRunning PerfTest on \"%s\" with random inputs (%d iterations)...\r\n",
-      net_exec_ctx[idx].report.model_name, niter);
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+  use_dataset = aiDatasetIsCompatible(idx);
+  if (use_dataset) {
+    /* each sample is used at least once */
+    if (niter < (int)dataset.n_samples)
+      niter = (int)dataset.n_samples;
+    aiTestDatasetStatsReset(&dataset_stats);
+  }
+#endif
+
+  printf("\r\nRunning PerfTest on \"%s\" with %s inputs (%d iterations)...\r\n",
+      net_exec_ctx[idx].report.model_name, use_dataset ? "dataset" : "random", niter);
 
 #if APP_DEBUG == 1
   MON_STACK_STATE("stack before test");
@@ -518,6 +675,11 @@ static int aiTestPerformance(int idx)
     fflush(stdout);
   }
 
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+  aiTraceReset();
+  aiTraceName((uint8_t)idx, AI_TRACE_TRACK_ID, net_exec_ctx[idx].report.model_name);
+#endif
+
 #if defined(USE_OBSERVER) && USE_OBSERVER == 1
   /* Enable observer */
   if (observer_mode) {
@@ -533,8 +695,15 @@ static int aiTestPerformance(int idx)
   /* Main inference loop */
   for (iter = 0; iter < niter; iter++) {
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+    /* Fill input tensors with the samples of the dataset */
+    for (int i = 0; use_dataset && (i < net_exec_ctx[idx].report.n_inputs); i++)
+      memcpy(ai_input[i].data, aiTestDatasetInput(&dataset, iter, i),
+          dataset.in_size[i]);
+#endif
+
     /* Fill input tensors with random data */
-    for (int i = 0; i < net_exec_ctx[idx].report.n_inputs; i++) {
+    for (int i = 0; !use_dataset && (i < net_exec_ctx[idx].report.n_inputs); i++) {
       const ai_buffer_format fmt = AI_BUFFER_FORMAT(&ai_input[i]);
       ai_i8 *in_data = (ai_i8 *)ai_input[i].data;
       for (ai_size j = 0; j < AI_BUFFER_SIZE(&ai_input[i]); ++j) {
@@ -556,6 +725,10 @@ static int aiTestPerformance(int idx)
 
     // free(malloc(20));
 
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+    aiTraceInferenceBegin();
+#endif
+
     cyclesCounterStart();
     batch = ai_mnetwork_run(net_exec_ctx[idx].handle, ai_input, ai_output);
     if (batch != 1) {
@@ -565,10 +738,27 @@ static int aiTestPerformance(int idx)
     }
     tend = cyclesCounterEnd();
 
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+    aiTraceInferenceEnd((uint8_t)idx, (uint16_t)iter, tend);
+#endif
+
     MON_ALLOC_DISABLE();
 
     tcumul += tend;
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+    if (use_dataset) {
+      uint64_t dur = tend;
+#if defined(USE_OBSERVER) && USE_OBSERVER == 1
+      /* remove the time of the user cb of this inference */
+      dur -= u_observer_ctx.u_dur_t - cb_dur;
+      cb_dur = u_observer_ctx.u_dur_t;
+#endif
+      aiTestDatasetStatsAdd(&dataset_stats, aiTestDatasetLabel(&dataset, iter),
+          dur);
+    }
+#endif
+
     dwtCyclesToTime(tend, &t);
 
 #if APP_DEBUG == 1
@@ -621,12 +811,22 @@ static int aiTestPerformance(int idx)
   MON_STACK_REPORT();
   MON_ALLOC_REPORT();
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+  if (use_dataset)
+    aiTestDatasetStatsReport(&dataset_stats, &dataset);
+#endif
+
 #if defined(USE_OBSERVER) && USE_OBSERVER == 1
   printf(" observer res : %d bytes used from the heap (%d c-nodes)\r\n", observer_heap_sz,
 			(int)net_exec_ctx[idx].report.n_nodes);
   aiObserverDone(&net_exec_ctx[idx]);
 #endif
 
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+  printf("\r\n");
+  aiTraceDump();
+#endif
+
   return 0;
 }
 
@@ -26,6 +26,23 @@
  *  - v1.0 - Initial version
  *  - v1.1 - Code clean-up
  *           Add CB log (APP_DEBUG only)
+ *  - v1.2 - can be built as a Linux process (AI_TEST_HOST=1), the model is
+ *           loaded at run-time (see aiSystemPerformance_host.c)
+ *  - v1.3 - dataset-driven runs (AI_TEST_DATASET=1), the inputs are the
+ *           samples of a dataset (see aiTestDataset.h), durations are
+ *           reported by class and distribution
+ *  - v1.4 - stack depth and heap usage by node (observer)
+ *  - v1.5 - trace of the inferences and of the nodes (AI_TEST_TRACE=1),
+ *           see aiTestTrace.h
+ *  - v1.6 - intra-kernel phases (scoped labels of the kernels), all the
+ *           sources built with RUY_PROFILER_LITE, see aiTestProfiler.h
+ *  - v1.7 - data cache simulation by node (host, AI_TEST_HOST_CACHE_SIM=1),
+ *           see aiTestCacheSim.h
+ *  - v1.8 - optional fast region of the tensor arena (TFLM_NETWORK_FAST_AREA_SIZE),
+ *           see tflm_c_create_ex()
+ *  - v1.9 - report the copies elided by the memory planner (views,
+ *           concatenation and split slices)
+ *  - v1.10 - report the nodes run patch by patch (TFLM_RUNTIME_PATCH_NODES)
  */
 
 /* System headers */
@@ -59,20 +76,35 @@
 /* APP header files */
 #include <aiSystemPerformance.h>
 #include <aiTestUtility.h>
+#include <aiTestDataset.h>
+#include <aiTestTrace.h>
+#include <aiTestProfiler.h>
+#include <aiTestCacheSim.h>
 
 /* AI x-cube-ai files */
+#if !defined(AI_TEST_HOST) || (AI_TEST_HOST == 0)
 #include <app_x-cube-ai.h>
+#endif
 
 #include <tflm_c.h>
 
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+#ifndef TFLM_NETWORK_TENSOR_AREA_SIZE
+#define TFLM_NETWORK_TENSOR_AREA_SIZE (1024 * 1024)
+#endif
+/* loaded from a .tflite file by the host application */
+extern const uint8_t *g_tflm_network_model_data;
+extern int g_tflm_network_model_data_len;
+#else
 #include "network_tflite_data.h"
+#endif
 
 /* -----------------------------------------------------------------------------
  * TEST-related definitions
  * -----------------------------------------------------------------------------
  */
 #define _APP_VERSION_MAJOR_     (0x01)
-#define _APP_VERSION_MINOR_     (0x01)
+#define _APP_VERSION_MINOR_     (0x0A)
 #define _APP_VERSION_           ((_APP_VERSION_MAJOR_ << 8) | _APP_VERSION_MINOR_)
 
 #define _APP_NAME_              "AI system performance measurement TFLM"
@@ -81,6 +113,12 @@
 static bool profiling_mode = false;
 static int  profiling_factor = 5;
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+static bool dataset_mode = false;
+static struct aiTestDataset dataset;
+static struct aiTestDatasetStats dataset_stats;
+#endif
+
 
 /* -----------------------------------------------------------------------------
  * Object definition/declaration for AI-related execution context
@@ -96,6 +134,16 @@ struct tflm_context {
 MEM_ALIGNED(16)
 static uint8_t tensor_arena[TFLM_NETWORK_TENSOR_AREA_SIZE+32];
 
+/* Fast region for the hottest activations and scratch buffers (i.e. DTCM),
+ * TFLM_NETWORK_FAST_AREA_ATTR can be used to place it (section attribute) */
+#if defined(TFLM_NETWORK_FAST_AREA_SIZE) && (TFLM_NETWORK_FAST_AREA_SIZE > 0)
+#ifndef TFLM_NETWORK_FAST_AREA_ATTR
+#define TFLM_NETWORK_FAST_AREA_ATTR
+#endif
+MEM_ALIGNED(16)
+static uint8_t tensor_fast_area[TFLM_NETWORK_FAST_AREA_SIZE+32] TFLM_NETWORK_FAST_AREA_ATTR;
+#endif
+
 extern UART_HandleTypeDef UartHandle;
 
 #ifdef __cplusplus
@@ -134,6 +182,9 @@ void log_tensor(struct tflm_c_tensor_info* t_info, int idx)
 struct u_node_stat {
   char name[22];
   uint64_t dur;
+  int32_t stack;      /* max stack depth, -1 if not monitored */
+  int32_t heap;       /* max used heap at the end of the node */
+  int32_t heap_peak;  /* max used heap during the node */
 };
 
 static uint64_t _current_time_ticks_cb(int mode)
@@ -144,15 +195,58 @@ static uint64_t _current_time_ticks_cb(int mode)
   return val;
 }
 
+static void _print_mon_value(int32_t val)
+{
+  if (val < 0)
+    printf(" %8s", "n.a.");
+  else
+    printf(" %8d", (int)val);
+}
+
+/* Called at the end of each node, the usage since the previous node is
+ * attributed to the node */
+static void _observer_node_mon(struct u_node_stat *stat)
+{
+  int32_t val;
+
+  val = MON_STACK_NODE_SAMPLE();
+  if (val > stat->stack)
+    stat->stack = val;
+  val = MON_ALLOC_NODE_MAX_USED();
+  if (val > stat->heap_peak)
+    stat->heap_peak = val;
+  val = MON_ALLOC_USED();
+  if (val > stat->heap)
+    stat->heap = val;
+  MON_ALLOC_NODE_RESET();
+}
+
 static int _observer_node_cb(const void* cookie,
     const uint32_t flags,
     const struct tflm_c_node* node)
 {
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+  const uint64_t ts = cyclesCounterEnd();
+#endif
+
   if (cookie) {
     struct u_node_stat* stat = (struct u_node_stat*)cookie;
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+    uint32_t bytes = 0;
+    for (int i=0; i<node->node_info.n_outputs; i++)
+      bytes += (uint32_t)node->output[i].bytes;
+    if (!stat[node->node_info.idx].name[0])
+      aiTraceName(0, (uint16_t)node->node_info.idx, node->node_info.name);
+    aiTraceNode(0, (uint16_t)node->node_info.idx, ts - node->node_info.dur, ts,
+        node->node_info.builtin_code, bytes);
+#endif
     // stat[node->node_info.idx].name =
     strncpy(stat[node->node_info.idx].name, node->node_info.name, 20); // strlen(node->node_info.name));
+#if defined(AI_TEST_HOST_CACHE_SIM) && (AI_TEST_HOST_CACHE_SIM == 1)
+    aiCacheSimNode(node->node_info.idx, stat[node->node_info.idx].name);
+#endif
     stat[node->node_info.idx].dur += node->node_info.dur;
+    _observer_node_mon(&stat[node->node_info.idx]);
   }
 
 #if APP_DEBUG == 1
@@ -199,6 +293,16 @@ static TfLiteStatus observer_init(struct tflm_context *ctx)
     return kTfLiteError;
 
   memset(_observer_options.cookie, 0, sz);
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1) && (APP_DEBUG != 1)
+  /* the output tensors are requested for the trace (size) */
+  _observer_options.flags = OBSERVER_FLAGS_DEFAULT;
+#endif
+  for (int i=0; i<tflm_c_operators_size(ctx->hdl); i++) {
+    struct u_node_stat* stat = (struct u_node_stat*)_observer_options.cookie;
+    stat[i].stack = -1;
+    stat[i].heap = -1;
+    stat[i].heap_peak = -1;
+  }
 
   res = tflm_c_observer_register(ctx->hdl, &_observer_options);
   if (res != kTfLiteOk) {
@@ -226,6 +330,9 @@ static void observer_done(struct tflm_context *ctx)
     printf("  kernel  : %d.%03dms (time passed in the c-kernel fcts)\r\n", t.s * 1000 + t.ms, t.us);
     dwtCyclesToTime(p_info.cb_dur / p_info.n_invoks, &t);
     printf("  user    : %d.%03dms (time passed in the user cb)\r\n", t.s * 1000 + t.ms, t.us);
+    if (p_info.n_fused_nodes)
+      printf("  fused   : %d nodes (%d bytes of memory traffic saved by inference)\r\n",
+          (int)p_info.n_fused_nodes, (int)p_info.fusion_bytes_saved);
 
     printf("\r\n %-6s%-25s %s\r\n", "idx", "name", "time (ms)");
     printf(" ---------------------------------------------------\r\n");
@@ -245,6 +352,18 @@ static void observer_done(struct tflm_context *ctx)
     dwtCyclesToTime(cumul / p_info.n_invoks, &t);
     printf(" %31s %6d.%03d ms\r\n", "", t.s * 1000 + t.ms, t.us);
 
+    printf("\r\n Stack and heap by c-node (max, bytes)\r\n");
+    printf("\r\n %-6s%-25s %8s %8s %8s\r\n", "idx", "name", "stack", "heap", "peak");
+    printf(" ---------------------------------------------------------\r\n");
+    for (int i=0; i<tflm_c_operators_size(ctx->hdl); i++) {
+      printf(" %-6d%-25s", i, stat[i].name);
+      _print_mon_value(stat[i].stack);
+      _print_mon_value(stat[i].heap);
+      _print_mon_value(stat[i].heap_peak);
+      printf("\r\n");
+    }
+    printf(" ---------------------------------------------------------\r\n");
+
     free(_observer_options.cookie);
     _observer_options.cookie = NULL;
 
@@ -254,23 +373,75 @@ static void observer_done(struct tflm_context *ctx)
 
 #endif
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+
+static void aiDatasetInit(struct tflm_context *ctx)
+{
+  dataset_mode = false;
+
+  if (!g_ai_test_dataset)
+    return;
+
+  if (aiTestDatasetInit(&dataset, g_ai_test_dataset, g_ai_test_dataset_len)) {
+    printf("W: invalid dataset, random inputs are used\r\n");
+    return;
+  }
+
+  if (dataset.n_inputs != (uint32_t)tflm_c_inputs_size(ctx->hdl)) {
+    printf("W: dataset with %d inputs, random inputs are used\r\n",
+        (int)dataset.n_inputs);
+    return;
+  }
+
+  for (int i=0; i<tflm_c_inputs_size(ctx->hdl); i++) {
+    struct tflm_c_tensor_info t_info;
+    tflm_c_input(ctx->hdl, i, &t_info);
+    if (dataset.in_size[i] != (uint32_t)t_info.bytes) {
+      printf("W: dataset input %d has %d bytes instead %d, random inputs are used\r\n",
+          i, (int)dataset.in_size[i], (int)t_info.bytes);
+      return;
+    }
+  }
+
+  printf(" Dataset            : %d samples, %d classes\r\n",
+      (int)dataset.n_samples, (int)dataset.n_classes);
+  dataset_mode = true;
+}
+
+#endif
+
 static int aiBootstrap(struct tflm_context *ctx)
 {
   TfLiteStatus res;
   struct tflm_c_version ver;
+  int32_t n_elided;
+  uint32_t elided_bytes;
+  int32_t n_patched;
+  uint32_t n_patches;
 
   /* Creating an instance of the network ------------------------- */
   printf("\r\nInstancing the network.. (cWrapper: v%s)\r\n", TFLM_C_VERSION_STR);
 
   /* TFLm runtime expects that the tensor arena is aligned on 16-bytes */
-  uint32_t uaddr = (uint32_t)tensor_arena;
-  uaddr = (uaddr + (16 - 1)) & (uint32_t)(-16);  // Round up to 16-byte boundary
+  uintptr_t uaddr = (uintptr_t)tensor_arena;
+  uaddr = (uaddr + (16 - 1)) & (uintptr_t)(-16);  // Round up to 16-byte boundary
+
+#if defined(TFLM_NETWORK_FAST_AREA_SIZE) && (TFLM_NETWORK_FAST_AREA_SIZE > 0)
+  struct tflm_c_arena_region regions[2] = {
+      { (uint8_t*)uaddr, TFLM_NETWORK_TENSOR_AREA_SIZE },
+      { tensor_fast_area, TFLM_NETWORK_FAST_AREA_SIZE + 32 },
+  };
+#endif
 
   MON_ALLOC_RESET();
   MON_ALLOC_ENABLE();
 
+#if defined(TFLM_NETWORK_FAST_AREA_SIZE) && (TFLM_NETWORK_FAST_AREA_SIZE > 0)
+  res = tflm_c_create_ex(g_tflm_network_model_data, regions, 2, &ctx->hdl);
+#else
   res = tflm_c_create(g_tflm_network_model_data, (uint8_t*)uaddr,
           TFLM_NETWORK_TENSOR_AREA_SIZE, &ctx->hdl);
+#endif
 
   MON_ALLOC_DISABLE();
 
@@ -278,16 +449,37 @@ static int aiBootstrap(struct tflm_context *ctx)
     return -1;
   }
 
+#if defined(AI_TEST_HOST_CACHE_SIM) && (AI_TEST_HOST_CACHE_SIM == 1)
+  aiCacheSimRegion((const void *)uaddr, TFLM_NETWORK_TENSOR_AREA_SIZE, "arena");
+  aiCacheSimRegion(g_tflm_network_model_data,
+      (uint32_t)g_tflm_network_model_data_len, "model");
+#if defined(TFLM_NETWORK_FAST_AREA_SIZE) && (TFLM_NETWORK_FAST_AREA_SIZE > 0)
+  aiCacheSimRegion(tensor_fast_area, sizeof(tensor_fast_area), "fast");
+#endif
+#endif
+
   tflm_c_rt_version(&ver);
 
   printf(" TFLM version       : %d.%d.%d\r\n", (int)ver.major, (int)ver.minor, (int)ver.patch);
-  printf(" TFLite file        : 0x%08x (%d bytes)\r\n", (int)g_tflm_network_model_data,
+  printf(" TFLite file        : 0x%08x (%d bytes)\r\n", (int)(uintptr_t)g_tflm_network_model_data,
       (int)g_tflm_network_model_data_len);
   printf(" Arena location     : 0x%08x\r\n", (int)uaddr);
   printf(" Operator size      : %d\r\n", (int)tflm_c_operators_size(ctx->hdl));
   printf(" Tensor size        : %d\r\n", (int)tflm_c_tensors_size(ctx->hdl));
   printf(" Allocated size     : %d / %d\r\n", (int)tflm_c_arena_used_bytes(ctx->hdl),
       TFLM_NETWORK_TENSOR_AREA_SIZE);
+#if defined(TFLM_NETWORK_FAST_AREA_SIZE) && (TFLM_NETWORK_FAST_AREA_SIZE > 0)
+  printf(" Fast area          : 0x%08x, %d / %d\r\n", (int)(uintptr_t)tensor_fast_area,
+      (int)tflm_c_arena_region_used_bytes(ctx->hdl, 1), TFLM_NETWORK_FAST_AREA_SIZE);
+#endif
+  n_elided = tflm_c_elided_copies(ctx->hdl, &elided_bytes);
+  if (n_elided)
+    printf(" Elided copies      : %d tensors (%d bytes by inference)\r\n",
+        (int)n_elided, (int)elided_bytes);
+  n_patched = tflm_c_patch_execution(ctx->hdl, &n_patches);
+  if (n_patched)
+    printf(" Patch execution    : %d nodes, %d patches\r\n",
+        (int)n_patched, (int)n_patches);
   printf(" Inputs size        : %d\r\n", (int)tflm_c_inputs_size(ctx->hdl));
   for (int i=0; i<tflm_c_inputs_size(ctx->hdl); i++) {
     struct tflm_c_tensor_info t_info;
@@ -306,15 +498,19 @@ static int aiBootstrap(struct tflm_context *ctx)
   // MON_ALLOC_REPORT();
 #endif
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+  aiDatasetInit(ctx);
+#endif
+
   return 0;
 }
 
 static void aiDone(struct tflm_context *ctx)
 {
   /* Releasing the instance(s) ------------------------------------- */
-  printf("Releasing the instance...\r\n");
-
+  /* Already released by the QUIT event on host */
   if (ctx->hdl != 0) {
+    printf("Releasing the instance...\r\n");
     tflm_c_destroy(ctx->hdl);
     ctx->hdl = 0;
   }
@@ -359,6 +555,11 @@ static int aiTestPerformance(void)
   struct tflm_c_profile_info p_info;
 #endif
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+  void *in_data[AI_TEST_DATASET_MAX_INPUTS];
+  uint64_t cb_dur = 0;
+#endif
+
   struct tflm_context *ctx = &net_exec_ctx[0];
 
   tflm_c_rt_version(&ver);
@@ -375,6 +576,20 @@ static int aiTestPerformance(void)
   else
     niter = _APP_ITER_;
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+  if (dataset_mode) {
+    /* each sample is used at least once */
+    if (niter < (int)dataset.n_samples)
+      niter = (int)dataset.n_samples;
+    for (int i=0; i<tflm_c_inputs_size(ctx->hdl); i++) {
+      struct tflm_c_tensor_info t_info;
+      tflm_c_input(ctx->hdl, i, &t_info);
+      in_data[i] = t_info.data;
+    }
+    aiTestDatasetStatsReset(&dataset_stats);
+    printf("\r\nRunning PerfTest with dataset inputs (%d iterations)...\r\n", niter);
+  } else
+#endif
   printf("\r\nRunning PerfTest with random inputs (%d iterations)...\r\n", niter);
 
 
@@ -398,11 +613,24 @@ static int aiTestPerformance(void)
     fflush(stdout);
   }
 
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+  aiTraceReset();
+  aiTraceName(0, AI_TRACE_TRACK_ID, "network");
+#endif
+
 #if defined(USE_OBSERVER) && USE_OBSERVER == 1
   observer_init(ctx);
   tflm_c_observer_start(ctx->hdl);
 #endif
 
+#if defined(RUY_PROFILER_LITE)
+  aiProfilerReset();
+#endif
+
+#if defined(AI_TEST_HOST_CACHE_SIM) && (AI_TEST_HOST_CACHE_SIM == 1)
+  aiCacheSimReset();
+#endif
+
   MON_ALLOC_RESET();
 
   /* Main inference loop */
@@ -411,14 +639,44 @@ static int aiTestPerformance(void)
     /* Fill input tensors with random data */
     /* .. */
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+    if (dataset_mode) {
+      for (uint32_t i=0; i<dataset.n_inputs; i++)
+        memcpy(in_data[i], aiTestDatasetInput(&dataset, iter, i),
+            dataset.in_size[i]);
+    }
+#endif
+
+#if defined(USE_OBSERVER) && USE_OBSERVER == 1
+    /* usage between two inferences is not attributed to the first node */
+    (void)MON_STACK_NODE_SAMPLE();
+    MON_ALLOC_NODE_RESET();
+#endif
+
     MON_ALLOC_ENABLE();
 
     // free(malloc(20));
 
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+    aiTraceInferenceBegin();
+#endif
+
+#if defined(AI_TEST_HOST_CACHE_SIM) && (AI_TEST_HOST_CACHE_SIM == 1)
+    aiCacheSimEnable(true);
+#endif
+
     cyclesCounterStart();
     res = tflm_c_invoke(ctx->hdl);
     tend = cyclesCounterEnd();
 
+#if defined(AI_TEST_HOST_CACHE_SIM) && (AI_TEST_HOST_CACHE_SIM == 1)
+    aiCacheSimEnable(false);
+#endif
+
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1)
+    aiTraceInferenceEnd(0, (uint16_t)iter, tend);
+#endif
+
     if (res != kTfLiteOk) {
       printf("tflm_c_invoke() fails\r\n");
       return res;
@@ -428,6 +686,20 @@ static int aiTestPerformance(void)
 
     tcumul += tend;
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+    if (dataset_mode) {
+      uint64_t dur = tend;
+#if defined(USE_OBSERVER) && USE_OBSERVER == 1
+      /* remove the time of the user cb of this inference */
+      tflm_c_observer_info(ctx->hdl, &p_info);
+      dur -= p_info.cb_dur - cb_dur;
+      cb_dur = p_info.cb_dur;
+#endif
+      aiTestDatasetStatsAdd(&dataset_stats, aiTestDatasetLabel(&dataset, iter),
+          dur);
+    }
+#endif
+
     dwtCyclesToTime(tend, &t);
 
 #if APP_DEBUG == 1
@@ -485,10 +757,30 @@ static int aiTestPerformance(void)
   MON_STACK_REPORT();
   MON_ALLOC_REPORT();
 
+#if defined(AI_TEST_DATASET) && (AI_TEST_DATASET == 1)
+  if (dataset_mode)
+    aiTestDatasetStatsReport(&dataset_stats, &dataset);
+#endif
+
 #if defined(USE_OBSERVER) && USE_OBSERVER == 1
   observer_done(ctx);
 #endif
 
+#if defined(RUY_PROFILER_LITE)
+  aiProfilerReport((uint32_t)iter);
+#endif
+
+#if defined(AI_TEST_HOST_CACHE_SIM) && (AI_TEST_HOST_CACHE_SIM == 1)
+  aiCacheSimReport((uint32_t)iter);
+#endif
+
+#if defined(AI_TEST_TRACE) && (AI_TEST_TRACE == 1) && \
+    (!defined(AI_TEST_HOST) || (AI_TEST_HOST == 0))
+  /* the host application writes the trace in a file */
+  printf("\r\n");
+  aiTraceDump();
+#endif
+
   return 0;
 }
 
@@ -510,10 +802,17 @@ static int aiTestPerformance(void)
 static int aiTestConsole(void)
 {
   uint8_t c = 0;
+  int res;
 
-  if (ioRawGetUint8(&c, 5000) == -1) /* Timeout */
+  res = ioRawGetUint8(&c, 5000);
+  if (res == -1) /* Timeout */
     return CONS_EVT_TIMEOUT;
 
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+  if (res == 0) /* end of the standard input, non-interactive run */
+    return CONS_EVT_QUIT;
+#endif
+
   if ((c == 'q') || (c == 'Q'))
     return CONS_EVT_QUIT;
 
@@ -552,7 +851,11 @@ int aiSystemPerformanceInit(void)
   cyclesCounterInit();
 
   if (aiInit()) {
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+    return -1;
+#else
     while (1);
+#endif
   }
 
   srand(3); /* deterministic outcome */
@@ -617,10 +920,14 @@ int aiSystemPerformanceProcess(void)
         disableInts();
         aiDeInit();
         printf("\r\n");
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+        break;
+#else
         printf("Board should be reseted...\r\n");
         while (1) {
           HAL_Delay(1000);
         }
+#endif
       }
       if (r == CONS_EVT_PAUSE) {
         printf("\r\n");
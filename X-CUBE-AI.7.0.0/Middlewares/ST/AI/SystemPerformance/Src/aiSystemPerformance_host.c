@@ -0,0 +1,172 @@
+/**
+ ******************************************************************************
+ * @file    aiSystemPerformance_host.c
+ * @author  MCD Vertical Application Team
+ * @brief   AI System perf. application - Linux process entry point (TFLM)
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/* Description
+ *
+ * - Runs aiSystemPerformance_TFLM.c as a Linux process, the TFLM model is
+ *   loaded from a .tflite file. The log has the same format as on target,
+ *   the core clock is emulated (AI_TEST_HOST_CORE_CLOCK, see aiTestHost.h).
+ *
+ *   Build (all files compiled with -DAI_TEST_HOST=1 -DTFLM_RUNTIME=1
+ *   -DTF_LITE_STATIC_MEMORY, include paths of the Inc directories). The host
+ *   files are empty when AI_TEST_HOST is not defined:
+ *     Misc/Src/{aiTestUtility_host.c, aiTestDataset.c, aiTestTrace.c,
+ *               aiTestProfiler.c, aiTestCacheSim_host.c}
+ *     SystemPerformance/Src/{aiSystemPerformance_host.c,
+ *                            aiSystemPerformance_TFLM.c}
+ *     TFliteMicro/Src/{tflm_c.cc, debug_log_imp.cc} + TFLM library
+ *
+ *   The heap monitor is enabled with -DAI_TEST_HOST_HEAP_MONITOR=1 and the
+ *   link options -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+ *
+ *   The data cache simulation is enabled with -DAI_TEST_HOST_CACHE_SIM=1,
+ *   the TFLM library is instrumented, see aiTestCacheSim.h
+ *
+ *   Usage:
+ *     aisystemperf_host -m <model.tflite> [-i <dataset>] [-t <trace>]
+ *                       [-c <KB:ways:line>]
+ *
+ *   -i  the inputs are the samples of a dataset (see aiTestDataset.h and
+ *       gen_perf_dataset.py) instead of random values
+ *   -t  the trace of the last perf. test is written in a file, see
+ *       aiTestTrace.h and gen_chrome_trace.py
+ *   -c  geometry of the simulated data cache (AI_TEST_HOST_CACHE_SIM=1),
+ *       default 16:4:32
+ *
+ *   The interactive console reads the standard input (keys followed by
+ *   enter). The process exits at the end of the standard input, so
+ *   "aisystemperf_host -m <model.tflite> < /dev/null" executes the perf.
+ *   test once (i.e. for a non-regression job).
+ *
+ * History:
+ *  - v1.0 - Initial version
+ *  - v1.1 - dataset-driven runs (-i option)
+ *  - v1.2 - trace file (-t option)
+ *  - v1.3 - geometry of the simulated data cache (-c option)
+ */
+
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+
+/* System headers */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+/* APP Header files */
+#include <aiSystemPerformance.h>
+#include <aiTestUtility.h>
+#include <aiTestDataset.h>
+#include <aiTestTrace.h>
+#include <aiTestCacheSim.h>
+
+
+/* model data, see aiSystemPerformance_TFLM.c */
+const uint8_t *g_tflm_network_model_data = NULL;
+int g_tflm_network_model_data_len = 0;
+
+static void usage(const char *app)
+{
+  printf("usage: %s -m <model.tflite> [-i <dataset>] [-t <trace>]"
+      " [-c <KB:ways:line>]\r\n", app);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *model = NULL;
+  const char *inputs = NULL;
+  const char *trace = NULL;
+  const char *cache = NULL;
+  void *model_data;
+  void *dataset_data = NULL;
+  int dataset_len = 0;
+  int opt;
+  int res;
+
+  while ((opt = getopt(argc, argv, "m:i:t:c:h")) != -1) {
+    switch (opt) {
+      case 'm': model = optarg; break;
+      case 'i': inputs = optarg; break;
+      case 't': trace = optarg; break;
+      case 'c': cache = optarg; break;
+      default: usage(argv[0]); return 1;
+    }
+  }
+
+  if (!model) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (cache) {
+#if defined(AI_TEST_HOST_CACHE_SIM) && (AI_TEST_HOST_CACHE_SIM == 1)
+    if (aiCacheSimConfig(cache)) {
+      printf("E: invalid cache geometry \"%s\"\r\n", cache);
+      return 1;
+    }
+#else
+    printf("W: -c ignored (built without AI_TEST_HOST_CACHE_SIM=1)\r\n");
+#endif
+  }
+
+  /* log is line buffered when redirected */
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  model_data = hostLoadFile(model, &g_tflm_network_model_data_len);
+  if (!model_data) {
+    printf("E: unable to load \"%s\"\r\n", model);
+    return 1;
+  }
+  g_tflm_network_model_data = (const uint8_t *)model_data;
+
+  if (inputs) {
+    dataset_data = hostLoadFile(inputs, &dataset_len);
+    if (!dataset_data) {
+      printf("E: unable to load \"%s\"\r\n", inputs);
+      free(model_data);
+      return 1;
+    }
+    g_ai_test_dataset = (const uint8_t *)dataset_data;
+    g_ai_test_dataset_len = (uint32_t)dataset_len;
+  }
+
+  res = aiSystemPerformanceInit();
+  if (!res)
+    res = aiSystemPerformanceProcess();
+  aiSystemPerformanceDeInit();
+
+  if (trace && !aiTraceIsEmpty()) {
+    uint32_t size;
+    const uint8_t *buf = aiTraceGet(&size);
+    FILE *f = fopen(trace, "wb");
+    if (!f || (fwrite(buf, 1, size, f) != size)) {
+      printf("E: unable to write \"%s\"\r\n", trace);
+      res = -1;
+    }
+    if (f)
+      fclose(f);
+  }
+
+  free(dataset_data);
+  free(model_data);
+
+  return (res < 0) ? 1 : 0;
+}
+
+#endif /* AI_TEST_HOST */
@@ -30,6 +30,10 @@
  * - v1.0: Initial version for STM32 aiSystemPerf/aiValidation support
  * - v1.1: Add reset all variables function
  *         Report only one scale/zero-point values (struct tflm_c_tensor_info)
+ * - v1.2: Add fused node count and saved memory traffic (struct tflm_c_profile_info)
+ * - v1.3: Add tflm_c_create_ex() (multi-region tensor arena)
+ * - v1.4: Add tflm_c_elided_copies() (tensors sharing the buffer of another tensor)
+ * - v1.5: Add tflm_c_patch_execution() (first nodes run patch by patch)
  *
  */
 
@@ -38,8 +42,8 @@ extern "C" {
 #endif
 
 #define TFLM_C_VERSION_MAJOR  (1)
-#define TFLM_C_VERSION_MINOR  (1)
-#define TFLM_C_VERSION_STR    "1.1"
+#define TFLM_C_VERSION_MINOR  (5)
+#define TFLM_C_VERSION_STR    "1.5"
 
 
 /* -----------------------------------------------------------------------------
@@ -112,6 +116,14 @@ struct tflm_c_version {
   uint8_t schema;
 };
 
+/* Memory region of the tensor arena, see tflm_c_create_ex() */
+struct tflm_c_arena_region {
+  uint8_t *buffer;
+  uint32_t size;
+};
+
+#define TFLM_C_MAX_ARENA_REGIONS (4)
+
 struct tflm_c_node {
   struct tflm_c_node_info node_info;
   struct tflm_c_tensor_info* output;
@@ -131,6 +143,8 @@ struct tflm_c_profile_info {
   uint64_t node_dur;
   uint32_t n_events;
   uint32_t n_invoks;
+  uint32_t n_fused_nodes;       /* nodes removed by the graph fusion pass */
+  uint32_t fusion_bytes_saved;  /* activation bytes no more moved per invoke */
 };
 
 #define OBSERVER_FLAGS_DEFAULT   (0)  // DATA + TIME
@@ -159,6 +173,20 @@ TfLiteStatus tflm_c_create(const uint8_t *model_data,
     const uint32_t tensor_arena_size,
     uint32_t *hdl);
 
+/*
+ * Same as tflm_c_create() with a tensor arena split in several memory
+ * regions (up to TFLM_C_MAX_ARENA_REGIONS). The first region holds the
+ * persistent data (interpreter, tensor structures, variables) and the
+ * non-persistent buffers which do not fit elsewhere. The next regions, from
+ * the fastest (i.e. DTCM) to the slowest, hold only non-persistent buffers:
+ * the scratch buffers first, then the tensors with the most node accesses
+ * over their lifetime.
+ */
+TfLiteStatus tflm_c_create_ex(const uint8_t *model_data,
+    const struct tflm_c_arena_region *regions,
+    const uint32_t n_regions,
+    uint32_t *hdl);
+
 TfLiteStatus tflm_c_destroy(uint32_t hdl);
 
 int32_t tflm_c_inputs_size(const uint32_t hdl);
@@ -176,6 +204,20 @@ int32_t tflm_c_tensors_size(const uint32_t hdl);
 
 int32_t tflm_c_arena_used_bytes(const uint32_t hdl);
 
+/* Used bytes of the region idx (see tflm_c_create_ex()), region 0 is the
+ * main arena (same as tflm_c_arena_used_bytes()) */
+int32_t tflm_c_arena_region_used_bytes(const uint32_t hdl, uint32_t idx);
+
+/* Number of tensors not copied by their operator (views, concatenation and
+ * split slices placed in the buffer of another tensor by the memory planner),
+ * bytes (optional): size of these copies by inference */
+int32_t tflm_c_elided_copies(const uint32_t hdl, uint32_t *bytes);
+
+/* Number of the first nodes run patch by patch (TFLM_RUNTIME_PATCH_NODES),
+ * 0 if the model is run layer by layer, n_patches (optional): number of
+ * spatial patches */
+int32_t tflm_c_patch_execution(const uint32_t hdl, uint32_t *n_patches);
+
 
 /* -----------------------------------------------------------------------------
  *  Observer/Profiler functions
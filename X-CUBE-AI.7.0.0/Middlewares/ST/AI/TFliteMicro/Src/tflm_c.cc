@@ -44,16 +44,86 @@
 #include "tensorflow/lite/micro/simple_memory_allocator.h"
 #include "tensorflow/lite/micro//memory_helpers.h"
 
+#include <cstdint>
+
 #include "tflm_c.h"
 
 // enable (=1) the capability to manage multiple output tensors in observer CB
 //  else only the first output tensor will be provided.
 #define _MULTIPLE_NODE_OUTPUTS_SUPPORT (1)
 
-// if (=0), resolver is created with all built-in operators
+// if (=1), resolver is created with the operators of the model only, as listed
+//  by the "tflm_c_model_ops.h" file generated by the RT-AK pipeline
+//  (gen_tflm_op_resolver.py).
+#if !defined(TFLM_RUNTIME_USE_MODEL_OPERATORS)
+#define TFLM_RUNTIME_USE_MODEL_OPERATORS 0
+#endif
+
+// if (=1), resolver is created with all built-in operators
 #if !defined(TFLM_RUNTIME_USE_ALL_OPERATORS)
+#if defined(TFLM_RUNTIME_USE_MODEL_OPERATORS) && TFLM_RUNTIME_USE_MODEL_OPERATORS == 1
+#define TFLM_RUNTIME_USE_ALL_OPERATORS 0
+#else
 #define TFLM_RUNTIME_USE_ALL_OPERATORS 1
 #endif
+#endif
+
+#if defined(TFLM_RUNTIME_USE_MODEL_OPERATORS) && TFLM_RUNTIME_USE_MODEL_OPERATORS == 1
+#include "tflm_c_model_ops.h"
+#endif
+
+// Host build (AI_TEST_HOST=1) with the heap monitor (see aiTestHost.h): as
+//  with the embedded C++ libraries, new/delete operators are based on the
+//  C-malloc/free functions, so the allocations are seen by the wrapped
+//  functions.
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1) && \
+    defined(AI_TEST_HOST_HEAP_MONITOR) && (AI_TEST_HOST_HEAP_MONITOR == 1)
+#include <cstdlib>
+#include <new>
+
+// The scalar and array forms do not call each other, each operator new has
+//  its unsized and sized operator delete.
+static void *tflm_c_host_new(std::size_t size) {
+  void *ptr = std::malloc(size ? size : 1);
+  if (!ptr)
+    std::abort();  // built without exceptions
+  return ptr;
+}
+
+void *operator new(std::size_t size) { return tflm_c_host_new(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+void *operator new[](std::size_t size) { return tflm_c_host_new(size); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+// if (=1), the graph fusion pass of the interpreter is enabled (see
+//  micro_graph_fusion.h): fused nodes are not reported by the observer.
+#if !defined(TFLM_RUNTIME_ENABLE_GRAPH_FUSION)
+#define TFLM_RUNTIME_ENABLE_GRAPH_FUSION 0
+#endif
+
+// if (>0), cache line size (bytes) of the cache-aware placement of the memory
+//  planner (see GreedyMemoryPlanner::SetCacheAwarePlacement()), i.e. 32 for
+//  the Cortex-M7 D-cache. Buffers used by a same node are placed side by side.
+#if !defined(TFLM_RUNTIME_CACHE_AWARE_PLANNER)
+#define TFLM_RUNTIME_CACHE_AWARE_PLANNER 0
+#endif
+
+// if (>0), number of the first nodes of the model run patch by patch (see
+//  micro_patch_execution.h), in TFLM_RUNTIME_PATCHES x TFLM_RUNTIME_PATCHES
+//  spatial patches: only one patch of their intermediate tensors is
+//  allocated. The nodes of the chain but the last are not reported by the
+//  observer, the last one includes the time of the chain.
+#if !defined(TFLM_RUNTIME_PATCH_NODES)
+#define TFLM_RUNTIME_PATCH_NODES 0
+#endif
+
+#if !defined(TFLM_RUNTIME_PATCHES)
+#define TFLM_RUNTIME_PATCHES 4
+#endif
 
 // if enabled indicates the maximum number of output tensors
 #if defined(_MULTIPLE_NODE_OUTPUTS_SUPPORT) and _MULTIPLE_NODE_OUTPUTS_SUPPORT == 1
@@ -63,6 +133,14 @@
 // forward declaration
 class CTfLiteInterpreterContext;
 
+// The C handle is the address of the context object. When the address does
+//  not fit in the uint32_t handle (64-bit host build), the context objects
+//  are registered in a table and the handle is the index + 1 in this table.
+#if UINTPTR_MAX > UINT32_MAX
+#define _HANDLE_TABLE_SIZE (8)
+static CTfLiteInterpreterContext* _handle_table[_HANDLE_TABLE_SIZE];
+#endif
+
 class CTfLiteProfiler : public tflite::MicroProfiler {
 public:
   CTfLiteProfiler(CTfLiteInterpreterContext* interp) : ctx_(interp), options_(nullptr),
@@ -120,6 +198,8 @@ public:
     p_info->cb_dur = cb_dur_;
     p_info->node_dur = node_dur_;
     p_info->n_events = event_starts_;
+    p_info->n_fused_nodes = fused_nodes();
+    p_info->fusion_bytes_saved = fusion_bytes_saved();
     return kTfLiteOk;
   }
 
@@ -187,64 +267,75 @@ public:
       uint8_t* tensor_arena, size_t tensor_arena_size,
       tflite::ErrorReporter* error_reporter): profiler(this),
           memory_allocator(error_reporter, tensor_arena, tensor_arena_size),
-          interpreter(model, op_resolver,
-              tflite::MicroAllocator::Create((tflite::SimpleMemoryAllocator *)&memory_allocator, error_reporter),
+          allocator(tflite::MicroAllocator::Create((tflite::SimpleMemoryAllocator *)&memory_allocator, error_reporter)),
+          interpreter(model, op_resolver, allocator,
           error_reporter, (tflite::MicroProfiler *)&profiler) {}
 
 public:
   CTfLiteProfiler profiler;
   CTfLiteAllocator memory_allocator;
+  tflite::MicroAllocator* allocator;
   tflite::MicroInterpreter interpreter;
   int n_invoks;
 
 public:
+  static CTfLiteInterpreterContext* from_handle(const uint32_t hdl) {
+#if UINTPTR_MAX > UINT32_MAX
+    if (hdl == 0 || hdl > _HANDLE_TABLE_SIZE)
+      return nullptr;
+    return _handle_table[hdl - 1];
+#else
+    return reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+#endif
+  }
+
   static TfLiteStatus input(const uint32_t hdl, int32_t index, struct tflm_c_tensor_info* t_info) {
-    CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+    CTfLiteInterpreterContext *ctx = from_handle(hdl);
     const TfLiteTensor* tens = ctx->interpreter.input(index);
     return ctx->tflitetensor_to(tens, t_info, -1);
   }
 
   static TfLiteStatus output(const uint32_t hdl, int32_t index, struct tflm_c_tensor_info* t_info) {
-    CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+    CTfLiteInterpreterContext *ctx = from_handle(hdl);
     const TfLiteTensor* tens = ctx->interpreter.output(index);
     return ctx->tflitetensor_to(tens, t_info, -1);
   }
 
   static TfLiteStatus invoke(const uint32_t hdl) {
-    CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+    CTfLiteInterpreterContext *ctx = from_handle(hdl);
     ctx->profiler.reset();
     ctx->n_invoks++;
     return ctx->interpreter.Invoke();
   }
 
   static TfLiteStatus reset_all_variables(const uint32_t hdl) {
-    CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+    CTfLiteInterpreterContext *ctx = from_handle(hdl);
     ctx->profiler.reset();
     return ctx->interpreter.ResetVariableTensors();
   }
 
   static TfLiteStatus observer_register(const uint32_t hdl, struct tflm_c_observer_options* options)
   {
-    CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+    CTfLiteInterpreterContext *ctx = from_handle(hdl);
     return ctx->profiler.register_cb(options);
   }
 
   static TfLiteStatus observer_unregister(const uint32_t hdl, struct tflm_c_observer_options* options)
   {
-    CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+    CTfLiteInterpreterContext *ctx = from_handle(hdl);
     return ctx->profiler.unregister_cb(options);
   }
 
   static TfLiteStatus observer_start(const uint32_t hdl)
   {
-    CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+    CTfLiteInterpreterContext *ctx = from_handle(hdl);
     ctx->n_invoks = 0;
     return ctx->profiler.start();
  }
 
   static TfLiteStatus observer_info(const uint32_t hdl, struct tflm_c_profile_info* p_info)
   {
-    CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+    CTfLiteInterpreterContext *ctx = from_handle(hdl);
     TfLiteStatus res = ctx->profiler.info(p_info);
     if (res == kTfLiteOk)
       p_info->n_invoks = ctx->n_invoks;
@@ -252,7 +343,26 @@ public:
   }
 
   uint32_t get_handle() {
+#if UINTPTR_MAX > UINT32_MAX
+    for (uint32_t idx = 0; idx < _HANDLE_TABLE_SIZE; idx++) {
+      if (_handle_table[idx] == nullptr || _handle_table[idx] == this) {
+        _handle_table[idx] = this;
+        return idx + 1;
+      }
+    }
+    return 0;
+#else
     return (uint32_t)this;
+#endif
+  }
+
+  void release_handle() {
+#if UINTPTR_MAX > UINT32_MAX
+    for (uint32_t idx = 0; idx < _HANDLE_TABLE_SIZE; idx++) {
+      if (_handle_table[idx] == this)
+        _handle_table[idx] = nullptr;
+    }
+#endif
   }
 
 private:
@@ -318,10 +428,21 @@ TfLiteStatus tflm_c_create(const uint8_t *model_data,
     uint8_t *tensor_arena,
     const uint32_t tensor_arena_size,
     uint32_t *hdl)
+{
+  struct tflm_c_arena_region region = { tensor_arena, tensor_arena_size };
+
+  return tflm_c_create_ex(model_data, &region, 1, hdl);
+}
+
+TfLiteStatus tflm_c_create_ex(const uint8_t *model_data,
+    const struct tflm_c_arena_region *regions,
+    const uint32_t n_regions,
+    uint32_t *hdl)
 {
   TfLiteStatus status;
 
-  if (!hdl || !tensor_arena_size || !tensor_arena || !model_data)
+  if (!hdl || !regions || !n_regions || n_regions > TFLM_C_MAX_ARENA_REGIONS ||
+      !regions[0].size || !regions[0].buffer || !model_data)
     return kTfLiteError;
 
   *hdl = 0;
@@ -335,29 +456,59 @@ TfLiteStatus tflm_c_create(const uint8_t *model_data,
 
 #if defined(TFLM_RUNTIME_USE_ALL_OPERATORS) && TFLM_RUNTIME_USE_ALL_OPERATORS == 1
   static tflite::AllOpsResolver _resolver;
+#elif defined(TFLM_RUNTIME_USE_MODEL_OPERATORS) && TFLM_RUNTIME_USE_MODEL_OPERATORS == 1
+  static tflite::MicroMutableOpResolver<TFLM_MODEL_OPS_COUNT> _resolver;
+  if (_resolver.GetRegistrationLength() == 0)
+    TFLM_MODEL_OPS_REGISTER(_resolver);
 #else
   static tflite::MicroMutableOpResolver<11> _resolver;
-  _resolver.AddConv2D();
-  _resolver.AddAveragePool2D();
-  _resolver.AddDepthwiseConv2D();
-  _resolver.AddFullyConnected();
-  _resolver.AddSoftmax();
-  _resolver.AddMaxPool2D();
-  _resolver.AddReshape();
-  _resolver.AddQuantize();
-  _resolver.AddDequantize();
-  _resolver.AddMul();
-  _resolver.AddAdd();
+  if (_resolver.GetRegistrationLength() == 0) {
+    _resolver.AddConv2D();
+    _resolver.AddAveragePool2D();
+    _resolver.AddDepthwiseConv2D();
+    _resolver.AddFullyConnected();
+    _resolver.AddSoftmax();
+    _resolver.AddMaxPool2D();
+    _resolver.AddReshape();
+    _resolver.AddQuantize();
+    _resolver.AddDequantize();
+    _resolver.AddMul();
+    _resolver.AddAdd();
+  }
  #endif
 
   CTfLiteInterpreterContext *ctx = new CTfLiteInterpreterContext(
       model,
       _resolver,
-      tensor_arena,
-      tensor_arena_size,
+      regions[0].buffer,
+      regions[0].size,
       &micro_error_reporter
   );
 
+  // Additional regions for the non-persistent buffers
+  for (uint32_t i = 1; i < n_regions; i++) {
+    if (ctx->allocator->AddArenaRegion(regions[i].buffer, regions[i].size) != kTfLiteOk) {
+      delete ctx;
+      return kTfLiteError;
+    }
+  }
+
+#if defined(TFLM_RUNTIME_ENABLE_GRAPH_FUSION) && TFLM_RUNTIME_ENABLE_GRAPH_FUSION == 1
+  ctx->interpreter.SetGraphFusionEnabled(true);
+#endif
+
+#if defined(TFLM_RUNTIME_CACHE_AWARE_PLANNER) && TFLM_RUNTIME_CACHE_AWARE_PLANNER > 0
+  if (ctx->allocator->SetCacheAwarePlanning(TFLM_RUNTIME_CACHE_AWARE_PLANNER) != kTfLiteOk) {
+    delete ctx;
+    return kTfLiteError;
+  }
+#endif
+
+#if defined(TFLM_RUNTIME_PATCH_NODES) && TFLM_RUNTIME_PATCH_NODES > 0
+  ctx->interpreter.SetPatchExecution(TFLM_RUNTIME_PATCH_NODES,
+      TFLM_RUNTIME_PATCHES, TFLM_RUNTIME_PATCHES);
+#endif
+
   // Allocate the resources
   status = ctx->interpreter.AllocateTensors();
   if (status != kTfLiteOk) {
@@ -367,26 +518,32 @@ TfLiteStatus tflm_c_create(const uint8_t *model_data,
   }
 
   *hdl = ctx->get_handle();
+  if (*hdl == 0) {
+    delete ctx;
+    return kTfLiteError;
+  }
 
   return kTfLiteOk;
 }
 
 TfLiteStatus tflm_c_destroy(uint32_t hdl)
 {
-  CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+  CTfLiteInterpreterContext *ctx = CTfLiteInterpreterContext::from_handle(hdl);
+  if (ctx)
+    ctx->release_handle();
   delete ctx;
   return kTfLiteOk;
 }
 
 int32_t tflm_c_inputs_size(const uint32_t hdl)
 {
-  CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+  CTfLiteInterpreterContext *ctx = CTfLiteInterpreterContext::from_handle(hdl);
   return ctx->interpreter.inputs_size();
 }
 
 int32_t tflm_c_outputs_size(const uint32_t hdl)
 {
-  CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+  CTfLiteInterpreterContext *ctx = CTfLiteInterpreterContext::from_handle(hdl);
   return ctx->interpreter.outputs_size();
 }
 
@@ -412,22 +569,47 @@ TfLiteStatus tflm_c_reset_all_variables(const uint32_t hdl)
 
 int32_t tflm_c_operators_size(const uint32_t hdl)
 {
-  CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+  CTfLiteInterpreterContext *ctx = CTfLiteInterpreterContext::from_handle(hdl);
   return ctx->interpreter.operators_size();
 }
 
 int32_t tflm_c_tensors_size(const uint32_t hdl)
 {
-  CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+  CTfLiteInterpreterContext *ctx = CTfLiteInterpreterContext::from_handle(hdl);
   return ctx->interpreter.tensors_size();
 }
 
 int32_t tflm_c_arena_used_bytes(const uint32_t hdl)
 {
-  CTfLiteInterpreterContext *ctx = reinterpret_cast<CTfLiteInterpreterContext *>(hdl);
+  CTfLiteInterpreterContext *ctx = CTfLiteInterpreterContext::from_handle(hdl);
   return ctx->interpreter.arena_used_bytes();
 }
 
+int32_t tflm_c_arena_region_used_bytes(const uint32_t hdl, uint32_t idx)
+{
+  CTfLiteInterpreterContext *ctx = CTfLiteInterpreterContext::from_handle(hdl);
+  if (idx == 0)
+    return ctx->interpreter.arena_used_bytes();
+  return ctx->allocator->region_used_bytes(idx - 1);
+}
+
+int32_t tflm_c_elided_copies(const uint32_t hdl, uint32_t *bytes)
+{
+  CTfLiteInterpreterContext *ctx = CTfLiteInterpreterContext::from_handle(hdl);
+  if (bytes)
+    *bytes = (uint32_t)ctx->allocator->elided_copy_bytes();
+  return ctx->allocator->elided_copies();
+}
+
+int32_t tflm_c_patch_execution(const uint32_t hdl, uint32_t *n_patches)
+{
+  CTfLiteInterpreterContext *ctx = CTfLiteInterpreterContext::from_handle(hdl);
+  const tflite::MicroPatchStats& stats = ctx->interpreter.patch_stats();
+  if (n_patches)
+    *n_patches = (uint32_t)stats.patches;
+  return stats.patched_nodes;
+}
+
 const char* tflm_c_TfLiteTypeGetName(TfLiteType type)
 {
   return TfLiteTypeGetName(type);
@@ -468,7 +650,12 @@ uint32_t CTfLiteProfiler::begin_event(const char* tag)
   volatile uint64_t ts = options_->get_time(0);
   event_starts_++;
   node_tag_ = tag;
-  node_idx_++;
+  // fused nodes are skipped by the interpreter (no event), the nodes run
+  // patch by patch are reported as the last node of the chain
+  do {
+    node_idx_++;
+  } while (ctx_->interpreter.is_fused_node(node_idx_) ||
+           ctx_->interpreter.is_patched_node(node_idx_));
   node_ts_begin_ = options_->get_time(0);  // ts before node execution
   cb_dur_ += (node_ts_begin_ - ts);
   return 0;
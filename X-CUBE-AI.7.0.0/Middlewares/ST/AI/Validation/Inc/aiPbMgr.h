@@ -35,6 +35,121 @@
 #define AI_PB_FULL_IO 0
 #endif
 
+/* AI_PB_DUMP_CODEC - support the encoded per-layer dumps (inspector mode),
+ *                    see AI_PB_DUMP_CODEC_XXX flags */
+#ifndef AI_PB_DUMP_CODEC
+#define AI_PB_DUMP_CODEC 1
+#endif
+
+/* AI_PB_DUMP_HISTORY_SIZE - size (in bytes) of the buffer used to keep the
+ *                    per-layer dumps of the previous sample (delta encoding),
+ *                    0 to disable the delta encoding */
+#ifndef AI_PB_DUMP_HISTORY_SIZE
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+#define AI_PB_DUMP_HISTORY_SIZE (4 * 1024 * 1024)
+#else
+#define AI_PB_DUMP_HISTORY_SIZE 0
+#endif
+#endif
+
+/* AI_PB_CAPTURE_SIZE - size (in bytes) of the ring buffer used to capture
+ *                    the per-layer outputs during the inference (deferred
+ *                    upload), 0 to disable the deferred capture */
+#ifndef AI_PB_CAPTURE_SIZE
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+#define AI_PB_CAPTURE_SIZE (4 * 1024 * 1024)
+#else
+#define AI_PB_CAPTURE_SIZE 0
+#endif
+#endif
+
+/* Capability flag (syncMsg.capability) - encoded per-layer dumps */
+#define AI_PB_CAP_DUMP_CODEC          (1U << 8)
+
+/* Encoding of the per-layer dumps
+ *
+ *  - requested by the host with the CMD_NETWORK_RUN request (reqMsg.param,
+ *    with the EnumRunParam_P_RUN_MODE_INSPECTOR mode)
+ *  - effective encoding of a dump: aiBufferShapeMsg.addr field of the
+ *    node message (0: raw data). A requested encoding is not applied if
+ *    it does not reduce the size or if the previous sample is not available
+ *    (delta). The output tensors are always sent raw.
+ *
+ *  Data are transformed in the following order:
+ *   STRIDE  only 1 item / (1 << stride) is sent (shape is unchanged)
+ *   DELTA   byte-wise difference (mod 256) with the previous sample
+ *   BPLANE  byte planes, byte 0 of all items, then byte 1.. (item > 1 byte)
+ *   RLE0    sequence of runs, varint header h: (h >> 1) zero bytes if h & 1
+ *           else (h >> 1) literal bytes follow. Without DELTA, the zero-point
+ *           is subtracted (mod 256) from the 8-bit quantized items before.
+ *   STATS   replace the data by 4 floats: min, max, mean and L2 norm of the
+ *           items, dequantized values if a scale is defined
+ */
+#define AI_PB_DUMP_CODEC_RLE0         (1U << 8)
+#define AI_PB_DUMP_CODEC_DELTA        (1U << 9)
+#define AI_PB_DUMP_CODEC_BPLANE       (1U << 10)
+#define AI_PB_DUMP_CODEC_STATS        (1U << 11)
+#define AI_PB_DUMP_CODEC_STRIDE_POS   (12)
+#define AI_PB_DUMP_CODEC_STRIDE_MSK   (0xFU << AI_PB_DUMP_CODEC_STRIDE_POS)
+#define AI_PB_DUMP_CODEC_MSK          (0xFF00U)
+
+/* On-device metrics
+ *
+ *  - capability flag (syncMsg.capability): AI_PB_CAP_METRICS
+ *  - CMD_NETWORK_RUN with the AI_PB_RUN_MODE_METRICS flag (reqMsg.param):
+ *    the outputs are not uploaded. After the inference, a reference tensor
+ *    (aiBufferByteMsg, float or format of the output) is expected for each
+ *    output. It is compared on the fly with the predicted values and the
+ *    metrics are updated (see aiPbMgrReceiveReference()).
+ *  - CMD_NETWORK_REPORT: a node message is returned for each output with
+ *    the AI_PB_METRIC_XXX values (float), duration field is the average
+ *    inference time. AI_PB_REPORT_RESET flag (reqMsg.param) resets the
+ *    metrics after the report.
+ *
+ *  Metrics are computed as described in the evaluation_metrics article,
+ *  error = reference - prediction, quantized values are dequantized. The
+ *  accuracy is -1 if the output has only one item.
+ */
+#define AI_PB_CAP_METRICS             (1U << 9)
+#define AI_PB_RUN_MODE_METRICS        (1U << 16)
+#define AI_PB_REPORT_RESET            (1U << 0)
+
+/* Deferred capture of the per-layer outputs
+ *
+ *  - capability flag (syncMsg.capability): AI_PB_CAP_CAPTURE
+ *  - CMD_NETWORK_RUN with the AI_PB_RUN_MODE_CAPTURE flag and an inspector
+ *    mode (reqMsg.param): the observer callback only copies the outputs of
+ *    the nodes and their durations in a preallocated ring buffer. The node
+ *    messages are sent after the inference, before the report. The
+ *    messages and their order are unchanged, only the time spent in the
+ *    callback (tcom) is reduced to a bounded memcpy.
+ *  - reqMsg.opt selects the captured nodes and the byte budget (see
+ *    AI_PB_CAPTURE_OPT()). Outside the node filter or when the budget is
+ *    exhausted, a node is captured without data (duration only).
+ */
+#define AI_PB_CAP_CAPTURE             (1U << 10)
+#define AI_PB_RUN_MODE_CAPTURE        (1U << 17)
+
+/* reqMsg.opt: nodes with first <= id < first + n (n = 0: all the nodes from
+ * first), budget in KiB (0: whole ring buffer) */
+#define AI_PB_CAPTURE_OPT(first, n, kib) \
+  (((uint32_t)(first) & 0xFFFU) | (((uint32_t)(n) & 0xFFFU) << 12) | \
+   (((uint32_t)(kib) & 0xFFU) << 24))
+#define AI_PB_CAPTURE_OPT_FIRST(opt)  ((uint32_t)(opt) & 0xFFFU)
+#define AI_PB_CAPTURE_OPT_N(opt)      (((uint32_t)(opt) >> 12) & 0xFFFU)
+#define AI_PB_CAPTURE_OPT_KIB(opt)    (((uint32_t)(opt) >> 24) & 0xFFU)
+
+enum {
+  AI_PB_METRIC_N_SAMPLES = 0,
+  AI_PB_METRIC_ACC,
+  AI_PB_METRIC_RMSE,
+  AI_PB_METRIC_MAE,
+  AI_PB_METRIC_L2R,
+  AI_PB_METRIC_MEAN,
+  AI_PB_METRIC_STD,
+  AI_PB_METRIC_NB
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -98,6 +213,40 @@ bool aiPbMgrWaitAck(void);
 
 /* --------------------------- */
 
+/* Running metrics of an output, O(1) memory whatever the number of samples
+ * (Welford/Chan updates) */
+struct aiPbMetrics {
+  uint32_t n_samples;
+  uint32_t n_correct;     /* samples with the same argmax */
+  double n_items;         /* number of compared items */
+  double mean;            /* error: mean and sum of squared deviations */
+  double m2;
+  double mean_abs;        /* mean of |error| */
+  double mean_sq;         /* mean of error^2 */
+  double mean_p2;         /* mean of prediction^2 (l2r) */
+  double dur_ms;          /* accumulated inference time */
+};
+
+void aiPbMetricsReset(struct aiPbMetrics *metrics);
+
+bool aiPbMgrReceiveReference(const reqMsg *req, respMsg *resp,
+    EnumState state, const ai_buffer *output, ai_float scale,
+    ai_i32 zero_point, struct aiPbMetrics *metrics);
+
+bool aiPbMgrSendMetrics(const reqMsg *req, respMsg *resp, EnumState state,
+    uint32_t id, const struct aiPbMetrics *metrics);
+
+/* --------------------------- */
+
+bool aiPbCaptureIsEnabled(void);
+
+void aiPbCaptureNode(uint32_t type, uint32_t id, ai_float dur_ms,
+    const ai_buffer *buffer, ai_float scale, ai_i32 zero_point);
+
+bool aiPbCaptureFlush(const reqMsg *req, respMsg *resp);
+
+/* --------------------------- */
+
 uint32_t aiPbAiBufferSize(const ai_buffer *buffer);
 void aiPbStrCopy(const char *src, char *dst, uint32_t max);
 uint32_t aiPbVersionToUint32(const ai_platform_version *ver);
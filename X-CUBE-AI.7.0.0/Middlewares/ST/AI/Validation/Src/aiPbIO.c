@@ -124,16 +124,19 @@ static bool read_callback(pb_istream_t *stream, uint8_t *buf, size_t count)
     return res;
 
   while (count) {
-    for (; i_packet.pr > 0 && count; i_packet.pr--) {
-      *pw = i_packet.payload[i_ridx];
-      pw++;
-      count--;
-      i_ridx++;
-    }
+    size_t n = (i_packet.pr < count) ? i_packet.pr : count;
+    memcpy(pw, &i_packet.payload[i_ridx], n);
+    pw += n;
+    count -= n;
+    i_ridx += n;
+    i_packet.pr -= (uint8_t)n;
     if (count && i_packet.pr == 0) {
       uint8_t sync = 0xAA;
       ioRawWriteBuffer(&sync, 1);
-      read_packet();
+      if (!read_packet()) {
+        i_packet.pr = 0xFF;
+        return false;
+      }
     }
   }
 
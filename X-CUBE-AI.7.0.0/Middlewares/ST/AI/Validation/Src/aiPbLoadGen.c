@@ -0,0 +1,1174 @@
+/**
+ ******************************************************************************
+ * @file    aiPbLoadGen.c
+ * @author  MCD Vertical Application Team
+ * @brief   Load generator for the AI validation protocol (host tool)
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/* Description
+ *
+ * - Linux client of the validation protocol (aiPbMgr.c). It sends
+ *   CMD_NETWORK_RUN requests with random input tensors back to back and
+ *   reports the request rate and the number of bytes/s exchanged on the
+ *   link, per-layer dumps included (inspector modes). The target can be a
+ *   board (serial device) or the host build of the validation stack
+ *   (aiValidation_host.c).
+ *
+ *   The encoded per-layer dumps (AI_PB_DUMP_CODEC_XXX, aiPbMgr.h) can be
+ *   requested with the inspector mode, they are decoded and optionally
+ *   written in a file (raw data of the decoded per-layer dumps).
+ *
+ *   With the inspector modes, the per-layer outputs can be captured by the
+ *   target during the inference and sent after it (deferred capture, see
+ *   AI_PB_RUN_MODE_CAPTURE). The inference time reported by the target is
+ *   printed, it includes the time spent in the observer callback.
+ *
+ *   The evaluation mode compares the outputs with random references (same
+ *   sequence for both modes): the metrics are computed by the host (outputs
+ *   are uploaded) or by the target (references are sent, on-device metrics,
+ *   see AI_PB_RUN_MODE_METRICS).
+ *
+ *   The decoding benchmark links the target side of the protocol
+ *   (aiPbMgr.c, aiPbIO.c) and feeds aiPbMgrReceiveAiBuffer3() with an
+ *   aiBufferByteMsg from memory, through a registered transport (see
+ *   ioRawSetTransport()). The decoding throughput is reported in MB/s.
+ *
+ *   Build:
+ *     gcc -O2 -DAI_TEST_HOST=1 -I../Inc -I../../Inc -I../../Misc/Inc
+ *         aiPbLoadGen.c aiPbMgr.c aiPbIO.c ../../Misc/Src/aiTestUtility_host.c
+ *         pb_common.c pb_decode.c pb_encode.c stm32msg.pb.c -lm -o aipb_loadgen
+ *
+ *   Usage:
+ *     aipb_loadgen (-u <socket path> | -d <serial device>) [-n <requests>]
+ *                  [-m <0:normal|1:inspector|2:inspector w/o data>]
+ *                  [-c <AI_PB_DUMP_CODEC_XXX flags>] [-o <file>] [-r]
+ *                  [-e <1:host metrics|2:target metrics>]
+ *                  [-k <first node>,<number of nodes>,<budget in KiB>]
+ *     aipb_loadgen -b <items>,<0:float|1:uint8> [-n <messages>]
+ *
+ *   -c  requested encoding of the per-layer dumps, e.g. 0x300 for RLE0|DELTA
+ *   -o  write the decoded per-layer dumps in a file
+ *   -r  new random input tensors for each request (default: same inputs)
+ *   -k  deferred capture, "-k 0,0,0" for all the nodes and the whole ring
+ *       buffer of the target
+ *   -b  decoding benchmark, tensor of <items> float or uint8 items
+ *
+ *   A serial device is used as is (raw mode, baud rate unchanged).
+ *
+ * History:
+ *  - v1.0 - Initial version
+ *  - v1.1 - decode the encoded per-layer dumps (-c, -o options)
+ *  - v1.2 - evaluation mode, host or on-device metrics (-e option)
+ *  - v1.3 - deferred capture of the per-layer outputs (-k option)
+ *  - v1.4 - decoding benchmark of the input tensors (-b option)
+ */
+
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* cfmakeraw() */
+#endif
+
+/* System headers */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <pb.h>
+#include <pb_encode.h>
+#include <pb_decode.h>
+#include <stm32msg.pb.h>
+#include <aiPbMgr.h>
+#include <aiTestUtility.h> /* ioRawSetTransport() */
+
+#define _PACKET_SIZE (EnumLowLevelIO_IO_OUT_PACKET_SIZE)
+#define _MAX_TENSORS (16)
+#define _MAX_DUMPS (256)
+
+/* -----------------------------------------------------------------------------
+ * Link - packet layer (see aiPbIO.c)
+ * -----------------------------------------------------------------------------
+ */
+
+static struct io_link {
+  int fd;
+  uint64_t tx_bytes;
+  uint64_t rx_bytes;
+  uint8_t *msg;         /* last received message */
+  size_t msg_size;
+  size_t msg_cap;
+} io_link = {
+  .fd = -1,
+  .tx_bytes = 0,
+  .rx_bytes = 0,
+  .msg = NULL,
+  .msg_size = 0,
+  .msg_cap = 0,
+};
+
+static bool link_write(const uint8_t *buf, size_t count)
+{
+  while (count) {
+    ssize_t n = write(io_link.fd, buf, count);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    buf += n;
+    count -= (size_t)n;
+    io_link.tx_bytes += (uint64_t)n;
+  }
+  return true;
+}
+
+static bool link_read(uint8_t *buf, size_t count)
+{
+  while (count) {
+    ssize_t n = read(io_link.fd, buf, count);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    buf += n;
+    count -= (size_t)n;
+    io_link.rx_bytes += (uint64_t)n;
+  }
+  return true;
+}
+
+/* Send a message: packets of _PACKET_SIZE bytes, the target requests the next
+ * packet with a sync byte. */
+static bool link_send(const uint8_t *msg, size_t size)
+{
+  uint8_t packet[_PACKET_SIZE + 1];
+
+  while (size) {
+    size_t n = (size > _PACKET_SIZE) ? _PACKET_SIZE : size;
+    memset(packet, 0, sizeof(packet));
+    packet[0] = (uint8_t)n;
+    memcpy(&packet[1], msg, n);
+    if (!link_write(packet, sizeof(packet)))
+      return false;
+    msg += n;
+    size -= n;
+    if (size) {
+      uint8_t sync;
+      if (!link_read(&sync, 1) || sync != EnumLowLevelIO_IO_OUT_SYNC)
+        return false;
+    }
+  }
+  return true;
+}
+
+/* Receive a message: packets until the EOM flag */
+static bool link_receive(void)
+{
+  uint8_t packet[_PACKET_SIZE + 1];
+  size_t n;
+
+  io_link.msg_size = 0;
+  do {
+    if (!link_read(packet, sizeof(packet)))
+      return false;
+    n = packet[0] & EnumLowLevelIO_IO_HEADER_SIZE_MSK;
+    if (n > _PACKET_SIZE)
+      return false;
+    if (io_link.msg_size + n > io_link.msg_cap) {
+      io_link.msg_cap = (io_link.msg_size + n) * 2;
+      io_link.msg = (uint8_t *)realloc(io_link.msg, io_link.msg_cap);
+      if (!io_link.msg)
+        return false;
+    }
+    memcpy(&io_link.msg[io_link.msg_size], &packet[1], n);
+    io_link.msg_size += n;
+  } while (!(packet[0] & EnumLowLevelIO_IO_HEADER_EOM_FLAG));
+  return true;
+}
+
+static int link_open_socket(const char *path)
+{
+  struct sockaddr_un addr;
+
+  if (strlen(path) >= sizeof(addr.sun_path))
+    return -1;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  io_link.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (io_link.fd < 0)
+    return -1;
+  return connect(io_link.fd, (struct sockaddr *)&addr, sizeof(addr));
+}
+
+static int link_open_device(const char *path)
+{
+  struct termios tio;
+
+  io_link.fd = open(path, O_RDWR | O_NOCTTY);
+  if (io_link.fd < 0)
+    return -1;
+  if (tcgetattr(io_link.fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tcsetattr(io_link.fd, TCSANOW, &tio);
+  }
+  return 0;
+}
+
+/* -----------------------------------------------------------------------------
+ * Protocol - messages
+ * -----------------------------------------------------------------------------
+ */
+
+/* Encode a message (delimited) in a growing buffer and send it */
+static uint8_t *tx_buf;
+static size_t tx_cap;
+
+static bool send_msg(const pb_field_t fields[], const void *msg)
+{
+  size_t size;
+  pb_ostream_t stream;
+
+  if (!pb_get_encoded_size(&size, fields, msg))
+    return false;
+  size += 10; /* varint prefix */
+  if (size > tx_cap) {
+    tx_cap = size;
+    tx_buf = (uint8_t *)realloc(tx_buf, tx_cap);
+    if (!tx_buf)
+      return false;
+  }
+  stream = pb_ostream_from_buffer(tx_buf, tx_cap);
+  if (!pb_encode_delimited(&stream, fields, msg))
+    return false;
+  return link_send(tx_buf, stream.bytes_written);
+}
+
+static bool send_req(uint32_t reqid, EnumCmd cmd, uint32_t param,
+    uint32_t opt, const char *name)
+{
+  reqMsg req = reqMsg_init_zero;
+  req.reqid = reqid;
+  req.cmd = cmd;
+  req.param = param;
+  req.opt = opt;
+  if (name)
+    snprintf(req.name, sizeof(req.name), "%s", name);
+  return send_msg(reqMsg_fields, &req);
+}
+
+static bool send_ack(void)
+{
+  ackMsg ack = ackMsg_init_zero;
+  return send_msg(ackMsg_fields, &ack);
+}
+
+/* Shapes of the inputs and outputs (CMD_NETWORK_INFO) */
+struct shapes {
+  uint32_t n;
+  aiBufferShapeMsg shape[_MAX_TENSORS];
+};
+
+static struct shapes inputs, outputs;
+
+static bool shape_r_cb(pb_istream_t *stream, const pb_field_t *field,
+    void **arg)
+{
+  struct shapes *shapes = (struct shapes *)*arg;
+  aiBufferShapeMsg shape = aiBufferShapeMsg_init_zero;
+  (void)field;
+  if (!pb_decode(stream, aiBufferShapeMsg_fields, &shape))
+    return false;
+  if (shapes->n < _MAX_TENSORS)
+    shapes->shape[shapes->n++] = shape;
+  return true;
+}
+
+/* Receive a response, only reqid, state and the type of the payload are
+ * decoded: the nodes sent without data have no (required) data field. */
+static bool receive_resp(respMsg *resp)
+{
+  pb_istream_t stream;
+  pb_wire_type_t wire_type;
+  uint32_t tag;
+  uint32_t value;
+  bool eof;
+
+  memset(resp, 0, sizeof(*resp));
+  if (!link_receive())
+    return false;
+
+  stream = pb_istream_from_buffer(io_link.msg, io_link.msg_size);
+  while (pb_decode_tag(&stream, &wire_type, &tag, &eof)) {
+    if (tag == 1 || tag == 2) {
+      if (!pb_decode_varint32(&stream, &value))
+        return false;
+      if (tag == 1)
+        resp->reqid = value;
+      else
+        resp->state = (EnumState)value;
+    } else {
+      resp->which_payload = (pb_size_t)tag;
+      if (!pb_skip_field(&stream, wire_type))
+        return false;
+    }
+  }
+  return eof;
+}
+
+/* Decode the ninfo payload of the last response, the input shapes are
+ * collected by the callback */
+static bool decode_ninfo(aiNetworkInfoMsg *ninfo)
+{
+  pb_istream_t stream = pb_istream_from_buffer(io_link.msg, io_link.msg_size);
+  pb_wire_type_t wire_type;
+  uint32_t tag;
+  bool eof;
+
+  while (pb_decode_tag(&stream, &wire_type, &tag, &eof)) {
+    if (tag == respMsg_ninfo_tag) {
+      pb_istream_t sub;
+      bool res;
+      memset(ninfo, 0, sizeof(*ninfo));
+      ninfo->inputs.funcs.decode = &shape_r_cb;
+      ninfo->inputs.arg = &inputs;
+      ninfo->outputs.funcs.decode = &shape_r_cb;
+      ninfo->outputs.arg = &outputs;
+      if (!pb_make_string_substream(&stream, &sub))
+        return false;
+      res = pb_decode(&sub, aiNetworkInfoMsg_fields, ninfo);
+      pb_close_string_substream(&stream, &sub);
+      return res;
+    }
+    if (!pb_skip_field(&stream, wire_type))
+      return false;
+  }
+  return false;
+}
+
+/* Input tensor: random bytes, shape/format of the model input */
+static const uint8_t *tensor_data;
+static size_t tensor_size;
+
+static bool tensor_w_cb(pb_ostream_t *stream, const pb_field_t *field,
+    void * const *arg)
+{
+  (void)arg;
+  if (!pb_encode_tag_for_field(stream, field))
+    return false;
+  return pb_encode_string(stream, tensor_data, tensor_size);
+}
+
+static size_t shape_byte_size(const aiBufferShapeMsg *shape)
+{
+  /* format: see AI_BUFFER_FMT_GET_BITS() (ai_platform.h) */
+  size_t bits = (shape->format >> 7) & 0x7F;
+  return ((size_t)shape->n_batches * shape->height * shape->width
+      * shape->channels * bits + 4) >> 3;
+}
+
+static bool send_tensor(const aiBufferShapeMsg *shape)
+{
+  aiBufferByteMsg msg = aiBufferByteMsg_init_zero;
+  msg.shape = *shape;
+  tensor_size = shape_byte_size(shape);
+  msg.datas.funcs.encode = &tensor_w_cb;
+  return send_msg(aiBufferByteMsg_fields, &msg);
+}
+
+/* -----------------------------------------------------------------------------
+ * Per-layer dumps (see AI_PB_DUMP_CODEC_XXX definitions)
+ * -----------------------------------------------------------------------------
+ */
+
+static struct {
+  uint8_t *data;        /* previous sample, decoded */
+  size_t size;
+} dumps[_MAX_DUMPS];
+
+static FILE *dump_file;
+
+/* Locate a length-delimited field (tag) in a message */
+static bool find_field(const uint8_t *msg, size_t size, uint32_t field,
+    const uint8_t **data, size_t *len)
+{
+  pb_istream_t stream = pb_istream_from_buffer(msg, size);
+  pb_wire_type_t wire_type;
+  uint32_t tag, value;
+  bool eof;
+
+  while (pb_decode_tag(&stream, &wire_type, &tag, &eof)) {
+    if (tag == field && wire_type == PB_WT_STRING) {
+      if (!pb_decode_varint32(&stream, &value) || value > stream.bytes_left)
+        return false;
+      *data = msg + (size - stream.bytes_left);
+      *len = value;
+      return true;
+    }
+    if (!pb_skip_field(&stream, wire_type))
+      return false;
+  }
+  return false;
+}
+
+static bool rle0_decode(const uint8_t *in, size_t len, uint8_t *out,
+    size_t size)
+{
+  pb_istream_t stream = pb_istream_from_buffer(in, len);
+  size_t pos = 0;
+  uint32_t h;
+
+  while (stream.bytes_left) {
+    if (!pb_decode_varint32(&stream, &h) || pos + (h >> 1) > size)
+      return false;
+    if (h & 1)
+      memset(&out[pos], 0, h >> 1);
+    else if (!pb_read(&stream, &out[pos], h >> 1))
+      return false;
+    pos += h >> 1;
+  }
+  return pos == size;
+}
+
+/* Decode the node payload of the last response, datas is NULL if the node
+ * is sent without data, duration is optional */
+static bool decode_node(uint32_t *type, aiBufferShapeMsg *shape,
+    const uint8_t **datas, size_t *len, float *duration)
+{
+  const uint8_t *node, *buffer, *shape_data;
+  size_t node_len, buffer_len, shape_len;
+  pb_istream_t stream;
+  pb_wire_type_t wire_type;
+  uint32_t tag;
+  bool eof;
+
+  if (!find_field(io_link.msg, io_link.msg_size, respMsg_node_tag,
+      &node, &node_len) ||
+      !find_field(node, node_len, nodeMsg_buffer_tag, &buffer, &buffer_len) ||
+      !find_field(buffer, buffer_len, aiBufferByteMsg_shape_tag,
+          &shape_data, &shape_len))
+    return false;
+
+  *type = 0;
+  stream = pb_istream_from_buffer(node, node_len);
+  while (pb_decode_tag(&stream, &wire_type, &tag, &eof)) {
+    if (tag == nodeMsg_type_tag) {
+      if (!pb_decode_varint32(&stream, type))
+        return false;
+    } else if (tag == nodeMsg_duration_tag && duration) {
+      if (!pb_decode_fixed32(&stream, duration))
+        return false;
+    } else if (!pb_skip_field(&stream, wire_type))
+      return false;
+  }
+
+  memset(shape, 0, sizeof(*shape));
+  stream = pb_istream_from_buffer(shape_data, shape_len);
+  if (!pb_decode(&stream, aiBufferShapeMsg_fields, shape))
+    return false;
+
+  *datas = NULL;
+  *len = 0;
+  find_field(buffer, buffer_len, aiBufferByteMsg_datas_tag, datas, len);
+  return true;
+}
+
+/* Decode a per-layer dump, idx: index of the dump in the run. Returns the
+ * size of the decoded data or -1. */
+static long decode_dump(uint32_t idx, const aiBufferShapeMsg *shape_,
+    const uint8_t *datas, size_t len)
+{
+  const aiBufferShapeMsg shape = *shape_;
+  uint8_t *tmp, *out;
+  size_t size, n_items, itsize;
+  uint32_t codec;
+
+  if (!datas)
+    return 0; /* without data */
+
+  codec = (uint32_t)shape.addr;
+  itsize = AI_BUFFER_FMT_GET_BITS(shape.format) / 8;
+  n_items = (size_t)shape.n_batches * shape.height * shape.width
+      * shape.channels;
+
+  if (codec & AI_PB_DUMP_CODEC_STATS) {
+    if (len != 4 * sizeof(float))
+      return -1;
+    if (dump_file)
+      fwrite(datas, 1, len, dump_file);
+    return (long)len;
+  }
+
+  if (!itsize || idx >= _MAX_DUMPS)
+    return -1;
+
+  size_t stride = (size_t)1 << ((codec & AI_PB_DUMP_CODEC_STRIDE_MSK) >>
+      AI_PB_DUMP_CODEC_STRIDE_POS);
+  n_items = (n_items + stride - 1) / stride;
+  size = n_items * itsize;
+
+  tmp = (uint8_t *)malloc(size ? size : 1);
+  out = (uint8_t *)malloc(size ? size : 1);
+  if (!tmp || !out)
+    return -1;
+
+  if (codec & AI_PB_DUMP_CODEC_RLE0) {
+    if (!rle0_decode(datas, len, tmp, size))
+      goto error;
+  } else if (len == size)
+    memcpy(tmp, datas, size);
+  else
+    goto error;
+
+  if ((codec & AI_PB_DUMP_CODEC_BPLANE) && itsize > 1) {
+    for (size_t p = 0; p < itsize; p++)
+      for (size_t j = 0; j < n_items; j++)
+        out[j * itsize + p] = tmp[p * n_items + j];
+  } else
+    memcpy(out, tmp, size);
+
+  if (codec & AI_PB_DUMP_CODEC_DELTA) {
+    if (dumps[idx].size != size)
+      goto error;
+    for (size_t i = 0; i < size; i++)
+      out[i] += dumps[idx].data[i];
+  } else if ((codec & AI_PB_DUMP_CODEC_RLE0) && itsize == 1 &&
+      AI_BUFFER_FMT_GET_TYPE(shape.format) == AI_BUFFER_FMT_TYPE_Q) {
+    for (size_t i = 0; i < size; i++)
+      out[i] += (uint8_t)shape.zeropoint;
+  }
+
+  if (dump_file)
+    fwrite(out, 1, size, dump_file);
+
+  free(tmp);
+  free(dumps[idx].data);
+  dumps[idx].data = out;
+  dumps[idx].size = size;
+  return (long)size;
+
+error:
+  free(tmp);
+  free(out);
+  return -1;
+}
+
+/* -----------------------------------------------------------------------------
+ * Load generation
+ * -----------------------------------------------------------------------------
+ */
+
+static double time_s(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+/* -----------------------------------------------------------------------------
+ * Metrics (see evaluation_metrics article and AI_PB_METRIC_XXX)
+ * -----------------------------------------------------------------------------
+ */
+
+enum { EVAL_NONE = 0, EVAL_HOST, EVAL_TARGET };
+
+static struct metrics {
+  uint32_t n_samples;
+  uint32_t n_correct;
+  double n, sum_e, sum_e2, sum_abs, sum_p2;
+} metrics[_MAX_TENSORS];
+
+/* References: random values [0, 1), same sequence for both modes */
+static float *refs[_MAX_TENSORS];
+
+static size_t shape_items(const aiBufferShapeMsg *shape)
+{
+  return (size_t)shape->n_batches * shape->height * shape->width
+      * shape->channels;
+}
+
+static void make_references(void)
+{
+  for (uint32_t i = 0; i < outputs.n; i++) {
+    size_t n = shape_items(&outputs.shape[i]);
+    if (!refs[i])
+      refs[i] = (float *)malloc(n * sizeof(float) + 1);
+    for (size_t j = 0; j < n; j++)
+      refs[i][j] = (float)rand() / ((float)RAND_MAX + 1.0f);
+  }
+}
+
+static bool send_reference(uint32_t idx)
+{
+  aiBufferByteMsg msg = aiBufferByteMsg_init_zero;
+  const uint8_t *data = tensor_data;
+  const size_t size = tensor_size;
+  bool res;
+
+  msg.shape = outputs.shape[idx];
+  msg.shape.format = AI_BUFFER_FORMAT_FLOAT;
+  msg.shape.scale = 0.0f;
+  msg.shape.zeropoint = 0;
+  tensor_data = (const uint8_t *)refs[idx];
+  tensor_size = shape_items(&msg.shape) * sizeof(float);
+  msg.datas.funcs.encode = &tensor_w_cb;
+  res = send_msg(aiBufferByteMsg_fields, &msg);
+
+  /* restore the input tensor */
+  tensor_data = data;
+  tensor_size = size;
+  return res;
+}
+
+static double item_value(const uint8_t *data, const aiBufferShapeMsg *shape)
+{
+  const uint32_t format = shape->format;
+  const uint32_t bits = AI_BUFFER_FMT_GET_BITS(format);
+  const bool is_signed = AI_BUFFER_FMT_GET_SIGN(format);
+  double val;
+
+  if (AI_BUFFER_FMT_GET_FLOAT(format)) {
+    float f;
+    memcpy(&f, data, sizeof(f));
+    return (double)f;
+  }
+  if (bits == 8)
+    val = is_signed ? (double)*(const int8_t *)data : (double)*data;
+  else if (bits == 16)
+    val = is_signed ? (double)*(const int16_t *)data :
+        (double)*(const uint16_t *)data;
+  else
+    val = is_signed ? (double)*(const int32_t *)data :
+        (double)*(const uint32_t *)data;
+  if (shape->scale != 0.0f)
+    val = (double)shape->scale * (val - (double)shape->zeropoint);
+  return val;
+}
+
+/* Host side metrics of an output */
+static bool update_metrics(uint32_t idx, const aiBufferShapeMsg *shape,
+    const uint8_t *datas, size_t len)
+{
+  const size_t n = shape_items(shape);
+  const size_t itsize = AI_BUFFER_FMT_GET_BITS(shape->format) / 8;
+  struct metrics *mt = &metrics[idx];
+  size_t r_idx = 0, p_idx = 0;
+
+  if (idx >= outputs.n || !datas || !itsize || len != n * itsize)
+    return false;
+
+  for (size_t j = 0; j < n; j++) {
+    const double p = item_value(&datas[j * itsize], shape);
+    const double r = (double)refs[idx][j];
+    const double e = r - p;
+    mt->sum_e += e;
+    mt->sum_e2 += e * e;
+    mt->sum_abs += fabs(e);
+    mt->sum_p2 += p * p;
+    if (r > refs[idx][r_idx])
+      r_idx = j;
+    if (p > item_value(&datas[p_idx * itsize], shape))
+      p_idx = j;
+  }
+  mt->n += (double)n;
+  mt->n_samples++;
+  if (r_idx == p_idx)
+    mt->n_correct++;
+  return true;
+}
+
+static void print_metrics(uint32_t idx, const float *values, float dur_ms)
+{
+  printf(" output #%u     : %u samples", (unsigned)idx,
+      (unsigned)values[AI_PB_METRIC_N_SAMPLES]);
+  if (values[AI_PB_METRIC_ACC] >= 0.0f)
+    printf(", acc=%.2f%%", 100.0f * values[AI_PB_METRIC_ACC]);
+  printf(", rmse=%.6f, mae=%.6f, l2r=%.6f, mean=%.6f, std=%.6f",
+      values[AI_PB_METRIC_RMSE], values[AI_PB_METRIC_MAE],
+      values[AI_PB_METRIC_L2R], values[AI_PB_METRIC_MEAN],
+      values[AI_PB_METRIC_STD]);
+  if (dur_ms > 0.0f)
+    printf(" (%.3f ms/inference)", dur_ms);
+  printf("\n");
+}
+
+static void host_metrics_report(void)
+{
+  for (uint32_t i = 0; i < outputs.n; i++) {
+    const struct metrics *mt = &metrics[i];
+    float values[AI_PB_METRIC_NB] = { 0 };
+    values[AI_PB_METRIC_N_SAMPLES] = (float)mt->n_samples;
+    if (mt->n_samples) {
+      const double mean = mt->sum_e / mt->n;
+      values[AI_PB_METRIC_ACC] = (mt->n > mt->n_samples) ?
+          (float)mt->n_correct / (float)mt->n_samples : -1.0f;
+      values[AI_PB_METRIC_RMSE] = (float)sqrt(mt->sum_e2 / mt->n);
+      values[AI_PB_METRIC_MAE] = (float)(mt->sum_abs / mt->n);
+      values[AI_PB_METRIC_L2R] = (float)(sqrt(mt->sum_e2) /
+          (sqrt(mt->sum_p2) + (double)FLT_EPSILON));
+      values[AI_PB_METRIC_MEAN] = (float)mean;
+      values[AI_PB_METRIC_STD] = (float)sqrt(mt->sum_e2 / mt->n - mean * mean);
+    }
+    print_metrics(i, values, 0.0f);
+  }
+}
+
+/* Request the metrics computed by the target (CMD_NETWORK_REPORT) */
+static bool target_metrics_report(const char *name)
+{
+  respMsg resp;
+  uint32_t idx = 0;
+
+  if (!send_req(1, EnumCmd_CMD_NETWORK_REPORT, AI_PB_REPORT_RESET, 0, name))
+    return false;
+  do {
+    uint32_t type;
+    aiBufferShapeMsg shape;
+    const uint8_t *datas;
+    size_t len;
+    float values[AI_PB_METRIC_NB];
+    float dur_ms = 0.0f;
+
+    if (!receive_resp(&resp) || resp.which_payload != respMsg_node_tag ||
+        !decode_node(&type, &shape, &datas, &len, &dur_ms) ||
+        len != sizeof(values))
+      return false;
+    memcpy(values, datas, sizeof(values));
+    print_metrics(idx++, values, dur_ms);
+    if (resp.state == EnumState_S_PROCESSING && !send_ack())
+      return false;
+  } while (resp.state != EnumState_S_DONE);
+  return true;
+}
+
+/* Inference time reported by the target (inspector modes) */
+static double report_ms;
+
+static bool decode_report(void)
+{
+  aiRunReportMsg report = aiRunReportMsg_init_zero;
+  const uint8_t *data;
+  size_t len;
+  pb_istream_t stream;
+
+  if (!find_field(io_link.msg, io_link.msg_size, respMsg_report_tag,
+      &data, &len))
+    return false;
+  stream = pb_istream_from_buffer(data, len);
+  if (!pb_decode(&stream, aiRunReportMsg_fields, &report))
+    return false;
+  report_ms += report.elapsed_ms;
+  return true;
+}
+
+/* One CMD_NETWORK_RUN exchange, returns the number of received node
+ * messages or -1 */
+static int network_run(uint32_t reqid, const char *name, uint32_t mode,
+    uint32_t opt, int eval, uint64_t *dump_bytes)
+{
+  respMsg resp;
+  int n_nodes = 0;
+  uint32_t idx = 0, o_idx = 0;
+
+  if (eval != EVAL_NONE)
+    make_references();
+  if (eval == EVAL_TARGET)
+    mode |= AI_PB_RUN_MODE_METRICS;
+
+  if (!send_req(reqid, EnumCmd_CMD_NETWORK_RUN, mode, opt, name) ||
+      !receive_resp(&resp) || resp.state != EnumState_S_WAITING)
+    return -1;
+
+  for (uint32_t i = 0; i < inputs.n; i++) {
+    if (!send_tensor(&inputs.shape[i]) || !receive_resp(&resp) ||
+        resp.state == EnumState_S_ERROR)
+      return -1;
+    if (!send_ack())
+      return -1;
+  }
+
+  /* references are compared by the target in place of the outputs */
+  if (eval == EVAL_TARGET) {
+    for (uint32_t i = 0; i < outputs.n; i++) {
+      if (!send_reference(i) || !receive_resp(&resp) ||
+          resp.state == EnumState_S_ERROR)
+        return -1;
+      if (resp.state == EnumState_S_PROCESSING && !send_ack())
+        return -1;
+    }
+    return (resp.state == EnumState_S_DONE) ? 0 : -1;
+  }
+
+  /* per-layer dumps, report and outputs until S_DONE */
+  do {
+    uint32_t type;
+    aiBufferShapeMsg shape;
+    const uint8_t *datas;
+    size_t len;
+
+    if (!receive_resp(&resp) || resp.state == EnumState_S_ERROR)
+      return -1;
+    if (resp.which_payload == respMsg_report_tag && !decode_report())
+      return -1;
+    if (resp.which_payload == respMsg_node_tag) {
+      n_nodes++;
+      if (!decode_node(&type, &shape, &datas, &len, NULL))
+        return -1;
+      if ((type >> 16) != EnumLayerType_LAYER_TYPE_OUTPUT) {
+        long size = decode_dump(idx++, &shape, datas, len);
+        if (size < 0) {
+          printf("E: invalid per-layer dump #%u\n", (unsigned)(idx - 1));
+          return -1;
+        }
+        *dump_bytes += (uint64_t)size;
+      } else if (eval == EVAL_HOST &&
+          !update_metrics(o_idx++, &shape, datas, len))
+        return -1;
+    }
+    if (resp.state == EnumState_S_PROCESSING && !send_ack())
+      return -1;
+  } while (resp.state != EnumState_S_DONE);
+
+  return n_nodes;
+}
+
+/* -----------------------------------------------------------------------------
+ * Decoding benchmark (-b option) - the target side of the protocol
+ * (aiPbMgr.c/aiPbIO.c) is linked in the tool and fed from memory
+ * -----------------------------------------------------------------------------
+ */
+
+static struct mem_link {
+  uint8_t *data;        /* packets of the encoded message */
+  size_t size;
+  size_t pos;
+} mem_link;
+
+static bool mem_link_write(void *ctx, const uint8_t *buff, int count)
+{
+  (void)ctx;
+  (void)buff;
+  (void)count;
+  return true; /* sync bytes and ack message are dropped */
+}
+
+static bool mem_link_read(void *ctx, uint8_t *buff, int count)
+{
+  struct mem_link *link = (struct mem_link *)ctx;
+
+  if (link->pos + (size_t)count > link->size)
+    return false;
+  memcpy(buff, &link->data[link->pos], (size_t)count);
+  link->pos += (size_t)count;
+  return true;
+}
+
+/* Encode a aiBufferByteMsg with random data and split it in packets as
+ * link_send() */
+static bool mem_link_fill(const aiBufferShapeMsg *shape)
+{
+  aiBufferByteMsg msg = aiBufferByteMsg_init_zero;
+  pb_ostream_t stream;
+  size_t size;
+
+  msg.shape = *shape;
+  msg.datas.funcs.encode = &tensor_w_cb;
+  if (!pb_get_encoded_size(&size, aiBufferByteMsg_fields, &msg))
+    return false;
+  size += 10; /* varint prefix */
+  if (size > tx_cap) {
+    tx_cap = size;
+    tx_buf = (uint8_t *)realloc(tx_buf, tx_cap);
+    if (!tx_buf)
+      return false;
+  }
+  stream = pb_ostream_from_buffer(tx_buf, tx_cap);
+  if (!pb_encode_delimited(&stream, aiBufferByteMsg_fields, &msg))
+    return false;
+  size = stream.bytes_written;
+
+  mem_link.size = (size + _PACKET_SIZE - 1) / _PACKET_SIZE * (_PACKET_SIZE + 1);
+  mem_link.data = (uint8_t *)calloc(mem_link.size, 1);
+  if (!mem_link.data)
+    return false;
+  for (size_t pos = 0, i = 0; pos < size; pos += _PACKET_SIZE, i++) {
+    size_t n = (size - pos > _PACKET_SIZE) ? _PACKET_SIZE : size - pos;
+    mem_link.data[i * (_PACKET_SIZE + 1)] = (uint8_t)n;
+    memcpy(&mem_link.data[i * (_PACKET_SIZE + 1) + 1], &tx_buf[pos], n);
+  }
+  return true;
+}
+
+static int decode_bench(uint32_t items, bool u8, int n_iter)
+{
+  struct ioTransport transport = { mem_link_write, mem_link_read, &mem_link };
+  aiBufferShapeMsg shape = aiBufferShapeMsg_init_zero;
+  reqMsg req = reqMsg_init_zero;
+  respMsg resp = respMsg_init_zero;
+  ai_buffer buffer;
+  size_t size;
+
+  shape.format = u8 ? AI_BUFFER_FORMAT_U8 : AI_BUFFER_FORMAT_FLOAT;
+  shape.n_batches = shape.height = shape.width = 1;
+  shape.channels = items;
+  size = shape_byte_size(&shape);
+
+  tensor_size = size;
+  tensor_data = (const uint8_t *)malloc(size ? size : 1);
+  for (size_t i = 0; i < size; i++)
+    ((uint8_t *)tensor_data)[i] = (uint8_t)rand();
+
+  memset(&buffer, 0, sizeof(buffer));
+  buffer.format = shape.format;
+  buffer.n_batches = buffer.height = buffer.width = 1;
+  buffer.channels = items;
+  buffer.data = malloc(size ? size : 1);
+
+  if (!buffer.data || !mem_link_fill(&shape)) {
+    printf("E: unable to encode the aiBufferByteMsg\n");
+    return 1;
+  }
+
+  ioRawSetTransport(&transport);
+  aiPbMgrInit(NULL);
+
+  double t0 = time_s();
+  for (int i = 0; i < n_iter; i++) {
+    mem_link.pos = 0;
+    if (!aiPbMgrReceiveAiBuffer3(&req, &resp, EnumState_S_DONE, &buffer)) {
+      printf("E: aiPbMgrReceiveAiBuffer3() #%d fails\n", i);
+      return 1;
+    }
+  }
+  double dur = time_s() - t0;
+
+  ioRawSetTransport(NULL);
+
+  if (memcmp(buffer.data, tensor_data, size)) {
+    printf("E: decoded tensor differs from the sent one\n");
+    return 1;
+  }
+
+  printf("%d aiBufferByteMsg (%u %s items, %u bytes) in %.3f s\n", n_iter,
+      (unsigned)items, u8 ? "uint8" : "float", (unsigned)size, dur);
+  printf(" decoding     : %.1f MB/s (%.3f ms/msg)\n",
+      (double)size * n_iter / dur / 1e6, 1000.0 * dur / n_iter);
+
+  free(mem_link.data);
+  free(buffer.data);
+  return 0;
+}
+
+static void usage(const char *app)
+{
+  printf("usage: %s (-u <socket path> | -d <serial device>) [-n <requests>]"
+      " [-m <mode>] [-c <codec>] [-o <file>] [-r] [-e <eval>]"
+      " [-k <first,n,kib>]\n", app);
+  printf("       %s -b <items>,<0:float|1:uint8> [-n <messages>]\n", app);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *socket_path = NULL;
+  const char *device = NULL;
+  int n_req = 100;
+  uint32_t mode = EnumRunParam_P_RUN_MODE_NORMAL;
+  respMsg resp;
+  aiNetworkInfoMsg ninfo;
+  char name[64];
+  size_t max_size = 0;
+  uint32_t codec = 0;
+  const char *dump_path = NULL;
+  bool new_inputs = false;
+  int eval = EVAL_NONE;
+  uint32_t capture_opt = 0;
+  unsigned int first, n, kib;
+  unsigned int bench_items = 0, bench_u8 = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "u:d:n:m:c:o:re:k:b:h")) != -1) {
+    switch (opt) {
+      case 'u': socket_path = optarg; break;
+      case 'd': device = optarg; break;
+      case 'n': n_req = atoi(optarg); break;
+      case 'm': mode = (uint32_t)atoi(optarg); break;
+      case 'c': codec = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'o': dump_path = optarg; break;
+      case 'r': new_inputs = true; break;
+      case 'e': eval = atoi(optarg); break;
+      case 'k':
+        if (sscanf(optarg, "%u,%u,%u", &first, &n, &kib) != 3) {
+          usage(argv[0]);
+          return 1;
+        }
+        mode |= AI_PB_RUN_MODE_CAPTURE;
+        capture_opt = AI_PB_CAPTURE_OPT(first, n, kib);
+        break;
+      case 'b':
+        if (sscanf(optarg, "%u,%u", &bench_items, &bench_u8) != 2 ||
+            !bench_items) {
+          usage(argv[0]);
+          return 1;
+        }
+        break;
+      default: usage(argv[0]); return 1;
+    }
+  }
+
+  if (bench_items)
+    return decode_bench(bench_items, bench_u8 != 0, n_req);
+
+  if ((!socket_path && !device) ||
+      (socket_path && link_open_socket(socket_path)) ||
+      (device && link_open_device(device))) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if ((mode & AI_PB_RUN_MODE_CAPTURE) &&
+      !(mode & (EnumRunParam_P_RUN_MODE_INSPECTOR |
+          EnumRunParam_P_RUN_MODE_INSPECTOR_WITHOUT_DATA))) {
+    printf("E: deferred capture requires an inspector mode\n");
+    return 1;
+  }
+
+  if ((eval == EVAL_TARGET) && (mode != EnumRunParam_P_RUN_MODE_NORMAL)) {
+    printf("E: on-device metrics are only supported with the normal mode\n");
+    return 1;
+  }
+
+  /* 0 - target capabilities --------------------------------------- */
+  if (codec || (eval == EVAL_TARGET) || (mode & AI_PB_RUN_MODE_CAPTURE)) {
+    syncMsg sync = syncMsg_init_zero;
+    const uint8_t *data;
+    size_t len;
+    pb_istream_t stream;
+
+    if (!send_req(0, EnumCmd_CMD_SYNC, 0, 0, NULL) || !receive_resp(&resp) ||
+        !find_field(io_link.msg, io_link.msg_size, respMsg_sync_tag,
+            &data, &len)) {
+      printf("E: CMD_SYNC fails\n");
+      return 1;
+    }
+    stream = pb_istream_from_buffer(data, len);
+    if (!pb_decode(&stream, syncMsg_fields, &sync)) {
+      printf("E: CMD_SYNC fails\n");
+      return 1;
+    }
+    if (codec && !(sync.capability & AI_PB_CAP_DUMP_CODEC)) {
+      printf("E: encoded per-layer dumps are not supported\n");
+      return 1;
+    }
+    if ((eval == EVAL_TARGET) && !(sync.capability & AI_PB_CAP_METRICS)) {
+      printf("E: on-device metrics are not supported\n");
+      return 1;
+    }
+    if ((mode & AI_PB_RUN_MODE_CAPTURE) &&
+        !(sync.capability & AI_PB_CAP_CAPTURE)) {
+      printf("E: deferred capture is not supported\n");
+      return 1;
+    }
+    mode |= codec & AI_PB_DUMP_CODEC_MSK;
+  }
+
+  if (dump_path && !(dump_file = fopen(dump_path, "wb"))) {
+    printf("E: unable to create \"%s\"\n", dump_path);
+    return 1;
+  }
+
+  /* 1 - network description --------------------------------------- */
+  if (!send_req(1, EnumCmd_CMD_NETWORK_INFO, 0, 0, NULL) ||
+      !receive_resp(&resp) || resp.which_payload != respMsg_ninfo_tag ||
+      !decode_ninfo(&ninfo)) {
+    printf("E: CMD_NETWORK_INFO fails\n");
+    return 1;
+  }
+  memcpy(name, ninfo.model_name, sizeof(name));
+  name[sizeof(name) - 1] = 0;
+  printf("network \"%s\": %u inputs, %u nodes\n", name,
+      (unsigned)inputs.n, (unsigned)ninfo.n_nodes);
+
+  for (uint32_t i = 0; i < inputs.n; i++) {
+    size_t size = shape_byte_size(&inputs.shape[i]);
+    if (size > max_size)
+      max_size = size;
+  }
+  tensor_data = (const uint8_t *)malloc(max_size ? max_size : 1);
+  for (size_t i = 0; i < max_size; i++)
+    ((uint8_t *)tensor_data)[i] = (uint8_t)rand();
+
+  /* 2 - requests back to back ------------------------------------- */
+  uint64_t tx0 = io_link.tx_bytes, rx0 = io_link.rx_bytes;
+  uint64_t dump_bytes = 0;
+  int n_nodes = 0;
+  double t0 = time_s();
+
+  for (int i = 0; i < n_req; i++) {
+    if (new_inputs && i)
+      for (size_t j = 0; j < max_size; j++)
+        ((uint8_t *)tensor_data)[j] = (uint8_t)rand();
+    int res = network_run((uint32_t)(i + 2), name, mode, capture_opt, eval,
+        &dump_bytes);
+    if (res < 0) {
+      printf("E: CMD_NETWORK_RUN #%d fails\n", i);
+      return 1;
+    }
+    n_nodes += res;
+  }
+
+  double dur = time_s() - t0;
+  double tx = (double)(io_link.tx_bytes - tx0);
+  double rx = (double)(io_link.rx_bytes - rx0);
+
+  printf("%d requests (mode=0x%x) in %.3f s\n", n_req, (unsigned)mode, dur);
+  printf(" request rate : %.1f req/s (%.3f ms/req)\n", n_req / dur,
+      1000.0 * dur / n_req);
+  printf(" node msgs    : %d\n", n_nodes);
+  printf(" host->target : %.3f MB/s (%.0f bytes/req)\n", tx / dur / 1e6,
+      tx / n_req);
+  printf(" target->host : %.3f MB/s (%.0f bytes/req)\n", rx / dur / 1e6,
+      rx / n_req);
+  if (mode & EnumRunParam_P_RUN_MODE_INSPECTOR)
+    printf(" dumps        : %.0f decoded bytes/req\n",
+        (double)dump_bytes / n_req);
+  if (report_ms > 0.0)
+    printf(" inference    : %.3f ms (reported by the target)\n",
+        report_ms / n_req);
+
+  if (eval == EVAL_HOST)
+    host_metrics_report();
+  else if ((eval == EVAL_TARGET) && !target_metrics_report(name)) {
+    printf("E: CMD_NETWORK_REPORT fails\n");
+    return 1;
+  }
+
+  if (dump_file)
+    fclose(dump_file);
+
+  close(io_link.fd);
+  return 0;
+}
+
+#endif /* AI_TEST_HOST */
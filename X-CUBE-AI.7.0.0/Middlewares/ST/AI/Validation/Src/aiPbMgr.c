@@ -17,6 +17,10 @@
  ******************************************************************************
  */
 
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
 #include <aiPbMgr.h>
 #include <aiPbIO.h>
 
@@ -35,6 +39,11 @@ static struct pbContextMgr {
   uint32_t  n_func;
 } pbContextMgr;
 
+#if defined(AI_PB_DUMP_CODEC) && (AI_PB_DUMP_CODEC == 1)
+static void aiPbDumpCodecConfig(uint32_t param);
+#endif
+static void aiPbCaptureConfig(const reqMsg *req);
+
 void aiPbMgrInit(const aiPbCmdFunc *funcs)
 {
   const aiPbCmdFunc *cfunc;
@@ -67,6 +76,13 @@ int aiPbMgrWaitAndProcess(void)
   pb_io_flush_istream();
   if (pb_decode_delimited(&pbContextMgr.input, reqMsg_fields, &req)) {
     pb_io_flush_istream();
+#if defined(AI_PB_DUMP_CODEC) && (AI_PB_DUMP_CODEC == 1)
+    /* encoding of the per-layer dumps for all test applications */
+    if (req.cmd == EnumCmd_CMD_NETWORK_RUN)
+      aiPbDumpCodecConfig(req.param);
+#endif
+    if (req.cmd == EnumCmd_CMD_NETWORK_RUN)
+      aiPbCaptureConfig(&req);
     for (idx = 0; idx < pbContextMgr.n_func; idx++) {
       cfunc = &pbContextMgr.funcs[idx];
       if (cfunc->cmd == req.cmd) {
@@ -200,21 +216,30 @@ static bool aiPbBuffer_read_cb3(pb_istream_t *stream, const pb_field_t *field,
 
       itsize = aiPbBufferGetItemSize(format);
 
-      /* Read data */
+      /* Unknown item size, skip the payload */
+      if (!itsize) {
+        bm->err = EnumError_E_INVALID_FORMAT;
+        return pb_read(stream, NULL, stream->bytes_left);
+      }
+
+      /* Truncated item - corrupted stream */
+      if (stream->bytes_left % itsize)
+        return false;
+
+      /* Read data - shape/format have been checked once, the payload is
+       * decoded in one go directly in the ai_buffer. Items which do not fit
+       * (or all items if the buffer is not valid) are only counted and
+       * skipped. */
+      size_t n_items = stream->bytes_left / itsize;
       uint8_t *pw = (uint8_t *)bm->buffer->data;
-      while (stream->bytes_left) {
-        uint64_t number;
-        if (!pb_read(stream, (pb_byte_t *)&number, itsize))
+      if ((maxr > 0) && pw) {
+        size_t n_rd = (n_items < (size_t)maxr) ? n_items : (size_t)maxr;
+        if (!pb_read(stream, (pb_byte_t *)pw, n_rd * itsize))
           return false;
-        if (maxr > 0) {
-          if (pw) {
-            memcpy(pw, &number, itsize);
-            pw += itsize;
-          }
-          maxr--;
-        }
-        bm->n_ops++;
       }
+      if (stream->bytes_left && !pb_read(stream, NULL, stream->bytes_left))
+        return false;
+      bm->n_ops += n_items;
 
       /* Check nb_op */
       if ((bm->err == EnumError_E_NONE) && (bm->n_ops != bm->n_max))
@@ -253,6 +278,351 @@ static bool aiPbBuffer_write_cb3(pb_ostream_t *stream, const pb_field_t *field,
   return true;
 }
 
+#if defined(AI_PB_DUMP_CODEC) && (AI_PB_DUMP_CODEC == 1)
+
+#define _DUMP_HISTORY_SLOTS (128)
+
+/* Encoding of the per-layer dumps for the current CMD_NETWORK_RUN request */
+static struct aiPbDumpCodec {
+  uint32_t mode;        /* requested AI_PB_DUMP_CODEC_XXX flags */
+  uint32_t idx;         /* index of the next dump in the run */
+#if AI_PB_DUMP_HISTORY_SIZE > 0
+  uint32_t n_slots;     /* dumps of the previous sample */
+  struct {
+    uint32_t offset;
+    uint32_t size;
+  } slot[_DUMP_HISTORY_SLOTS];
+  uint8_t history[AI_PB_DUMP_HISTORY_SIZE];
+#endif
+} aiPbDumpCodec;
+
+/* Encoder state: the transformed byte stream is generated on the fly from the
+ * tensor, no intermediate buffer is used */
+struct aiPbDumpEnc {
+  const uint8_t *src;   /* tensor data */
+  const uint8_t *prev;  /* previous sample (NULL: no delta) */
+  uint32_t n_items;     /* number of items to send (after downsampling) */
+  uint32_t it_shift;    /* log2(item size) */
+  uint32_t st_shift;    /* log2(stride) */
+  uint32_t codec;       /* effective encoding */
+  uint32_t size;        /* encoded size */
+  uint8_t zero;         /* quantized zero (8-bit items, RLE0 w/o delta) */
+  float stats[4];
+  uint8_t chunk[64];
+  uint32_t n_chunk;
+};
+
+static void aiPbDumpCodecConfig(uint32_t param)
+{
+  uint32_t mode = param & AI_PB_DUMP_CODEC_MSK;
+
+  if ((param & EnumRunParam_P_RUN_MODE_INSPECTOR) == 0)
+    mode = 0;
+
+#if AI_PB_DUMP_HISTORY_SIZE > 0
+  /* previous sample is only usable with the same encoding */
+  if ((mode != aiPbDumpCodec.mode) || !(mode & AI_PB_DUMP_CODEC_DELTA))
+    aiPbDumpCodec.n_slots = 0;
+#endif
+
+  aiPbDumpCodec.mode = mode;
+  aiPbDumpCodec.idx = 0;
+}
+
+static uint32_t aiPbDumpLog2(uint32_t val)
+{
+  uint32_t res = 0;
+  while ((1U << (res + 1)) <= val)
+    res++;
+  return ((1U << res) == val) ? res : 0xFF;
+}
+
+/* byte k of the plane p of the transformed stream */
+static inline uint8_t aiPbDumpGet(const struct aiPbDumpEnc *enc,
+    uint32_t p, uint32_t k)
+{
+  uint32_t j, b;
+  uint8_t val;
+
+  if (enc->codec & AI_PB_DUMP_CODEC_BPLANE) {
+    j = k;
+    b = p;
+  } else {
+    j = k >> enc->it_shift;
+    b = k & ((1U << enc->it_shift) - 1);
+  }
+  val = enc->src[(j << (enc->st_shift + enc->it_shift)) + b];
+  if (enc->prev)
+    val -= enc->prev[(j << enc->it_shift) + b];
+  else
+    val -= enc->zero;
+  return val;
+}
+
+static bool aiPbDumpFlush(pb_ostream_t *stream, struct aiPbDumpEnc *enc)
+{
+  bool res = pb_write(stream, enc->chunk, enc->n_chunk);
+  enc->n_chunk = 0;
+  return res;
+}
+
+static bool aiPbDumpPut(pb_ostream_t *stream, struct aiPbDumpEnc *enc,
+    uint8_t val)
+{
+  enc->chunk[enc->n_chunk++] = val;
+  if (enc->n_chunk == sizeof(enc->chunk))
+    return aiPbDumpFlush(stream, enc);
+  return true;
+}
+
+static bool aiPbDumpPutVarint(pb_ostream_t *stream, struct aiPbDumpEnc *enc,
+    uint32_t val)
+{
+  while (val >= 0x80) {
+    if (!aiPbDumpPut(stream, enc, (uint8_t)(val | 0x80)))
+      return false;
+    val >>= 7;
+  }
+  return aiPbDumpPut(stream, enc, (uint8_t)val);
+}
+
+static uint32_t aiPbDumpZeros(const struct aiPbDumpEnc *enc, uint32_t p,
+    uint32_t k, uint32_t len)
+{
+  uint32_t n = k;
+  while ((n < len) && (aiPbDumpGet(enc, p, n) == 0))
+    n++;
+  return n - k;
+}
+
+#define _DUMP_RLE_MIN_ZEROS (4)
+
+/* Write the transformed stream (size is not known: a sizing stream can be
+ * used) */
+static bool aiPbDumpWrite(pb_ostream_t *stream, struct aiPbDumpEnc *enc)
+{
+  uint32_t n_planes, len;
+
+  enc->n_chunk = 0;
+
+  if (enc->codec & AI_PB_DUMP_CODEC_STATS) {
+    if (!pb_write(stream, (const pb_byte_t *)enc->stats, sizeof(enc->stats)))
+      return false;
+    return true;
+  }
+
+  if (enc->codec & AI_PB_DUMP_CODEC_BPLANE) {
+    n_planes = 1U << enc->it_shift;
+    len = enc->n_items;
+  } else {
+    n_planes = 1;
+    len = enc->n_items << enc->it_shift;
+  }
+
+  for (uint32_t p = 0; p < n_planes; p++) {
+    uint32_t k = 0;
+    while (k < len) {
+      uint32_t start = k;
+      if (enc->codec & AI_PB_DUMP_CODEC_RLE0) {
+        uint32_t z = aiPbDumpZeros(enc, p, k, len);
+        if (z >= _DUMP_RLE_MIN_ZEROS) {
+          if (!aiPbDumpPutVarint(stream, enc, (z << 1) | 1))
+            return false;
+          k += z;
+          continue;
+        }
+        /* literal run up to the next run of zeros */
+        while (k < len) {
+          if (aiPbDumpGet(enc, p, k) == 0) {
+            z = aiPbDumpZeros(enc, p, k, len);
+            if (z >= _DUMP_RLE_MIN_ZEROS)
+              break;
+            k += z;
+          } else
+            k++;
+        }
+        if (!aiPbDumpPutVarint(stream, enc, (k - start) << 1))
+          return false;
+      } else
+        k = len;
+      for (uint32_t i = start; i < k; i++)
+        if (!aiPbDumpPut(stream, enc, aiPbDumpGet(enc, p, i)))
+          return false;
+    }
+  }
+
+  return aiPbDumpFlush(stream, enc);
+}
+
+static void aiPbDumpStats(struct aiPbDumpEnc *enc, ai_buffer_format format,
+    uint32_t n_items, float scale, int32_t zero_point)
+{
+  const uint32_t bits = AI_BUFFER_FMT_GET_BITS(format);
+  const bool is_signed = AI_BUFFER_FMT_GET_SIGN(format);
+  const bool is_float = AI_BUFFER_FMT_GET_FLOAT(format);
+  float vmin = 0.0f, vmax = 0.0f, sum = 0.0f, sum2 = 0.0f;
+
+  for (uint32_t i = 0; i < n_items; i++) {
+    float val;
+    if (is_float)
+      val = ((const float *)enc->src)[i];
+    else if (bits == 8)
+      val = is_signed ? (float)((const int8_t *)enc->src)[i] :
+          (float)enc->src[i];
+    else if (bits == 16)
+      val = is_signed ? (float)((const int16_t *)enc->src)[i] :
+          (float)((const uint16_t *)enc->src)[i];
+    else
+      val = is_signed ? (float)((const int32_t *)enc->src)[i] :
+          (float)((const uint32_t *)enc->src)[i];
+    if (scale != 0.0f)
+      val = scale * (val - (float)zero_point);
+    if ((i == 0) || (val < vmin))
+      vmin = val;
+    if ((i == 0) || (val > vmax))
+      vmax = val;
+    sum += val;
+    sum2 += val * val;
+  }
+
+  enc->stats[0] = vmin;
+  enc->stats[1] = vmax;
+  enc->stats[2] = n_items ? sum / (float)n_items : 0.0f;
+  enc->stats[3] = sqrtf(sum2);
+}
+
+/* Select the effective encoding of a dump, returns false if the dump is sent
+ * raw */
+static bool aiPbDumpEncInit(struct aiPbDumpEnc *enc, const ai_buffer *buffer,
+    uint32_t n_items, const aiBufferShapeMsg *shape)
+{
+  const uint32_t mode = aiPbDumpCodec.mode;
+  const size_t itsize = aiPbBufferGetItemSize(buffer->format);
+  pb_ostream_t sizing = PB_OSTREAM_SIZING;
+  uint32_t raw_size;
+
+  memset(enc, 0, sizeof(*enc));
+  enc->src = (const uint8_t *)buffer->data;
+  enc->n_items = n_items;
+  enc->it_shift = aiPbDumpLog2((uint32_t)itsize);
+
+  if (!enc->src || (enc->it_shift > 2) ||
+      (AI_BUFFER_BYTE_SIZE(n_items, buffer->format) != n_items * itsize))
+    return false;
+
+  if (mode & AI_PB_DUMP_CODEC_STATS) {
+    enc->codec = AI_PB_DUMP_CODEC_STATS;
+    enc->size = sizeof(enc->stats);
+    aiPbDumpStats(enc, buffer->format, n_items, shape->scale,
+        shape->zeropoint);
+    return true;
+  }
+
+  enc->st_shift = (mode & AI_PB_DUMP_CODEC_STRIDE_MSK) >>
+      AI_PB_DUMP_CODEC_STRIDE_POS;
+  enc->n_items = (n_items + (1U << enc->st_shift) - 1) >> enc->st_shift;
+  enc->codec = mode & (AI_PB_DUMP_CODEC_RLE0 | AI_PB_DUMP_CODEC_STRIDE_MSK);
+  if ((mode & AI_PB_DUMP_CODEC_BPLANE) && enc->it_shift)
+    enc->codec |= AI_PB_DUMP_CODEC_BPLANE;
+  raw_size = enc->n_items << enc->it_shift;
+
+#if AI_PB_DUMP_HISTORY_SIZE > 0
+  /* previous sample, same dump index and size */
+  const uint32_t idx = aiPbDumpCodec.idx;
+  if ((mode & AI_PB_DUMP_CODEC_DELTA) && (idx < aiPbDumpCodec.n_slots) &&
+      (aiPbDumpCodec.slot[idx].size == raw_size)) {
+    enc->prev = &aiPbDumpCodec.history[aiPbDumpCodec.slot[idx].offset];
+    enc->codec |= AI_PB_DUMP_CODEC_DELTA;
+  }
+#endif
+
+  enc->size = raw_size;
+  if (enc->codec & AI_PB_DUMP_CODEC_RLE0) {
+    /* zero after ReLU is the zero-point for the 8-bit quantized items */
+    if (!enc->prev && !enc->it_shift &&
+        (AI_BUFFER_FMT_GET_TYPE(buffer->format) == AI_BUFFER_FMT_TYPE_Q))
+      enc->zero = (uint8_t)shape->zeropoint;
+    aiPbDumpWrite(&sizing, enc);
+    if (sizing.bytes_written < raw_size)
+      enc->size = (uint32_t)sizing.bytes_written;
+    else {
+      enc->codec &= ~AI_PB_DUMP_CODEC_RLE0;
+      enc->zero = 0;
+    }
+  }
+
+  /* delta/byte planes alone do not reduce the size, send raw data */
+  if (!(enc->codec & (AI_PB_DUMP_CODEC_RLE0 | AI_PB_DUMP_CODEC_STRIDE_MSK))) {
+    enc->codec = 0;
+    enc->prev = NULL;
+    return false;
+  }
+
+  return true;
+}
+
+/* Keep the sent items, previous sample of the next delta encoding */
+static void aiPbDumpUpdateHistory(const struct aiPbDumpEnc *enc)
+{
+#if AI_PB_DUMP_HISTORY_SIZE > 0
+  const uint32_t idx = aiPbDumpCodec.idx;
+  const uint32_t size = enc->n_items << enc->it_shift;
+  uint32_t offset;
+
+  if (!(aiPbDumpCodec.mode & AI_PB_DUMP_CODEC_DELTA) ||
+      (enc->codec & AI_PB_DUMP_CODEC_STATS) || !enc->src ||
+      (enc->it_shift > 2))
+    return;
+
+  if ((idx >= aiPbDumpCodec.n_slots) ||
+      (aiPbDumpCodec.slot[idx].size != size)) {
+    /* new slot, the next ones are dropped */
+    offset = idx ? aiPbDumpCodec.slot[idx - 1].offset +
+        aiPbDumpCodec.slot[idx - 1].size : 0;
+    if ((idx > aiPbDumpCodec.n_slots) || (idx >= _DUMP_HISTORY_SLOTS) ||
+        (offset + size > AI_PB_DUMP_HISTORY_SIZE)) {
+      if (idx < aiPbDumpCodec.n_slots)
+        aiPbDumpCodec.n_slots = idx;
+      return;
+    }
+    aiPbDumpCodec.slot[idx].offset = offset;
+    aiPbDumpCodec.slot[idx].size = size;
+    aiPbDumpCodec.n_slots = idx + 1;
+  }
+
+  uint8_t *pw = &aiPbDumpCodec.history[aiPbDumpCodec.slot[idx].offset];
+  const uint32_t itsize = 1U << enc->it_shift;
+  for (uint32_t j = 0; j < enc->n_items; j++)
+    memcpy(&pw[j << enc->it_shift],
+        &enc->src[(j << enc->st_shift) << enc->it_shift], itsize);
+#else
+  UNUSED(enc);
+#endif
+}
+
+static bool aiPbBuffer_write_codec_cb(pb_ostream_t *stream,
+    const pb_field_t *field, void * const *arg)
+{
+  struct aiPbMgrBuffer *bm = (struct aiPbMgrBuffer *)*arg;
+  struct aiPbDumpEnc *enc = (struct aiPbDumpEnc *)bm->msg;
+
+  if (!pb_encode_tag_for_field(stream, field))
+    return false;
+
+  if (!pb_encode_varint(stream, enc->size))
+    return false;
+
+  /* sizing pass of the parent message, size is known */
+  if (!stream->callback)
+    return pb_write(stream, NULL, enc->size);
+
+  bm->n_ops = bm->n_max;
+
+  return aiPbDumpWrite(stream, enc);
+}
+
+#endif /* AI_PB_DUMP_CODEC */
+
 bool aiPbMgrReceiveAiBuffer3(const reqMsg *req, respMsg *resp,
     EnumState state, ai_buffer *buffer)
 {
@@ -327,6 +697,12 @@ bool aiPbMgrSendAiBuffer4(const reqMsg *req, respMsg *resp, EnumState state,
 #endif
   type &= (~PB_BUFFER_TYPE_SEND_WITHOUT_DATA);
 
+#if defined(AI_PB_DUMP_CODEC) && (AI_PB_DUMP_CODEC == 1)
+  struct aiPbDumpEnc enc;
+  const bool is_dump = (aiPbDumpCodec.mode != 0) && (hdlb.n_max != 0) &&
+      (((type >> 16) & 0x7FFF) != EnumLayerType_LAYER_TYPE_OUTPUT);
+#endif
+
   /* Fill Node sub-message */
   resp->which_payload = respMsg_node_tag;
   resp->payload.node.type = type;
@@ -349,9 +725,25 @@ bool aiPbMgrSendAiBuffer4(const reqMsg *req, respMsg *resp, EnumState state,
   resp->payload.node.buffer.datas.funcs.encode = &aiPbBuffer_write_cb3;
   resp->payload.node.buffer.datas.arg = &hdlb;
 
+#if defined(AI_PB_DUMP_CODEC) && (AI_PB_DUMP_CODEC == 1)
+  if (is_dump && aiPbDumpEncInit(&enc, buffer, hdlb.n_max,
+      &resp->payload.node.buffer.shape)) {
+    resp->payload.node.buffer.shape.addr = (int32_t)enc.codec;
+    resp->payload.node.buffer.datas.funcs.encode = &aiPbBuffer_write_codec_cb;
+    hdlb.msg = &enc;
+  }
+#endif
+
   /* Send msg */
   aiPbMgrSendResp(req, resp, state);
 
+#if defined(AI_PB_DUMP_CODEC) && (AI_PB_DUMP_CODEC == 1)
+  if (is_dump) {
+    aiPbDumpUpdateHistory(&enc);
+    aiPbDumpCodec.idx++;
+  }
+#endif
+
   /* Waiting ACK */
   if (state == EnumState_S_PROCESSING)
     return aiPbMgrWaitAck();
@@ -361,6 +753,395 @@ bool aiPbMgrSendAiBuffer4(const reqMsg *req, respMsg *resp, EnumState state,
 
 /*---------------------------------------------------------------------------*/
 
+/* On-device metrics */
+
+#define _METRICS_CHUNK_SIZE (64)
+
+struct aiPbMgrRef {
+  const ai_buffer *output;
+  float scale;            /* dequantization of the output/reference */
+  int32_t zero_point;
+  struct aiPbMetrics *metrics;
+  uint32_t err;
+  aiBufferByteMsg *msg;
+};
+
+void aiPbMetricsReset(struct aiPbMetrics *metrics)
+{
+  if (metrics)
+    memset(metrics, 0, sizeof(struct aiPbMetrics));
+}
+
+static float aiPbItemToFloat(const uint8_t *data, ai_buffer_format format,
+    float scale, int32_t zero_point)
+{
+  const uint32_t bits = AI_BUFFER_FMT_GET_BITS(format);
+  const bool is_signed = AI_BUFFER_FMT_GET_SIGN(format);
+  float val;
+
+  if (AI_BUFFER_FMT_GET_FLOAT(format))
+    return *(const float *)data;
+
+  if (bits == 8)
+    val = is_signed ? (float)*(const int8_t *)data : (float)*data;
+  else if (bits == 16)
+    val = is_signed ? (float)*(const int16_t *)data :
+        (float)*(const uint16_t *)data;
+  else
+    val = is_signed ? (float)*(const int32_t *)data :
+        (float)*(const uint32_t *)data;
+
+  if (scale != 0.0f)
+    val = scale * (val - (float)zero_point);
+  return val;
+}
+
+/* Compare the reference with the predicted values while it is received, the
+ * reference is not stored */
+static bool aiPbBuffer_ref_cb(pb_istream_t *stream, const pb_field_t *field,
+    void **arg)
+{
+  struct aiPbMgrRef *ref = (struct aiPbMgrRef *)*arg;
+  const ai_buffer *output = ref->output;
+  const ai_buffer_format format = aiPbMsgFmtToAiFmt(ref->msg->shape.format);
+  const size_t itsize = aiPbBufferGetItemSize(format);
+  const size_t o_itsize = aiPbBufferGetItemSize(output->format);
+  const uint32_t n_items = aiPbAiBufferSize(output);
+  const uint8_t *pred = (const uint8_t *)output->data;
+  uint8_t chunk[_METRICS_CHUNK_SIZE];
+  float mean = 0.0f, m2 = 0.0f, s_abs = 0.0f, s_sq = 0.0f, s_p2 = 0.0f;
+  float r_max = 0.0f, p_max = 0.0f;
+  uint32_t r_idx = 0, p_idx = 0, idx = 0;
+
+  UNUSED(field);
+
+  if ((format != AI_BUFFER_FORMAT_FLOAT) && (format != output->format))
+    ref->err = EnumError_E_INVALID_FORMAT;
+  else if ((ref->msg->shape.channels != output->channels) ||
+      (ref->msg->shape.height != output->height) ||
+      (ref->msg->shape.width != output->width) ||
+      (ref->msg->shape.n_batches != output->n_batches))
+    ref->err = EnumError_E_INVALID_SHAPE;
+  else if (!itsize || !o_itsize || !pred ||
+      (AI_BUFFER_BYTE_SIZE(n_items, format) != n_items * itsize) ||
+      (stream->bytes_left != n_items * itsize))
+    ref->err = EnumError_E_INVALID_SIZE;
+
+  if (ref->err != EnumError_E_NONE)
+    return pb_read(stream, NULL, stream->bytes_left);
+
+  /* Metrics of the sample (Welford for the error) */
+  while (stream->bytes_left) {
+    size_t n = stream->bytes_left;
+    if (n > sizeof(chunk))
+      n = (sizeof(chunk) / itsize) * itsize;
+    if (!pb_read(stream, chunk, n))
+      return false;
+    for (size_t i = 0; i < n; i += itsize, idx++) {
+      const float r = aiPbItemToFloat(&chunk[i], format, ref->scale,
+          ref->zero_point);
+      const float p = aiPbItemToFloat(&pred[idx * o_itsize], output->format,
+          ref->scale, ref->zero_point);
+      const float e = r - p;
+      const float delta = e - mean;
+      mean += delta / (float)(idx + 1);
+      m2 += delta * (e - mean);
+      s_abs += (e < 0.0f) ? -e : e;
+      s_sq += e * e;
+      s_p2 += p * p;
+      if ((idx == 0) || (r > r_max)) {
+        r_max = r;
+        r_idx = idx;
+      }
+      if ((idx == 0) || (p > p_max)) {
+        p_max = p;
+        p_idx = idx;
+      }
+    }
+  }
+
+  /* Merge with the previous samples (Chan) */
+  struct aiPbMetrics *mt = ref->metrics;
+  const double n_a = mt->n_items;
+  const double n_b = (double)n_items;
+  const double n_ab = n_a + n_b;
+  const double delta = (double)mean - mt->mean;
+
+  mt->mean += delta * n_b / n_ab;
+  mt->m2 += (double)m2 + delta * delta * n_a * n_b / n_ab;
+  mt->mean_abs += ((double)s_abs / n_b - mt->mean_abs) * n_b / n_ab;
+  mt->mean_sq += ((double)s_sq / n_b - mt->mean_sq) * n_b / n_ab;
+  mt->mean_p2 += ((double)s_p2 / n_b - mt->mean_p2) * n_b / n_ab;
+  mt->n_items = n_ab;
+  mt->n_samples++;
+  if (r_idx == p_idx)
+    mt->n_correct++;
+
+  return true;
+}
+
+bool aiPbMgrReceiveReference(const reqMsg *req, respMsg *resp,
+    EnumState state, const ai_buffer *output, ai_float scale,
+    ai_i32 zero_point, struct aiPbMetrics *metrics)
+{
+  aiBufferByteMsg msg;
+  struct aiPbMgrRef hdlr;
+  const ai_buffer_meta_info *meta_info = AI_BUFFER_META_INFO(output);
+
+  hdlr.output = output;
+  hdlr.scale = scale;
+  hdlr.zero_point = zero_point;
+  hdlr.metrics = metrics;
+  hdlr.err = EnumError_E_NONE;
+  hdlr.msg = &msg;
+
+  if (meta_info && scale == 0.0f && AI_BUFFER_META_INFO_INTQ(meta_info)) {
+    hdlr.scale = AI_BUFFER_META_INFO_INTQ_GET_SCALE(meta_info, 0);
+    hdlr.zero_point = AI_BUFFER_META_INFO_INTQ_GET_ZEROPOINT(meta_info, 0);
+  }
+
+  msg.datas.funcs.decode = &aiPbBuffer_ref_cb;
+  msg.datas.arg = &hdlr;
+
+  /* Waiting the reference */
+  if (!pb_decode_delimited(&pbContextMgr.input, aiBufferByteMsg_fields, &msg)
+      && (hdlr.err == EnumError_E_NONE))
+    hdlr.err = EnumError_E_GENERIC;
+  pb_io_flush_istream();
+
+  /* Send ACK and wait ACK (or send ACK only if error) */
+  if (hdlr.err) {
+    aiPbMgrSendAck(req, resp, EnumState_S_ERROR, hdlr.err,
+        (EnumError)hdlr.err);
+    return false;
+  }
+
+  aiPbMgrSendAck(req, resp, state, metrics->n_samples, EnumError_E_NONE);
+  if (state == EnumState_S_PROCESSING)
+    aiPbMgrWaitAck();
+
+  return true;
+}
+
+bool aiPbMgrSendMetrics(const reqMsg *req, respMsg *resp, EnumState state,
+    uint32_t id, const struct aiPbMetrics *metrics)
+{
+  float values[AI_PB_METRIC_NB];
+  ai_buffer buffer;
+  const double n = metrics->n_items;
+  const uint32_t n_samples = metrics->n_samples;
+
+  memset(values, 0, sizeof(values));
+  values[AI_PB_METRIC_N_SAMPLES] = (float)n_samples;
+  if (n_samples) {
+    values[AI_PB_METRIC_ACC] = ((uint32_t)n > n_samples) ?
+        (float)metrics->n_correct / (float)n_samples : -1.0f;
+    values[AI_PB_METRIC_RMSE] = (float)sqrt(metrics->mean_sq);
+    values[AI_PB_METRIC_MAE] = (float)metrics->mean_abs;
+    values[AI_PB_METRIC_L2R] = (float)(sqrt(metrics->mean_sq * n) /
+        (sqrt(metrics->mean_p2 * n) + (double)FLT_EPSILON));
+    values[AI_PB_METRIC_MEAN] = (float)metrics->mean;
+    values[AI_PB_METRIC_STD] = (float)sqrt(metrics->m2 / n);
+  }
+
+  memset(&buffer, 0, sizeof(buffer));
+  buffer.format = AI_BUFFER_FORMAT_FLOAT;
+  buffer.n_batches = 1;
+  buffer.height = 1;
+  buffer.width = 1;
+  buffer.channels = AI_PB_METRIC_NB;
+  buffer.data = AI_HANDLE_PTR(values);
+
+  return aiPbMgrSendAiBuffer4(req, resp, state,
+      EnumLayerType_LAYER_TYPE_OUTPUT << 16 | 0, id,
+      n_samples ? (ai_float)(metrics->dur_ms / n_samples) : 0.0f,
+      &buffer, 0.0f, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+
+/* Deferred capture of the per-layer outputs */
+
+/* Captured node, followed by the data (if any) */
+struct aiPbCaptureRec {
+  uint32_t size;          /* size of the record (header + data) */
+  uint32_t type;
+  uint32_t id;
+  ai_float dur_ms;
+  ai_float scale;
+  ai_i32 zero_point;
+  ai_buffer buffer;       /* data: NULL if captured without data */
+};
+
+#define _CAPTURE_ALIGN(sz) (((sz) + 7U) & ~7U)
+
+static struct aiPbCapture {
+  bool enabled;
+  uint32_t first;         /* node filter: first <= id < last */
+  uint32_t last;
+  uint32_t size;          /* budget (bytes), <= AI_PB_CAPTURE_SIZE */
+  uint32_t head;          /* write offset */
+  uint32_t tail;          /* read offset */
+  uint32_t end;           /* end of the valid records before a wrap */
+  uint32_t n_recs;
+#if AI_PB_CAPTURE_SIZE > 0
+  AI_ALIGNED(8) uint8_t ring[AI_PB_CAPTURE_SIZE];
+#endif
+} aiPbCapture;
+
+static void aiPbCaptureConfig(const reqMsg *req)
+{
+  aiPbCapture.enabled = false;
+  aiPbCapture.n_recs = 0;
+  aiPbCapture.head = aiPbCapture.tail = 0;
+
+#if AI_PB_CAPTURE_SIZE > 0
+  const uint32_t n = AI_PB_CAPTURE_OPT_N(req->opt);
+  uint32_t size = AI_PB_CAPTURE_OPT_KIB(req->opt) * 1024U;
+
+  if (!(req->param & AI_PB_RUN_MODE_CAPTURE) ||
+      !(req->param & (EnumRunParam_P_RUN_MODE_INSPECTOR |
+          EnumRunParam_P_RUN_MODE_INSPECTOR_WITHOUT_DATA)))
+    return;
+
+  if ((size == 0) || (size > AI_PB_CAPTURE_SIZE))
+    size = AI_PB_CAPTURE_SIZE;
+
+  aiPbCapture.first = AI_PB_CAPTURE_OPT_FIRST(req->opt);
+  aiPbCapture.last = n ? aiPbCapture.first + n : 0xFFFFFFFFU;
+  aiPbCapture.size = size & ~7U;
+  aiPbCapture.end = aiPbCapture.size;
+  aiPbCapture.enabled = true;
+#else
+  UNUSED(req);
+#endif
+}
+
+bool aiPbCaptureIsEnabled(void)
+{
+  return aiPbCapture.enabled;
+}
+
+#if AI_PB_CAPTURE_SIZE > 0
+/* Reserve a contiguous record, the end of the ring is skipped if too small */
+static struct aiPbCaptureRec *aiPbCaptureAlloc(uint32_t size)
+{
+  struct aiPbCapture *cap = &aiPbCapture;
+  uint32_t pos;
+
+  if (cap->n_recs == 0) {
+    cap->head = cap->tail = 0;
+    cap->end = cap->size;
+  }
+
+  if ((cap->n_recs != 0) && (cap->head == cap->tail))
+    return NULL;
+
+  if (cap->head >= cap->tail) {
+    /* free space: [head, size) and [0, tail) */
+    if (cap->head + size <= cap->size)
+      pos = cap->head;
+    else if (size <= cap->tail) {
+      cap->end = cap->head;
+      pos = 0;
+    } else
+      return NULL;
+  } else if (cap->head + size <= cap->tail)
+    pos = cap->head;
+  else
+    return NULL;
+
+  cap->head = pos + size;
+  cap->n_recs++;
+  return (struct aiPbCaptureRec *)&cap->ring[pos];
+}
+#endif
+
+/* Called in the observer callback, in place of aiPbMgrSendAiBuffer4().
+ * The node is captured without data if it is outside the node filter, if
+ * the PB_BUFFER_TYPE_SEND_WITHOUT_DATA flag is set or if the budget is
+ * exhausted. It is dropped if even the header does not fit. */
+void aiPbCaptureNode(uint32_t type, uint32_t id, ai_float dur_ms,
+    const ai_buffer *buffer, ai_float scale, ai_i32 zero_point)
+{
+#if AI_PB_CAPTURE_SIZE > 0
+  const uint32_t hsize = _CAPTURE_ALIGN(sizeof(struct aiPbCaptureRec));
+  struct aiPbCaptureRec *rec = NULL;
+  uint32_t dsize = 0;
+
+  if (!aiPbCapture.enabled)
+    return;
+
+  if (!(type & PB_BUFFER_TYPE_SEND_WITHOUT_DATA) && buffer->data &&
+      (id >= aiPbCapture.first) && (id < aiPbCapture.last))
+    dsize = AI_BUFFER_BYTE_SIZE(aiPbAiBufferSize(buffer), buffer->format);
+
+  if (dsize)
+    rec = aiPbCaptureAlloc(hsize + _CAPTURE_ALIGN(dsize));
+  if (!rec) {
+    dsize = 0;
+    rec = aiPbCaptureAlloc(hsize);
+    if (!rec)
+      return;
+  }
+
+  rec->size = hsize + _CAPTURE_ALIGN(dsize);
+  rec->type = type;
+  rec->id = id;
+  rec->dur_ms = dur_ms;
+  rec->scale = scale;
+  rec->zero_point = zero_point;
+  rec->buffer = *buffer;
+  rec->buffer.meta_info = NULL;
+  if (dsize) {
+    rec->buffer.data = AI_HANDLE_PTR((uint8_t *)rec + hsize);
+    memcpy((uint8_t *)rec + hsize, buffer->data, dsize);
+  } else {
+    /* IO flag would force the upload of the data */
+    rec->buffer.format &= ~AI_BUFFER_FMT_FLAG_IS_IO;
+    rec->buffer.data = AI_HANDLE_PTR(NULL);
+    rec->type |= PB_BUFFER_TYPE_SEND_WITHOUT_DATA;
+  }
+#else
+  UNUSED(type);
+  UNUSED(id);
+  UNUSED(dur_ms);
+  UNUSED(buffer);
+  UNUSED(scale);
+  UNUSED(zero_point);
+#endif
+}
+
+/* Send the captured nodes (S_PROCESSING state), called after the inference */
+bool aiPbCaptureFlush(const reqMsg *req, respMsg *resp)
+{
+#if AI_PB_CAPTURE_SIZE > 0
+  struct aiPbCapture *cap = &aiPbCapture;
+
+  while (cap->enabled && cap->n_recs) {
+    struct aiPbCaptureRec *rec;
+    if (cap->tail == cap->end) {
+      cap->tail = 0;
+      cap->end = cap->size;
+    }
+    rec = (struct aiPbCaptureRec *)&cap->ring[cap->tail];
+    cap->tail += rec->size;
+    cap->n_recs--;
+    if (!aiPbMgrSendAiBuffer4(req, resp, EnumState_S_PROCESSING, rec->type,
+        rec->id, rec->dur_ms, &rec->buffer, rec->scale, rec->zero_point)) {
+      cap->n_recs = 0;
+      return false;
+    }
+  }
+#else
+  UNUSED(req);
+  UNUSED(resp);
+#endif
+  return true;
+}
+
+/*---------------------------------------------------------------------------*/
+
 void aiPbCmdSync(const reqMsg *req, respMsg *resp, void *param)
 {
   resp->which_payload = respMsg_sync_tag;
@@ -374,8 +1155,17 @@ void aiPbCmdSync(const reqMsg *req, respMsg *resp, void *param)
   resp->payload.sync.capability |= EnumCapability_CAP_SELF_TEST;
 #endif
 
-  resp->payload.sync.rtid = (uint32_t)param >> 16;
-  resp->payload.sync.capability |= ((uint32_t)param & 0xFFFF);
+  resp->payload.sync.rtid = (uint32_t)(uintptr_t)param >> 16;
+  resp->payload.sync.capability |= ((uint32_t)(uintptr_t)param & 0xFFFF);
+
+#if defined(AI_PB_DUMP_CODEC) && (AI_PB_DUMP_CODEC == 1)
+  if (resp->payload.sync.capability & EnumCapability_CAP_INSPECTOR)
+    resp->payload.sync.capability |= AI_PB_CAP_DUMP_CODEC;
+#endif
+#if AI_PB_CAPTURE_SIZE > 0
+  if (resp->payload.sync.capability & EnumCapability_CAP_INSPECTOR)
+    resp->payload.sync.capability |= AI_PB_CAP_CAPTURE;
+#endif
 
   resp->payload.sync.rtid |= (_ARM_TOOLS_ID << 8);
 
@@ -427,7 +1217,7 @@ static void init_aibuffer_msg(const ai_buffer *aibuffer, aiBufferShapeMsg *msg)
   msg->height = aibuffer->height;
   msg->width = aibuffer->width;
   msg->n_batches = aibuffer->n_batches;
-  msg->addr = (uint32_t)aibuffer->data;
+  msg->addr = (uint32_t)(uintptr_t)aibuffer->data;
   aiPbMgrSetMetaInfo(meta_info, 0, msg);
 #endif
 }
@@ -39,6 +39,8 @@
  *           code clean-up: remove legacy code/add comments
  *  - v5.1 - minor - let irq enabled if USB CDC is used
  *  - v5.2 - Use the fix cycle count overflow support
+ *  - v5.3 - Add on-device metrics (AI_PB_RUN_MODE_METRICS/CMD_NETWORK_REPORT)
+ *  - v5.4 - Add deferred capture of the per-layer outputs (AI_PB_RUN_MODE_CAPTURE)
  */
 
 #ifndef HAS_INSPECTOR
@@ -92,7 +94,7 @@
 #define _APP_DEBUG_         			0
 
 #define _APP_VERSION_MAJOR_     (0x05)
-#define _APP_VERSION_MINOR_     (0x02)
+#define _APP_VERSION_MINOR_     (0x04)
 #define _APP_VERSION_   ((_APP_VERSION_MAJOR_ << 8) | _APP_VERSION_MINOR_)
 
 #define _APP_NAME_   "AI Validation (Observer based)"
@@ -111,6 +113,7 @@ struct ai_network_user_obs_ctx {
   const reqMsg *creq;             /* reference of the current PB request */
   respMsg *cresp;                 /* reference of the current PB response */
   bool no_data;                   /* indicate that the data of the tensor should be not up-loaded */
+  bool capture;                   /* indicate that the data are captured and up-loaded after the inference */
   uint64_t tcom;                  /* number of cycles to up-load the data by layer (COM) */
   uint64_t tnodes;                /* number of cycles to execute the operators (including nn.init)
                                      nn.done is excluded but added by the adjust function */
@@ -126,6 +129,7 @@ struct ai_network_user_obs_ctx  net_obs_ctx; /* execution the models is serializ
 struct ai_network_exec_ctx {
   ai_handle handle;
   ai_network_report report;
+  struct aiPbMetrics metrics[AI_MNETWORK_OUT_NUM];  /* running metrics by output */
 #ifdef HAS_OBSERVER
   struct ai_network_user_obs_ctx *obs_ctx;
 #endif
@@ -209,12 +213,17 @@ static ai_u32 aiOnExecNode_cb(const ai_handle cookie,
       } else {
         n_type = type;
       }
-      aiPbMgrSendAiBuffer4(obs_ctx->creq, obs_ctx->cresp, EnumState_S_PROCESSING,
-          n_type,
-          node->id,
-          dwtCyclesToFloatMs(ts),
-          &buffer,
-          scale, zero_point);
+      /* deferred capture: data are sent after the inference */
+      if (obs_ctx->capture)
+        aiPbCaptureNode(n_type, node->id, dwtCyclesToFloatMs(ts),
+            &buffer, scale, zero_point);
+      else
+        aiPbMgrSendAiBuffer4(obs_ctx->creq, obs_ctx->cresp, EnumState_S_PROCESSING,
+            n_type,
+            node->id,
+            dwtCyclesToFloatMs(ts),
+            &buffer,
+            scale, zero_point);
 
       // break; /* currently (X-CUBE-AI 5.x) only one output tensor is available by operator */
     }
@@ -256,6 +265,9 @@ static void aiObserverSendReport(const reqMsg *req, respMsg *resp,
   if (obs_ctx->is_enabled == false)
     return;
 
+  /* per-layer outputs captured during the inference */
+  aiPbCaptureFlush(req, resp);
+
   resp->which_payload = respMsg_report_tag;
   resp->payload.report.id = 0;
   resp->payload.report.elapsed_ms = dur_ms;
@@ -282,6 +294,7 @@ static int aiObserverConfig(struct ai_network_exec_ctx *ctx,
     net_obs_ctx.is_enabled = true;
     net_obs_ctx.no_data = true;
   }
+  net_obs_ctx.capture = aiPbCaptureIsEnabled();
 
   net_obs_ctx.tcom = 0ULL;
   net_obs_ctx.tnodes = 0ULL;
@@ -629,10 +642,18 @@ void aiPbCmdNNRun(const reqMsg *req, respMsg *resp, void *param)
       dwtCyclesToFloatMs(tend));
 
   /* 5 - Send all output tensors ----------------------------------- */
+  /*     or compare them with the references (on-device metrics) */
   for (int i = 0; i < ctx->report.n_outputs; i++) {
     EnumState state = EnumState_S_PROCESSING;
     if ((i + 1) == ctx->report.n_outputs)
       state = EnumState_S_DONE;
+    if (req->param & AI_PB_RUN_MODE_METRICS) {
+      ctx->metrics[i].dur_ms += dwtCyclesToFloatMs(tend);
+      if (!aiPbMgrReceiveReference(req, resp, state, &ai_output[i],
+          0.0f, 0, &ctx->metrics[i]))
+        break;
+      continue;
+    }
     aiPbMgrSendAiBuffer4(req, resp, state,
         EnumLayerType_LAYER_TYPE_OUTPUT << 16 | 0,
         0, dwtCyclesToFloatMs(tend),
@@ -642,15 +663,40 @@ void aiPbCmdNNRun(const reqMsg *req, respMsg *resp, void *param)
   aiObserverUnbind(ctx);
 }
 
+void aiPbCmdNNReport(const reqMsg *req, respMsg *resp, void *param)
+{
+  struct ai_network_exec_ctx *ctx;
+
+  UNUSED(param);
+
+  ctx = aiExecCtx(req->name, -1);
+  if (!ctx) {
+    aiPbMgrSendAck(req, resp, EnumState_S_ERROR,
+        EnumError_E_INVALID_PARAM, EnumError_E_INVALID_PARAM);
+    return;
+  }
+
+  /* Send the metrics of all outputs */
+  for (int i = 0; i < ctx->report.n_outputs; i++) {
+    EnumState state = EnumState_S_PROCESSING;
+    if ((i + 1) == ctx->report.n_outputs)
+      state = EnumState_S_DONE;
+    aiPbMgrSendMetrics(req, resp, state, i, &ctx->metrics[i]);
+    if (req->param & AI_PB_REPORT_RESET)
+      aiPbMetricsReset(&ctx->metrics[i]);
+  }
+}
+
 static aiPbCmdFunc pbCmdFuncTab[] = {
 #ifdef HAS_INSPECTOR
-    AI_PB_CMD_SYNC((void *)(EnumCapability_CAP_INSPECTOR | (EnumAiRuntime_AI_RT_STM_AI << 16))),
+    AI_PB_CMD_SYNC((void *)(EnumCapability_CAP_INSPECTOR | AI_PB_CAP_METRICS | (EnumAiRuntime_AI_RT_STM_AI << 16))),
 #else
-    AI_PB_CMD_SYNC(NULL),
+    AI_PB_CMD_SYNC((void *)(AI_PB_CAP_METRICS)),
 #endif
     AI_PB_CMD_SYS_INFO(NULL),
     { EnumCmd_CMD_NETWORK_INFO, &aiPbCmdNNInfo, NULL },
     { EnumCmd_CMD_NETWORK_RUN, &aiPbCmdNNRun, NULL },
+    { EnumCmd_CMD_NETWORK_REPORT, &aiPbCmdNNReport, NULL },
 #if defined(AI_PB_TEST) && AI_PB_TEST == 1
     AI_PB_CMD_TEST(NULL),
 #endif
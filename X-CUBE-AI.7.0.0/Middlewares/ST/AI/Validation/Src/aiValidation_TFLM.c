@@ -28,6 +28,10 @@
  *  - v2.0 - align code for TFLM 2.5.0
  *           add observer support to upload time by layer with or w/o data
  *  - v2.1 - Use the fix cycle count overflow support
+ *  - v2.2 - can be built as a Linux process (AI_TEST_HOST=1), the model is
+ *           loaded at run-time (see aiValidation_host.c)
+ *  - v2.3 - add on-device metrics (AI_PB_RUN_MODE_METRICS/CMD_NETWORK_REPORT)
+ *  - v2.4 - add deferred capture of the per-layer outputs (AI_PB_RUN_MODE_CAPTURE)
  */
 
 /* System headers */
@@ -56,7 +60,9 @@
 #include <aiPbMgr.h>
 
 /* AI x-cube-ai files */
+#if !defined(AI_TEST_HOST) || (AI_TEST_HOST == 0)
 #include <app_x-cube-ai.h>
+#endif
 
 /* AI header files */
 #include <ai_platform.h>
@@ -65,7 +71,16 @@
 
 #include <tflm_c.h>
 
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+#ifndef TFLM_NETWORK_TENSOR_AREA_SIZE
+#define TFLM_NETWORK_TENSOR_AREA_SIZE (1024 * 1024)
+#endif
+/* loaded from a .tflite file by the host application */
+extern const uint8_t *g_tflm_network_model_data;
+extern int g_tflm_network_model_data_len;
+#else
 #include "network_tflite_data.h"
+#endif
 
 
 /* -----------------------------------------------------------------------------
@@ -184,6 +199,7 @@ struct tflm_context {
   uint32_t hdl;
   ai_network_report report;
   int error;
+  struct aiPbMetrics *metrics;    /* running metrics by output */
 #if defined(USE_OBSERVER) && USE_OBSERVER == 1
   bool obs_is_enabled;
   bool obs_no_data;
@@ -292,12 +308,18 @@ static int _observer_node_cb(const void* cookie,
         n_type = type;
       }
 
-      aiPbMgrSendAiBuffer4(ctx->creq, ctx->cresp, EnumState_S_PROCESSING,
-          n_type,
-          node->node_info.idx,
-          dwtCyclesToFloatMs(node->node_info.dur),
-          &buffer,
-          scale, zero_point);
+      /* deferred capture: data are sent after the inference */
+      if (aiPbCaptureIsEnabled())
+        aiPbCaptureNode(n_type, node->node_info.idx,
+            dwtCyclesToFloatMs(node->node_info.dur),
+            &buffer, scale, zero_point);
+      else
+        aiPbMgrSendAiBuffer4(ctx->creq, ctx->cresp, EnumState_S_PROCESSING,
+            n_type,
+            node->node_info.idx,
+            dwtCyclesToFloatMs(node->node_info.dur),
+            &buffer,
+            scale, zero_point);
     }
   }
 
@@ -379,6 +401,9 @@ static void aiObserverSendReport(const reqMsg *req, respMsg *resp,
   if ((ctx->hdl == 0) || (ctx->obs_is_enabled == false))
     return;
 
+  /* per-layer outputs captured during the inference */
+  aiPbCaptureFlush(req, resp);
+
   resp->which_payload = respMsg_report_tag;
   resp->payload.report.id = 0;
   resp->payload.report.elapsed_ms = dur_ms;
@@ -444,8 +469,8 @@ static int aiBootstrap(struct tflm_context *ctx)
   printf("\r\nInstancing the network (TFLM)..\r\n");
 
   /* TFLm runtime expects that the tensor arena is aligned on 16-bytes */
-  uint32_t uaddr = (uint32_t)tensor_arena;
-  uaddr = (uaddr + (16 - 1)) & (uint32_t)(-16);  // Round up to 16-byte boundary
+  uintptr_t uaddr = (uintptr_t)tensor_arena;
+  uaddr = (uaddr + (16 - 1)) & (uintptr_t)(-16);  // Round up to 16-byte boundary
 
   MON_ALLOC_RESET();
   MON_ALLOC_ENABLE();
@@ -463,10 +488,13 @@ static int aiBootstrap(struct tflm_context *ctx)
 
   set_ai_network_report(ctx->hdl, &ctx->report);
 
+  ctx->metrics = (struct aiPbMetrics *)calloc(ctx->report.n_outputs,
+      sizeof(struct aiPbMetrics));
+
   tflm_c_rt_version(&ver);
 
   printf(" TFLM version       : %d.%d.%d\r\n", (int)ver.major, (int)ver.minor, (int)ver.patch);
-  printf(" TFLite file        : 0x%08x\r\n", (int)g_tflm_network_model_data);
+  printf(" TFLite file        : 0x%08x\r\n", (int)(uintptr_t)g_tflm_network_model_data);
   printf(" Arena location     : 0x%08x\r\n", (int)uaddr);
   printf(" Operator size      : %d\r\n", (int)tflm_c_operators_size(ctx->hdl));
   printf(" Tensor size        : %d\r\n", (int)tflm_c_tensors_size(ctx->hdl));
@@ -501,6 +529,8 @@ static void aiDone(struct tflm_context *ctx)
   if (ctx->hdl != 0) {
     free(ctx->report.inputs);
     free(ctx->report.outputs);
+    free(ctx->metrics);
+    ctx->metrics = NULL;
     tflm_c_destroy(ctx->hdl);
     ctx->hdl = 0;
   }
@@ -601,12 +631,21 @@ void aiPbCmdNNRun(const reqMsg *req, respMsg *resp, void *param)
       dwtCyclesToFloatMs(tend));
 
   /* 5 - Send all output tensors ----------------------------------- */
+  /*     or compare them with the references (on-device metrics) */
   for (int i = 0; i < ctx->report.n_outputs; i++) {
     EnumState state = EnumState_S_PROCESSING;
     struct tflm_c_tensor_info t_info;
     tflm_c_output(ctx->hdl, i, &t_info);
     if ((i + 1) == ctx->report.n_outputs)
       state = EnumState_S_DONE;
+    if (req->param & AI_PB_RUN_MODE_METRICS) {
+      ctx->metrics[i].dur_ms += dwtCyclesToFloatMs(tend);
+      if (!aiPbMgrReceiveReference(req, resp, state,
+          &ctx->report.outputs[i], t_info.scale, t_info.zero_point,
+          &ctx->metrics[i]))
+        break;
+      continue;
+    }
     aiPbMgrSendAiBuffer4(req, resp, state,
         EnumLayerType_LAYER_TYPE_OUTPUT << 16 | 0,
         0, dwtCyclesToFloatMs(tend),
@@ -618,15 +657,41 @@ void aiPbCmdNNRun(const reqMsg *req, respMsg *resp, void *param)
   aiObserverUnbind(ctx);
 }
 
+void aiPbCmdNNReport(const reqMsg *req, respMsg *resp, void *param)
+{
+  UNUSED(param);
+
+  struct tflm_context *ctx = &net_exec_ctx[0];
+
+  if ((ctx->hdl == 0) || (!ctx->metrics) ||
+      (strncmp(ctx->report.model_name, req->name,
+          strlen(ctx->report.model_name)) != 0)) {
+    aiPbMgrSendAck(req, resp, EnumState_S_ERROR,
+        EnumError_E_INVALID_PARAM, EnumError_E_INVALID_PARAM);
+    return;
+  }
+
+  /* Send the metrics of all outputs */
+  for (int i = 0; i < ctx->report.n_outputs; i++) {
+    EnumState state = EnumState_S_PROCESSING;
+    if ((i + 1) == ctx->report.n_outputs)
+      state = EnumState_S_DONE;
+    aiPbMgrSendMetrics(req, resp, state, i, &ctx->metrics[i]);
+    if (req->param & AI_PB_REPORT_RESET)
+      aiPbMetricsReset(&ctx->metrics[i]);
+  }
+}
+
 static aiPbCmdFunc pbCmdFuncTab[] = {
 #if defined(USE_OBSERVER) && USE_OBSERVER == 1
-    AI_PB_CMD_SYNC((void *)(EnumCapability_CAP_INSPECTOR | (EnumAiRuntime_AI_RT_TFLM << 16))),
+    AI_PB_CMD_SYNC((void *)(EnumCapability_CAP_INSPECTOR | AI_PB_CAP_METRICS | (EnumAiRuntime_AI_RT_TFLM << 16))),
 #else
-    AI_PB_CMD_SYNC(NULL),
+    AI_PB_CMD_SYNC((void *)(AI_PB_CAP_METRICS)),
 #endif
     AI_PB_CMD_SYS_INFO(NULL),
     { EnumCmd_CMD_NETWORK_INFO, &aiPbCmdNNInfo, NULL },
     { EnumCmd_CMD_NETWORK_RUN, &aiPbCmdNNRun, NULL },
+    { EnumCmd_CMD_NETWORK_REPORT, &aiPbCmdNNReport, NULL },
 #if defined(AI_PB_TEST) && AI_PB_TEST == 1
     AI_PB_CMD_TEST(NULL),
 #endif
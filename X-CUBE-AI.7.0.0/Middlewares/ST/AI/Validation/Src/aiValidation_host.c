@@ -0,0 +1,131 @@
+/**
+ ******************************************************************************
+ * @file    aiValidation_host.c
+ * @author  MCD Vertical Application Team
+ * @brief   AI Validation application - Linux process entry point (TFLM)
+ ******************************************************************************
+ * @attention
+ *
+ * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+ * All rights reserved.</center></h2>
+ *
+ * This software component is licensed by ST under Ultimate Liberty license
+ * SLA0044, the "License"; You may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at:
+ *                             www.st.com/SLA0044
+ *
+ ******************************************************************************
+ */
+
+/* Description
+ *
+ * - Runs the validation stack (aiPbMgr.c, aiValidation_TFLM.c) as a Linux
+ *   process, with the protocol over a pseudo-terminal or a Unix domain
+ *   socket in place of the UART/USB CDC. The TFLM model is loaded from a
+ *   .tflite file.
+ *
+ *   Build (all files compiled with -DAI_TEST_HOST=1 -DTFLM_RUNTIME=1
+ *   -DTF_LITE_STATIC_MEMORY, include paths of the Inc directories). The host
+ *   files are empty when AI_TEST_HOST is not defined:
+ *     Misc/Src/aiTestUtility_host.c
+ *     Validation/Src/{aiValidation_host.c, aiValidation_TFLM.c, aiPbMgr.c,
+ *                     aiPbIO.c, pb_common.c, pb_decode.c, pb_encode.c,
+ *                     stm32msg.pb.c}
+ *     TFliteMicro/Src/{tflm_c.cc, debug_log_imp.cc} + TFLM library
+ *
+ *   Usage:
+ *     aivalidation_host -m <model.tflite> [-u <socket path>]
+ *
+ *   Without -u, a pseudo-terminal is created and its name is printed, it can
+ *   be used as the serial port of the host tools. aiPbLoadGen.c is a client
+ *   measuring the request rate and the throughput of the protocol.
+ *
+ * History:
+ *  - v1.0 - Initial version
+ */
+
+#if defined(AI_TEST_HOST) && (AI_TEST_HOST == 1)
+
+/* System headers */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/* APP Header files */
+#include <aiValidation.h>
+#include <aiTestUtility.h>
+
+
+/* model data, see aiValidation_TFLM.c */
+const uint8_t *g_tflm_network_model_data = NULL;
+int g_tflm_network_model_data_len = 0;
+
+static void usage(const char *app)
+{
+  printf("usage: %s -m <model.tflite> [-u <socket path>]\r\n", app);
+}
+
+int main(int argc, char *argv[])
+{
+  struct ioTransport transport;
+  const char *model = NULL;
+  const char *socket_path = NULL;
+  char pty_name[64];
+  void *model_data;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "m:u:h")) != -1) {
+    switch (opt) {
+      case 'm': model = optarg; break;
+      case 'u': socket_path = optarg; break;
+      default: usage(argv[0]); return 1;
+    }
+  }
+
+  if (!model) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  /* log is line buffered when redirected */
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  model_data = hostLoadFile(model, &g_tflm_network_model_data_len);
+  if (!model_data) {
+    printf("E: unable to load \"%s\"\r\n", model);
+    return 1;
+  }
+  g_tflm_network_model_data = (const uint8_t *)model_data;
+
+  if (socket_path) {
+    if (ioHostOpenUnixSocket(&transport, socket_path)) {
+      printf("E: unable to listen on \"%s\"\r\n", socket_path);
+      return 1;
+    }
+    printf("Protocol channel   : unix socket %s\r\n", socket_path);
+  } else {
+    if (ioHostOpenPty(&transport, pty_name, sizeof(pty_name))) {
+      printf("E: unable to create a pseudo-terminal\r\n");
+      return 1;
+    }
+    printf("Protocol channel   : %s\r\n", pty_name);
+  }
+
+  ioRawSetTransport(&transport);
+
+  aiValidationInit();
+  aiValidationProcess();
+  aiValidationDeInit();
+
+  ioRawSetTransport(NULL);
+  ioHostClose(&transport);
+  if (socket_path)
+    unlink(socket_path);
+  free(model_data);
+
+  return 0;
+}
+
+#endif /* AI_TEST_HOST */
@@ -0,0 +1,315 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Sweeps the scratch budgets of the cmsis_nn CONV_2D kernel
+// (TF_LITE_MICRO_CONV_SCRATCH_BUDGET) and times the kernel each budget
+// selects, the number of filter rows being chosen as in kernels/cmsis_nn/
+// conv.cc. The outputs must be identical to the unbudgeted kernel:
+//  - int8: arm_convolve_row_tiled_s8() against arm_convolve_s8(). The host
+//    build has no ARM_MATH_DSP, so arm_convolve_s8() needs no buffer here: the
+//    size it needs with ARM_MATH_DSP is used to select the tiled kernel, and
+//    the timings are those of the portable C loops;
+//  - float32: ConvFloat() with fewer filter rows against the whole filter.
+// Returns 1 if a check fails.
+//
+// On the host (TF_LITE_USE_CTIME):
+//   tensorflow/lite/micro/testing/test_host.sh \
+//       tensorflow/lite/micro/benchmarks/conv_scratch_budget_benchmark.cc
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "arm_nnfunctions.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/micro/kernels/float_kernels.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_time.h"
+#include "tensorflow/lite/micro/system_setup.h"
+
+namespace {
+
+// Scratch budgets in bytes, 0 is no limit.
+constexpr int32_t kBudgets[] = {0, 16384, 8192, 4096, 2048, 1024, 512, 256};
+
+constexpr int kMaxInputSize = 80 * 1024;
+constexpr int kMaxFilterSize = 110 * 1024;
+constexpr int kMaxOutputSize = 64 * 1024;
+constexpr int kMaxChannels = 128;
+constexpr int kMaxBufferBytes = 64 * 1024;
+
+union {
+  int8_t int8[kMaxInputSize];
+  float f32[kMaxInputSize];
+} input_data;
+union {
+  int8_t int8[kMaxFilterSize];
+  float f32[kMaxFilterSize];
+} filter_data;
+union {
+  int8_t int8[kMaxOutputSize];
+  float f32[kMaxOutputSize];
+} reference_output, output_data;
+union {
+  int32_t int32[kMaxChannels];
+  float f32[kMaxChannels];
+} bias_data;
+int32_t output_multiplier[kMaxChannels];
+int32_t output_shift[kMaxChannels];
+alignas(16) uint8_t scratch_buffer[kMaxBufferBytes];
+
+uint32_t seed = 1;
+
+int32_t Random(int32_t min, int32_t max) {
+  seed = seed * 1664525u + 1013904223u;
+  return min + static_cast<int32_t>((seed >> 8) %
+                                    static_cast<uint32_t>(max - min + 1));
+}
+
+float RandomFloat() {
+  return static_cast<float>(Random(-(1 << 20), 1 << 20)) /
+         static_cast<float>(1 << 20);
+}
+
+// Average duration in microseconds of `runs` calls to `kernel`.
+template <typename Kernel>
+int32_t TimeUs(int runs, Kernel kernel) {
+  const int32_t start = tflite::GetCurrentTimeTicks();
+  for (int i = 0; i < runs; ++i) {
+    kernel();
+  }
+  const int32_t ticks = tflite::GetCurrentTimeTicks() - start;
+  const int32_t ticks_per_second = tflite::ticks_per_second();
+  if (ticks_per_second == 0) {
+    return 0;
+  }
+  return static_cast<int32_t>(static_cast<int64_t>(ticks) * 1000000 /
+                              ticks_per_second / runs);
+}
+
+// Filter rows of the im2col buffer for `budget`, as ScratchBudgetFilterRows()
+// in kernels/cmsis_nn/conv.cc.
+template <typename BufferSize>
+int BudgetFilterRows(int32_t budget, int filter_height,
+                     BufferSize buffer_size) {
+  int rows = filter_height;
+  while (rows > 1 && budget > 0 && buffer_size(rows) > budget) {
+    --rows;
+  }
+  return rows;
+}
+
+// SAME padding of a dimension, returns the output size.
+int SamePadding(int size, int filter_size, int stride, int* padding) {
+  const int output_size = (size + stride - 1) / stride;
+  const int total = (output_size - 1) * stride + filter_size - size;
+  *padding = total > 0 ? total / 2 : 0;
+  return output_size;
+}
+
+void PrintRun(const char* name, int32_t budget, const char* kernel, int rows,
+              int32_t bytes, int32_t us, int32_t reference_us,
+              int mismatches) {
+  const int32_t speed_x10 = us > 0 ? reference_us * 10 / us : 0;
+  MicroPrintf("%s budget %d: %s %d rows, %d bytes, %d us (x%d.%d), %d "
+              "mismatches",
+              name, budget, kernel, rows, bytes, us, speed_x10 / 10,
+              speed_x10 % 10, mismatches);
+}
+
+// Returns false if an output differs from arm_convolve_s8().
+bool BenchmarkInt8(const char* name, int height, int width, int input_depth,
+                   int filter_size, int output_depth, int stride, int runs) {
+  int padding_h;
+  int padding_w;
+  const int output_height = SamePadding(height, filter_size, stride,
+                                        &padding_h);
+  const int output_width = SamePadding(width, filter_size, stride,
+                                       &padding_w);
+  const int output_size = output_height * output_width * output_depth;
+  for (int i = 0; i < height * width * input_depth; ++i) {
+    input_data.int8[i] = static_cast<int8_t>(Random(-128, 127));
+  }
+  for (int i = 0; i < output_depth * filter_size * filter_size * input_depth;
+       ++i) {
+    filter_data.int8[i] = static_cast<int8_t>(Random(-127, 127));
+  }
+  for (int i = 0; i < output_depth; ++i) {
+    bias_data.int32[i] = Random(-10000, 10000);
+    output_multiplier[i] = 1073741824 + Random(0, 100000000);
+    output_shift[i] = -Random(8, 10);
+  }
+
+  cmsis_nn_conv_params conv_params;
+  conv_params.input_offset = 5;
+  conv_params.output_offset = -3;
+  conv_params.stride = {stride, stride};
+  conv_params.padding = {padding_w, padding_h};
+  conv_params.dilation = {1, 1};
+  conv_params.activation = {-128, 127};
+  cmsis_nn_per_channel_quant_params quant_params = {output_multiplier,
+                                                    output_shift};
+  const cmsis_nn_dims input_dims = {1, height, width, input_depth};
+  const cmsis_nn_dims filter_dims = {output_depth, filter_size, filter_size,
+                                     input_depth};
+  const cmsis_nn_dims bias_dims = {1, 1, 1, output_depth};
+  const cmsis_nn_dims output_dims = {1, output_height, output_width,
+                                     output_depth};
+  // arm_convolve_s8_get_buffer_size() with ARM_MATH_DSP.
+  const int32_t dsp_buffer_size =
+      2 * input_depth * filter_size * filter_size * sizeof(int16_t);
+  cmsis_nn_context ctx = {scratch_buffer, kMaxBufferBytes};
+
+  auto reference = [&]() {
+    arm_convolve_s8(&ctx, &conv_params, &quant_params, &input_dims,
+                    input_data.int8, &filter_dims, filter_data.int8,
+                    &bias_dims, bias_data.int32, &output_dims,
+                    reference_output.int8);
+  };
+  // The first run warms up the caches.
+  reference();
+  const int32_t reference_us = TimeUs(runs, reference);
+
+  bool ok = true;
+  for (int32_t budget : kBudgets) {
+    if (budget <= 0 || dsp_buffer_size <= budget) {
+      PrintRun(name, budget, "arm_convolve_s8", filter_size, dsp_buffer_size,
+               reference_us, reference_us, 0);
+      continue;
+    }
+    const int rows = BudgetFilterRows(budget, filter_size, [&](int rows) {
+      return arm_convolve_row_tiled_s8_get_buffer_size(&filter_dims, rows);
+    });
+    const int32_t bytes =
+        arm_convolve_row_tiled_s8_get_buffer_size(&filter_dims, rows);
+    if (bytes > kMaxBufferBytes) {
+      MicroPrintf("%s: %d bytes of buffer needed, %d available", name, bytes,
+                  kMaxBufferBytes);
+      return false;
+    }
+    std::memset(output_data.int8, 0, output_size);
+    const int32_t us = TimeUs(runs, [&]() {
+      arm_convolve_row_tiled_s8(&ctx, &conv_params, &quant_params, &input_dims,
+                                input_data.int8, &filter_dims,
+                                filter_data.int8, &bias_dims, bias_data.int32,
+                                &output_dims, output_data.int8, rows);
+    });
+    int mismatches = 0;
+    for (int i = 0; i < output_size; ++i) {
+      if (reference_output.int8[i] != output_data.int8[i]) {
+        ++mismatches;
+      }
+    }
+    PrintRun(name, budget, "row tiled", rows, bytes, us, reference_us,
+             mismatches);
+    ok &= mismatches == 0;
+  }
+  return ok;
+}
+
+// Returns false if an output differs from ConvFloat() on the whole filter.
+bool BenchmarkFloat(const char* name, int height, int width, int input_depth,
+                    int filter_size, int output_depth, int stride, int runs) {
+  int padding_h;
+  int padding_w;
+  const int output_height = SamePadding(height, filter_size, stride,
+                                        &padding_h);
+  const int output_width = SamePadding(width, filter_size, stride,
+                                       &padding_w);
+  const tflite::RuntimeShape input_shape({1, height, width, input_depth});
+  const tflite::RuntimeShape filter_shape(
+      {output_depth, filter_size, filter_size, input_depth});
+  const tflite::RuntimeShape bias_shape({output_depth});
+  const tflite::RuntimeShape output_shape(
+      {1, output_height, output_width, output_depth});
+  for (int i = 0; i < input_shape.FlatSize(); ++i) {
+    input_data.f32[i] = RandomFloat();
+  }
+  for (int i = 0; i < filter_shape.FlatSize(); ++i) {
+    filter_data.f32[i] = RandomFloat();
+  }
+  for (int i = 0; i < output_depth; ++i) {
+    bias_data.f32[i] = RandomFloat();
+  }
+
+  tflite::ConvParams params = {};
+  params.stride_height = stride;
+  params.stride_width = stride;
+  params.dilation_height_factor = 1;
+  params.dilation_width_factor = 1;
+  params.padding_values.height = padding_h;
+  params.padding_values.width = padding_w;
+  params.float_activation_min = std::numeric_limits<float>::lowest();
+  params.float_activation_max = std::numeric_limits<float>::max();
+  auto buffer_size = [&](int rows) {
+    return static_cast<int32_t>(
+        tflite::micro::ConvFloatIm2colBufferSize(filter_shape, rows));
+  };
+  if (buffer_size(filter_size) > kMaxBufferBytes) {
+    MicroPrintf("%s: %d bytes of buffer needed, %d available", name,
+                buffer_size(filter_size), kMaxBufferBytes);
+    return false;
+  }
+  float* im2col = reinterpret_cast<float*>(scratch_buffer);
+
+  auto reference = [&]() {
+    tflite::micro::ConvFloat(params, input_shape, input_data.f32, filter_shape,
+                             filter_data.f32, bias_shape, bias_data.f32,
+                             output_shape, reference_output.f32, filter_size,
+                             im2col);
+  };
+  // The first run warms up the caches.
+  reference();
+  const int32_t reference_us = TimeUs(runs, reference);
+
+  bool ok = true;
+  for (int32_t budget : kBudgets) {
+    const int rows = BudgetFilterRows(budget, filter_size, buffer_size);
+    std::memset(output_data.f32, 0, output_shape.FlatSize() * sizeof(float));
+    const int32_t us = TimeUs(runs, [&]() {
+      tflite::micro::ConvFloat(params, input_shape, input_data.f32,
+                               filter_shape, filter_data.f32, bias_shape,
+                               bias_data.f32, output_shape, output_data.f32,
+                               rows, im2col);
+    });
+    // The sums are in the same order for any number of rows: the outputs
+    // must be bit-identical.
+    const int mismatches =
+        std::memcmp(reference_output.f32, output_data.f32,
+                    output_shape.FlatSize() * sizeof(float)) != 0;
+    PrintRun(name, budget, "ConvFloat", rows, buffer_size(rows), us,
+             reference_us, mismatches);
+    ok &= mismatches == 0;
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  tflite::InitializeTarget();
+
+  bool ok = true;
+  ok &= BenchmarkInt8("int8 32x32x32 7x7->32", 32, 32, 32, 7, 32, 1, 5);
+  ok &= BenchmarkInt8("int8 24x24x128 3x3->64", 24, 24, 128, 3, 64, 1, 5);
+  ok &= BenchmarkInt8("int8 17x15x5 5x5->7 /2", 17, 15, 5, 5, 7, 2, 200);
+  ok &= BenchmarkFloat("f32 32x32x64 5x5->64", 32, 32, 64, 5, 64, 1, 5);
+  ok &= BenchmarkFloat("f32 32x32x32 7x7->32", 32, 32, 32, 7, 32, 1, 5);
+  ok &= BenchmarkFloat("f32 17x15x5 5x5->7 /2", 17, 15, 5, 5, 7, 2, 200);
+
+  MicroPrintf(ok ? "Outputs identical for all the scratch budgets"
+                 : "Outputs differ for a scratch budget");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,283 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Times the Winograd F(2x2, 3x3) convolutions used by the cmsis_nn CONV_2D
+// kernel with TF_LITE_MICRO_CONV_WINOGRAD against the direct convolutions
+// they replace, and checks their accuracy:
+//  - int8: arm_convolve_winograd_s8() against arm_convolve_s8(), the outputs
+//    must be identical;
+//  - float32: ConvFloatWinograd() against ConvFloat(), the largest difference
+//    must stay below kFloatTolerance of the largest output magnitude.
+// Returns 1 if a check fails.
+//
+// On the host (TF_LITE_USE_CTIME):
+//   tensorflow/lite/micro/testing/test_host.sh \
+//       tensorflow/lite/micro/benchmarks/conv_winograd_benchmark.cc
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "arm_nnfunctions.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/micro/kernels/float_kernels.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_time.h"
+#include "tensorflow/lite/micro/system_setup.h"
+
+namespace {
+
+// Tolerance documented next to TF_LITE_MICRO_CONV_WINOGRAD in
+// kernels/cmsis_nn/conv.cc.
+constexpr float kFloatTolerance = 2e-6f;
+
+constexpr int kMaxInputSize = 64 * 1024;
+constexpr int kMaxFilterSize = 160 * 1024;
+constexpr int kMaxOutputSize = 32 * 1024;
+constexpr int kMaxChannels = 128;
+constexpr int kMaxBufferBytes = 512 * 1024;
+constexpr int kMaxTransformedFilterBytes = 16 * 128 * 128 * sizeof(float);
+
+union {
+  int8_t int8[kMaxInputSize];
+  float f32[kMaxInputSize];
+} input_data;
+union {
+  int8_t int8[kMaxFilterSize];
+  float f32[kMaxFilterSize];
+} filter_data;
+union {
+  int8_t int8[kMaxOutputSize];
+  float f32[kMaxOutputSize];
+} reference_output, output_data;
+union {
+  int32_t int32[kMaxChannels];
+  float f32[kMaxChannels];
+} bias_data;
+int32_t output_multiplier[kMaxChannels];
+int32_t output_shift[kMaxChannels];
+// Transformed filter, im2col buffer and Winograd scratch buffer.
+alignas(16) uint8_t transformed_filter[kMaxTransformedFilterBytes];
+alignas(16) uint8_t direct_buffer[kMaxBufferBytes];
+alignas(16) uint8_t winograd_buffer[kMaxBufferBytes];
+
+uint32_t seed = 1;
+
+int32_t Random(int32_t min, int32_t max) {
+  seed = seed * 1664525u + 1013904223u;
+  return min + static_cast<int32_t>((seed >> 8) %
+                                    static_cast<uint32_t>(max - min + 1));
+}
+
+float RandomFloat() {
+  return static_cast<float>(Random(-(1 << 20), 1 << 20)) /
+         static_cast<float>(1 << 20);
+}
+
+// Average duration in microseconds of `runs` calls to `kernel`.
+template <typename Kernel>
+int32_t TimeUs(int runs, Kernel kernel) {
+  const int32_t start = tflite::GetCurrentTimeTicks();
+  for (int i = 0; i < runs; ++i) {
+    kernel();
+  }
+  const int32_t ticks = tflite::GetCurrentTimeTicks() - start;
+  const int32_t ticks_per_second = tflite::ticks_per_second();
+  if (ticks_per_second == 0) {
+    return 0;
+  }
+  return static_cast<int32_t>(static_cast<int64_t>(ticks) * 1000000 /
+                              ticks_per_second / runs);
+}
+
+bool FitsBuffer(const char* name, size_t bytes,
+                int capacity = kMaxBufferBytes) {
+  if (bytes > static_cast<size_t>(capacity)) {
+    MicroPrintf("%s: %d bytes of buffer needed, %d available", name,
+                static_cast<int>(bytes), capacity);
+    return false;
+  }
+  return true;
+}
+
+// Returns false if the outputs differ.
+bool BenchmarkInt8(const char* name, int height, int width, int input_depth,
+                   int output_depth, int padding, int32_t input_offset,
+                   int runs) {
+  const int output_height = height + 2 * padding - 2;
+  const int output_width = width + 2 * padding - 2;
+  const int output_size = output_height * output_width * output_depth;
+  for (int i = 0; i < height * width * input_depth; ++i) {
+    input_data.int8[i] = static_cast<int8_t>(Random(-128, 127));
+  }
+  for (int i = 0; i < output_depth * 9 * input_depth; ++i) {
+    filter_data.int8[i] = static_cast<int8_t>(Random(-127, 127));
+  }
+  for (int i = 0; i < output_depth; ++i) {
+    bias_data.int32[i] = Random(-10000, 10000);
+    output_multiplier[i] = 1073741824 + Random(0, 100000000);
+    output_shift[i] = -Random(8, 10);
+  }
+
+  cmsis_nn_conv_params conv_params;
+  conv_params.input_offset = input_offset;
+  conv_params.output_offset = -3;
+  conv_params.stride = {1, 1};
+  conv_params.padding = {padding, padding};
+  conv_params.dilation = {1, 1};
+  conv_params.activation = {-128, 127};
+  cmsis_nn_per_channel_quant_params quant_params = {output_multiplier,
+                                                    output_shift};
+  const cmsis_nn_dims input_dims = {1, height, width, input_depth};
+  const cmsis_nn_dims filter_dims = {output_depth, 3, 3, input_depth};
+  const cmsis_nn_dims bias_dims = {1, 1, 1, output_depth};
+  const cmsis_nn_dims output_dims = {1, output_height, output_width,
+                                     output_depth};
+  if (!FitsBuffer(name,
+                  arm_convolve_s8_get_buffer_size(&input_dims, &filter_dims)) ||
+      !FitsBuffer(name, arm_convolve_winograd_s8_get_buffer_size(&input_dims)) ||
+      !FitsBuffer(name, arm_convolve_winograd_s8_get_filter_size(&filter_dims),
+                  kMaxTransformedFilterBytes)) {
+    return false;
+  }
+  q15_t* winograd_filter = reinterpret_cast<q15_t*>(transformed_filter);
+  arm_convolve_winograd_s8_transform_filter(&filter_dims, filter_data.int8,
+                                            winograd_filter);
+  cmsis_nn_context direct_ctx = {direct_buffer, kMaxBufferBytes};
+  cmsis_nn_context winograd_ctx = {winograd_buffer, kMaxBufferBytes};
+
+  const int32_t direct_us = TimeUs(runs, [&]() {
+    arm_convolve_s8(&direct_ctx, &conv_params, &quant_params, &input_dims,
+                    input_data.int8, &filter_dims, filter_data.int8,
+                    &bias_dims, bias_data.int32, &output_dims,
+                    reference_output.int8);
+  });
+  const int32_t winograd_us = TimeUs(runs, [&]() {
+    arm_convolve_winograd_s8(&winograd_ctx, &conv_params, &quant_params,
+                             &input_dims, input_data.int8, &filter_dims,
+                             winograd_filter, &bias_dims, bias_data.int32,
+                             &output_dims, output_data.int8);
+  });
+
+  int mismatches = 0;
+  for (int i = 0; i < output_size; ++i) {
+    if (reference_output.int8[i] != output_data.int8[i]) {
+      ++mismatches;
+    }
+  }
+  const int32_t speedup_x10 =
+      winograd_us > 0 ? direct_us * 10 / winograd_us : 0;
+  MicroPrintf("%s: direct %d us, winograd %d us (x%d.%d), %d mismatches",
+              name, direct_us, winograd_us, speedup_x10 / 10,
+              speedup_x10 % 10, mismatches);
+  return mismatches == 0;
+}
+
+// Returns false if the error exceeds kFloatTolerance.
+bool BenchmarkFloat(const char* name, int height, int width, int input_depth,
+                    int output_depth, int padding, int runs) {
+  const int output_height = height + 2 * padding - 2;
+  const int output_width = width + 2 * padding - 2;
+  const tflite::RuntimeShape input_shape({1, height, width, input_depth});
+  const tflite::RuntimeShape filter_shape({output_depth, 3, 3, input_depth});
+  const tflite::RuntimeShape bias_shape({output_depth});
+  const tflite::RuntimeShape output_shape(
+      {1, output_height, output_width, output_depth});
+  for (int i = 0; i < input_shape.FlatSize(); ++i) {
+    input_data.f32[i] = RandomFloat();
+  }
+  for (int i = 0; i < filter_shape.FlatSize(); ++i) {
+    filter_data.f32[i] = RandomFloat();
+  }
+  for (int i = 0; i < output_depth; ++i) {
+    bias_data.f32[i] = RandomFloat();
+  }
+
+  tflite::ConvParams params = {};
+  params.stride_height = 1;
+  params.stride_width = 1;
+  params.dilation_height_factor = 1;
+  params.dilation_width_factor = 1;
+  params.padding_values.height = padding;
+  params.padding_values.width = padding;
+  params.float_activation_min = std::numeric_limits<float>::lowest();
+  params.float_activation_max = std::numeric_limits<float>::max();
+  if (!FitsBuffer(name,
+                  tflite::micro::ConvFloatIm2colBufferSize(filter_shape, 3)) ||
+      !FitsBuffer(name, tflite::micro::ConvFloatWinogradBufferSize(
+                            input_shape, output_shape)) ||
+      !FitsBuffer(name,
+                  tflite::micro::ConvFloatWinogradFilterSize(filter_shape),
+                  kMaxTransformedFilterBytes)) {
+    return false;
+  }
+  float* winograd_filter = reinterpret_cast<float*>(transformed_filter);
+  tflite::micro::ConvFloatWinogradTransformFilter(filter_shape,
+                                                  filter_data.f32,
+                                                  winograd_filter);
+
+  const int32_t direct_us = TimeUs(runs, [&]() {
+    tflite::micro::ConvFloat(params, input_shape, input_data.f32, filter_shape,
+                             filter_data.f32, bias_shape, bias_data.f32,
+                             output_shape, reference_output.f32, 3,
+                             reinterpret_cast<float*>(direct_buffer));
+  });
+  const int32_t winograd_us = TimeUs(runs, [&]() {
+    tflite::micro::ConvFloatWinograd(
+        params, input_shape, input_data.f32, filter_shape, winograd_filter,
+        bias_shape, bias_data.f32, output_shape, output_data.f32,
+        reinterpret_cast<float*>(winograd_buffer));
+  });
+
+  float range = 0.0f;
+  float max_error = 0.0f;
+  for (int i = 0; i < output_shape.FlatSize(); ++i) {
+    range = std::fmax(range, std::fabs(reference_output.f32[i]));
+    max_error = std::fmax(
+        max_error, std::fabs(reference_output.f32[i] - output_data.f32[i]));
+  }
+  const float relative_error = max_error / range;
+  const int32_t speedup_x10 =
+      winograd_us > 0 ? direct_us * 10 / winograd_us : 0;
+  // MicroPrintf() prints floats in binary scientific notation.
+  MicroPrintf("%s: direct %d us, winograd %d us (x%d.%d), error %de-9 of the "
+              "output range",
+              name, direct_us, winograd_us, speedup_x10 / 10,
+              speedup_x10 % 10, static_cast<int>(relative_error * 1e9f));
+  return relative_error < kFloatTolerance;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  tflite::InitializeTarget();
+
+  bool ok = true;
+  ok &= BenchmarkInt8("int8 9x11x5->13", 9, 11, 5, 13, 1, 3, 20);
+  ok &= BenchmarkInt8("int8 32x32x8->16", 32, 32, 8, 16, 1, 128, 10);
+  ok &= BenchmarkInt8("int8 16x16x32->64", 16, 16, 32, 64, 1, 5, 5);
+  ok &= BenchmarkInt8("int8 15x13x64->64 valid", 15, 13, 64, 64, 0, -7, 5);
+  ok &= BenchmarkInt8("int8 8x8x128->128", 8, 8, 128, 128, 1, 0, 5);
+  ok &= BenchmarkInt8("int8 7x7x1024->8", 7, 7, 1024, 8, 1, 128, 5);
+  ok &= BenchmarkFloat("f32 9x11x5->13", 9, 11, 5, 13, 1, 20);
+  ok &= BenchmarkFloat("f32 32x32x8->16", 32, 32, 8, 16, 1, 10);
+  ok &= BenchmarkFloat("f32 16x16x32->64", 16, 16, 32, 64, 1, 5);
+  ok &= BenchmarkFloat("f32 15x13x64->64 valid", 15, 13, 64, 64, 0, 5);
+  ok &= BenchmarkFloat("f32 8x8x128->128", 8, 8, 128, 128, 1, 5);
+
+  MicroPrintf(ok ? "Winograd outputs within tolerance"
+                 : "Winograd outputs out of tolerance");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Times the float32 kernels of micro/kernels/float_kernels.h against the
+// reference kernels they replace in the cmsis_nn CONV_2D, DEPTHWISE_CONV_2D
+// and FULLY_CONNECTED kernels, and checks that both produce the same outputs.
+// Returns 1 if an output differs.
+//
+// On the host (TF_LITE_USE_CTIME):
+//   tensorflow/lite/micro/testing/test_host.sh \
+//       tensorflow/lite/micro/benchmarks/float_kernels_benchmark.cc
+
+#include <cstdint>
+#include <limits>
+
+#include "tensorflow/lite/kernels/internal/reference/conv.h"
+#include "tensorflow/lite/kernels/internal/reference/depthwiseconv_float.h"
+#include "tensorflow/lite/kernels/internal/reference/fully_connected.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/micro/kernels/float_kernels.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_time.h"
+#include "tensorflow/lite/micro/system_setup.h"
+
+namespace {
+
+constexpr int kMaxInputSize = 32 * 32 * 32;
+constexpr int kMaxFilterSize = 128 * 3 * 3 * 128;
+constexpr int kMaxOutputSize = 32 * 32 * 32;
+constexpr int kMaxBiasSize = 256;
+constexpr int kMaxIm2colSize = 3 * 3 * 128 * tflite::micro::kFloatGemmTileRows;
+
+float input_data[kMaxInputSize];
+float filter_data[kMaxFilterSize];
+float bias_data[kMaxBiasSize];
+float reference_output[kMaxOutputSize];
+float output_data[kMaxOutputSize];
+float im2col_data[kMaxIm2colSize];
+
+uint32_t seed = 1;
+
+void FillRandom(float* data, int size) {
+  for (int i = 0; i < size; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    data[i] = static_cast<float>(static_cast<int32_t>(seed >> 9) - (1 << 22)) /
+              static_cast<float>(1 << 22);
+  }
+}
+
+// Returns the number of outputs that differ. -0.0f and 0.0f are equal: the
+// only difference allowed, on the padded taps.
+int CountMismatches(int size) {
+  int mismatches = 0;
+  for (int i = 0; i < size; ++i) {
+    if (reference_output[i] != output_data[i]) {
+      ++mismatches;
+    }
+  }
+  return mismatches;
+}
+
+// Average duration in microseconds of `runs` calls to `kernel`.
+template <typename Kernel>
+int32_t TimeUs(int runs, Kernel kernel) {
+  const int32_t start = tflite::GetCurrentTimeTicks();
+  for (int i = 0; i < runs; ++i) {
+    kernel();
+  }
+  const int32_t ticks = tflite::GetCurrentTimeTicks() - start;
+  const int32_t ticks_per_second = tflite::ticks_per_second();
+  if (ticks_per_second == 0) {
+    return 0;
+  }
+  return static_cast<int32_t>(static_cast<int64_t>(ticks) * 1000000 /
+                              ticks_per_second / runs);
+}
+
+void Report(const char* name, int32_t reference_us, int32_t optimized_us,
+            int mismatches) {
+  // MicroPrintf() prints floats in binary scientific notation.
+  const int32_t speedup_x10 =
+      optimized_us > 0 ? reference_us * 10 / optimized_us : 0;
+  MicroPrintf("%s: reference %d us, optimized %d us (x%d.%d), %d mismatches",
+              name, reference_us, optimized_us, speedup_x10 / 10,
+              speedup_x10 % 10, mismatches);
+}
+
+int BenchmarkConv(const char* name, int height, int width, int input_depth,
+                  int output_depth, int filter_size, int stride, int padding,
+                  int runs) {
+  const int output_height = (height + 2 * padding - filter_size) / stride + 1;
+  const int output_width = (width + 2 * padding - filter_size) / stride + 1;
+  const tflite::RuntimeShape input_shape({1, height, width, input_depth});
+  const tflite::RuntimeShape filter_shape(
+      {output_depth, filter_size, filter_size, input_depth});
+  const tflite::RuntimeShape bias_shape({output_depth});
+  const tflite::RuntimeShape output_shape(
+      {1, output_height, output_width, output_depth});
+  FillRandom(input_data, input_shape.FlatSize());
+  FillRandom(filter_data, filter_shape.FlatSize());
+  FillRandom(bias_data, output_depth);
+
+  tflite::ConvParams params = {};
+  params.stride_height = stride;
+  params.stride_width = stride;
+  params.dilation_height_factor = 1;
+  params.dilation_width_factor = 1;
+  params.padding_values.height = padding;
+  params.padding_values.width = padding;
+  params.float_activation_min = 0.0f;
+  params.float_activation_max = std::numeric_limits<float>::max();
+
+  const int32_t reference_us = TimeUs(runs, [&]() {
+    tflite::reference_ops::Conv(params, input_shape, input_data, filter_shape,
+                                filter_data, bias_shape, bias_data,
+                                output_shape, reference_output,
+                                tflite::RuntimeShape(), nullptr);
+  });
+  const int32_t optimized_us = TimeUs(runs, [&]() {
+    tflite::micro::ConvFloat(params, input_shape, input_data, filter_shape,
+                             filter_data, bias_shape, bias_data, output_shape,
+                             output_data, filter_size, im2col_data);
+  });
+  const int mismatches = CountMismatches(output_shape.FlatSize());
+  Report(name, reference_us, optimized_us, mismatches);
+  return mismatches;
+}
+
+int BenchmarkDepthwiseConv(const char* name, int height, int width,
+                           int input_depth, int depth_multiplier,
+                           int filter_size, int stride, int padding,
+                           bool with_bias, int runs) {
+  const int output_height = (height + 2 * padding - filter_size) / stride + 1;
+  const int output_width = (width + 2 * padding - filter_size) / stride + 1;
+  const int output_depth = input_depth * depth_multiplier;
+  const tflite::RuntimeShape input_shape({1, height, width, input_depth});
+  const tflite::RuntimeShape filter_shape(
+      {1, filter_size, filter_size, output_depth});
+  // The reference kernel checks the bias shape even without bias.
+  const tflite::RuntimeShape reference_bias_shape({output_depth});
+  const tflite::RuntimeShape bias_shape =
+      with_bias ? reference_bias_shape : tflite::RuntimeShape();
+  const float* bias = with_bias ? bias_data : nullptr;
+  const tflite::RuntimeShape output_shape(
+      {1, output_height, output_width, output_depth});
+  FillRandom(input_data, input_shape.FlatSize());
+  FillRandom(filter_data, filter_shape.FlatSize());
+  FillRandom(bias_data, output_depth);
+
+  tflite::DepthwiseParams params = {};
+  params.stride_height = stride;
+  params.stride_width = stride;
+  params.dilation_height_factor = 1;
+  params.dilation_width_factor = 1;
+  params.padding_values.height = padding;
+  params.padding_values.width = padding;
+  params.depth_multiplier = depth_multiplier;
+  params.float_activation_min = std::numeric_limits<float>::lowest();
+  params.float_activation_max = std::numeric_limits<float>::max();
+
+  const int32_t reference_us = TimeUs(runs, [&]() {
+    tflite::reference_ops::DepthwiseConv(
+        params, input_shape, input_data, filter_shape, filter_data,
+        reference_bias_shape, bias, output_shape, reference_output);
+  });
+  const int32_t optimized_us = TimeUs(runs, [&]() {
+    tflite::micro::DepthwiseConvFloat(params, input_shape, input_data,
+                                      filter_shape, filter_data, bias_shape,
+                                      bias, output_shape, output_data);
+  });
+  const int mismatches = CountMismatches(output_shape.FlatSize());
+  Report(name, reference_us, optimized_us, mismatches);
+  return mismatches;
+}
+
+int BenchmarkFullyConnected(const char* name, int batches, int input_depth,
+                            int output_depth, int runs) {
+  const tflite::RuntimeShape input_shape({batches, input_depth});
+  const tflite::RuntimeShape weights_shape({output_depth, input_depth});
+  const tflite::RuntimeShape bias_shape({output_depth});
+  const tflite::RuntimeShape output_shape({batches, output_depth});
+  FillRandom(input_data, input_shape.FlatSize());
+  FillRandom(filter_data, weights_shape.FlatSize());
+  FillRandom(bias_data, output_depth);
+
+  tflite::FullyConnectedParams params = {};
+  params.float_activation_min = std::numeric_limits<float>::lowest();
+  params.float_activation_max = std::numeric_limits<float>::max();
+
+  const int32_t reference_us = TimeUs(runs, [&]() {
+    tflite::reference_ops::FullyConnected(
+        params, input_shape, input_data, weights_shape, filter_data,
+        bias_shape, bias_data, output_shape, reference_output);
+  });
+  const int32_t optimized_us = TimeUs(runs, [&]() {
+    tflite::micro::FullyConnectedFloat(params, input_shape, input_data,
+                                       weights_shape, filter_data, bias_shape,
+                                       bias_data, output_shape, output_data);
+  });
+  const int mismatches = CountMismatches(output_shape.FlatSize());
+  Report(name, reference_us, optimized_us, mismatches);
+  return mismatches;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  tflite::InitializeTarget();
+
+  int mismatches = 0;
+  mismatches += BenchmarkConv("conv 49x10x1->8 3x3", 49, 10, 1, 8, 3, 1, 1, 50);
+  mismatches +=
+      BenchmarkConv("conv 32x32x3->16 3x3/s2", 32, 32, 3, 16, 3, 2, 1, 50);
+  mismatches +=
+      BenchmarkConv("conv 16x16x32->64 3x3", 16, 16, 32, 64, 3, 1, 1, 10);
+  mismatches +=
+      BenchmarkConv("conv 16x16x64->64 1x1", 16, 16, 64, 64, 1, 1, 0, 10);
+  mismatches +=
+      BenchmarkConv("conv 8x8x128->127 3x3", 8, 8, 128, 127, 3, 1, 0, 10);
+  mismatches += BenchmarkDepthwiseConv("dw 32x32x32 3x3", 32, 32, 32, 1, 3, 1,
+                                       1, true, 20);
+  mismatches += BenchmarkDepthwiseConv("dw 16x16x64 3x3/s2", 16, 16, 64, 1, 3,
+                                       2, 1, true, 50);
+  mismatches += BenchmarkDepthwiseConv("dw 16x16x8 m4 3x3", 16, 16, 8, 4, 3, 1,
+                                       1, true, 50);
+  mismatches += BenchmarkDepthwiseConv("dw 16x16x32 3x3 no bias", 16, 16, 32,
+                                       1, 3, 1, 1, false, 50);
+  mismatches += BenchmarkFullyConnected("fc 1x1024->10", 1, 1024, 10, 500);
+  mismatches += BenchmarkFullyConnected("fc 1x256->255", 1, 256, 255, 200);
+  mismatches += BenchmarkFullyConnected("fc 4x400->128", 4, 400, 128, 100);
+
+  MicroPrintf(mismatches == 0 ? "All outputs match the reference kernels"
+                              : "Outputs differ from the reference kernels");
+  return mismatches == 0 ? 0 : 1;
+}
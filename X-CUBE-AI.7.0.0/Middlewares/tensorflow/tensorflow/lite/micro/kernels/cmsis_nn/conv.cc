@@ -21,23 +21,121 @@ limitations under the License.
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/internal/common.h"
 #include "tensorflow/lite/kernels/internal/quantization_util.h"
-#include "tensorflow/lite/kernels/internal/reference/conv.h"
 #include "tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/kernels/padding.h"
+#include "tensorflow/lite/micro/kernels/float_kernels.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 
 namespace tflite {
 namespace {
 
+// 3x3 stride 1 convolutions can be computed with the Winograd F(2x2, 3x3)
+// transform, which needs 2.25x fewer multiplications. The transformed filter
+// is kept in the arena and takes 16/9 of the filter size (32/9 for int8 as it
+// is stored as int16), so this is opt-in.
+// The int8 outputs are identical to the ones of arm_convolve_s8(). The float
+// outputs differ from the ones of ConvFloat() by less than 2e-6 of the largest
+// output magnitude with up to 128 input channels, the error growing with the
+// input depth. benchmarks/conv_winograd_benchmark.cc checks both.
+#if defined(TF_LITE_MICRO_CONV_WINOGRAD)
+constexpr bool kWinogradEnabled = true;
+#else
+constexpr bool kWinogradEnabled = false;
+#endif
+
+// Limit of arm_convolve_winograd_s8() keeping its accumulators in range.
+constexpr int kWinogradMaxInputDepthInt8 = 1024;
+
+// Budget in bytes of the scratch buffer of a convolution (0: no limit). The
+// im2col buffers hold the receptive fields of a few output pixels, so they
+// grow with the filter size and the input depth. Above the budget the
+// receptive fields are expanded a few filter rows at a time (as many as the
+// budget allows, at least one) and the partial sums are kept in the buffer,
+// which is slower. The Winograd kernels are not used above the budget.
+#if defined(TF_LITE_MICRO_CONV_SCRATCH_BUDGET)
+constexpr int32_t kScratchBudget = TF_LITE_MICRO_CONV_SCRATCH_BUDGET;
+#else
+constexpr int32_t kScratchBudget = 0;
+#endif
+
+// Largest size in bytes of the packed copy of the filter of an int8
+// convolution (0: no packing). The filters up to this size are widened to
+// int16 and interleaved by pairs of output channels at Prepare, in the arena,
+// so that the kernel reads them linearly instead of expanding them on each
+// invoke. The copy takes twice the size of the filter: the limit sets which
+// layers trade arena memory for speed.
+#if defined(TF_LITE_MICRO_PACKED_WEIGHTS_MAX_SIZE)
+constexpr int32_t kPackedFilterMaxSize = TF_LITE_MICRO_PACKED_WEIGHTS_MAX_SIZE;
+#else
+constexpr int32_t kPackedFilterMaxSize = 0;
+#endif
+
+// Largest size in bytes of the bias of a pointwise int8 convolution with the
+// input zero point folded in at Prepare (0: no folding). The folded bias is an
+// int32 per output channel in the arena: it saves the sums of the filter of
+// each invoke.
+#if defined(TF_LITE_MICRO_FOLDED_BIAS_MAX_SIZE)
+constexpr int32_t kFoldedBiasMaxSize = TF_LITE_MICRO_FOLDED_BIAS_MAX_SIZE;
+#else
+constexpr int32_t kFoldedBiasMaxSize = 0;
+#endif
+
 struct OpData {
   OpDataConv reference_op_data;
 
   // Index to buffer for optimizations if applicable.
   int buffer_idx;
+
+  // Filter transformed to the Winograd domain at Prepare, nullptr if the
+  // im2col kernels are used.
+  void* winograd_filter;
+
+  // Number of filter rows of the im2col buffer. For int8, 0 runs the
+  // arm_convolve_wrapper_s8() kernels (within the scratch budget).
+  int filter_rows;
+
+  // Filter packed by arm_convolve_packed_s8_pack_filter() at Prepare, nullptr
+  // if the filter is read from the model.
+  void* packed_filter;
+
+  // Bias of arm_convolve_1x1_s8_fast() with the contribution of the input
+  // zero point folded in at Prepare, nullptr if the kernel sums the filter on
+  // each invoke.
+  int32_t* folded_bias;
 };
 
+bool FitsScratchBudget(int32_t size) {
+  return kScratchBudget <= 0 || size <= kScratchBudget;
+}
+
+// Returns the largest number of filter rows for which `buffer_size(rows)`
+// fits in the scratch budget, 1 if none does.
+template <typename BufferSize>
+int ScratchBudgetFilterRows(int filter_height, BufferSize buffer_size) {
+  int rows = filter_height;
+  while (rows > 1 && !FitsScratchBudget(buffer_size(rows))) {
+    --rows;
+  }
+  return rows;
+}
+
+bool CanUseWinograd(const TfLiteConvParams& params, const TfLiteTensor* input,
+                    const TfLiteTensor* filter) {
+  if (!kWinogradEnabled || !IsConstantTensor(filter) ||
+      filter->dims->data[1] != 3 || filter->dims->data[2] != 3 ||
+      params.stride_height != 1 || params.stride_width != 1 ||
+      params.dilation_height_factor != 1 ||
+      params.dilation_width_factor != 1) {
+    return false;
+  }
+  if (input->type == kTfLiteInt8) {
+    return input->dims->data[3] <= kWinogradMaxInputDepthInt8;
+  }
+  return input->type == kTfLiteFloat32;
+}
+
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
   return context->AllocatePersistentBuffer(context, sizeof(OpData));
@@ -101,7 +199,42 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
       filter_dims.h, output_dims.w, output_dims.h, input->type,
       &data->reference_op_data));
 
-  if (input->type == kTfLiteInt8) {
+  data->winograd_filter = nullptr;
+  data->filter_rows = 0;
+  data->packed_filter = nullptr;
+  data->folded_bias = nullptr;
+  bool use_winograd = CanUseWinograd(params, input, filter);
+  if (use_winograd) {
+    use_winograd = FitsScratchBudget(
+        input->type == kTfLiteInt8
+            ? arm_convolve_winograd_s8_get_buffer_size(&input_dims)
+            : static_cast<int32_t>(tflite::micro::ConvFloatWinogradBufferSize(
+                  input_shape, output_shape)));
+  }
+  if (use_winograd) {
+    if (input->type == kTfLiteInt8) {
+      data->winograd_filter = context->AllocatePersistentBuffer(
+          context, arm_convolve_winograd_s8_get_filter_size(&filter_dims));
+      TF_LITE_ENSURE(context, data->winograd_filter != nullptr);
+      TF_LITE_ENSURE_EQ(context,
+                        arm_convolve_winograd_s8_transform_filter(
+                            &filter_dims, GetTensorData<int8_t>(filter),
+                            static_cast<q15_t*>(data->winograd_filter)),
+                        ARM_MATH_SUCCESS);
+      buf_size = arm_convolve_winograd_s8_get_buffer_size(&input_dims);
+    } else {
+      data->winograd_filter = context->AllocatePersistentBuffer(
+          context, tflite::micro::ConvFloatWinogradFilterSize(
+                       GetTensorShape(filter)));
+      TF_LITE_ENSURE(context, data->winograd_filter != nullptr);
+      tflite::micro::ConvFloatWinogradTransformFilter(
+          GetTensorShape(filter), GetTensorData<float>(filter),
+          static_cast<float*>(data->winograd_filter));
+      buf_size = static_cast<int32_t>(
+          tflite::micro::ConvFloatWinogradBufferSize(input_shape,
+                                                     output_shape));
+    }
+  } else if (input->type == kTfLiteInt8) {
     // Initialize cmsis_nn convolution parameters
     cmsis_nn_conv_params conv_params;
     conv_params.input_offset = -input->params.zero_point;
@@ -117,6 +250,65 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
     buf_size = arm_convolve_wrapper_s8_get_buffer_size(
         &conv_params, &input_dims, &filter_dims, &output_dims);
+    // Dilated convolutions run the reference kernel.
+    if (!FitsScratchBudget(buf_size) && conv_params.dilation.h == 1 &&
+        conv_params.dilation.w == 1) {
+      data->filter_rows =
+          ScratchBudgetFilterRows(filter_dims.h, [&](int rows) {
+            return arm_convolve_row_tiled_s8_get_buffer_size(&filter_dims,
+                                                             rows);
+          });
+      buf_size = arm_convolve_row_tiled_s8_get_buffer_size(&filter_dims,
+                                                           data->filter_rows);
+    } else if (kPackedFilterMaxSize > 0 && IsConstantTensor(filter) &&
+               conv_params.dilation.h == 1 && conv_params.dilation.w == 1 &&
+               arm_convolve_packed_s8_get_filter_size(&filter_dims) <=
+                   kPackedFilterMaxSize &&
+               FitsScratchBudget(arm_convolve_packed_s8_get_buffer_size(
+                   &input_dims, &filter_dims))) {
+      data->packed_filter = context->AllocatePersistentBuffer(
+          context, arm_convolve_packed_s8_get_filter_size(&filter_dims));
+      TF_LITE_ENSURE(context, data->packed_filter != nullptr);
+      TF_LITE_ENSURE_EQ(context,
+                        arm_convolve_packed_s8_pack_filter(
+                            &filter_dims, GetTensorData<int8_t>(filter),
+                            static_cast<q15_t*>(data->packed_filter)),
+                        ARM_MATH_SUCCESS);
+      buf_size =
+          arm_convolve_packed_s8_get_buffer_size(&input_dims, &filter_dims);
+    } else if (kFoldedBiasMaxSize > 0 && filter_dims.h == 1 &&
+               filter_dims.w == 1 && input_dims.c % 4 == 0 &&
+               conv_params.stride.h == 1 && conv_params.stride.w == 1 &&
+               conv_params.padding.h == 0 && conv_params.padding.w == 0 &&
+               conv_params.dilation.h == 1 && conv_params.dilation.w == 1 &&
+               static_cast<int32_t>(filter_dims.n * sizeof(int32_t)) <=
+                   kFoldedBiasMaxSize &&
+               IsConstantTensor(filter)) {
+      // Pointwise convolution run by arm_convolve_1x1_s8_fast(): the input
+      // offset times the sum of the filter of an output channel is added once
+      // to the bias.
+      const TfLiteTensor* bias =
+          GetOptionalInputTensor(context, node, kConvBiasTensor);
+      if (bias == nullptr || IsConstantTensor(bias)) {
+        data->folded_bias = static_cast<int32_t*>(
+            context->AllocatePersistentBuffer(
+                context, filter_dims.n * sizeof(int32_t)));
+        TF_LITE_ENSURE(context, data->folded_bias != nullptr);
+        arm_convolve_1x1_s8_fast_fold_bias(
+            &conv_params, &filter_dims, GetTensorData<int8_t>(filter),
+            bias != nullptr ? GetTensorData<int32_t>(bias) : nullptr,
+            data->folded_bias);
+      }
+    }
+  } else if (input->type == kTfLiteFloat32) {
+    const RuntimeShape filter_shape = GetTensorShape(filter);
+    data->filter_rows =
+        ScratchBudgetFilterRows(filter_dims.h, [&](int rows) {
+          return static_cast<int32_t>(
+              tflite::micro::ConvFloatIm2colBufferSize(filter_shape, rows));
+        });
+    buf_size = static_cast<int32_t>(tflite::micro::ConvFloatIm2colBufferSize(
+        filter_shape, data->filter_rows));
   }
 
   if (buf_size > 0) {
@@ -133,6 +325,9 @@ TfLiteStatus EvalQuantizedPerChannel(
     const OpData& data, const TfLiteEvalTensor* input,
     const TfLiteEvalTensor* filter, const TfLiteEvalTensor* bias,
     TfLiteEvalTensor* output, TfLiteEvalTensor* im2col) {
+  // The bias is optional, e.g. for a CONV_2D that absorbed a PAD.
+  const int32_t* bias_data =
+      bias != nullptr ? tflite::micro::GetTensorData<int32_t>(bias) : nullptr;
   cmsis_nn_conv_params conv_params;
   conv_params.dilation.h = params.dilation_height_factor;
   conv_params.dilation.w = params.dilation_width_factor;
@@ -170,7 +365,7 @@ TfLiteStatus EvalQuantizedPerChannel(
     const int batch_size = MatchingDim(input_shape, 0, output_shape, 0);
     const int input_depth = MatchingDim(input_shape, 3, filter_shape, 3);
     const int output_depth = MatchingDim(filter_shape, 0, output_shape, 3);
-    if (tflite::micro::GetTensorData<int8_t>(bias)) {
+    if (bias_data != nullptr) {
       TFLITE_DCHECK_EQ(bias_shape.FlatSize(), output_depth);
     }
 
@@ -215,6 +410,55 @@ TfLiteStatus EvalQuantizedPerChannel(
       // arm_convolve_wrapper_s8_get_buffer_size
     }
 
+    if (data.winograd_filter != nullptr) {
+      TFLITE_DCHECK_EQ(
+          arm_convolve_winograd_s8(
+              &ctx, &conv_params, &quant_params, &input_dims,
+              tflite::micro::GetTensorData<int8_t>(input), &filter_dims,
+              static_cast<const q15_t*>(data.winograd_filter), &bias_dims,
+              bias_data, &output_dims,
+              tflite::micro::GetTensorData<int8_t>(output)),
+          ARM_MATH_SUCCESS);
+      return kTfLiteOk;
+    }
+
+    if (data.packed_filter != nullptr) {
+      TFLITE_DCHECK_EQ(
+          arm_convolve_packed_s8(
+              &ctx, &conv_params, &quant_params, &input_dims,
+              tflite::micro::GetTensorData<int8_t>(input), &filter_dims,
+              static_cast<const q15_t*>(data.packed_filter), &bias_dims,
+              bias_data, &output_dims,
+              tflite::micro::GetTensorData<int8_t>(output)),
+          ARM_MATH_SUCCESS);
+      return kTfLiteOk;
+    }
+
+    if (data.folded_bias != nullptr) {
+      conv_params.input_offset = 0;
+      TFLITE_DCHECK_EQ(
+          arm_convolve_1x1_s8_fast(
+              &ctx, &conv_params, &quant_params, &input_dims,
+              tflite::micro::GetTensorData<int8_t>(input), &filter_dims,
+              tflite::micro::GetTensorData<int8_t>(filter), &bias_dims,
+              data.folded_bias, &output_dims,
+              tflite::micro::GetTensorData<int8_t>(output)),
+          ARM_MATH_SUCCESS);
+      return kTfLiteOk;
+    }
+
+    if (data.filter_rows > 0) {
+      TFLITE_DCHECK_EQ(
+          arm_convolve_row_tiled_s8(
+              &ctx, &conv_params, &quant_params, &input_dims,
+              tflite::micro::GetTensorData<int8_t>(input), &filter_dims,
+              tflite::micro::GetTensorData<int8_t>(filter), &bias_dims,
+              bias_data, &output_dims,
+              tflite::micro::GetTensorData<int8_t>(output), data.filter_rows),
+          ARM_MATH_SUCCESS);
+      return kTfLiteOk;
+    }
+
     // arm_convolve_wrapper_s8 dispatches the optimized kernel accordingly with
     // the parameters passed
     TFLITE_DCHECK_EQ(
@@ -222,7 +466,7 @@ TfLiteStatus EvalQuantizedPerChannel(
             &ctx, &conv_params, &quant_params, &input_dims,
             tflite::micro::GetTensorData<int8_t>(input), &filter_dims,
             tflite::micro::GetTensorData<int8_t>(filter), &bias_dims,
-            tflite::micro::GetTensorData<int32_t>(bias), &output_dims,
+            bias_data, &output_dims,
             tflite::micro::GetTensorData<int8_t>(output)),
         ARM_MATH_SUCCESS);
   } else {
@@ -234,8 +478,7 @@ TfLiteStatus EvalQuantizedPerChannel(
         tflite::micro::GetTensorData<int8_t>(input),
         tflite::micro::GetTensorShape(filter),
         tflite::micro::GetTensorData<int8_t>(filter),
-        tflite::micro::GetTensorShape(bias),
-        tflite::micro::GetTensorData<int32_t>(bias),
+        tflite::micro::GetTensorShape(bias), bias_data,
         tflite::micro::GetTensorShape(output),
         tflite::micro::GetTensorData<int8_t>(output));
   }
@@ -248,7 +491,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteEvalTensor* filter =
       tflite::micro::GetEvalInput(context, node, kConvWeightsTensor);
   const TfLiteEvalTensor* bias =
-      (NumInputs(node) == 3)
+      (NumInputs(node) > kConvBiasTensor &&
+       node->inputs->data[kConvBiasTensor] != kTfLiteOptionalTensor)
           ? tflite::micro::GetEvalInput(context, node, kConvBiasTensor)
           : nullptr;
   TfLiteEvalTensor* output =
@@ -266,17 +510,36 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 
   switch (input->type) {  // Already know in/out types are same.
     case kTfLiteFloat32: {
-      tflite::reference_ops::Conv(
+      TFLITE_DCHECK(data.buffer_idx > -1);
+      const float* bias_data =
+          bias != nullptr ? tflite::micro::GetTensorData<float>(bias) : nullptr;
+      if (data.winograd_filter != nullptr) {
+        tflite::micro::ConvFloatWinograd(
+            ConvParamsFloat(params, data.reference_op_data),
+            tflite::micro::GetTensorShape(input),
+            tflite::micro::GetTensorData<float>(input),
+            tflite::micro::GetTensorShape(filter),
+            static_cast<const float*>(data.winograd_filter),
+            tflite::micro::GetTensorShape(bias),
+            bias_data,
+            tflite::micro::GetTensorShape(output),
+            tflite::micro::GetTensorData<float>(output),
+            static_cast<float*>(
+                context->GetScratchBuffer(context, data.buffer_idx)));
+        break;
+      }
+      tflite::micro::ConvFloat(
           ConvParamsFloat(params, data.reference_op_data),
           tflite::micro::GetTensorShape(input),
           tflite::micro::GetTensorData<float>(input),
           tflite::micro::GetTensorShape(filter),
           tflite::micro::GetTensorData<float>(filter),
           tflite::micro::GetTensorShape(bias),
-          tflite::micro::GetTensorData<float>(bias),
+          bias_data,
           tflite::micro::GetTensorShape(output),
-          tflite::micro::GetTensorData<float>(output),
-          tflite::micro::GetTensorShape(nullptr), nullptr);
+          tflite::micro::GetTensorData<float>(output), data.filter_rows,
+          static_cast<float*>(
+              context->GetScratchBuffer(context, data.buffer_idx)));
       break;
     }
     case kTfLiteInt8:
@@ -24,16 +24,47 @@ limitations under the License.
 #include "tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/float_kernels.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 
 namespace tflite {
 namespace {
 
+// Largest size in bytes of the packed copy of the weights of an int8 layer
+// (0: no packing). The weights up to this size are widened to int16 and
+// interleaved by pairs of rows at Prepare, in the arena, so that the kernel
+// reads them linearly instead of expanding them on each invoke. The copy takes
+// twice the size of the weights: the limit sets which layers trade arena
+// memory for speed.
+#if defined(TF_LITE_MICRO_PACKED_WEIGHTS_MAX_SIZE)
+constexpr int32_t kPackedWeightsMaxSize = TF_LITE_MICRO_PACKED_WEIGHTS_MAX_SIZE;
+#else
+constexpr int32_t kPackedWeightsMaxSize = 0;
+#endif
+
+// Largest size in bytes of the bias with the input zero point folded in at
+// Prepare (0: no folding). The folded bias is an int32 per output channel in
+// the arena: it saves the offset additions of the inner loop of each invoke.
+#if defined(TF_LITE_MICRO_FOLDED_BIAS_MAX_SIZE)
+constexpr int32_t kFoldedBiasMaxSize = TF_LITE_MICRO_FOLDED_BIAS_MAX_SIZE;
+#else
+constexpr int32_t kFoldedBiasMaxSize = 0;
+#endif
+
 struct OpData {
   OpDataFullyConnected reference_op_data;
 
   // Index to buffer for optimizations if applicable.
   int buffer_idx;
+
+  // Weights packed by arm_fully_connected_packed_s8_pack_weights() at
+  // Prepare, nullptr if the weights are read from the model.
+  void* packed_weights;
+
+  // Bias with the contribution of the input zero point folded in by
+  // arm_fully_connected_folded_s8_fold_bias() at Prepare, nullptr if the
+  // kernel applies the input offset to each input value.
+  int32_t* folded_bias;
 };
 
 // TODO(b/169801227): This global struct is needed for the linker to drop unused
@@ -71,6 +102,8 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
   // Set buffer index to a reset value
   data->buffer_idx = -1;
+  data->packed_weights = nullptr;
+  data->folded_bias = nullptr;
   TF_LITE_ENSURE_STATUS(CalculateOpDataFullyConnected(
       context, params->activation, input->type, input, filter, bias, output,
       &(data->reference_op_data)));
@@ -87,8 +120,56 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     filter_dims.w = 1;
     filter_dims.c = output_shape.Dims(1);
 
-    const int32_t buf_size =
-        arm_fully_connected_s8_get_buffer_size(&filter_dims);
+    int32_t buf_size = arm_fully_connected_s8_get_buffer_size(&filter_dims);
+
+    const int32_t packed_size =
+        arm_fully_connected_packed_s8_get_weights_size(&filter_dims);
+    if (kPackedWeightsMaxSize > 0 && IsConstantTensor(filter) &&
+        packed_size <= kPackedWeightsMaxSize) {
+      cmsis_nn_dims input_dims;
+      input_dims.n = output_shape.Dims(0);
+      input_dims.h = 1;
+      input_dims.w = 1;
+      input_dims.c = filter_dims.n;
+
+      cmsis_nn_fc_params fc_params;
+      fc_params.filter_offset = -data->reference_op_data.filter_zero_point;
+
+      data->packed_weights =
+          context->AllocatePersistentBuffer(context, packed_size);
+      TF_LITE_ENSURE(context, data->packed_weights != nullptr);
+      TF_LITE_ENSURE_EQ(context,
+                        arm_fully_connected_packed_s8_pack_weights(
+                            &fc_params, &filter_dims,
+                            GetTensorData<int8_t>(filter),
+                            static_cast<q15_t*>(data->packed_weights)),
+                        ARM_MATH_SUCCESS);
+      buf_size = arm_fully_connected_packed_s8_get_buffer_size(&input_dims,
+                                                               &filter_dims);
+    } else if (kFoldedBiasMaxSize > 0 && IsConstantTensor(filter) &&
+               (bias == nullptr || IsConstantTensor(bias)) &&
+               data->reference_op_data.filter_zero_point == 0 &&
+               static_cast<int32_t>(filter_dims.c * sizeof(int32_t)) <=
+                   kFoldedBiasMaxSize) {
+      // The input offset times the sum of the weights of an output channel is
+      // constant: it is added once to the bias instead of adding the offset
+      // to each input value in the inner loop.
+      cmsis_nn_fc_params fc_params;
+      fc_params.input_offset = -data->reference_op_data.input_zero_point;
+      fc_params.filter_offset = 0;
+
+      data->folded_bias = static_cast<int32_t*>(
+          context->AllocatePersistentBuffer(context,
+                                            filter_dims.c * sizeof(int32_t)));
+      TF_LITE_ENSURE(context, data->folded_bias != nullptr);
+      TF_LITE_ENSURE_EQ(
+          context,
+          arm_fully_connected_folded_s8_fold_bias(
+              &fc_params, &filter_dims, GetTensorData<int8_t>(filter),
+              bias != nullptr ? GetTensorData<int32_t>(bias) : nullptr,
+              data->folded_bias),
+          ARM_MATH_SUCCESS);
+    }
 
     if (buf_size > 0) {
       TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
@@ -158,6 +239,32 @@ TfLiteStatus EvalQuantizedInt8(TfLiteContext* context, TfLiteNode* node,
     ctx.buf = context->GetScratchBuffer(context, data.buffer_idx);
   }
 
+  if (data.packed_weights != nullptr) {
+    TF_LITE_ENSURE_EQ(
+        context,
+        arm_fully_connected_packed_s8(
+            &ctx, &fc_params, &quant_params, &input_dims,
+            tflite::micro::GetTensorData<int8_t>(input), &filter_dims,
+            static_cast<const q15_t*>(data.packed_weights), &bias_dims,
+            tflite::micro::GetTensorData<int32_t>(bias), &output_dims,
+            tflite::micro::GetTensorData<int8_t>(output)),
+        ARM_MATH_SUCCESS);
+    return kTfLiteOk;
+  }
+
+  if (data.folded_bias != nullptr) {
+    TF_LITE_ENSURE_EQ(
+        context,
+        arm_fully_connected_folded_s8(
+            &ctx, &fc_params, &quant_params, &input_dims,
+            tflite::micro::GetTensorData<int8_t>(input), &filter_dims,
+            tflite::micro::GetTensorData<int8_t>(filter), &bias_dims,
+            data.folded_bias, &output_dims,
+            tflite::micro::GetTensorData<int8_t>(output)),
+        ARM_MATH_SUCCESS);
+    return kTfLiteOk;
+  }
+
   TF_LITE_ENSURE_EQ(
       context,
       arm_fully_connected_s8(
@@ -191,7 +298,7 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   // Checks in Prepare ensure input, output and filter types are all the same.
   switch (input->type) {
     case kTfLiteFloat32: {
-      tflite::reference_ops::FullyConnected(
+      tflite::micro::FullyConnectedFloat(
           FullyConnectedParamsFloat(params->activation),
           tflite::micro::GetTensorShape(input),
           tflite::micro::GetTensorData<float>(input),
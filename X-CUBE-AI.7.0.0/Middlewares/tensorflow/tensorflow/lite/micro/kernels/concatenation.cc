@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/internal/reference/concatenation.h"
 
 #include <cstdint>
+#include <cstring>
 
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
@@ -83,8 +84,40 @@ inline void GetAllInputTensorData(const TfLiteContext* context,
   }
 }
 
+// Concatenation along the outermost non-trivial axis: the inputs are
+// contiguous in the output and can be slices of it (see MicroAllocator), their
+// data is then already in place. Returns false for the other axes.
+template <typename data_type>
+bool EvalOuterAxis(TfLiteContext* context, TfLiteNode* node, int axis) {
+  TfLiteEvalTensor* output =
+      tflite::micro::GetEvalOutput(context, node, kOutputTensor);
+  for (int i = 0; i < axis; ++i) {
+    if (output->dims->data[i] != 1) {
+      return false;
+    }
+  }
+  data_type* output_ptr = tflite::micro::GetTensorData<data_type>(output);
+  for (int i = 0; i < node->inputs->size; ++i) {
+    const TfLiteEvalTensor* t = tflite::micro::GetEvalInput(context, node, i);
+    const data_type* input_ptr = tflite::micro::GetTensorData<data_type>(t);
+    const int size = tflite::micro::GetTensorShape(t).FlatSize();
+    if (input_ptr != output_ptr) {
+      memcpy(output_ptr, input_ptr, size * sizeof(data_type));
+    }
+    output_ptr += size;
+  }
+  return true;
+}
+
 template <typename data_type>
 void EvalUnquantized(TfLiteContext* context, TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  if (EvalOuterAxis<data_type>(
+          context, node,
+          static_cast<const OpData*>(node->user_data)->params.axis)) {
+    return;
+  }
+
   // Collect the shapes and data pointer of input tensors
   RuntimeShape inputs_shape[kMaxInputNum];
   const RuntimeShape* inputs_shape_ptr[kMaxInputNum];
@@ -50,6 +50,9 @@ struct OpDataConv {
 extern const int kConvInputTensor;
 extern const int kConvWeightsTensor;
 extern const int kConvBiasTensor;
+// Optional fourth input added by the graph fusion pass when a PAD node is
+// folded into the convolution: the int32 {4, 2} paddings of that PAD.
+extern const int kConvPaddingsTensor;
 extern const int kConvOutputTensor;
 extern const int kConvQuantizedDimension;
 
@@ -30,6 +30,7 @@ namespace tflite {
 const int kConvInputTensor = 0;
 const int kConvWeightsTensor = 1;
 const int kConvBiasTensor = 2;
+const int kConvPaddingsTensor = 3;
 const int kConvOutputTensor = 0;
 
 // Conv is quantized along dimension 0:
@@ -81,24 +82,49 @@ TfLiteStatus CalculateOpDataConv(TfLiteContext* context, TfLiteNode* node,
                                  int filter_height, int out_width,
                                  int out_height, const TfLiteType data_type,
                                  OpDataConv* data) {
-  bool has_bias = node->inputs->size == 3;
-  // Check number of inputs/outputs
-  TF_LITE_ENSURE(context, has_bias || node->inputs->size == 2);
+  // Check number of inputs/outputs. A folded PAD appends its paddings as a
+  // 4th input, the bias input is then kTfLiteOptionalTensor if there is none.
+  TF_LITE_ENSURE(context,
+                 node->inputs->size >= 2 && node->inputs->size <= 4);
+  const bool has_bias = node->inputs->size > kConvBiasTensor &&
+                        node->inputs->data[kConvBiasTensor] !=
+                            kTfLiteOptionalTensor;
+  const bool has_paddings = node->inputs->size > kConvPaddingsTensor;
   TF_LITE_ENSURE_EQ(context, node->outputs->size, 1);
 
+  // A folded PAD grows the spatial dimensions seen by the convolution; the
+  // leading pads are then absorbed by the convolution padding.
+  int pad_top = 0;
+  int pad_left = 0;
+  if (has_paddings) {
+    const TfLiteTensor* paddings =
+        GetInput(context, node, kConvPaddingsTensor);
+    TF_LITE_ENSURE(context, paddings != nullptr);
+    TF_LITE_ENSURE_TYPES_EQ(context, paddings->type, kTfLiteInt32);
+    TF_LITE_ENSURE_EQ(context, NumElements(paddings), 8);
+    const int32_t* pads = GetTensorData<int32_t>(paddings);
+    pad_top = pads[2];
+    pad_left = pads[4];
+    height += pads[2] + pads[3];
+    width += pads[4] + pads[5];
+  }
+
   // Matching GetWindowedOutputSize in TensorFlow.
   auto padding = params.padding;
   data->padding = ComputePaddingHeightWidth(
       params.stride_height, params.stride_width, params.dilation_height_factor,
       params.dilation_width_factor, height, width, filter_height, filter_width,
       padding, &out_height, &out_width);
+  data->padding.height += pad_top;
+  data->padding.width += pad_left;
 
   const TfLiteTensor* input = GetInput(context, node, kConvInputTensor);
   TF_LITE_ENSURE(context, input != nullptr);
   const TfLiteTensor* filter = GetInput(context, node, kConvWeightsTensor);
   TF_LITE_ENSURE(context, filter != nullptr);
   const TfLiteTensor* bias =
-      GetOptionalInputTensor(context, node, kConvBiasTensor);
+      has_bias ? GetInput(context, node, kConvBiasTensor) : nullptr;
+  TF_LITE_ENSURE(context, !has_bias || bias != nullptr);
   TfLiteTensor* output = GetOutput(context, node, kConvOutputTensor);
   TF_LITE_ENSURE(context, output != nullptr);
 
@@ -118,6 +118,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   }
   ExpandTensorDim(context, input, axis_value, output);
 
+  // The output can share the buffer of the input (see MicroAllocator).
+  if (output->data.data == input->data.data) {
+    return kTfLiteOk;
+  }
+
   switch (input->type) {
     case kTfLiteFloat32: {
       memCopyN(tflite::micro::GetTensorData<float>(output),
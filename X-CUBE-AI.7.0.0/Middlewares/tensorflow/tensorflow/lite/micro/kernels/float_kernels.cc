@@ -0,0 +1,619 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/kernels/float_kernels.h"
+
+#include <algorithm>
+
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+
+namespace tflite {
+namespace micro {
+
+namespace {
+
+constexpr int kMr = kFloatGemmTileRows;
+constexpr int kNr = kFloatGemmTileCols;
+
+// Fills `packed` (depth x kMr, depth-major) with the rows [filter_y_begin,
+// filter_y_begin + filter_rows) of the receptive fields of `rows` consecutive
+// output pixels starting at `first_pixel`. Taps outside the input image and
+// lanes past `rows` are zero.
+void PackIm2colBlock(const ConvParams& params, const RuntimeShape& input_shape,
+                     const float* input_data, int batch, int filter_y_begin,
+                     int filter_rows, int filter_width, int output_width,
+                     int first_pixel, int rows, float* packed) {
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int input_depth = input_shape.Dims(3);
+  const int patch_depth = filter_rows * filter_width * input_depth;
+
+  for (int i = 0; i < kMr; ++i) {
+    float* lane = packed + i;
+    if (i >= rows) {
+      for (int k = 0; k < patch_depth; ++k) {
+        lane[k * kMr] = 0.0f;
+      }
+      continue;
+    }
+    const int out_y = (first_pixel + i) / output_width;
+    const int out_x = (first_pixel + i) % output_width;
+    const int in_y_origin =
+        (out_y * params.stride_height) - params.padding_values.height;
+    const int in_x_origin =
+        (out_x * params.stride_width) - params.padding_values.width;
+    int k = 0;
+    for (int filter_y = filter_y_begin; filter_y < filter_y_begin + filter_rows;
+         ++filter_y) {
+      const int in_y = in_y_origin + params.dilation_height_factor * filter_y;
+      for (int filter_x = 0; filter_x < filter_width; ++filter_x) {
+        const int in_x = in_x_origin + params.dilation_width_factor * filter_x;
+        if ((in_x >= 0) && (in_x < input_width) && (in_y >= 0) &&
+            (in_y < input_height)) {
+          const float* in =
+              input_data + Offset(input_shape, batch, in_y, in_x, 0);
+          for (int c = 0; c < input_depth; ++c) {
+            lane[(k + c) * kMr] = in[c];
+          }
+        } else {
+          for (int c = 0; c < input_depth; ++c) {
+            lane[(k + c) * kMr] = 0.0f;
+          }
+        }
+        k += input_depth;
+      }
+    }
+  }
+}
+
+// Adds to the kMr x kNr tile `acc` the products of the packed lanes with
+// `depth` weights of kNr rows `weights_stride` apart: acc[j][i] accumulates
+// packed lane i with weights row j. The accumulation runs along depth, as in
+// the reference kernels, and the kMr lanes are contiguous so they can be
+// vectorized.
+inline void GemmTileAccumulate(const float* packed, const float* weights,
+                               int weights_stride, int depth,
+                               float acc[kNr][kMr]) {
+  const float* w0 = weights;
+  const float* w1 = weights + weights_stride;
+  const float* w2 = weights + 2 * weights_stride;
+  const float* w3 = weights + 3 * weights_stride;
+  for (int k = 0; k < depth; ++k) {
+    const float* a = packed + k * kMr;
+    const float b[kNr] = {w0[k], w1[k], w2[k], w3[k]};
+    for (int j = 0; j < kNr; ++j) {
+      for (int i = 0; i < kMr; ++i) {
+        acc[j][i] += a[i] * b[j];
+      }
+    }
+  }
+}
+
+// Single weights row version of GemmTileAccumulate() for the output channel
+// remainder.
+inline void GemmColumnAccumulate(const float* packed, const float* weights,
+                                 int depth, float acc[kMr]) {
+  for (int k = 0; k < depth; ++k) {
+    const float* a = packed + k * kMr;
+    const float b = weights[k];
+    for (int i = 0; i < kMr; ++i) {
+      acc[i] += a[i] * b;
+    }
+  }
+}
+
+// Computes a kMr x kNr tile: acc[j][i] is the dot product of packed lane i
+// with weights row j.
+inline void GemmTile(const float* packed, const float* weights, int depth,
+                     float acc[kNr][kMr]) {
+  for (int j = 0; j < kNr; ++j) {
+    for (int i = 0; i < kMr; ++i) {
+      acc[j][i] = 0.0f;
+    }
+  }
+  GemmTileAccumulate(packed, weights, depth, depth, acc);
+}
+
+// Single weights row version of GemmTile() for the output channel remainder.
+inline void GemmColumn(const float* packed, const float* weights, int depth,
+                       float acc[kMr]) {
+  for (int i = 0; i < kMr; ++i) {
+    acc[i] = 0.0f;
+  }
+  GemmColumnAccumulate(packed, weights, depth, acc);
+}
+
+// Winograd F(2x2, 3x3) tile geometry.
+constexpr int kWinogradTile = 4;
+constexpr int kWinogradTileSize = kWinogradTile * kWinogradTile;
+
+// Applies B^T = [1 0 -1 0; 0 1 1 0; 0 -1 1 0; 0 1 0 -1] in place to four
+// rows of `depth` channels. Called on the columns then on the rows of a
+// [16][depth] tile it computes B^T d B for every channel.
+inline void WinogradInputTransform(float* r0, float* r1, float* r2, float* r3,
+                                   int depth) {
+  for (int c = 0; c < depth; ++c) {
+    const float d0 = r0[c];
+    const float d1 = r1[c];
+    const float d2 = r2[c];
+    const float d3 = r3[c];
+    r0[c] = d0 - d2;
+    r1[c] = d1 + d2;
+    r2[c] = d2 - d1;
+    r3[c] = d1 - d3;
+  }
+}
+
+// Applies A^T = [1 1 1 0; 0 1 -1 -1] in place to four rows of `depth`
+// channels, leaving the two results in `r0` and `r1`.
+inline void WinogradOutputTransform(float* r0, float* r1, const float* r2,
+                                    const float* r3, int depth) {
+  for (int c = 0; c < depth; ++c) {
+    const float m0 = r0[c];
+    const float m1 = r1[c];
+    const float m2 = r2[c];
+    const float m3 = r3[c];
+    r0[c] = m0 + m1 + m2;
+    r1[c] = m1 - m2 - m3;
+  }
+}
+
+}  // namespace
+
+size_t ConvFloatIm2colBufferSize(const RuntimeShape& filter_shape,
+                                 int filter_rows) {
+  const int filter_height = filter_shape.Dims(1);
+  TFLITE_DCHECK_GT(filter_rows, 0);
+  TFLITE_DCHECK_LE(filter_rows, filter_height);
+  size_t size = sizeof(float) * kMr * filter_rows * filter_shape.Dims(2) *
+                filter_shape.Dims(3);
+  if (filter_rows < filter_height) {
+    // Partial sums of the kMr output pixels for all the output channels.
+    size += sizeof(float) * kMr * filter_shape.Dims(0);
+  }
+  return size;
+}
+
+void ConvFloat(const ConvParams& params, const RuntimeShape& input_shape,
+               const float* input_data, const RuntimeShape& filter_shape,
+               const float* filter_data, const RuntimeShape& bias_shape,
+               const float* bias_data, const RuntimeShape& output_shape,
+               float* output_data, int filter_rows, float* im2col_data) {
+  const float output_activation_min = params.float_activation_min;
+  const float output_activation_max = params.float_activation_max;
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK(im2col_data != nullptr);
+
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  TFLITE_DCHECK_EQ(input_shape.Dims(3), filter_shape.Dims(3));
+  const int output_depth = MatchingDim(filter_shape, 0, output_shape, 3);
+  if (bias_data) {
+    TFLITE_DCHECK_EQ(bias_shape.FlatSize(), output_depth);
+  }
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int row_depth = filter_width * filter_shape.Dims(3);
+  const int patch_depth = filter_height * row_depth;
+  const int output_width = output_shape.Dims(2);
+  const int output_pixels = output_shape.Dims(1) * output_width;
+  TFLITE_DCHECK_GT(filter_rows, 0);
+  TFLITE_DCHECK_LE(filter_rows, filter_height);
+
+  // When the block only holds `filter_rows` filter rows, the partial sums
+  // ([output_depth][kMr]) are kept after it until the last rows are done.
+  // The products are still added in the order of the reference kernels.
+  float* partial_data = im2col_data + kMr * filter_rows * row_depth;
+
+  float acc[kNr][kMr];
+  for (int batch = 0; batch < batches; ++batch) {
+    float* batch_output = output_data + Offset(output_shape, batch, 0, 0, 0);
+    for (int pixel = 0; pixel < output_pixels; pixel += kMr) {
+      const int rows = std::min(kMr, output_pixels - pixel);
+      for (int filter_y = 0; filter_y < filter_height;
+           filter_y += filter_rows) {
+        const int block_rows = std::min(filter_rows, filter_height - filter_y);
+        const int depth = block_rows * row_depth;
+        const bool first = (filter_y == 0);
+        const bool last = (filter_y + block_rows == filter_height);
+        const float* weights = filter_data + filter_y * row_depth;
+        PackIm2colBlock(params, input_shape, input_data, batch, filter_y,
+                        block_rows, filter_width, output_width, pixel, rows,
+                        im2col_data);
+
+        int oc = 0;
+        for (; oc + kNr <= output_depth; oc += kNr) {
+          float* partial = partial_data + oc * kMr;
+          for (int j = 0; j < kNr; ++j) {
+            for (int i = 0; i < kMr; ++i) {
+              acc[j][i] = first ? 0.0f : partial[j * kMr + i];
+            }
+          }
+          GemmTileAccumulate(im2col_data, weights + oc * patch_depth,
+                             patch_depth, depth, acc);
+          if (!last) {
+            for (int j = 0; j < kNr; ++j) {
+              for (int i = 0; i < kMr; ++i) {
+                partial[j * kMr + i] = acc[j][i];
+              }
+            }
+            continue;
+          }
+          for (int j = 0; j < kNr; ++j) {
+            const float bias_value = bias_data ? bias_data[oc + j] : 0.0f;
+            for (int i = 0; i < rows; ++i) {
+              batch_output[(pixel + i) * output_depth + oc + j] =
+                  ActivationFunctionWithMinMax(acc[j][i] + bias_value,
+                                               output_activation_min,
+                                               output_activation_max);
+            }
+          }
+        }
+        for (; oc < output_depth; ++oc) {
+          float* partial = partial_data + oc * kMr;
+          for (int i = 0; i < kMr; ++i) {
+            acc[0][i] = first ? 0.0f : partial[i];
+          }
+          GemmColumnAccumulate(im2col_data, weights + oc * patch_depth, depth,
+                               acc[0]);
+          if (!last) {
+            for (int i = 0; i < kMr; ++i) {
+              partial[i] = acc[0][i];
+            }
+            continue;
+          }
+          const float bias_value = bias_data ? bias_data[oc] : 0.0f;
+          for (int i = 0; i < rows; ++i) {
+            batch_output[(pixel + i) * output_depth + oc] =
+                ActivationFunctionWithMinMax(acc[0][i] + bias_value,
+                                             output_activation_min,
+                                             output_activation_max);
+          }
+        }
+      }
+    }
+  }
+}
+
+void DepthwiseConvFloat(const DepthwiseParams& params,
+                        const RuntimeShape& input_shape,
+                        const float* input_data,
+                        const RuntimeShape& filter_shape,
+                        const float* filter_data,
+                        const RuntimeShape& bias_shape, const float* bias_data,
+                        const RuntimeShape& output_shape, float* output_data) {
+  const int stride_width = params.stride_width;
+  const int stride_height = params.stride_height;
+  const int dilation_width_factor = params.dilation_width_factor;
+  const int dilation_height_factor = params.dilation_height_factor;
+  const int pad_width = params.padding_values.width;
+  const int pad_height = params.padding_values.height;
+  const int depth_multiplier = params.depth_multiplier;
+  const float output_activation_min = params.float_activation_min;
+  const float output_activation_max = params.float_activation_max;
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int output_depth = MatchingDim(filter_shape, 3, output_shape, 3);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int input_depth = input_shape.Dims(3);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  TFLITE_DCHECK_EQ(output_depth, input_depth * depth_multiplier);
+  if (bias_data) {
+    TFLITE_DCHECK_EQ(bias_shape.FlatSize(), output_depth);
+  }
+
+  for (int b = 0; b < batches; ++b) {
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      const int in_y_origin = (out_y * stride_height) - pad_height;
+      for (int out_x = 0; out_x < output_width; ++out_x) {
+        const int in_x_origin = (out_x * stride_width) - pad_width;
+        float* out = output_data + Offset(output_shape, b, out_y, out_x, 0);
+        for (int oc = 0; oc < output_depth; ++oc) {
+          out[oc] = 0.0f;
+        }
+        // Taps in the reference order, each one updating every channel.
+        for (int filter_y = 0; filter_y < filter_height; ++filter_y) {
+          const int in_y = in_y_origin + dilation_height_factor * filter_y;
+          if ((in_y < 0) || (in_y >= input_height)) {
+            continue;
+          }
+          for (int filter_x = 0; filter_x < filter_width; ++filter_x) {
+            const int in_x = in_x_origin + dilation_width_factor * filter_x;
+            if ((in_x < 0) || (in_x >= input_width)) {
+              continue;
+            }
+            const float* in =
+                input_data + Offset(input_shape, b, in_y, in_x, 0);
+            const float* filter =
+                filter_data + Offset(filter_shape, 0, filter_y, filter_x, 0);
+            if (depth_multiplier == 1) {
+              for (int c = 0; c < output_depth; ++c) {
+                out[c] += in[c] * filter[c];
+              }
+            } else {
+              for (int ic = 0; ic < input_depth; ++ic) {
+                const float input_value = in[ic];
+                float* out_ic = out + ic * depth_multiplier;
+                const float* filter_ic = filter + ic * depth_multiplier;
+                for (int m = 0; m < depth_multiplier; ++m) {
+                  out_ic[m] += input_value * filter_ic[m];
+                }
+              }
+            }
+          }
+        }
+        for (int oc = 0; oc < output_depth; ++oc) {
+          const float bias_value = bias_data ? bias_data[oc] : 0.0f;
+          out[oc] = ActivationFunctionWithMinMax(out[oc] + bias_value,
+                                                 output_activation_min,
+                                                 output_activation_max);
+        }
+      }
+    }
+  }
+}
+
+void FullyConnectedFloat(const FullyConnectedParams& params,
+                         const RuntimeShape& input_shape,
+                         const float* input_data,
+                         const RuntimeShape& weights_shape,
+                         const float* weights_data,
+                         const RuntimeShape& bias_shape, const float* bias_data,
+                         const RuntimeShape& output_shape, float* output_data) {
+  const float output_activation_min = params.float_activation_min;
+  const float output_activation_max = params.float_activation_max;
+  const int output_dims_count = output_shape.DimensionsCount();
+  const int weights_dims_count = weights_shape.DimensionsCount();
+  const int batches = FlatSizeSkipDim(output_shape, output_dims_count - 1);
+  const int output_depth = MatchingDim(weights_shape, weights_dims_count - 2,
+                                       output_shape, output_dims_count - 1);
+  const int accum_depth = weights_shape.Dims(weights_dims_count - 1);
+
+  for (int b = 0; b < batches; ++b) {
+    const float* input = input_data + b * accum_depth;
+    float* output = output_data + b * output_depth;
+    int out_c = 0;
+    for (; out_c + kNr <= output_depth; out_c += kNr) {
+      const float* w0 = weights_data + out_c * accum_depth;
+      const float* w1 = w0 + accum_depth;
+      const float* w2 = w1 + accum_depth;
+      const float* w3 = w2 + accum_depth;
+      float acc[kNr] = {0.0f, 0.0f, 0.0f, 0.0f};
+      for (int d = 0; d < accum_depth; ++d) {
+        const float input_value = input[d];
+        acc[0] += input_value * w0[d];
+        acc[1] += input_value * w1[d];
+        acc[2] += input_value * w2[d];
+        acc[3] += input_value * w3[d];
+      }
+      for (int j = 0; j < kNr; ++j) {
+        const float bias_value = bias_data ? bias_data[out_c + j] : 0.0f;
+        output[out_c + j] = ActivationFunctionWithMinMax(
+            acc[j] + bias_value, output_activation_min, output_activation_max);
+      }
+    }
+    for (; out_c < output_depth; ++out_c) {
+      const float* w = weights_data + out_c * accum_depth;
+      float total = 0.0f;
+      for (int d = 0; d < accum_depth; ++d) {
+        total += input[d] * w[d];
+      }
+      const float bias_value = bias_data ? bias_data[out_c] : 0.0f;
+      output[out_c] = ActivationFunctionWithMinMax(
+          total + bias_value, output_activation_min, output_activation_max);
+    }
+  }
+}
+
+size_t ConvFloatWinogradFilterSize(const RuntimeShape& filter_shape) {
+  return sizeof(float) * kWinogradTileSize * filter_shape.Dims(0) *
+         filter_shape.Dims(3);
+}
+
+size_t ConvFloatWinogradBufferSize(const RuntimeShape& input_shape,
+                                   const RuntimeShape& output_shape) {
+  return sizeof(float) * kWinogradTileSize * kMr *
+         (input_shape.Dims(3) + output_shape.Dims(3));
+}
+
+void ConvFloatWinogradTransformFilter(const RuntimeShape& filter_shape,
+                                      const float* filter_data,
+                                      float* transformed_filter_data) {
+  TFLITE_DCHECK_EQ(filter_shape.Dims(1), 3);
+  TFLITE_DCHECK_EQ(filter_shape.Dims(2), 3);
+  const int output_depth = filter_shape.Dims(0);
+  const int input_depth = filter_shape.Dims(3);
+
+  for (int oc = 0; oc < output_depth; ++oc) {
+    for (int ic = 0; ic < input_depth; ++ic) {
+      float g[9];
+      for (int k = 0; k < 9; ++k) {
+        g[k] = filter_data[(oc * 9 + k) * input_depth + ic];
+      }
+      // t = G g, with G = [1 0 0; .5 .5 .5; .5 -.5 .5; 0 0 1].
+      float t[12];
+      for (int i = 0; i < 3; ++i) {
+        t[0 * 3 + i] = g[0 * 3 + i];
+        t[1 * 3 + i] = 0.5f * (g[0 * 3 + i] + g[1 * 3 + i] + g[2 * 3 + i]);
+        t[2 * 3 + i] = 0.5f * (g[0 * 3 + i] - g[1 * 3 + i] + g[2 * 3 + i]);
+        t[3 * 3 + i] = g[2 * 3 + i];
+      }
+      // U = t G^T, stored as [16][output_depth][input_depth] so that each
+      // tile position is a weights matrix for GemmTile().
+      for (int i = 0; i < kWinogradTile; ++i) {
+        const float* row = &t[i * 3];
+        const float u[kWinogradTile] = {
+            row[0], 0.5f * (row[0] + row[1] + row[2]),
+            0.5f * (row[0] - row[1] + row[2]), row[2]};
+        for (int j = 0; j < kWinogradTile; ++j) {
+          const int p = i * kWinogradTile + j;
+          transformed_filter_data[(p * output_depth + oc) * input_depth + ic] =
+              u[j];
+        }
+      }
+    }
+  }
+}
+
+void ConvFloatWinograd(const ConvParams& params,
+                       const RuntimeShape& input_shape,
+                       const float* input_data,
+                       const RuntimeShape& filter_shape,
+                       const float* transformed_filter_data,
+                       const RuntimeShape& bias_shape, const float* bias_data,
+                       const RuntimeShape& output_shape, float* output_data,
+                       float* scratch_data) {
+  const float output_activation_min = params.float_activation_min;
+  const float output_activation_max = params.float_activation_max;
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(params.stride_height, 1);
+  TFLITE_DCHECK_EQ(params.stride_width, 1);
+  TFLITE_DCHECK(scratch_data != nullptr);
+
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_depth = MatchingDim(input_shape, 3, filter_shape, 3);
+  const int output_depth = MatchingDim(filter_shape, 0, output_shape, 3);
+  if (bias_data) {
+    TFLITE_DCHECK_EQ(bias_shape.FlatSize(), output_depth);
+  }
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int pad_height = params.padding_values.height;
+  const int pad_width = params.padding_values.width;
+
+  // kMr horizontally adjacent 2x2 tiles are transformed together so that the
+  // element-wise products run as GEMMs on the GemmTile() register blocks.
+  // V is [16][input_depth][kMr] and M is [16][output_depth][kMr].
+  const int v_stride = input_depth * kMr;
+  const int m_stride = output_depth * kMr;
+  float* v_data = scratch_data;
+  float* m_data = scratch_data + kWinogradTileSize * v_stride;
+  const int block_width = 2 * kMr;
+
+  float acc[kNr][kMr];
+  for (int batch = 0; batch < batches; ++batch) {
+    for (int tile_y = 0; tile_y < output_height; tile_y += 2) {
+      const int in_y_origin = tile_y - pad_height;
+      for (int block_x = 0; block_x < output_width; block_x += block_width) {
+        const int tiles = std::min(kMr, (output_width - block_x + 1) / 2);
+
+        for (int y = 0; y < kWinogradTile; ++y) {
+          const int in_y = in_y_origin + y;
+          const bool row_valid = (in_y >= 0) && (in_y < input_height);
+          for (int x = 0; x < kWinogradTile; ++x) {
+            float* v = v_data + (y * kWinogradTile + x) * v_stride;
+            for (int i = 0; i < kMr; ++i) {
+              const int in_x = block_x + 2 * i + x - pad_width;
+              if (i < tiles && row_valid && (in_x >= 0) &&
+                  (in_x < input_width)) {
+                const float* in =
+                    input_data + Offset(input_shape, batch, in_y, in_x, 0);
+                for (int ic = 0; ic < input_depth; ++ic) {
+                  v[ic * kMr + i] = in[ic];
+                }
+              } else {
+                for (int ic = 0; ic < input_depth; ++ic) {
+                  v[ic * kMr + i] = 0.0f;
+                }
+              }
+            }
+          }
+        }
+        for (int i = 0; i < kWinogradTile; ++i) {
+          float* column = v_data + i * v_stride;
+          const int stride = kWinogradTile * v_stride;
+          WinogradInputTransform(column, column + stride, column + 2 * stride,
+                                 column + 3 * stride, v_stride);
+        }
+        for (int i = 0; i < kWinogradTile; ++i) {
+          float* row = v_data + i * kWinogradTile * v_stride;
+          WinogradInputTransform(row, row + v_stride, row + 2 * v_stride,
+                                 row + 3 * v_stride, v_stride);
+        }
+
+        // M[p] = U[p] V[p] for each of the 16 tile positions.
+        for (int p = 0; p < kWinogradTileSize; ++p) {
+          const float* v = v_data + p * v_stride;
+          const float* u =
+              transformed_filter_data + p * output_depth * input_depth;
+          float* m = m_data + p * m_stride;
+          int oc = 0;
+          for (; oc + kNr <= output_depth; oc += kNr) {
+            GemmTile(v, u + oc * input_depth, input_depth, acc);
+            for (int j = 0; j < kNr; ++j) {
+              for (int i = 0; i < kMr; ++i) {
+                m[(oc + j) * kMr + i] = acc[j][i];
+              }
+            }
+          }
+          for (; oc < output_depth; ++oc) {
+            GemmColumn(v, u + oc * input_depth, input_depth, acc[0]);
+            for (int i = 0; i < kMr; ++i) {
+              m[oc * kMr + i] = acc[0][i];
+            }
+          }
+        }
+
+        // Y = A^T M A. Each 2x2 tile ends up in M[0], M[1], M[4] and M[5].
+        for (int i = 0; i < kWinogradTile; ++i) {
+          float* column = m_data + i * m_stride;
+          const int stride = kWinogradTile * m_stride;
+          WinogradOutputTransform(column, column + stride, column + 2 * stride,
+                                  column + 3 * stride, m_stride);
+        }
+        const int rows = std::min(2, output_height - tile_y);
+        for (int y = 0; y < rows; ++y) {
+          float* row = m_data + y * kWinogradTile * m_stride;
+          WinogradOutputTransform(row, row + m_stride, row + 2 * m_stride,
+                                  row + 3 * m_stride, m_stride);
+          for (int i = 0; i < tiles; ++i) {
+            for (int x = 0; x < 2; ++x) {
+              const int out_x = block_x + 2 * i + x;
+              if (out_x >= output_width) {
+                break;
+              }
+              const float* m = row + x * m_stride + i;
+              float* out = output_data +
+                           Offset(output_shape, batch, tile_y + y, out_x, 0);
+              for (int oc = 0; oc < output_depth; ++oc) {
+                const float bias_value = bias_data ? bias_data[oc] : 0.0f;
+                out[oc] = ActivationFunctionWithMinMax(m[oc * kMr] + bias_value,
+                                                       output_activation_min,
+                                                       output_activation_max);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace micro
+}  // namespace tflite
@@ -0,0 +1,109 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_FLOAT_KERNELS_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_FLOAT_KERNELS_H_
+
+#include <cstddef>
+
+#include "tensorflow/lite/kernels/internal/types.h"
+
+namespace tflite {
+namespace micro {
+
+// Float32 convolution, depthwise convolution and fully connected kernels used
+// in place of the reference loops. They accumulate the products of each output
+// in the same order as the reference kernels, so both only differ where the
+// reference skips a padded tap that these kernels multiply by zero.
+//
+// The inner loops are written with compile-time trip counts and independent
+// accumulators so that the compiler keeps the tile in FPU registers on
+// Cortex-M and vectorizes it on hosts with SIMD units, without relying on
+// floating point reassociation.
+
+// Number of output pixels and output channels computed per register tile.
+constexpr int kFloatGemmTileRows = 4;
+constexpr int kFloatGemmTileCols = 4;
+
+// Returns the size in bytes of the im2col buffer needed by ConvFloat() for a
+// filter of the given shape (OHWI) packed `filter_rows` filter rows at a time.
+size_t ConvFloatIm2colBufferSize(const RuntimeShape& filter_shape,
+                                 int filter_rows);
+
+// Convolution computed as a GEMM between im2col blocks of
+// kFloatGemmTileRows output pixels and the filter. The blocks hold
+// `filter_rows` (1 to the filter height) rows of the receptive fields: with
+// less than the whole filter the partial sums are kept in the buffer, which
+// trades some throughput for a smaller buffer on large filters. The result
+// doesn't depend on `filter_rows`. `im2col_data` must hold
+// ConvFloatIm2colBufferSize() bytes.
+void ConvFloat(const ConvParams& params, const RuntimeShape& input_shape,
+               const float* input_data, const RuntimeShape& filter_shape,
+               const float* filter_data, const RuntimeShape& bias_shape,
+               const float* bias_data, const RuntimeShape& output_shape,
+               float* output_data, int filter_rows, float* im2col_data);
+
+// Returns the size in bytes of the Winograd domain filter produced by
+// ConvFloatWinogradTransformFilter() for a 3x3 filter of the given shape.
+size_t ConvFloatWinogradFilterSize(const RuntimeShape& filter_shape);
+
+// Returns the size in bytes of the scratch buffer needed by
+// ConvFloatWinograd().
+size_t ConvFloatWinogradBufferSize(const RuntimeShape& input_shape,
+                                   const RuntimeShape& output_shape);
+
+// Transforms a 3x3 OHWI filter to the Winograd F(2x2, 3x3) domain. This is
+// meant to be done once, when the kernel is prepared.
+void ConvFloatWinogradTransformFilter(const RuntimeShape& filter_shape,
+                                      const float* filter_data,
+                                      float* transformed_filter_data);
+
+// 3x3, stride 1, dilation 1 convolution computing each 2x2 output tile with
+// 16 instead of 36 multiplications per input channel. Unlike the other
+// kernels in this file the result is not bit-exact with the reference: the
+// transforms reassociate the sums. The difference grows with the filter depth
+// and stays below 2e-6 of the output range for up to 128 input channels.
+void ConvFloatWinograd(const ConvParams& params,
+                       const RuntimeShape& input_shape,
+                       const float* input_data,
+                       const RuntimeShape& filter_shape,
+                       const float* transformed_filter_data,
+                       const RuntimeShape& bias_shape, const float* bias_data,
+                       const RuntimeShape& output_shape, float* output_data,
+                       float* scratch_data);
+
+// Depthwise convolution accumulating a full row of output channels per filter
+// tap directly in the output buffer. No scratch memory is needed.
+void DepthwiseConvFloat(const DepthwiseParams& params,
+                        const RuntimeShape& input_shape,
+                        const float* input_data,
+                        const RuntimeShape& filter_shape,
+                        const float* filter_data,
+                        const RuntimeShape& bias_shape, const float* bias_data,
+                        const RuntimeShape& output_shape, float* output_data);
+
+// Fully connected layer computing kFloatGemmTileCols output channels at a time
+// so that every input value is loaded once per tile.
+void FullyConnectedFloat(const FullyConnectedParams& params,
+                         const RuntimeShape& input_shape,
+                         const float* input_data,
+                         const RuntimeShape& weights_shape,
+                         const float* weights_data,
+                         const RuntimeShape& bias_shape, const float* bias_data,
+                         const RuntimeShape& output_shape, float* output_data);
+
+}  // namespace micro
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_FLOAT_KERNELS_H_
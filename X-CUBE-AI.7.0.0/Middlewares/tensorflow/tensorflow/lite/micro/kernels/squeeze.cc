@@ -90,8 +90,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   }
 
   TF_LITE_ENSURE_EQ(context, op_context.input->bytes, op_context.output->bytes);
-  memcpy(op_context.output->data.raw, op_context.input->data.raw,
-         op_context.input->bytes);
+  // The output can share the buffer of the input (see MicroAllocator).
+  if (op_context.output->data.raw != op_context.input->data.raw) {
+    memcpy(op_context.output->data.raw, op_context.input->data.raw,
+           op_context.input->bytes);
+  }
   return kTfLiteOk;
 }
 
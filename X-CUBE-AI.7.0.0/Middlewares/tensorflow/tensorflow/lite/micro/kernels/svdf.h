@@ -33,6 +33,12 @@ struct OpData {
   // Cached tensor zero point values for quantized operations.
   int input_zero_point;
   int output_zero_point;
+
+  // Column of the activation state that receives the next feature activation.
+  // The state is kept as a ring buffer along the memory axis instead of being
+  // shifted left by one time step on every invoke, so the oldest entry of each
+  // filter lives at (state_head + 1) % memory_size.
+  int state_head;
 };
 
 // Input tensors.
@@ -46,6 +52,12 @@ extern const int kSvdfInputActivationStateTensor;
 // Output tensor.
 extern const int kSvdfOutputTensor;
 
+// Returns the column that follows `state_head` in the ring-buffered activation
+// state, i.e. the position of the oldest entry once the current one is written.
+inline int NextSvdfStateHead(int state_head, int memory_size) {
+  return (state_head + 1 == memory_size) ? 0 : state_head + 1;
+}
+
 // TensorflowLite Micro-specific reference implementation for Integer SVDF.
 void EvalIntegerSvdfReference(TfLiteContext* context, TfLiteNode* node,
                               const TfLiteEvalTensor* input_tensor,
@@ -54,14 +66,13 @@ void EvalIntegerSvdfReference(TfLiteContext* context, TfLiteNode* node,
                               const TfLiteEvalTensor* bias_tensor,
                               const TfLiteSVDFParams* params,
                               TfLiteEvalTensor* activation_state_tensor,
-                              TfLiteEvalTensor* output_tensor,
-                              const OpData& data);
+                              TfLiteEvalTensor* output_tensor, OpData* data);
 
 void EvalFloatSvdfReference(
     TfLiteContext* context, TfLiteNode* node, const TfLiteEvalTensor* input,
     const TfLiteEvalTensor* weights_feature,
     const TfLiteEvalTensor* weights_time, const TfLiteEvalTensor* bias,
-    const TfLiteSVDFParams* params, int scratch_tensor_index,
+    const TfLiteSVDFParams* params, int scratch_tensor_index, int* state_head,
     TfLiteEvalTensor* activation_state, TfLiteEvalTensor* output);
 
 TfLiteStatus PrepareSvdf(TfLiteContext* context, TfLiteNode* node);
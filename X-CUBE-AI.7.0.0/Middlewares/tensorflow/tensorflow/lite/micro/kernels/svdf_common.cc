@@ -55,8 +55,7 @@ void EvalIntegerSvdfReference(TfLiteContext* context, TfLiteNode* node,
                               const TfLiteEvalTensor* bias_tensor,
                               const TfLiteSVDFParams* params,
                               TfLiteEvalTensor* activation_state_tensor,
-                              TfLiteEvalTensor* output_tensor,
-                              const OpData& data) {
+                              TfLiteEvalTensor* output_tensor, OpData* data) {
   const int n_rank = params->rank;
   const int n_batch = input_tensor->dims->data[0];
   const int n_input = input_tensor->dims->data[1];
@@ -68,23 +67,15 @@ void EvalIntegerSvdfReference(TfLiteContext* context, TfLiteNode* node,
   TFLITE_DCHECK(context->GetScratchBuffer != nullptr);
 
   int32_t* scratch_tensor = static_cast<int32_t*>(
-      context->GetScratchBuffer(context, data.scratch_tensor_index));
+      context->GetScratchBuffer(context, data->scratch_tensor_index));
   int32_t* scratch_output_tensor = static_cast<int32_t*>(
-      context->GetScratchBuffer(context, data.scratch_output_tensor_index));
+      context->GetScratchBuffer(context, data->scratch_output_tensor_index));
 
-  // Shift states.
-  int16_t* const state_ptr =
-      tflite::micro::GetTensorData<int16_t>(activation_state_tensor);
-
-  // Left shift the activation_state.
-  {
-    int16_t* new_state_start = state_ptr;
-    const int16_t* old_state_start = state_ptr + 1;
-    const int16_t* old_state_end = state_ptr + n_batch * n_filter * n_memory;
-    while (old_state_start != old_state_end) {
-      *new_state_start++ = *old_state_start++;
-    }
-  }
+  // The activation_state is a ring buffer along the memory axis: the current
+  // activation overwrites the oldest column (state_head) and the time matmul
+  // starts reading at the column after it, so no state shifting is needed.
+  const int state_head = data->state_head;
+  const int state_tail = NextSvdfStateHead(state_head, n_memory);
 
   // Note: no need to clear the latest activation, matmul is not accumulative.
 
@@ -97,7 +88,7 @@ void EvalIntegerSvdfReference(TfLiteContext* context, TfLiteNode* node,
         tflite::micro::GetTensorData<int8_t>(weights_feature_tensor);
     const int32_t output_max = std::numeric_limits<int16_t>::max();
     const int32_t output_min = std::numeric_limits<int16_t>::min();
-    int16_t* result_in_batch = state + (n_memory - 1);
+    int16_t* result_in_batch = state + state_head;
     for (int b = 0; b < n_batch; b++) {
       const int8_t* matrix_ptr = weight_feature;
       for (int r = 0; r < n_filter; r++) {
@@ -105,10 +96,10 @@ void EvalIntegerSvdfReference(TfLiteContext* context, TfLiteNode* node,
         const int8_t* vector_in_batch = input + b * n_input;
         for (int c = 0; c < n_input; c++) {
           dot_prod +=
-              *matrix_ptr++ * (*vector_in_batch++ - data.input_zero_point);
+              *matrix_ptr++ * (*vector_in_batch++ - data->input_zero_point);
         }
         dot_prod = MultiplyByQuantizedMultiplier(
-            dot_prod, data.effective_scale_1_a, data.effective_scale_1_b);
+            dot_prod, data->effective_scale_1_a, data->effective_scale_1_b);
         dot_prod = std::min(std::max(output_min, dot_prod), output_max);
         // This assumes state is symmetrically quantized. Otherwise last bit of
         // state should be initialized to its zero point and accumulate the
@@ -135,15 +126,23 @@ void EvalIntegerSvdfReference(TfLiteContext* context, TfLiteNode* node,
           b * n_memory * n_filter;
 
       for (int i = 0; i < n_filter; i++) {
+        // Walk the ring from the oldest entry to the newest one, which keeps
+        // the accumulation order identical to the shifted layout.
         *scratch_ptr_batch = 0;
-        for (int j = 0; j < n_memory; j++) {
-          *scratch_ptr_batch += *vector1_ptr++ * *vector2_ptr++;
+        for (int j = state_tail; j < n_memory; j++) {
+          *scratch_ptr_batch += *vector1_ptr++ * vector2_ptr[j];
+        }
+        for (int j = 0; j < state_tail; j++) {
+          *scratch_ptr_batch += *vector1_ptr++ * vector2_ptr[j];
         }
+        vector2_ptr += n_memory;
         scratch_ptr_batch++;
       }
     }
   }
 
+  data->state_head = state_tail;
+
   // Reduce, add bias, rescale, activation.
   {
     // Add bias.
@@ -183,9 +182,9 @@ void EvalIntegerSvdfReference(TfLiteContext* context, TfLiteNode* node,
     const int32_t output_min = std::numeric_limits<int8_t>::min();
     for (int i = 0; i < n_batch * n_unit; ++i) {
       int32_t x1 = scratch_output_tensor[i];
-      int32_t x2 = MultiplyByQuantizedMultiplier(x1, data.effective_scale_2_a,
-                                                 data.effective_scale_2_b);
-      int32_t x3 = x2 + data.output_zero_point;
+      int32_t x2 = MultiplyByQuantizedMultiplier(x1, data->effective_scale_2_a,
+                                                 data->effective_scale_2_b);
+      int32_t x3 = x2 + data->output_zero_point;
       int32_t x4 = std::min(std::max(output_min, x3), output_max);
       tflite::micro::GetTensorData<int8_t>(output_tensor)[i] =
           static_cast<int8_t>(x4);
@@ -194,7 +193,7 @@ void EvalIntegerSvdfReference(TfLiteContext* context, TfLiteNode* node,
 }
 static inline void ApplyTimeWeightsBiasAndActivation(
     int batch_size, int memory_size, int num_filters, int num_units, int rank,
-    const float* const __restrict__ weights_time_ptr,
+    int state_tail, const float* const __restrict__ weights_time_ptr,
     const float* const __restrict__ bias_ptr, TfLiteFusedActivation activation,
     float* const __restrict__ state_ptr, float* const __restrict__ scratch_ptr,
     float* const __restrict__ output_ptr) {
@@ -205,10 +204,16 @@ static inline void ApplyTimeWeightsBiasAndActivation(
     const float* vector1_ptr = weights_time_ptr;
     const float* vector2_ptr = state_ptr + b * memory_size * num_filters;
     for (int i = 0; i < num_filters; ++i) {
+      // Oldest-to-newest order keeps the float sums bit-exact with the
+      // shifted state layout.
       *scratch_ptr_batch = 0.f;
-      for (int j = 0; j < memory_size; ++j) {
-        *scratch_ptr_batch += *vector1_ptr++ * *vector2_ptr++;
+      for (int j = state_tail; j < memory_size; ++j) {
+        *scratch_ptr_batch += *vector1_ptr++ * vector2_ptr[j];
       }
+      for (int j = 0; j < state_tail; ++j) {
+        *scratch_ptr_batch += *vector1_ptr++ * vector2_ptr[j];
+      }
+      vector2_ptr += memory_size;
       scratch_ptr_batch++;
     }
   }
@@ -258,7 +263,7 @@ void EvalFloatSvdfReference(
     TfLiteContext* context, TfLiteNode* node, const TfLiteEvalTensor* input,
     const TfLiteEvalTensor* weights_feature,
     const TfLiteEvalTensor* weights_time, const TfLiteEvalTensor* bias,
-    const TfLiteSVDFParams* params, int scratch_tensor_index,
+    const TfLiteSVDFParams* params, int scratch_tensor_index, int* state_head,
     TfLiteEvalTensor* activation_state, TfLiteEvalTensor* output) {
   const int rank = params->rank;
   const int batch_size = input->dims->data[0];
@@ -284,29 +289,22 @@ void EvalFloatSvdfReference(
 
   float* output_ptr = tflite::micro::GetTensorData<float>(output);
 
-  // Left shift the activation_state.
-  {
-    float* new_state_start = state_ptr;
-    const float* old_state_start = state_ptr + 1;
-    const float* old_state_end =
-        state_ptr + batch_size * num_filters * memory_size;
-    while (old_state_start != old_state_end) {
-      *new_state_start++ = *old_state_start++;
-    }
-  }
+  // The activation_state is a ring buffer along the memory axis, see
+  // OpData::state_head. No shifting is needed.
+  const int state_tail = NextSvdfStateHead(*state_head, memory_size);
 
   // Note: no need to clear the latest activation, matmul is not accumulative.
 
   // Compute conv1d(inputs, weights_feature).
-  // The activation_state's rightmost column is used to save current cycle
-  // activation. This is achieved by starting at state_ptr[memory_size - 1] and
+  // The activation_state's head column is used to save current cycle
+  // activation. This is achieved by starting at state_ptr[*state_head] and
   // having the stride equal to memory_size.
 
   // Perform batched matrix vector multiply operation:
   {
     const float* matrix = weights_feature_ptr;
     const float* vector = input_ptr;
-    float* result = &state_ptr[memory_size - 1];
+    float* result = &state_ptr[*state_head];
     float* result_in_batch = result;
     for (int i = 0; i < batch_size; ++i) {
       const float* matrix_ptr = matrix;
@@ -323,8 +321,11 @@ void EvalFloatSvdfReference(
   }
 
   ApplyTimeWeightsBiasAndActivation(
-      batch_size, memory_size, num_filters, num_units, rank, weights_time_ptr,
-      bias_ptr, params->activation, state_ptr, scratch_ptr, output_ptr);
+      batch_size, memory_size, num_filters, num_units, rank, state_tail,
+      weights_time_ptr, bias_ptr, params->activation, state_ptr, scratch_ptr,
+      output_ptr);
+
+  *state_head = state_tail;
 }
 
 TfLiteStatus PrepareSvdf(TfLiteContext* context, TfLiteNode* node) {
@@ -403,6 +404,10 @@ TfLiteStatus PrepareSvdf(TfLiteContext* context, TfLiteNode* node) {
   TFLITE_DCHECK(node->user_data != nullptr);
   OpData* data = static_cast<OpData*>(node->user_data);
 
+  // The variable tensors are zeroed on allocation, so any head position is a
+  // valid starting point; start from the last column like the shifted layout.
+  data->state_head = memory_size - 1;
+
   if (input->type == kTfLiteInt8) {
     TF_LITE_ENSURE_EQ(context, weights_feature->type, kTfLiteInt8);
     TF_LITE_ENSURE_EQ(context, weights_time->type, kTfLiteInt16);
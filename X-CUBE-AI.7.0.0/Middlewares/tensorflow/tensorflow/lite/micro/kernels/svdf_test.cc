@@ -0,0 +1,466 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// The SVDF kernels keep the activation state as a ring buffer along the memory
+// axis (see OpData::state_head). These tests run the same SVDF for several
+// invokes, so that the head wraps around at least twice, against the shifted
+// state layout of the TFLite reference: every output and every state entry
+// (read back in the shifted order) must be bit-exact after each invoke.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "CMSIS/NN/Include/arm_nnfunctions.h"
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/micro/kernels/kernel_runner.h"
+#include "tensorflow/lite/micro/kernels/micro_ops.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+namespace tflite {
+namespace testing {
+namespace {
+
+constexpr int kMaxBatches = 3;
+constexpr int kMaxInputSize = 16;
+constexpr int kMaxFilters = 12;
+constexpr int kMaxMemorySize = 8;
+constexpr int kMaxUnits = kMaxFilters;
+constexpr int kMaxState = kMaxBatches * kMaxFilters * kMaxMemorySize;
+
+struct SvdfShape {
+  int batches;
+  int input_size;
+  int filters;
+  int rank;
+  int memory_size;
+};
+
+// Odd and even memory sizes, a single-column state, several batches and ranks.
+constexpr SvdfShape kShapes[] = {
+    {1, 3, 4, 2, 5}, {2, 5, 6, 2, 4}, {2, 8, 8, 1, 1}, {3, 13, 12, 3, 7},
+};
+
+// Invokes of a test, the head wraps around at least twice.
+int InvokeCount(const SvdfShape& shape) { return 2 * shape.memory_size + 2; }
+
+// Small deterministic generator, the tests do not depend on rand().
+uint32_t NextRandom(uint32_t* seed) {
+  *seed = *seed * 1664525u + 1013904223u;
+  return *seed >> 8;
+}
+
+int RandomInt(uint32_t* seed, int min, int max) {
+  return min + static_cast<int>(NextRandom(seed) %
+                                static_cast<uint32_t>(max - min + 1));
+}
+
+float RandomFloat(uint32_t* seed) {
+  return static_cast<float>(RandomInt(seed, -1000, 1000)) / 1000.0f;
+}
+
+// Column `j` (0: oldest) of the filter `f` of the batch `b` of a ring-buffered
+// state whose next write is at `head`, i.e. where the oldest entry lives.
+template <typename T>
+T RingStateAt(const T* state, const SvdfShape& shape, int head, int b, int f,
+              int j) {
+  const int m = shape.memory_size;
+  return state[(b * shape.filters + f) * m + (head + j) % m];
+}
+
+// Head after `invokes` invokes, it starts at the last column.
+int HeadAfter(const SvdfShape& shape, int invokes) {
+  return (shape.memory_size - 1 + invokes) % shape.memory_size;
+}
+
+// Float SVDF with the shifted state: the state is moved left by one column
+// and the new activation is written in the last one.
+void ShiftedSvdfFloat(const SvdfShape& shape, const float* input,
+                      const float* weights_feature, const float* weights_time,
+                      const float* bias, float* state, float* output) {
+  const int m = shape.memory_size;
+  const int units = shape.filters / shape.rank;
+  float scratch[kMaxBatches * kMaxFilters];
+
+  for (int b = 0; b < shape.batches; ++b) {
+    for (int f = 0; f < shape.filters; ++f) {
+      float* row = state + (b * shape.filters + f) * m;
+      for (int j = 0; j < m - 1; ++j) {
+        row[j] = row[j + 1];
+      }
+      float dot_prod = 0.0f;
+      for (int c = 0; c < shape.input_size; ++c) {
+        dot_prod += weights_feature[f * shape.input_size + c] *
+                    input[b * shape.input_size + c];
+      }
+      row[m - 1] = dot_prod;
+
+      scratch[b * shape.filters + f] = 0.0f;
+      for (int j = 0; j < m; ++j) {
+        scratch[b * shape.filters + f] += weights_time[f * m + j] * row[j];
+      }
+    }
+  }
+  for (int b = 0; b < shape.batches; ++b) {
+    for (int u = 0; u < units; ++u) {
+      float sum = bias[u];
+      for (int r = 0; r < shape.rank; ++r) {
+        sum += scratch[b * shape.filters + u * shape.rank + r];
+      }
+      output[b * units + u] = std::max(0.0f, sum);  // kTfLiteActRelu
+    }
+  }
+}
+
+struct SvdfInt8Quantization {
+  int32_t input_zero_point;
+  int32_t output_zero_point;
+  int32_t multiplier_1;
+  int shift_1;
+  int32_t multiplier_2;
+  int shift_2;
+};
+
+// Int8 SVDF with the shifted state, same arithmetic as the TFLite reference.
+void ShiftedSvdfInt8(const SvdfShape& shape, const SvdfInt8Quantization& q,
+                     const int8_t* input, const int8_t* weights_feature,
+                     const int16_t* weights_time, const int32_t* bias,
+                     int16_t* state, int8_t* output) {
+  const int m = shape.memory_size;
+  const int units = shape.filters / shape.rank;
+  int32_t scratch[kMaxBatches * kMaxFilters];
+
+  for (int b = 0; b < shape.batches; ++b) {
+    for (int f = 0; f < shape.filters; ++f) {
+      int16_t* row = state + (b * shape.filters + f) * m;
+      for (int j = 0; j < m - 1; ++j) {
+        row[j] = row[j + 1];
+      }
+      int32_t dot_prod = 0;
+      for (int c = 0; c < shape.input_size; ++c) {
+        dot_prod += weights_feature[f * shape.input_size + c] *
+                    (input[b * shape.input_size + c] - q.input_zero_point);
+      }
+      dot_prod =
+          MultiplyByQuantizedMultiplier(dot_prod, q.multiplier_1, q.shift_1);
+      row[m - 1] = static_cast<int16_t>(
+          std::min<int32_t>(std::max<int32_t>(dot_prod, INT16_MIN), INT16_MAX));
+
+      scratch[b * shape.filters + f] = 0;
+      for (int j = 0; j < m; ++j) {
+        scratch[b * shape.filters + f] += weights_time[f * m + j] * row[j];
+      }
+    }
+  }
+  for (int b = 0; b < shape.batches; ++b) {
+    for (int u = 0; u < units; ++u) {
+      int32_t sum = bias[u];
+      for (int r = 0; r < shape.rank; ++r) {
+        sum += scratch[b * shape.filters + u * shape.rank + r];
+      }
+      sum = MultiplyByQuantizedMultiplier(sum, q.multiplier_2, q.shift_2) +
+            q.output_zero_point;
+      output[b * units + u] = static_cast<int8_t>(
+          std::min<int32_t>(std::max<int32_t>(sum, INT8_MIN), INT8_MAX));
+    }
+  }
+}
+
+void TestSvdfFloatRingState(const SvdfShape& shape, uint32_t seed) {
+  const int units = shape.filters / shape.rank;
+  float input[kMaxBatches * kMaxInputSize];
+  float weights_feature[kMaxFilters * kMaxInputSize];
+  float weights_time[kMaxFilters * kMaxMemorySize];
+  float bias[kMaxUnits];
+  float state[kMaxState] = {};
+  float expected_state[kMaxState] = {};
+  float output[kMaxBatches * kMaxUnits];
+  float expected_output[kMaxBatches * kMaxUnits];
+
+  for (int i = 0; i < shape.filters * shape.input_size; ++i) {
+    weights_feature[i] = RandomFloat(&seed);
+  }
+  for (int i = 0; i < shape.filters * shape.memory_size; ++i) {
+    weights_time[i] = RandomFloat(&seed);
+  }
+  for (int i = 0; i < units; ++i) {
+    bias[i] = RandomFloat(&seed);
+  }
+
+  const int input_dims_data[] = {2, shape.batches, shape.input_size};
+  const int weights_feature_dims_data[] = {2, shape.filters, shape.input_size};
+  const int weights_time_dims_data[] = {2, shape.filters, shape.memory_size};
+  const int bias_dims_data[] = {1, units};
+  const int state_dims_data[] = {2, shape.batches,
+                                 shape.memory_size * shape.filters};
+  const int output_dims_data[] = {2, shape.batches, units};
+
+  TfLiteTensor tensors[] = {
+      CreateTensor(input, IntArrayFromInts(input_dims_data)),
+      CreateTensor(weights_feature, IntArrayFromInts(weights_feature_dims_data)),
+      CreateTensor(weights_time, IntArrayFromInts(weights_time_dims_data)),
+      CreateTensor(bias, IntArrayFromInts(bias_dims_data)),
+      CreateTensor(state, IntArrayFromInts(state_dims_data),
+                   /*is_variable=*/true),
+      CreateTensor(output, IntArrayFromInts(output_dims_data)),
+  };
+
+  const int inputs_array_data[] = {5, 0, 1, 2, 3, 4};
+  const int outputs_array_data[] = {1, 5};
+  TfLiteSVDFParams params = {shape.rank, kTfLiteActRelu, false};
+
+  const TfLiteRegistration registration = Register_SVDF();
+  micro::KernelRunner runner(registration, tensors,
+                             sizeof(tensors) / sizeof(tensors[0]),
+                             IntArrayFromInts(inputs_array_data),
+                             IntArrayFromInts(outputs_array_data), &params);
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.InitAndPrepare());
+
+  for (int invoke = 1; invoke <= InvokeCount(shape); ++invoke) {
+    for (int i = 0; i < shape.batches * shape.input_size; ++i) {
+      input[i] = RandomFloat(&seed);
+    }
+    TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+    ShiftedSvdfFloat(shape, input, weights_feature, weights_time, bias,
+                     expected_state, expected_output);
+
+    for (int i = 0; i < shape.batches * units; ++i) {
+      TF_LITE_MICRO_EXPECT_EQ(0, std::memcmp(&expected_output[i], &output[i],
+                                             sizeof(float)));
+    }
+    const int head = HeadAfter(shape, invoke);
+    for (int b = 0; b < shape.batches; ++b) {
+      for (int f = 0; f < shape.filters; ++f) {
+        for (int j = 0; j < shape.memory_size; ++j) {
+          const float value = RingStateAt(state, shape, head, b, f, j);
+          TF_LITE_MICRO_EXPECT_EQ(
+              0, std::memcmp(&expected_state[(b * shape.filters + f) *
+                                                 shape.memory_size +
+                                             j],
+                             &value, sizeof(float)));
+        }
+      }
+    }
+  }
+}
+
+void TestSvdfInt8RingState(const SvdfShape& shape, uint32_t seed) {
+  const int units = shape.filters / shape.rank;
+  int8_t input[kMaxBatches * kMaxInputSize];
+  int8_t weights_feature[kMaxFilters * kMaxInputSize];
+  int16_t weights_time[kMaxFilters * kMaxMemorySize];
+  int32_t bias[kMaxUnits];
+  int16_t state[kMaxState] = {};
+  int16_t expected_state[kMaxState] = {};
+  int8_t output[kMaxBatches * kMaxUnits];
+  int8_t expected_output[kMaxBatches * kMaxUnits];
+
+  for (int i = 0; i < shape.filters * shape.input_size; ++i) {
+    weights_feature[i] = static_cast<int8_t>(RandomInt(&seed, -128, 127));
+  }
+  for (int i = 0; i < shape.filters * shape.memory_size; ++i) {
+    weights_time[i] = static_cast<int16_t>(RandomInt(&seed, -4000, 4000));
+  }
+  for (int i = 0; i < units; ++i) {
+    bias[i] = RandomInt(&seed, -20000, 20000);
+  }
+
+  const float input_scale = 0.03f;
+  const int input_zero_point = 3;
+  const float weights_feature_scale = 0.01f;
+  const float state_scale = 0.0025f;
+  const float weights_time_scale = 0.0004f;
+  const float bias_scale = state_scale * weights_time_scale;
+  const float output_scale = 0.02f;
+  const int output_zero_point = -4;
+
+  const int input_dims_data[] = {2, shape.batches, shape.input_size};
+  const int weights_feature_dims_data[] = {2, shape.filters, shape.input_size};
+  const int weights_time_dims_data[] = {2, shape.filters, shape.memory_size};
+  const int bias_dims_data[] = {1, units};
+  const int state_dims_data[] = {2, shape.batches,
+                                 shape.memory_size * shape.filters};
+  const int output_dims_data[] = {2, shape.batches, units};
+
+  TfLiteTensor tensors[] = {
+      CreateQuantizedTensor(input, IntArrayFromInts(input_dims_data),
+                            input_scale, input_zero_point),
+      CreateQuantizedTensor(weights_feature,
+                            IntArrayFromInts(weights_feature_dims_data),
+                            weights_feature_scale, 0),
+      CreateQuantizedTensor(weights_time,
+                            IntArrayFromInts(weights_time_dims_data),
+                            weights_time_scale, 0),
+      CreateQuantizedTensor(bias, IntArrayFromInts(bias_dims_data), bias_scale,
+                            0),
+      CreateQuantizedTensor(state, IntArrayFromInts(state_dims_data),
+                            state_scale, 0, /*is_variable=*/true),
+      CreateQuantizedTensor(output, IntArrayFromInts(output_dims_data),
+                            output_scale, output_zero_point),
+  };
+
+  const int inputs_array_data[] = {5, 0, 1, 2, 3, 4};
+  const int outputs_array_data[] = {1, 5};
+  TfLiteSVDFParams params = {shape.rank, kTfLiteActNone, false};
+
+  const TfLiteRegistration registration = Register_SVDF();
+  micro::KernelRunner runner(registration, tensors,
+                             sizeof(tensors) / sizeof(tensors[0]),
+                             IntArrayFromInts(inputs_array_data),
+                             IntArrayFromInts(outputs_array_data), &params);
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.InitAndPrepare());
+
+  // Same effective scales as PrepareSvdf().
+  SvdfInt8Quantization q;
+  q.input_zero_point = input_zero_point;
+  q.output_zero_point = output_zero_point;
+  QuantizeMultiplier(static_cast<double>(input_scale * weights_feature_scale /
+                                         state_scale),
+                     &q.multiplier_1, &q.shift_1);
+  QuantizeMultiplier(static_cast<double>(state_scale * weights_time_scale /
+                                         output_scale),
+                     &q.multiplier_2, &q.shift_2);
+
+  for (int invoke = 1; invoke <= InvokeCount(shape); ++invoke) {
+    for (int i = 0; i < shape.batches * shape.input_size; ++i) {
+      input[i] = static_cast<int8_t>(RandomInt(&seed, -128, 127));
+    }
+    TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, runner.Invoke());
+    ShiftedSvdfInt8(shape, q, input, weights_feature, weights_time, bias,
+                    expected_state, expected_output);
+
+    for (int i = 0; i < shape.batches * units; ++i) {
+      TF_LITE_MICRO_EXPECT_EQ(expected_output[i], output[i]);
+    }
+    const int head = HeadAfter(shape, invoke);
+    for (int b = 0; b < shape.batches; ++b) {
+      for (int f = 0; f < shape.filters; ++f) {
+        for (int j = 0; j < shape.memory_size; ++j) {
+          TF_LITE_MICRO_EXPECT_EQ(
+              expected_state[(b * shape.filters + f) * shape.memory_size + j],
+              RingStateAt(state, shape, head, b, f, j));
+        }
+      }
+    }
+  }
+}
+
+// arm_svdf_s8() (shifted state) against arm_svdf_ring_s8().
+void TestCmsisNnSvdfRingState(const SvdfShape& shape, uint32_t seed) {
+  const int units = shape.filters / shape.rank;
+  int8_t input[kMaxBatches * kMaxInputSize];
+  int8_t weights_feature[kMaxFilters * kMaxInputSize];
+  int16_t weights_time[kMaxFilters * kMaxMemorySize];
+  int32_t bias[kMaxUnits];
+  int16_t shift_state[kMaxState] = {};
+  int16_t ring_state[kMaxState] = {};
+  int8_t shift_output[kMaxBatches * kMaxUnits];
+  int8_t ring_output[kMaxBatches * kMaxUnits];
+  int32_t buffer_a[kMaxBatches * kMaxFilters];
+  int32_t buffer_b[kMaxBatches * kMaxUnits];
+
+  for (int i = 0; i < shape.filters * shape.input_size; ++i) {
+    weights_feature[i] = static_cast<int8_t>(RandomInt(&seed, -128, 127));
+  }
+  for (int i = 0; i < shape.filters * shape.memory_size; ++i) {
+    weights_time[i] = static_cast<int16_t>(RandomInt(&seed, -32768, 32767));
+  }
+  for (int i = 0; i < units; ++i) {
+    bias[i] = RandomInt(&seed, -100000, 100000);
+  }
+
+  cmsis_nn_context input_ctx = {buffer_a, sizeof(buffer_a)};
+  cmsis_nn_context output_ctx = {buffer_b, sizeof(buffer_b)};
+  cmsis_nn_svdf_params svdf_params;
+  svdf_params.rank = shape.rank;
+  svdf_params.input_offset = -5;
+  svdf_params.output_offset = 7;
+  svdf_params.input_activation = {INT16_MIN, INT16_MAX};
+  svdf_params.output_activation = {INT8_MIN, INT8_MAX};
+  cmsis_nn_per_tensor_quant_params input_quant_params = {1500000000, -3};
+  cmsis_nn_per_tensor_quant_params output_quant_params = {1200000000, -14};
+  cmsis_nn_dims input_dims = {shape.batches, shape.input_size, 0, 0};
+  cmsis_nn_dims state_dims = {};
+  cmsis_nn_dims weights_feature_dims = {shape.filters, shape.input_size, 0, 0};
+  cmsis_nn_dims weights_time_dims = {shape.filters, shape.memory_size, 0, 0};
+  cmsis_nn_dims bias_dims = {units, 0, 0, 0};
+  cmsis_nn_dims output_dims = {shape.batches, units, 0, 0};
+
+  int head = shape.memory_size - 1;
+  for (int invoke = 1; invoke <= InvokeCount(shape); ++invoke) {
+    for (int i = 0; i < shape.batches * shape.input_size; ++i) {
+      input[i] = static_cast<int8_t>(RandomInt(&seed, -128, 127));
+    }
+    TF_LITE_MICRO_EXPECT_EQ(
+        ARM_MATH_SUCCESS,
+        arm_svdf_s8(&input_ctx, &output_ctx, &svdf_params, &input_quant_params,
+                    &output_quant_params, &input_dims, input, &state_dims,
+                    shift_state, &weights_feature_dims, weights_feature,
+                    &weights_time_dims, weights_time, &bias_dims, bias,
+                    &output_dims, shift_output));
+    TF_LITE_MICRO_EXPECT_EQ(
+        ARM_MATH_SUCCESS,
+        arm_svdf_ring_s8(&input_ctx, &output_ctx, &svdf_params,
+                         &input_quant_params, &output_quant_params,
+                         &input_dims, input, &state_dims, ring_state, head,
+                         &weights_feature_dims, weights_feature,
+                         &weights_time_dims, weights_time, &bias_dims, bias,
+                         &output_dims, ring_output));
+    head = (head + 1 == shape.memory_size) ? 0 : head + 1;
+    TF_LITE_MICRO_EXPECT_EQ(head, HeadAfter(shape, invoke));
+
+    TF_LITE_MICRO_EXPECT_EQ(
+        0, std::memcmp(shift_output, ring_output, shape.batches * units));
+    for (int b = 0; b < shape.batches; ++b) {
+      for (int f = 0; f < shape.filters; ++f) {
+        for (int j = 0; j < shape.memory_size; ++j) {
+          TF_LITE_MICRO_EXPECT_EQ(
+              shift_state[(b * shape.filters + f) * shape.memory_size + j],
+              RingStateAt(ring_state, shape, head, b, f, j));
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace tflite
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(SvdfFloatRingStateMatchesShiftedState) {
+  for (const auto& shape : tflite::testing::kShapes) {
+    tflite::testing::TestSvdfFloatRingState(shape, 1);
+  }
+}
+
+TF_LITE_MICRO_TEST(SvdfInt8RingStateMatchesShiftedState) {
+  for (const auto& shape : tflite::testing::kShapes) {
+    tflite::testing::TestSvdfInt8RingState(shape, 2);
+  }
+}
+
+TF_LITE_MICRO_TEST(CmsisNnSvdfRingStateMatchesShiftedState) {
+  for (const auto& shape : tflite::testing::kShapes) {
+    tflite::testing::TestCmsisNnSvdfRingState(shape, 3);
+  }
+}
+
+TF_LITE_MICRO_TESTS_END
@@ -66,6 +66,10 @@ TfLiteStatus UnpackImpl(TfLiteContext* context, TfLiteNode* node,
       T* output_ptr = output_data + copy_size * k;
       int loc = k * output_count * copy_size + i * copy_size;
       const T* input_ptr = input_data + loc;
+      // The output can be a slice of the input (see MicroAllocator).
+      if (output_ptr == input_ptr) {
+        continue;
+      }
       for (int j = 0; j < copy_size; ++j) output_ptr[j] = input_ptr[j];
     }
   }
@@ -73,6 +73,9 @@ TfLiteStatus GreedyMemoryPlanner::AddBuffer(
     return kTfLiteError;
   }
   BufferRequirements* current = &requirements_[buffer_count_];
+  if (line_size_ > 0) {
+    size = (size + line_size_ - 1) & ~(line_size_ - 1);
+  }
   current->size = size;
   current->first_time_used = first_time_used;
   current->last_time_used = last_time_used;
@@ -90,10 +93,17 @@ TfLiteStatus GreedyMemoryPlanner::AddBuffer(
       kTfLiteOk) {
     return kTfLiteError;
   }
+  // The offline planned buffers keep their size.
+  current->size = size;
   current->offline_offset = offline_offset;
   return kTfLiteOk;
 }
 
+void GreedyMemoryPlanner::SetCacheAwarePlacement(int line_size) {
+  line_size_ = line_size;
+  need_to_calculate_offsets_ = true;
+}
+
 bool GreedyMemoryPlanner::DoesEntryOverlapInTime(
     const GreedyMemoryPlanner::ListEntry* entry, const int first_time_used,
     const int last_time_used) const {
@@ -137,12 +147,109 @@ GreedyMemoryPlanner::NextSimultaneouslyActiveBuffer(
   return result;
 }
 
+bool GreedyMemoryPlanner::AreUsedBySameNode(int a_index, int b_index) const {
+  const BufferRequirements* a = &requirements_[a_index];
+  const BufferRequirements* b = &requirements_[b_index];
+  return (a->first_time_used == b->first_time_used) ||
+         (a->first_time_used == b->last_time_used) ||
+         (a->last_time_used == b->first_time_used) ||
+         (a->last_time_used == b->last_time_used);
+}
+
+int GreedyMemoryPlanner::DistanceToRelatedBuffers(int buffer_id,
+                                                  int offset) const {
+  const int end = offset + requirements_[buffer_id].size;
+  int distance = -1;
+  int entry_index = first_entry_index_;
+  while (entry_index != -1) {
+    const ListEntry* entry = &buffers_sorted_by_offset_[entry_index];
+    entry_index = entry->next_entry_index;
+    if (!AreUsedBySameNode(buffer_id, entry->requirements_index)) {
+      continue;
+    }
+    const int entry_end =
+        entry->offset + requirements_[entry->requirements_index].size;
+    const int current = (entry->offset >= end) ? entry->offset - end
+                                               : offset - entry_end;
+    if ((current >= 0) && ((distance == -1) || (current < distance))) {
+      distance = current;
+    }
+  }
+  return distance;
+}
+
+int GreedyMemoryPlanner::CacheAwareOffset(int buffer_id, int first_fit_offset,
+                                          int peak) {
+  const BufferRequirements* wanted_requirements = &requirements_[buffer_id];
+  const int wanted_size = wanted_requirements->size;
+  const int max_end = (first_fit_offset + wanted_size > peak)
+                          ? first_fit_offset + wanted_size
+                          : peak;
+
+  int best_offset = first_fit_offset;
+  int best_distance = DistanceToRelatedBuffers(buffer_id, first_fit_offset);
+  if (best_distance == 0) {
+    return best_offset;
+  }
+
+  // Same walk as the first fit search, both ends of each large enough gap
+  // are candidates.
+  ListEntry* prior_entry = nullptr;
+  int gap_start = 0;
+  while (true) {
+    ListEntry* next_entry = NextSimultaneouslyActiveBuffer(
+        prior_entry, wanted_requirements->first_time_used,
+        wanted_requirements->last_time_used);
+    if (prior_entry) {
+      const int prior_end =
+          prior_entry->offset + requirements_[prior_entry->requirements_index].size;
+      if (prior_end > gap_start) {
+        gap_start = prior_end;
+      }
+    }
+    const int gap_end = next_entry ? next_entry->offset : max_end;
+    if (gap_end - gap_start >= wanted_size) {
+      const int candidates[2] = {
+          gap_start, (gap_end - wanted_size) & ~(line_size_ - 1)};
+      for (int offset : candidates) {
+        if (offset < gap_start) {
+          continue;
+        }
+        const int distance = DistanceToRelatedBuffers(buffer_id, offset);
+        if ((distance != -1) &&
+            ((best_distance == -1) || (distance < best_distance))) {
+          best_distance = distance;
+          best_offset = offset;
+        }
+      }
+    }
+    if ((next_entry == nullptr) || (best_distance == 0)) {
+      break;
+    }
+    prior_entry = next_entry;
+  }
+  return best_offset;
+}
+
 void GreedyMemoryPlanner::CalculateOffsetsIfNeeded() {
   if (!need_to_calculate_offsets_ || (buffer_count_ == 0)) {
     return;
   }
   need_to_calculate_offsets_ = false;
 
+  if (line_size_ > 0) {
+    // The cache-aware placement is only kept if it does not need more memory
+    // than the first fit one.
+    const int first_fit_peak = PlaceBuffers(false);
+    if (PlaceBuffers(true) > first_fit_peak) {
+      PlaceBuffers(false);
+    }
+  } else {
+    PlaceBuffers(false);
+  }
+}
+
+int GreedyMemoryPlanner::PlaceBuffers(bool cache_aware) {
   // Start off by ordering the buffers in descending order of size.
   // This helps find a more compact layout. Intuitively, you can think
   // about putting the large buffers in place first, and then the
@@ -187,6 +294,8 @@ void GreedyMemoryPlanner::CalculateOffsetsIfNeeded() {
     buffer_offsets_[buffer_id] = 0;
   }
   first_entry->offset = buffer_offsets_[buffer_id];
+  // High-water mark of the buffers placed so far.
+  int peak = first_entry->offset + requirements_[buffer_id].size;
 
   // Work through the rest of the buffers to find a good gap to place each one.
   for (int i = 1; i < buffer_count_; ++i) {
@@ -237,10 +346,17 @@ void GreedyMemoryPlanner::CalculateOffsetsIfNeeded() {
         // The gap wasn't big enough, so move on to another candidate.
         prior_entry = next_entry;
       }
+      if (cache_aware) {
+        candidate_offset =
+            CacheAwareOffset(buffer_id, candidate_offset, peak);
+      }
     } else {
       // Offline planned offset are to be considered constant
       candidate_offset = wanted_requirements->offline_offset;
     }
+    if (candidate_offset + wanted_size > peak) {
+      peak = candidate_offset + wanted_size;
+    }
     // At this point, we've either found a gap (possibly at the end of the
     // list) and want to place the buffer there, or there are no other active
     // buffers in this time range and so we can put it at offset zero.
@@ -285,6 +401,7 @@ void GreedyMemoryPlanner::CalculateOffsetsIfNeeded() {
       }
     }
   }
+  return peak;
 }
 
 size_t GreedyMemoryPlanner::GetMaximumMemorySize() {
@@ -43,6 +43,14 @@ constexpr int kOnlinePlannedBuffer = -1;
 //
 // This is not guaranteed to produce the best placement, since that's an
 // NP-Complete problem, but in practice it should produce one that's decent.
+//
+// With the cache-aware placement (SetCacheAwarePlacement()), the sizes are
+// rounded up to a cache line and a buffer is not always put in the first gap:
+// among the gaps which do not raise the high-water mark more than the first
+// one, it goes at the start or the end of the gap closest to a buffer used by
+// the same node (i.e. the input of the node which creates it). The buffers
+// touched back-to-back stay contiguous instead of sharing cache sets. The
+// first fit plan is kept when the cache-aware one needs more memory.
 class GreedyMemoryPlanner : public MemoryPlanner {
  public:
   // You need to pass in an area of memory to be used for planning. This memory
@@ -61,6 +69,13 @@ class GreedyMemoryPlanner : public MemoryPlanner {
   TfLiteStatus AddBuffer(ErrorReporter* error_reporter, int size,
                          int first_time_used, int last_time_used) override;
 
+  // Enables the cache-aware placement with a `line_size` bytes cache line
+  // (power of 2), 0 disables it (default). It should be called before the
+  // buffers are added. The offsets are multiples of the line size, the base
+  // address of the arena should be aligned on it. The plan takes
+  // O(buffers^3) steps instead of O(buffers^2).
+  void SetCacheAwarePlacement(int line_size);
+
   // Record details of an offline planned buffer offset we want to place.
   // offline_offset is the buffer offset from the start of the arena.
   TfLiteStatus AddBuffer(ErrorReporter* error_reporter, int size,
@@ -119,6 +134,21 @@ class GreedyMemoryPlanner : public MemoryPlanner {
   // If there isn't an up to date plan, calculate a new one.
   void CalculateOffsetsIfNeeded();
 
+  // Places all the buffers, returns the high-water mark of the plan.
+  int PlaceBuffers(bool cache_aware);
+
+  // Whether two buffers can be used by a same node: one is created or last
+  // used when the other is.
+  bool AreUsedBySameNode(int a_index, int b_index) const;
+
+  // Distance in bytes between a placement of a buffer and the closest placed
+  // buffer used by a same node, -1 if there are none.
+  int DistanceToRelatedBuffers(int buffer_id, int offset) const;
+
+  // Offset of the cache-aware placement of a buffer, the high-water mark of
+  // the plan is not raised more than by the first fit placement.
+  int CacheAwareOffset(int buffer_id, int first_fit_offset, int peak);
+
   // How many buffers we can plan for, based on the arena size we're given in
   // the constructor.
   int max_buffer_count_;
@@ -155,6 +185,9 @@ class GreedyMemoryPlanner : public MemoryPlanner {
   // Whether buffers have been added since the last plan was calculated.
   bool need_to_calculate_offsets_;
 
+  // Cache line size of the cache-aware placement, 0 if disabled.
+  int line_size_ = 0;
+
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
 
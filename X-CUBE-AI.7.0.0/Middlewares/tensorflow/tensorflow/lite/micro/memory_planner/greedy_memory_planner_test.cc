@@ -0,0 +1,145 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+namespace {
+constexpr int kScratchBufferSize = 4096;
+unsigned char g_scratch_buffer[kScratchBufferSize];
+unsigned char g_first_fit_scratch_buffer[kScratchBufferSize];
+
+struct Buffer {
+  int size;
+  int first_time_used;
+  int last_time_used;
+};
+
+// Plans `buffers` with the cache-aware placement and with the first fit one
+// on the same line-rounded sizes, and checks that the cache-aware plan has
+// line-aligned offsets, no overlaps, and a peak no higher than first fit.
+void TestCacheAwarePlan(tflite::GreedyMemoryPlanner* planner,
+                        tflite::GreedyMemoryPlanner* first_fit_planner,
+                        const Buffer* buffers, int buffer_count,
+                        int line_size) {
+  tflite::MicroErrorReporter micro_error_reporter;
+  planner->SetCacheAwarePlacement(line_size);
+  for (int i = 0; i < buffer_count; ++i) {
+    const Buffer& buffer = buffers[i];
+    TF_LITE_MICRO_EXPECT_EQ(
+        kTfLiteOk,
+        planner->AddBuffer(&micro_error_reporter, buffer.size,
+                           buffer.first_time_used, buffer.last_time_used));
+    const int rounded_size = (buffer.size + line_size - 1) & ~(line_size - 1);
+    TF_LITE_MICRO_EXPECT_EQ(
+        kTfLiteOk, first_fit_planner->AddBuffer(
+                       &micro_error_reporter, rounded_size,
+                       buffer.first_time_used, buffer.last_time_used));
+  }
+  for (int i = 0; i < buffer_count; ++i) {
+    int offset = -1;
+    TF_LITE_MICRO_EXPECT_EQ(
+        kTfLiteOk, planner->GetOffsetForBuffer(&micro_error_reporter, i,
+                                               &offset));
+    TF_LITE_MICRO_EXPECT_GE(offset, 0);
+    TF_LITE_MICRO_EXPECT_EQ(0, offset % line_size);
+  }
+  TF_LITE_MICRO_EXPECT_FALSE(
+      planner->DoAnyBuffersOverlap(&micro_error_reporter));
+  TF_LITE_MICRO_EXPECT_LE(planner->GetMaximumMemorySize(),
+                          first_fit_planner->GetMaximumMemorySize());
+}
+
+}  // namespace
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(TestCacheAwareKeepsNodeBuffersContiguous) {
+  tflite::MicroErrorReporter micro_error_reporter;
+  tflite::GreedyMemoryPlanner planner(g_scratch_buffer, kScratchBufferSize);
+  tflite::GreedyMemoryPlanner first_fit_planner(g_first_fit_scratch_buffer,
+                                                kScratchBufferSize);
+  // Buffer 2 is the input of the node creating buffer 3. First fit puts it
+  // at 0, the cache-aware placement right before buffer 3.
+  const Buffer buffers[] = {{75, 2, 3}, {7, 5, 7}, {4, 0, 1}, {16, 1, 3}};
+  TestCacheAwarePlan(&planner, &first_fit_planner, buffers, 4, 32);
+  TF_LITE_MICRO_EXPECT_EQ(static_cast<size_t>(128),
+                          planner.GetMaximumMemorySize());
+
+  int offset = -1;
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk,
+      first_fit_planner.GetOffsetForBuffer(&micro_error_reporter, 2, &offset));
+  TF_LITE_MICRO_EXPECT_EQ(0, offset);
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk, planner.GetOffsetForBuffer(&micro_error_reporter, 2, &offset));
+  TF_LITE_MICRO_EXPECT_EQ(64, offset);
+  TF_LITE_MICRO_EXPECT_EQ(
+      kTfLiteOk, planner.GetOffsetForBuffer(&micro_error_reporter, 3, &offset));
+  TF_LITE_MICRO_EXPECT_EQ(96, offset);
+}
+
+TF_LITE_MICRO_TEST(TestCacheAwareFallsBackToFirstFit) {
+  tflite::MicroErrorReporter micro_error_reporter;
+  tflite::GreedyMemoryPlanner planner(g_scratch_buffer, kScratchBufferSize);
+  tflite::GreedyMemoryPlanner first_fit_planner(g_first_fit_scratch_buffer,
+                                                kScratchBufferSize);
+  // The cache-aware placement of these buffers takes 96 bytes, first fit 80
+  // bytes: the first fit plan is kept.
+  const Buffer buffers[] = {
+      {6, 2, 4}, {43, 0, 1}, {6, 3, 3}, {18, 2, 2}, {21, 0, 2}};
+  TestCacheAwarePlan(&planner, &first_fit_planner, buffers, 5, 16);
+  TF_LITE_MICRO_EXPECT_EQ(static_cast<size_t>(80),
+                          planner.GetMaximumMemorySize());
+  for (int i = 0; i < 5; ++i) {
+    int offset = -1;
+    int first_fit_offset = -1;
+    TF_LITE_MICRO_EXPECT_EQ(
+        kTfLiteOk,
+        planner.GetOffsetForBuffer(&micro_error_reporter, i, &offset));
+    TF_LITE_MICRO_EXPECT_EQ(
+        kTfLiteOk, first_fit_planner.GetOffsetForBuffer(&micro_error_reporter,
+                                                        i, &first_fit_offset));
+    TF_LITE_MICRO_EXPECT_EQ(first_fit_offset, offset);
+  }
+}
+
+TF_LITE_MICRO_TEST(TestCacheAwareRandomPlans) {
+  // Random plans of 3 to 24 buffers with 16, 32 and 64 bytes lines.
+  unsigned int seed = 1;
+  auto random = [&seed](int range) {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<int>((seed >> 16) % range);
+  };
+  Buffer buffers[24];
+  for (int plan = 0; plan < 500; ++plan) {
+    const int line_size = 16 << random(3);
+    const int buffer_count = 3 + random(22);
+    for (int i = 0; i < buffer_count; ++i) {
+      buffers[i].size = 1 + random(8 * line_size);
+      buffers[i].first_time_used = random(12);
+      buffers[i].last_time_used = buffers[i].first_time_used + random(4);
+    }
+    tflite::GreedyMemoryPlanner planner(g_scratch_buffer, kScratchBufferSize);
+    tflite::GreedyMemoryPlanner first_fit_planner(g_first_fit_scratch_buffer,
+                                                  kScratchBufferSize);
+    TestCacheAwarePlan(&planner, &first_fit_planner, buffers, buffer_count,
+                       line_size);
+  }
+}
+
+TF_LITE_MICRO_TESTS_END
@@ -19,6 +19,7 @@ limitations under the License.
 #include <cstdint>
 
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/flatbuffer_conversions.h"
@@ -54,6 +55,15 @@ struct AllocationInfo {
   int last_used;
   int32_t offline_offset;
   bool needs_allocating;
+  // 0: head of the arena, n: additional arena region n-1.
+  int region;
+  // Index of the tensor whose buffer is shared (-1: own buffer) and offset
+  // in this buffer.
+  int alias_of;
+  size_t alias_offset;
+  // Lifetime set by MicroAllocator::ExtendTensorLifetime(), the buffer is not
+  // shared.
+  bool exclusive;
 };
 
 // We align tensor buffers to 16-byte boundaries, since this is a common
@@ -168,10 +178,32 @@ class AllocationInfoBuilder {
       const Model* model, const int32_t** offline_planner_offsets);
 
   // Add allocaiton information for the tensors.
+  // Tensor lifetimes are taken from the node input/output lists rather than
+  // from the flatbuffer operators, so graph rewrites made before the plan is
+  // committed are honoured. Tensors no node references are not allocated.
   TfLiteStatus AddTensors(const SubGraph* subgraph,
+                          const NodeAndRegistration* node_and_registrations,
                           const int32_t* offline_offsets,
                           TfLiteEvalTensor* eval_tensors);
 
+  // Extends the lifetime of the tensors, their buffer is not shared by
+  // AddAliases(). Must be called after AddTensors().
+  void ExtendLifetimes(const TensorLifetime* lifetimes, int count);
+
+  // Let tensors share the buffer of another tensor instead of being copied:
+  //  - the output of the view operators (RESHAPE, SQUEEZE, EXPAND_DIMS) and of
+  //    the in-place elementwise operators is the buffer of their first input,
+  //    when this input is not used after the node.
+  //  - the inputs of a CONCATENATION are slices of its output and the outputs
+  //    of SPLIT, SPLIT_V and UNPACK are slices of their input, when the axis
+  //    is the outermost non-trivial one (contiguous slices).
+  // The aliased tensors are not planned, their buffer is set by
+  // CommitAliases(). Must be called after AddTensors(), not with offline
+  // planned offsets.
+  void AddAliases(const SubGraph* subgraph,
+                  const NodeAndRegistration* node_and_registrations,
+                  TfLiteEvalTensor* eval_tensors);
+
   // Add allocation information for the scratch buffers.
   TfLiteStatus AddScratchBuffers(
       internal::ScratchBufferRequest* scratch_buffer_requests,
@@ -180,16 +212,47 @@ class AllocationInfoBuilder {
   // Returns a pointer to the built AllocationInfo array.
   const AllocationInfo* Finish() const { return info_; }
 
+  // Copies removed by AddAliases() (the in-place operators are not counted).
+  int elided_copies() const { return elided_copies_; }
+  size_t elided_copy_bytes() const { return elided_copy_bytes_; }
+
  private:
+  // Tensor owning the buffer of `tensor_index` and offset in this buffer.
+  int Root(int tensor_index) const {
+    return (info_[tensor_index].alias_of != -1) ? info_[tensor_index].alias_of
+                                                 : tensor_index;
+  }
+  size_t Offset(int tensor_index) const {
+    return (info_[tensor_index].alias_of != -1)
+               ? info_[tensor_index].alias_offset
+               : 0;
+  }
+  // Online planned tensor owning its buffer.
+  bool IsAliasable(int tensor_index) const;
+  bool SharesBufferWith(const flatbuffers::Vector<int32_t>* tensors,
+                        int root_index) const;
+  // Makes `tensor_index` share the buffer of `parent_index` at `offset`
+  // bytes, the lifetime of the shared buffer covers both tensors.
+  void SetAlias(int tensor_index, int parent_index, size_t offset);
+  void AddUnaryAlias(const SubGraph* subgraph, const TfLiteNode& node,
+                     int node_index, bool in_place);
+  void AddConcatAliases(const SubGraph* subgraph, const TfLiteNode& node,
+                        TfLiteEvalTensor* eval_tensors);
+  void AddSplitAliases(const TfLiteNode& node, int input_index, int axis,
+                       TfLiteEvalTensor* eval_tensors);
+
   AllocationInfo* info_ = nullptr;
   size_t tensor_count_ = 0;
   size_t buffer_count_ = 0;
   ErrorReporter* reporter_ = nullptr;
+  int elided_copies_ = 0;
+  size_t elided_copy_bytes_ = 0;
 };
 
-TfLiteStatus AllocationInfoBuilder::AddTensors(const SubGraph* subgraph,
-                                               const int32_t* offline_offsets,
-                                               TfLiteEvalTensor* eval_tensors) {
+TfLiteStatus AllocationInfoBuilder::AddTensors(
+    const SubGraph* subgraph, const NodeAndRegistration* node_and_registrations,
+    const int32_t* offline_offsets, TfLiteEvalTensor* eval_tensors) {
+  TFLITE_DCHECK(node_and_registrations != nullptr);
   TFLITE_DCHECK(eval_tensors != nullptr);
 
   // Set up allocation info for all tensors.
@@ -204,6 +267,10 @@ TfLiteStatus AllocationInfoBuilder::AddTensors(const SubGraph* subgraph,
     current->last_used = -1;
     current->needs_allocating = (eval_tensors[i].data.data == nullptr) &&
                                 (!subgraph->tensors()->Get(i)->is_variable());
+    current->region = 0;
+    current->alias_of = -1;
+    current->alias_offset = 0;
+    current->exclusive = false;
     if (offline_offsets) {
       current->offline_offset = offline_offsets[i];
     } else {
@@ -226,16 +293,19 @@ TfLiteStatus AllocationInfoBuilder::AddTensors(const SubGraph* subgraph,
 
   // Figure out when the first and last use of each tensor is.
   for (int i = (subgraph->operators()->size() - 1); i >= 0; --i) {
-    const auto* op = subgraph->operators()->Get(i);
-    for (size_t n = 0; n < op->inputs()->size(); ++n) {
-      const int tensor_index = op->inputs()->Get(n);
+    const TfLiteNode& node = node_and_registrations[i].node;
+    for (int n = 0; n < node.inputs->size; ++n) {
+      const int tensor_index = node.inputs->data[n];
+      if (tensor_index < 0) {
+        continue;  // Omitted optional input.
+      }
       AllocationInfo* current = &info_[tensor_index];
       if (((current->last_used == -1) || (current->last_used < i))) {
         current->last_used = i;
       }
     }
-    for (size_t n = 0; n < op->outputs()->size(); ++n) {
-      const int tensor_index = op->outputs()->Get(n);
+    for (int n = 0; n < node.outputs->size; ++n) {
+      const int tensor_index = node.outputs->data[n];
       AllocationInfo* current = &info_[tensor_index];
       if ((current->first_created == -1) || (current->first_created > i)) {
         current->first_created = i;
@@ -246,6 +316,11 @@ TfLiteStatus AllocationInfoBuilder::AddTensors(const SubGraph* subgraph,
   // Sanity check for valid tensor lifetime.
   for (size_t i = 0; i < tensor_count_; ++i) {
     AllocationInfo* current = &info_[i];
+    // Tensors left without producer and consumer by a graph rewrite.
+    if ((current->first_created == -1) && (current->last_used == -1)) {
+      current->needs_allocating = false;
+      continue;
+    }
     // Even though tensor appears to be read only it may still need to be
     // allocated.
     const bool appears_read_only =
@@ -265,6 +340,255 @@ TfLiteStatus AllocationInfoBuilder::AddTensors(const SubGraph* subgraph,
   return kTfLiteOk;
 }
 
+// View operators: the output is the input with another shape.
+bool IsViewOperator(int32_t builtin_code) {
+  return builtin_code == BuiltinOperator_RESHAPE ||
+         builtin_code == BuiltinOperator_SQUEEZE ||
+         builtin_code == BuiltinOperator_EXPAND_DIMS;
+}
+
+// Elementwise operators which read an element before writing it, at the same
+// offset: the output can be written over the input. Only the outputs with the
+// size of the input are aliased (QUANTIZE: requantization to a type of the
+// same width).
+bool IsInPlaceOperator(int32_t builtin_code) {
+  switch (builtin_code) {
+    case BuiltinOperator_RELU:
+    case BuiltinOperator_RELU6:
+    case BuiltinOperator_LOGISTIC:
+    case BuiltinOperator_TANH:
+    case BuiltinOperator_QUANTIZE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Number of slices along the dimensions before `axis`. The slices along
+// `axis` are contiguous when it is 1.
+int OuterSize(const TfLiteIntArray* dims, int axis) {
+  int outer_size = 1;
+  for (int i = 0; i < axis; ++i) {
+    outer_size *= dims->data[i];
+  }
+  return outer_size;
+}
+
+bool IsSubgraphTensor(const flatbuffers::Vector<int32_t>* tensors,
+                      int tensor_index) {
+  for (size_t i = 0; i < tensors->size(); ++i) {
+    if (tensors->Get(i) == tensor_index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AllocationInfoBuilder::ExtendLifetimes(const TensorLifetime* lifetimes,
+                                            int count) {
+  for (int i = 0; i < count; ++i) {
+    AllocationInfo* current = &info_[lifetimes[i].tensor_index];
+    if (current->first_created == -1 ||
+        current->first_created > lifetimes[i].first_node) {
+      current->first_created = lifetimes[i].first_node;
+    }
+    if (current->last_used < lifetimes[i].last_node) {
+      current->last_used = lifetimes[i].last_node;
+    }
+    current->exclusive = true;
+  }
+}
+
+bool AllocationInfoBuilder::IsAliasable(int tensor_index) const {
+  const AllocationInfo* current = &info_[tensor_index];
+  return current->needs_allocating &&
+         current->offline_offset == kOnlinePlannedBuffer &&
+         current->alias_of == -1 && !current->exclusive;
+}
+
+bool AllocationInfoBuilder::SharesBufferWith(
+    const flatbuffers::Vector<int32_t>* tensors, int root_index) const {
+  for (size_t i = 0; i < tensors->size(); ++i) {
+    if (Root(tensors->Get(i)) == root_index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AllocationInfoBuilder::SetAlias(int tensor_index, int parent_index,
+                                     size_t offset) {
+  offset += Offset(parent_index);
+  parent_index = Root(parent_index);
+  AllocationInfo* parent = &info_[parent_index];
+  AllocationInfo* current = &info_[tensor_index];
+
+  // The tensors sharing the buffer of `tensor_index` follow it.
+  for (size_t i = 0; i < tensor_count_; ++i) {
+    if (info_[i].alias_of == tensor_index) {
+      info_[i].alias_of = parent_index;
+      info_[i].alias_offset += offset;
+    }
+  }
+  if (current->first_created < parent->first_created) {
+    parent->first_created = current->first_created;
+  }
+  if (current->last_used > parent->last_used) {
+    parent->last_used = current->last_used;
+  }
+  current->alias_of = parent_index;
+  current->alias_offset = offset;
+  current->needs_allocating = false;
+}
+
+void AllocationInfoBuilder::AddUnaryAlias(const SubGraph* subgraph,
+                                          const TfLiteNode& node,
+                                          int node_index, bool in_place) {
+  if (node.inputs->size < 1 || node.outputs->size != 1) {
+    return;
+  }
+  const int input_index = node.inputs->data[0];
+  const int output_index = node.outputs->data[0];
+  if (input_index < 0 || input_index == output_index ||
+      !IsAliasable(output_index) ||
+      info_[output_index].bytes != info_[input_index].bytes ||
+      info_[input_index].last_used != node_index) {
+    return;
+  }
+  const int root_index = Root(input_index);
+  const AllocationInfo* root = &info_[root_index];
+  if (!root->needs_allocating || root->exclusive ||
+      root->offline_offset != kOnlinePlannedBuffer) {
+    return;
+  }
+  // The operator writes the buffer: it must not be read after the node, the
+  // inputs and the outputs of the model keep their value across the
+  // inferences.
+  if (in_place && (root->last_used != node_index ||
+                   SharesBufferWith(subgraph->inputs(), root_index) ||
+                   SharesBufferWith(subgraph->outputs(), root_index))) {
+    return;
+  }
+  SetAlias(output_index, input_index, 0);
+  if (!in_place) {
+    ++elided_copies_;
+    elided_copy_bytes_ += info_[output_index].bytes;
+  }
+}
+
+void AllocationInfoBuilder::AddConcatAliases(const SubGraph* subgraph,
+                                             const TfLiteNode& node,
+                                             TfLiteEvalTensor* eval_tensors) {
+  const TfLiteConcatenationParams* params =
+      reinterpret_cast<const TfLiteConcatenationParams*>(node.builtin_data);
+  const int output_index = node.outputs->data[0];
+  const TfLiteIntArray* dims = eval_tensors[output_index].dims;
+  const int axis = (params->axis < 0) ? params->axis + dims->size
+                                      : params->axis;
+  // UINT8 inputs are requantized.
+  if (!IsAliasable(output_index) || OuterSize(dims, axis) != 1 ||
+      subgraph->tensors()->Get(output_index)->type() == TensorType_UINT8) {
+    return;
+  }
+  size_t bytes = 0;
+  for (int n = 0; n < node.inputs->size; ++n) {
+    bytes += info_[node.inputs->data[n]].bytes;
+  }
+  if (bytes != info_[output_index].bytes) {
+    return;
+  }
+
+  // The producers of the inputs write in the output.
+  size_t offset = 0;
+  for (int n = 0; n < node.inputs->size; ++n) {
+    const int input_index = node.inputs->data[n];
+    const size_t input_bytes = info_[input_index].bytes;
+    bool aliasable = IsAliasable(input_index) &&
+                     info_[input_index].first_created >= 0 &&
+                     !IsSubgraphTensor(subgraph->inputs(), input_index) &&
+                     !IsSubgraphTensor(subgraph->outputs(), input_index);
+    for (int m = 0; aliasable && m < node.inputs->size; ++m) {
+      aliasable = (m == n) || (node.inputs->data[m] != input_index);
+    }
+    if (aliasable) {
+      SetAlias(input_index, output_index, offset);
+      ++elided_copies_;
+      elided_copy_bytes_ += input_bytes;
+    }
+    offset += input_bytes;
+  }
+}
+
+void AllocationInfoBuilder::AddSplitAliases(const TfLiteNode& node,
+                                            int input_index, int axis,
+                                            TfLiteEvalTensor* eval_tensors) {
+  const AllocationInfo* root = &info_[Root(input_index)];
+  const TfLiteIntArray* dims = eval_tensors[input_index].dims;
+  if (axis < 0) {
+    axis += dims->size;
+  }
+  if (!root->needs_allocating || root->exclusive ||
+      root->offline_offset != kOnlinePlannedBuffer ||
+      OuterSize(dims, axis) != 1) {
+    return;
+  }
+  size_t bytes = 0;
+  for (int n = 0; n < node.outputs->size; ++n) {
+    if (!IsAliasable(node.outputs->data[n])) {
+      return;
+    }
+    bytes += info_[node.outputs->data[n]].bytes;
+  }
+  if (bytes != info_[input_index].bytes) {
+    return;
+  }
+
+  // The outputs are read in the input.
+  size_t offset = 0;
+  for (int n = 0; n < node.outputs->size; ++n) {
+    const int output_index = node.outputs->data[n];
+    const size_t output_bytes = info_[output_index].bytes;
+    SetAlias(output_index, input_index, offset);
+    ++elided_copies_;
+    elided_copy_bytes_ += output_bytes;
+    offset += output_bytes;
+  }
+}
+
+void AllocationInfoBuilder::AddAliases(
+    const SubGraph* subgraph, const NodeAndRegistration* node_and_registrations,
+    TfLiteEvalTensor* eval_tensors) {
+  for (size_t i = 0; i < subgraph->operators()->size(); ++i) {
+    const NodeAndRegistration& current = node_and_registrations[i];
+    const TfLiteNode& node = current.node;
+    if (current.registration == nullptr) {
+      continue;
+    }
+    const int32_t builtin_code = current.registration->builtin_code;
+    if (IsViewOperator(builtin_code) || IsInPlaceOperator(builtin_code)) {
+      AddUnaryAlias(subgraph, node, static_cast<int>(i),
+                    IsInPlaceOperator(builtin_code));
+    } else if (builtin_code == BuiltinOperator_CONCATENATION) {
+      AddConcatAliases(subgraph, node, eval_tensors);
+    } else if (builtin_code == BuiltinOperator_SPLIT &&
+               node.inputs->size == 2) {
+      // The axis is a constant tensor.
+      AddSplitAliases(node, node.inputs->data[1],
+                      eval_tensors[node.inputs->data[0]].data.i32[0],
+                      eval_tensors);
+    } else if (builtin_code == BuiltinOperator_SPLIT_V &&
+               node.inputs->size == 3) {
+      AddSplitAliases(node, node.inputs->data[0],
+                      eval_tensors[node.inputs->data[2]].data.i32[0],
+                      eval_tensors);
+    } else if (builtin_code == BuiltinOperator_UNPACK) {
+      const TfLiteUnpackParams* params =
+          reinterpret_cast<const TfLiteUnpackParams*>(node.builtin_data);
+      AddSplitAliases(node, node.inputs->data[0], params->axis, eval_tensors);
+    }
+  }
+}
+
 // The tensor offsets will be encoded in the metadata:[Metadata] field of the
 // Model. The following encoding applies:
 //
@@ -330,6 +654,10 @@ TfLiteStatus AllocationInfoBuilder::AddScratchBuffers(
     current->last_used = current_request->node_idx;
     current->offline_offset = kOnlinePlannedBuffer;
     current->needs_allocating = true;
+    current->region = 0;
+    current->alias_of = -1;
+    current->alias_offset = 0;
+    current->exclusive = false;
   }
   return kTfLiteOk;
 }
@@ -337,11 +665,11 @@ TfLiteStatus AllocationInfoBuilder::AddScratchBuffers(
 TfLiteStatus CreatePlan(ErrorReporter* error_reporter,
                         GreedyMemoryPlanner* planner,
                         const AllocationInfo* allocation_info,
-                        size_t allocation_info_size) {
+                        size_t allocation_info_size, int region = 0) {
   // Add the tensors to our allocation plan.
   for (size_t i = 0; i < allocation_info_size; ++i) {
     const AllocationInfo* current = &allocation_info[i];
-    if (current->needs_allocating) {
+    if (current->needs_allocating && current->region == region) {
       size_t aligned_bytes_required =
           AlignSizeUp(current->bytes, kBufferAlignment);
       if (current->offline_offset == kOnlinePlannedBuffer) {
@@ -361,12 +689,12 @@ TfLiteStatus CreatePlan(ErrorReporter* error_reporter,
 TfLiteStatus CommitPlan(ErrorReporter* error_reporter, MemoryPlanner* planner,
                         uint8_t* starting_point,
                         const AllocationInfo* allocation_info,
-                        size_t allocation_info_size) {
+                        size_t allocation_info_size, int region = 0) {
   // Figure out the actual memory addresses for each buffer, based on the plan.
   int planner_index = 0;
   for (size_t i = 0; i < allocation_info_size; ++i) {
     const AllocationInfo* current = &allocation_info[i];
-    if (current->needs_allocating) {
+    if (current->needs_allocating && current->region == region) {
       int offset = -1;
       TF_LITE_ENSURE_STATUS(
           planner->GetOffsetForBuffer(error_reporter, planner_index, &offset));
@@ -376,6 +704,186 @@ TfLiteStatus CommitPlan(ErrorReporter* error_reporter, MemoryPlanner* planner,
   }
   return kTfLiteOk;
 }
+
+// Whether the buffer `a` is hotter than the buffer `b`. The scratch buffers
+// (im2col, packed weights..) come first. The tensors are ordered by number of
+// node references per node of lifetime: a tensor read or written by each node
+// it is alive for is worth more of a fast region than a tensor kept alive
+// across a long branch, for the same bytes.
+bool IsHotterBuffer(const AllocationInfo& a, int refs_a, bool scratch_a,
+                    const AllocationInfo& b, int refs_b, bool scratch_b) {
+  if (scratch_a != scratch_b) {
+    return scratch_a;
+  }
+  const int64_t life_a = a.last_used - a.first_created + 1;
+  const int64_t life_b = b.last_used - b.first_created + 1;
+  if (refs_a * life_b != refs_b * life_a) {
+    return refs_a * life_b > refs_b * life_a;
+  }
+  return a.bytes < b.bytes;
+}
+
+// Moves the hottest online planned buffers to the additional arena regions,
+// filled in order. The buffers are selected while the bytes alive at each node
+// fit in the region (a lower bound of the plan), then the selection is
+// planned and the coldest selected buffers are spilled back until the plan
+// fits. The buffers of a region are committed here, the remaining ones keep
+// region 0 and are planned in the head of the arena by the caller.
+// `line_size` enables the cache-aware placement of the planner (0: disabled).
+TfLiteStatus PlanArenaRegions(ErrorReporter* error_reporter,
+                              SimpleMemoryAllocator* memory_allocator,
+                              const NodeAndRegistration* node_and_registrations,
+                              int operator_count,
+                              AllocationInfo* allocation_info,
+                              size_t tensor_count, size_t allocation_info_size,
+                              ArenaRegion* regions, int region_count,
+                              int line_size) {
+  if (region_count == 0 || operator_count == 0) {
+    return kTfLiteOk;
+  }
+
+  int* order = reinterpret_cast<int*>(memory_allocator->AllocateTemp(
+      sizeof(int) * allocation_info_size, alignof(int)));
+  int* refs = reinterpret_cast<int*>(memory_allocator->AllocateTemp(
+      sizeof(int) * allocation_info_size, alignof(int)));
+  size_t* load = reinterpret_cast<size_t*>(memory_allocator->AllocateTemp(
+      sizeof(size_t) * operator_count, alignof(size_t)));
+  if (order == nullptr || refs == nullptr || load == nullptr) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "Failed to allocate memory to plan the arena regions");
+    return kTfLiteError;
+  }
+
+  // Node references of the tensors, the scratch buffers are used by their
+  // node only.
+  for (size_t i = 0; i < allocation_info_size; ++i) {
+    refs[i] = (i < tensor_count) ? 0 : 1;
+  }
+  for (int i = 0; i < operator_count; ++i) {
+    const TfLiteNode& node = node_and_registrations[i].node;
+    for (int n = 0; n < node.inputs->size; ++n) {
+      if (node.inputs->data[n] >= 0) {
+        ++refs[node.inputs->data[n]];
+      }
+    }
+    for (int n = 0; n < node.outputs->size; ++n) {
+      ++refs[node.outputs->data[n]];
+    }
+  }
+
+  // Candidates sorted from the hottest (insertion sort, the lists are short).
+  int candidate_count = 0;
+  for (size_t i = 0; i < allocation_info_size; ++i) {
+    const AllocationInfo& current = allocation_info[i];
+    if (!current.needs_allocating ||
+        current.offline_offset != kOnlinePlannedBuffer) {
+      continue;
+    }
+    int j = candidate_count++;
+    for (; j > 0; --j) {
+      const int k = order[j - 1];
+      if (!IsHotterBuffer(current, refs[i], i >= tensor_count,
+                          allocation_info[k], refs[k],
+                          static_cast<size_t>(k) >= tensor_count)) {
+        break;
+      }
+      order[j] = k;
+    }
+    order[j] = static_cast<int>(i);
+  }
+
+  const size_t planner_size =
+      GreedyMemoryPlanner::per_buffer_size() * candidate_count;
+  uint8_t* planner_arena =
+      memory_allocator->AllocateTemp(planner_size, kBufferAlignment);
+  if (candidate_count && planner_arena == nullptr) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "Failed to allocate memory to plan the arena regions");
+    return kTfLiteError;
+  }
+
+  const size_t alignment =
+      (line_size > kBufferAlignment) ? line_size : kBufferAlignment;
+
+  for (int r = 0; r < region_count; ++r) {
+    ArenaRegion* region = &regions[r];
+    const int region_id = r + 1;
+    uint8_t* base = AlignPointerUp(region->buffer, alignment);
+    const size_t padding = base - region->buffer;
+    const size_t size = (region->size > padding) ? region->size - padding : 0;
+    int selected = 0;
+
+    for (int t = 0; t < operator_count; ++t) {
+      load[t] = 0;
+    }
+    for (int c = 0; c < candidate_count; ++c) {
+      AllocationInfo* current = &allocation_info[order[c]];
+      if (current->region != 0) {
+        continue;
+      }
+      const size_t bytes = AlignSizeUp(current->bytes, alignment);
+      const int first = current->first_created < 0 ? 0 : current->first_created;
+      const int last = current->last_used < first ? first : current->last_used;
+      bool fits = bytes <= size;
+      for (int t = first; fits && t <= last; ++t) {
+        fits = (load[t] + bytes) <= size;
+      }
+      if (fits) {
+        for (int t = first; t <= last; ++t) {
+          load[t] += bytes;
+        }
+        current->region = region_id;
+        ++selected;
+      }
+    }
+
+    size_t plan_size = 0;
+    while (selected) {
+      GreedyMemoryPlanner planner(planner_arena, planner_size);
+      planner.SetCacheAwarePlacement(line_size);
+      TF_LITE_ENSURE_STATUS(CreatePlan(error_reporter, &planner,
+                                       allocation_info, allocation_info_size,
+                                       region_id));
+      plan_size = planner.GetMaximumMemorySize();
+      if (plan_size <= size) {
+        TF_LITE_ENSURE_STATUS(CommitPlan(error_reporter, &planner, base,
+                                         allocation_info, allocation_info_size,
+                                         region_id));
+        plan_size += padding;
+        break;
+      }
+      // Spill the coldest buffer of the selection.
+      for (int c = candidate_count - 1; c >= 0; --c) {
+        if (allocation_info[order[c]].region == region_id) {
+          allocation_info[order[c]].region = 0;
+          break;
+        }
+      }
+      --selected;
+      plan_size = 0;
+    }
+
+    if (region->used_bytes < plan_size) {
+      region->used_bytes = plan_size;
+    }
+  }
+  return kTfLiteOk;
+}
+
+// Sets the buffer of the aliased tensors, once the shared buffers are
+// committed.
+void CommitAliases(const AllocationInfo* allocation_info,
+                   size_t allocation_info_size) {
+  for (size_t i = 0; i < allocation_info_size; ++i) {
+    const AllocationInfo* current = &allocation_info[i];
+    if (current->alias_of != -1) {
+      *current->output_ptr =
+          static_cast<uint8_t*>(
+              *allocation_info[current->alias_of].output_ptr) +
+          current->alias_offset;
+    }
+  }
+}
 }  // namespace
 
 namespace internal {
@@ -645,6 +1153,7 @@ TfLiteStatus MicroAllocator::StartModelAllocation(
       AllocateNodeAndRegistrations(model, node_and_registrations));
   TF_LITE_ENSURE_STATUS(PrepareNodeAndRegistrationDataFromFlatbuffer(
       model, op_resolver, *node_and_registrations));
+  node_and_registrations_ = *node_and_registrations;
 
   return kTfLiteOk;
 }
@@ -668,6 +1177,7 @@ TfLiteStatus MicroAllocator::FinishModelAllocation(
                                                *scratch_buffer_handles));
   TF_LITE_ENSURE_STATUS(AllocateVariables(subgraph, eval_tensors));
 
+  lifetime_extension_count_ = 0;
   model_is_allocating_ = false;
   return kTfLiteOk;
 }
@@ -750,6 +1260,81 @@ size_t MicroAllocator::used_bytes() const {
   return memory_allocator_->GetUsedBytes();
 }
 
+TfLiteStatus MicroAllocator::AddArenaRegion(uint8_t* buffer, size_t size) {
+  if (model_is_allocating_) {
+    TF_LITE_REPORT_ERROR(error_reporter_,
+                         "MicroAllocator: Arena region added while a model is "
+                         "allocating");
+    return kTfLiteError;
+  }
+  if (arena_region_count_ >= kMaxArenaRegions) {
+    TF_LITE_REPORT_ERROR(error_reporter_,
+                         "MicroAllocator: At most %d arena regions",
+                         kMaxArenaRegions);
+    return kTfLiteError;
+  }
+  TF_LITE_ENSURE(error_reporter_, buffer != nullptr);
+  if (arena_regions_ == nullptr) {
+    arena_regions_ =
+        reinterpret_cast<ArenaRegion*>(memory_allocator_->AllocateFromTail(
+            sizeof(ArenaRegion) * kMaxArenaRegions, alignof(ArenaRegion)));
+    if (arena_regions_ == nullptr) {
+      TF_LITE_REPORT_ERROR(error_reporter_,
+                           "Failed to allocate memory for the arena regions");
+      return kTfLiteError;
+    }
+  }
+
+  uint8_t* aligned_buffer = AlignPointerUp(buffer, kBufferAlignment);
+  const size_t offset = aligned_buffer - buffer;
+  ArenaRegion* region = &arena_regions_[arena_region_count_++];
+  region->buffer = aligned_buffer;
+  region->size = (size > offset) ? size - offset : 0;
+  region->used_bytes = 0;
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroAllocator::SetCacheAwarePlanning(int line_size) {
+  if ((line_size < 0) || (line_size & (line_size - 1))) {
+    TF_LITE_REPORT_ERROR(error_reporter_,
+                         "MicroAllocator: Invalid cache line size %d",
+                         line_size);
+    return kTfLiteError;
+  }
+  planner_line_size_ = line_size;
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroAllocator::ExtendTensorLifetime(int tensor_index,
+                                                  int first_node,
+                                                  int last_node) {
+  if (!model_is_allocating_) {
+    TF_LITE_REPORT_ERROR(error_reporter_,
+                         "MicroAllocator: Tensor lifetime set outside of the "
+                         "model allocation");
+    return kTfLiteError;
+  }
+  if (lifetime_extension_count_ >= kMaxTensorLifetimeExtensions ||
+      first_node < 0 || last_node < first_node) {
+    TF_LITE_REPORT_ERROR(error_reporter_,
+                         "MicroAllocator: Invalid lifetime of tensor %d",
+                         tensor_index);
+    return kTfLiteError;
+  }
+  TensorLifetime* current = &lifetime_extensions_[lifetime_extension_count_++];
+  current->tensor_index = tensor_index;
+  current->first_node = first_node;
+  current->last_node = last_node;
+  return kTfLiteOk;
+}
+
+size_t MicroAllocator::region_used_bytes(int index) const {
+  if (index < 0 || index >= arena_region_count_) {
+    return 0;
+  }
+  return arena_regions_[index].used_bytes;
+}
+
 TfLiteStatus MicroAllocator::AllocateNodeAndRegistrations(
     const Model* model, NodeAndRegistration** node_and_registrations) {
   TFLITE_DCHECK(node_and_registrations);
@@ -1026,7 +1611,9 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   size_t head_usage = 0;
   // Create static memory plan
   // 1. Calculate AllocationInfo to know the lifetime of each tensor/buffer.
-  // 2. Add them into the planner (such as the GreedyMemoryPlanner).
+  //    The hottest ones are planned and committed in the additional arena
+  //    regions, if any.
+  // 2. Add the others into the planner (such as the GreedyMemoryPlanner).
   // 3. Static memory planning using the planner.
   // 4. Set tensor/buffer pointers based on the offsets from the previous step.
   //
@@ -1059,7 +1646,14 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   TF_LITE_ENSURE_STATUS(
       builder.GetOfflinePlannedOffsets(model, &offline_planner_offsets));
   TF_LITE_ENSURE_STATUS(
-      builder.AddTensors(subgraph, offline_planner_offsets, eval_tensors));
+      builder.AddTensors(subgraph, node_and_registrations_,
+                         offline_planner_offsets, eval_tensors));
+  builder.ExtendLifetimes(lifetime_extensions_, lifetime_extension_count_);
+  if (buffer_aliasing_ && offline_planner_offsets == nullptr) {
+    builder.AddAliases(subgraph, node_and_registrations_, eval_tensors);
+  }
+  elided_copy_count_ = builder.elided_copies();
+  elided_copy_bytes_ = builder.elided_copy_bytes();
 
   internal::ScratchBufferRequest* scratch_buffer_requests =
       GetScratchBufferRequests();
@@ -1067,6 +1661,13 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   TF_LITE_ENSURE_STATUS(builder.AddScratchBuffers(scratch_buffer_requests,
                                                   scratch_buffer_handles));
 
+  // The hottest buffers are committed in the additional arena regions.
+  TF_LITE_ENSURE_STATUS(PlanArenaRegions(
+      error_reporter_, memory_allocator_, node_and_registrations_,
+      subgraph->operators()->size(), allocation_info,
+      subgraph->tensors()->size(), allocation_info_count, arena_regions_,
+      arena_region_count_, planner_line_size_));
+
   // Remaining arena size that memory planner can use for calculating offsets.
   size_t remaining_arena_size =
       memory_allocator_->GetAvailableMemory(kBufferAlignment);
@@ -1074,6 +1675,7 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
       memory_allocator_->AllocateTemp(remaining_arena_size, kBufferAlignment);
   TF_LITE_ENSURE(error_reporter_, planner_arena != nullptr);
   GreedyMemoryPlanner planner(planner_arena, remaining_arena_size);
+  planner.SetCacheAwarePlacement(planner_line_size_);
   TF_LITE_ENSURE_STATUS(CreatePlan(error_reporter_, &planner, allocation_info,
                                    allocation_info_count));
 
@@ -1083,20 +1685,30 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   size_t actual_available_arena_size =
       memory_allocator_->GetAvailableMemory(kBufferAlignment);
 
+  // With the cache-aware placement, the plan starts on a cache line.
+  uint8_t* planner_base = memory_allocator_->GetHeadBuffer();
+  if (planner_line_size_ > kBufferAlignment) {
+    planner_base = AlignPointerUp(planner_base, planner_line_size_);
+  }
+  const size_t planner_padding =
+      planner_base - memory_allocator_->GetHeadBuffer();
+
   // Make sure we have enough arena size.
-  if (planner.GetMaximumMemorySize() > actual_available_arena_size) {
+  if (planner.GetMaximumMemorySize() + planner_padding >
+      actual_available_arena_size) {
     TF_LITE_REPORT_ERROR(
         error_reporter_,
         "Arena size is too small for all buffers. Needed %u but only "
         "%u was available.",
-        planner.GetMaximumMemorySize(), actual_available_arena_size);
+        planner.GetMaximumMemorySize() + planner_padding,
+        actual_available_arena_size);
     return kTfLiteError;
   }
   // Commit the plan.
-  TF_LITE_ENSURE_STATUS(CommitPlan(error_reporter_, &planner,
-                                   memory_allocator_->GetHeadBuffer(),
+  TF_LITE_ENSURE_STATUS(CommitPlan(error_reporter_, &planner, planner_base,
                                    allocation_info, allocation_info_count));
-  head_usage = planner.GetMaximumMemorySize();
+  CommitAliases(allocation_info, allocation_info_count);
+  head_usage = planner.GetMaximumMemorySize() + planner_padding;
 
   // The head is used to store memory plans for one model at a time during the
   // model preparation stage, and is re-purposed to store scratch buffer handles
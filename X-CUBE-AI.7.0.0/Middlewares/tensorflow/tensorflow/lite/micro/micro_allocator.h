@@ -67,6 +67,30 @@ typedef struct {
   const TfLiteRegistration* registration;
 } NodeAndRegistration;
 
+// Maximum number of memory regions added to the arena with
+// MicroAllocator::AddArenaRegion().
+constexpr int kMaxArenaRegions = 3;
+
+// Additional memory region for the non-persistent buffers (e.g. a fast TCM
+// when the arena is in a slower SRAM).
+typedef struct {
+  uint8_t* buffer;
+  size_t size;
+  // Size of the largest memory plan committed in the region.
+  size_t used_bytes;
+} ArenaRegion;
+
+// Maximum number of tensors whose lifetime is set with
+// MicroAllocator::ExtendTensorLifetime().
+constexpr int kMaxTensorLifetimeExtensions = 4;
+
+// Nodes from which the buffer of a tensor is kept alive.
+typedef struct {
+  int tensor_index;
+  int first_node;
+  int last_node;
+} TensorLifetime;
+
 // Holds a pointer to a buffer for a scratch buffer requested by a kernel during
 // the model prepare stage. This struct is allocated in-place and allows for
 // quick pointer-indexed lookup for speed during model inference.
@@ -98,6 +122,10 @@ typedef struct {
 //                                               - ->GetDataSize()
 // persistent area (tail)
 // ************** .memory_allocator->GetBuffer() + ->GetMaxBufferSize()
+//
+// Additional regions (AddArenaRegion()) only hold non-persistent buffers. The
+// hottest buffers are placed in the regions in the order they are added, the
+// others are spilled to the head of the arena.
 class MicroAllocator {
  public:
   // Creates a MicroAllocator instance from a given tensor arena. This arena
@@ -183,6 +211,41 @@ class MicroAllocator {
   // `FinishModelAllocation`. Otherwise, it will return 0.
   size_t used_bytes() const;
 
+  // Adds a memory region for the non-persistent buffers (tensors and scratch
+  // buffers). It should be called before the model allocation, the buffer
+  // must be valid for the lifetime of the allocator. At most
+  // kMaxArenaRegions regions can be added.
+  TfLiteStatus AddArenaRegion(uint8_t* buffer, size_t size);
+
+  // Enables the cache-aware placement of the memory planner (see
+  // GreedyMemoryPlanner::SetCacheAwarePlacement()) for a `line_size` bytes
+  // cache line, 0 disables it (default). It should be called before the
+  // model allocation.
+  TfLiteStatus SetCacheAwarePlanning(int line_size);
+
+  // Enables or disables the buffer aliasing of the views, in-place operators,
+  // concatenations and splits (enabled by default). It should be called
+  // before the model allocation.
+  void SetBufferAliasing(bool enabled) { buffer_aliasing_ = enabled; }
+
+  // Keeps the buffer of the tensor `tensor_index` alive at least from node
+  // `first_node` to node `last_node`, on its own (it is not shared with the
+  // buffer of another tensor). It should be called between
+  // StartModelAllocation() and FinishModelAllocation(), for at most
+  // kMaxTensorLifetimeExtensions tensors.
+  TfLiteStatus ExtendTensorLifetime(int tensor_index, int first_node,
+                                    int last_node);
+
+  // Returns the usage in bytes of the additional region `index` (in order of
+  // AddArenaRegion() calls), only available after `FinishModelAllocation`.
+  size_t region_used_bytes(int index) const;
+
+  // Returns the number of tensors which are not copied by their operator
+  // (views, concatenation and split slices sharing the buffer of another
+  // tensor) and the bytes of these copies, for the last committed plan.
+  int elided_copies() const { return elided_copy_count_; }
+  size_t elided_copy_bytes() const { return elided_copy_bytes_; }
+
  protected:
   MicroAllocator(SimpleMemoryAllocator* memory_allocator,
                  ErrorReporter* error_reporter);
@@ -264,6 +327,10 @@ class MicroAllocator {
   ErrorReporter* error_reporter_;
   bool model_is_allocating_;
 
+  // Node graph of the model being allocated, set by StartModelAllocation().
+  // The memory plan derives tensor lifetimes from it.
+  NodeAndRegistration* node_and_registrations_ = nullptr;
+
   // Holds the number of ScratchBufferRequest instances stored in the head
   // section when a model is allocating.
   size_t scratch_buffer_request_count_ = 0;
@@ -272,6 +339,25 @@ class MicroAllocator {
   // to ensure that multi-tenant allocations can share the head for buffers.
   size_t max_head_buffer_usage_ = 0;
 
+  // Additional regions for the non-persistent buffers, allocated in the tail
+  // by the first AddArenaRegion() call.
+  ArenaRegion* arena_regions_ = nullptr;
+  int arena_region_count_ = 0;
+
+  // Cache line size of the cache-aware planning, 0 if disabled.
+  int planner_line_size_ = 0;
+
+  // Whether tensors can share the buffer of another tensor.
+  bool buffer_aliasing_ = true;
+
+  // Lifetimes set for the model being allocated.
+  TensorLifetime lifetime_extensions_[kMaxTensorLifetimeExtensions] = {};
+  int lifetime_extension_count_ = 0;
+
+  // Copies elided by the buffer aliasing of the last committed plan.
+  int elided_copy_count_ = 0;
+  size_t elided_copy_bytes_ = 0;
+
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
 
@@ -0,0 +1,330 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/micro_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+namespace tflite {
+namespace testing {
+namespace {
+
+constexpr size_t kArenaSize = 64 * 1024;
+// The largest of the outputs of the test models: the 12x12x1 float output of
+// the pooling chain.
+constexpr size_t kMaxOutputBytes = 12 * 12 * sizeof(float);
+constexpr size_t kMaxTensors = 16;
+
+struct ModelRun {
+  // The outputs of the model, one after the other.
+  uint8_t output[kMaxOutputBytes];
+  size_t output_bytes;
+  size_t arena_used_bytes;
+  size_t region_used_bytes[kMaxArenaRegions];
+  int elided_copies;
+  size_t elided_copy_bytes;
+  // Buffer of each tensor.
+  const uint8_t* tensor_data[kMaxTensors];
+};
+
+const MicroOpResolver& GetOpResolver() {
+  static MicroMutableOpResolver<15> resolver;
+  static bool is_filled = false;
+  if (!is_filled) {
+    resolver.AddConcatenation();
+    resolver.AddConv2D();
+    resolver.AddDepthwiseConv2D();
+    resolver.AddExpandDims();
+    resolver.AddLogistic();
+    resolver.AddMaxPool2D();
+    resolver.AddPad();
+    resolver.AddRelu();
+    resolver.AddRelu6();
+    resolver.AddReshape();
+    resolver.AddSplit();
+    resolver.AddSplitV();
+    resolver.AddSqueeze();
+    resolver.AddTanh();
+    resolver.AddUnpack();
+    is_filled = true;
+  }
+  return resolver;
+}
+
+// Runs `model` with the additional arena regions `regions` of `sizes` bytes,
+// with or without the buffer aliasing. The arena and the regions are filled
+// with a pattern first, so that a buffer read before being written can't go
+// unnoticed.
+void RunModel(const Model* model, uint8_t* const* regions, const size_t* sizes,
+              int region_count, bool buffer_aliasing, ModelRun* run) {
+  alignas(16) static uint8_t arena[kArenaSize];
+  std::memset(arena, 0x55, kArenaSize);
+  MicroAllocator* allocator =
+      MicroAllocator::Create(arena, kArenaSize, GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT(allocator != nullptr);
+  allocator->SetBufferAliasing(buffer_aliasing);
+  for (int i = 0; i < region_count; ++i) {
+    std::memset(regions[i], 0x55, sizes[i]);
+    TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk,
+                            allocator->AddArenaRegion(regions[i], sizes[i]));
+  }
+  MicroInterpreter interpreter(model, GetOpResolver(), allocator,
+                               GetMicroErrorReporter());
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, interpreter.AllocateTensors());
+
+  TfLiteTensor* input = interpreter.input(0);
+  if (input->type == kTfLiteFloat32) {
+    for (size_t i = 0; i < input->bytes / sizeof(float); ++i) {
+      input->data.f[i] = static_cast<float>((i * 97 + 11) % 256) / 16.0f - 8.0f;
+    }
+  } else {
+    for (size_t i = 0; i < input->bytes; ++i) {
+      input->data.int8[i] = static_cast<int8_t>((i * 97 + 11) % 256);
+    }
+  }
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, interpreter.Invoke());
+  run->output_bytes = 0;
+  for (size_t i = 0; i < interpreter.outputs_size(); ++i) {
+    const TfLiteTensor* output = interpreter.output(i);
+    TF_LITE_MICRO_EXPECT_LE(run->output_bytes + output->bytes,
+                            kMaxOutputBytes);
+    std::memcpy(run->output + run->output_bytes, output->data.raw,
+                output->bytes);
+    run->output_bytes += output->bytes;
+  }
+  run->arena_used_bytes = interpreter.arena_used_bytes();
+  for (int i = 0; i < region_count; ++i) {
+    run->region_used_bytes[i] = allocator->region_used_bytes(i);
+  }
+  run->elided_copies = allocator->elided_copies();
+  run->elided_copy_bytes = allocator->elided_copy_bytes();
+  // The TfLiteTensor structs are allocated in the arena, after its use has
+  // been read.
+  TF_LITE_MICRO_EXPECT_LE(interpreter.tensors_size(), kMaxTensors);
+  for (size_t i = 0; i < interpreter.tensors_size(); ++i) {
+    run->tensor_data[i] =
+        reinterpret_cast<const uint8_t*>(interpreter.tensor(i)->data.raw);
+  }
+}
+
+void ExpectSameOutputs(const ModelRun& expected, const ModelRun& run) {
+  TF_LITE_MICRO_EXPECT_EQ(expected.output_bytes, run.output_bytes);
+  for (size_t i = 0; i < expected.output_bytes; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(expected.output[i], run.output[i]);
+  }
+}
+
+// Runs `model` without and with the regions, and checks that both runs have
+// the same outputs and that each region is used within its size.
+void TestRegionsMatchSingleArena(const Model* model, uint8_t* const* regions,
+                                 const size_t* sizes, int region_count,
+                                 ModelRun* reference, ModelRun* run) {
+  RunModel(model, nullptr, nullptr, 0, /*buffer_aliasing=*/true, reference);
+  RunModel(model, regions, sizes, region_count, /*buffer_aliasing=*/true, run);
+  ExpectSameOutputs(*reference, *run);
+  for (int i = 0; i < region_count; ++i) {
+    TF_LITE_MICRO_EXPECT_LE(run->region_used_bytes[i], sizes[i]);
+  }
+}
+
+// Runs `model` with and without the buffer aliasing and checks that the
+// outputs are bit-identical, that the aliasing doesn't use more memory, and
+// that nothing is elided without it.
+void TestAliasingMatchesCopies(const Model* model, ModelRun* aliased,
+                               ModelRun* copied) {
+  RunModel(model, nullptr, nullptr, 0, /*buffer_aliasing=*/true, aliased);
+  RunModel(model, nullptr, nullptr, 0, /*buffer_aliasing=*/false, copied);
+  ExpectSameOutputs(*copied, *aliased);
+  TF_LITE_MICRO_EXPECT_LE(aliased->arena_used_bytes, copied->arena_used_bytes);
+  TF_LITE_MICRO_EXPECT_EQ(0, copied->elided_copies);
+  TF_LITE_MICRO_EXPECT_EQ(static_cast<size_t>(0), copied->elided_copy_bytes);
+}
+
+// Tensors used by a same node, alive at the same time.
+struct TensorPair {
+  int first;
+  int second;
+};
+
+// Checks that each pair of tensors of `run` doesn't share a buffer.
+void ExpectNoSharedBuffers(const ModelRun& run,
+                           std::initializer_list<TensorPair> pairs) {
+  for (const TensorPair& pair : pairs) {
+    TF_LITE_MICRO_EXPECT(run.tensor_data[pair.first] !=
+                         run.tensor_data[pair.second]);
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace tflite
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(RegionTakesTheHottestBuffers) {
+  alignas(16) static uint8_t region[8 * 1024];
+  uint8_t* regions[] = {region};
+  const size_t sizes[] = {sizeof(region)};
+  tflite::testing::ModelRun reference;
+  tflite::testing::ModelRun run;
+  tflite::testing::TestRegionsMatchSingleArena(
+      tflite::testing::GetConvChainModel(/*with_pad=*/false,
+                                         /*with_bias=*/true),
+      regions, sizes, 1, &reference, &run);
+  MicroPrintf("Arena use: %d bytes, %d bytes with a %d bytes region",
+              static_cast<int>(reference.arena_used_bytes),
+              static_cast<int>(run.arena_used_bytes),
+              static_cast<int>(sizes[0]));
+  TF_LITE_MICRO_EXPECT_GT(run.region_used_bytes[0], static_cast<size_t>(0));
+  TF_LITE_MICRO_EXPECT_LT(run.arena_used_bytes, reference.arena_used_bytes);
+}
+
+TF_LITE_MICRO_TEST(RegionsAreFilledInOrder) {
+  alignas(16) static uint8_t first[2 * 1024];
+  alignas(16) static uint8_t second[4 * 1024];
+  uint8_t* regions[] = {first, second};
+  const size_t sizes[] = {sizeof(first), sizeof(second)};
+  tflite::testing::ModelRun reference;
+  tflite::testing::ModelRun run;
+  tflite::testing::TestRegionsMatchSingleArena(
+      tflite::testing::GetConvChainModel(/*with_pad=*/false,
+                                         /*with_bias=*/true),
+      regions, sizes, 2, &reference, &run);
+  TF_LITE_MICRO_EXPECT_GT(run.region_used_bytes[0], static_cast<size_t>(0));
+  TF_LITE_MICRO_EXPECT_GT(run.region_used_bytes[1], static_cast<size_t>(0));
+  TF_LITE_MICRO_EXPECT_LT(run.arena_used_bytes, reference.arena_used_bytes);
+}
+
+TF_LITE_MICRO_TEST(UndersizedRegionsKeepBuffersInTheArena) {
+  // From a region too small for any buffer to regions a bit short of the
+  // largest plans: the buffers which don't fit stay in the arena. The arena
+  // use can then grow by the region table.
+  alignas(16) static uint8_t region[9 * 1024];
+  const size_t kSizes[] = {8,    48,   200,  500,  1000, 2100,
+                           3000, 3100, 5000, 8200, 9000};
+  for (size_t size : kSizes) {
+    uint8_t* regions[] = {region};
+    const size_t sizes[] = {size};
+    tflite::testing::ModelRun reference;
+    tflite::testing::ModelRun run;
+    tflite::testing::TestRegionsMatchSingleArena(
+        tflite::testing::GetConvChainModel(/*with_pad=*/false,
+                                           /*with_bias=*/true),
+        regions, sizes, 1, &reference, &run);
+  }
+}
+
+TF_LITE_MICRO_TEST(RegionSpillsTheColdestBufferBack) {
+  // The four intermediate buffers of the pooling chain never take more than
+  // 112 bytes at once, so they are all selected for a 112 bytes region. The
+  // greedy plan of the four takes 160 bytes though, and the last one is
+  // spilled back to the arena.
+  alignas(16) static uint8_t region[112];
+  uint8_t* regions[] = {region};
+  const size_t sizes[] = {sizeof(region)};
+  tflite::testing::ModelRun reference;
+  tflite::testing::ModelRun run;
+  tflite::testing::TestRegionsMatchSingleArena(
+      tflite::testing::GetPoolingChainModel(), regions, sizes, 1, &reference,
+      &run);
+  TF_LITE_MICRO_EXPECT_EQ(sizeof(region), run.region_used_bytes[0]);
+}
+
+TF_LITE_MICRO_TEST(ViewsAndInPlaceOutputsShareTheirInputBuffer) {
+  tflite::testing::ModelRun aliased;
+  tflite::testing::ModelRun copied;
+  tflite::testing::TestAliasingMatchesCopies(
+      tflite::testing::GetViewChainModel(), &aliased, &copied);
+  // RELU (2) runs in place, RESHAPE (3), EXPAND_DIMS (5) and SQUEEZE (6) are
+  // views of its buffer. LOGISTIC (1) doesn't write over the model input.
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[0] != aliased.tensor_data[1]);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[1] == aliased.tensor_data[2]);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[1] == aliased.tensor_data[3]);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[1] == aliased.tensor_data[5]);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[1] == aliased.tensor_data[6]);
+  // The in-place RELU is not a copy.
+  TF_LITE_MICRO_EXPECT_EQ(3, aliased.elided_copies);
+  TF_LITE_MICRO_EXPECT_EQ(3 * 16 * sizeof(float), aliased.elided_copy_bytes);
+
+  tflite::testing::ExpectNoSharedBuffers(
+      copied, {{0, 1}, {1, 2}, {2, 3}, {3, 5}, {5, 6}});
+}
+
+TF_LITE_MICRO_TEST(AliasingIsRefusedForModelInputsOutputsAndLaterReads) {
+  tflite::testing::ModelRun aliased;
+  tflite::testing::ModelRun copied;
+  tflite::testing::TestAliasingMatchesCopies(
+      tflite::testing::GetAliasRefusalModel(), &aliased, &copied);
+  tflite::testing::ExpectNoSharedBuffers(
+      aliased, {{0, 1}, {1, 2}, {1, 3}, {2, 3}, {0, 4}, {3, 5}});
+  TF_LITE_MICRO_EXPECT_EQ(0, aliased.elided_copies);
+  TF_LITE_MICRO_EXPECT_EQ(static_cast<size_t>(0), aliased.elided_copy_bytes);
+}
+
+TF_LITE_MICRO_TEST(AliasingKeepsTheOutputsOfTheConvChain) {
+  // The RELU of the conv chain runs in place over the conv output.
+  tflite::testing::ModelRun aliased;
+  tflite::testing::ModelRun copied;
+  tflite::testing::TestAliasingMatchesCopies(
+      tflite::testing::GetConvChainModel(/*with_pad=*/false,
+                                         /*with_bias=*/true),
+      &aliased, &copied);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[3] == aliased.tensor_data[4]);
+  TF_LITE_MICRO_EXPECT(copied.tensor_data[3] != copied.tensor_data[4]);
+}
+
+TF_LITE_MICRO_TEST(SlicesShareTheBufferOfTheirConcatenationOrSplit) {
+  tflite::testing::ModelRun aliased;
+  tflite::testing::ModelRun copied;
+  tflite::testing::TestAliasingMatchesCopies(tflite::testing::GetSliceModel(),
+                                             &aliased, &copied);
+  constexpr int kRowBytes = 8 * sizeof(float);
+  const uint8_t* input = aliased.tensor_data[0];
+  const uint8_t* concat_output = aliased.tensor_data[6];
+  // SPLIT outputs in the input.
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[2] == input);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[3] == input + kRowBytes);
+  // LOGISTIC and TANH outputs (not in place over the model input) in the
+  // CONCATENATION output.
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[4] == concat_output);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[5] == concat_output + kRowBytes);
+  // UNPACK outputs in the CONCATENATION output.
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[7] == concat_output);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[8] == concat_output + kRowBytes);
+  // SPLIT_V outputs in the first UNPACK output.
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[10] == concat_output);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[11] ==
+                       concat_output + kRowBytes / 2);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[12] != concat_output);
+  TF_LITE_MICRO_EXPECT(aliased.tensor_data[0] != concat_output);
+  // 2 SPLIT, 2 CONCATENATION, 2 UNPACK and 2 SPLIT_V copies.
+  TF_LITE_MICRO_EXPECT_EQ(8, aliased.elided_copies);
+  TF_LITE_MICRO_EXPECT_EQ(static_cast<size_t>(7 * kRowBytes),
+                          aliased.elided_copy_bytes);
+
+  tflite::testing::ExpectNoSharedBuffers(
+      copied, {{0, 2}, {0, 3}, {2, 3}, {4, 6}, {5, 6}, {6, 7}, {6, 8},
+               {7, 10}, {7, 11}, {10, 12}, {11, 12}, {8, 12}});
+}
+
+TF_LITE_MICRO_TESTS_END
@@ -0,0 +1,434 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/micro_graph_fusion.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/core/api/error_reporter.h"
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/micro_utils.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+namespace {
+
+constexpr char kOfflineMemAllocMetadata[] = "OfflineMemoryAllocation";
+
+// Input/output layout of the nodes handled by the pass.
+constexpr int kPadInputTensor = 0;
+constexpr int kPadPaddingsTensor = 1;
+constexpr int kConvInputTensor = 0;
+constexpr int kConvBiasTensor = 2;
+constexpr int kConvPaddingsTensor = 3;
+
+// Shared by all the fused nodes: an empty input/output list.
+TfLiteIntArray kFusedNodeIntArray = {/*size=*/0};
+
+bool HasOfflineMemoryPlan(const Model* model) {
+  if (model->metadata() == nullptr) {
+    return false;
+  }
+  for (size_t i = 0; i < model->metadata()->size(); ++i) {
+    auto metadata = model->metadata()->Get(i);
+    if (strncmp(metadata->name()->c_str(), kOfflineMemAllocMetadata,
+                strlen(kOfflineMemAllocMetadata)) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+class GraphFuser {
+ public:
+  GraphFuser(const SubGraph* subgraph, TfLiteEvalTensor* eval_tensors,
+             NodeAndRegistration* node_and_registrations,
+             MicroAllocator* allocator, ErrorReporter* error_reporter,
+             MicroGraphFusionStats* stats)
+      : subgraph_(subgraph),
+        eval_tensors_(eval_tensors),
+        nodes_(node_and_registrations),
+        nodes_size_(subgraph->operators()->size()),
+        allocator_(allocator),
+        error_reporter_(error_reporter),
+        stats_(stats) {}
+
+  TfLiteStatus CancelDequantizeQuantize();
+  TfLiteStatus FusePadIntoConv();
+  TfLiteStatus FuseActivations();
+
+ private:
+  BuiltinOperator BuiltinCode(int node_index) const {
+    return static_cast<BuiltinOperator>(
+        nodes_[node_index].registration->builtin_code);
+  }
+
+  bool IsLive(int node_index) const {
+    return !IsFusedNode(nodes_[node_index].node);
+  }
+
+  bool IsGraphOutput(int tensor_index) const;
+  bool IsConstant(int tensor_index) const {
+    return eval_tensors_[tensor_index].data.data != nullptr;
+  }
+
+  // Returns the index of the live node producing the tensor, or -1.
+  int FindProducer(int tensor_index) const;
+
+  // Returns the number of live node inputs referencing the tensor. The last
+  // consumer found is stored in `consumer`.
+  int CountConsumers(int tensor_index, int* consumer) const;
+
+  bool HaveSameTypeAndQuantization(int tensor_a, int tensor_b) const;
+  bool HaveSameShape(int tensor_a, int tensor_b) const;
+  size_t BytesOf(int tensor_index) const;
+
+  // Returns a persistent copy of `source` with `extra` spare trailing slots.
+  TfLiteIntArray* CopyIntArray(const TfLiteIntArray* source, int extra);
+
+  void MarkFused(int node_index, size_t bytes_saved);
+
+  const SubGraph* subgraph_;
+  TfLiteEvalTensor* eval_tensors_;
+  NodeAndRegistration* nodes_;
+  const int nodes_size_;
+  MicroAllocator* allocator_;
+  ErrorReporter* error_reporter_;
+  MicroGraphFusionStats* stats_;
+};
+
+bool GraphFuser::IsGraphOutput(int tensor_index) const {
+  for (size_t i = 0; i < subgraph_->outputs()->size(); ++i) {
+    if (subgraph_->outputs()->Get(i) == tensor_index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int GraphFuser::FindProducer(int tensor_index) const {
+  for (int i = 0; i < nodes_size_; ++i) {
+    if (!IsLive(i)) continue;
+    const TfLiteIntArray* outputs = nodes_[i].node.outputs;
+    for (int n = 0; n < outputs->size; ++n) {
+      if (outputs->data[n] == tensor_index) {
+        return i;
+      }
+    }
+  }
+  return -1;
+}
+
+int GraphFuser::CountConsumers(int tensor_index, int* consumer) const {
+  int count = 0;
+  for (int i = 0; i < nodes_size_; ++i) {
+    if (!IsLive(i)) continue;
+    const TfLiteIntArray* inputs = nodes_[i].node.inputs;
+    for (int n = 0; n < inputs->size; ++n) {
+      if (inputs->data[n] == tensor_index) {
+        *consumer = i;
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+bool GraphFuser::HaveSameTypeAndQuantization(int tensor_a, int tensor_b) const {
+  if (eval_tensors_[tensor_a].type != eval_tensors_[tensor_b].type) {
+    return false;
+  }
+  const auto* quant_a = subgraph_->tensors()->Get(tensor_a)->quantization();
+  const auto* quant_b = subgraph_->tensors()->Get(tensor_b)->quantization();
+  const bool has_a = quant_a != nullptr && quant_a->scale() != nullptr &&
+                     quant_a->scale()->size() > 0;
+  const bool has_b = quant_b != nullptr && quant_b->scale() != nullptr &&
+                     quant_b->scale()->size() > 0;
+  if (!has_a || !has_b) {
+    return has_a == has_b;
+  }
+  // Only per-tensor activation quantization is expected here.
+  if (quant_a->scale()->size() != 1 || quant_b->scale()->size() != 1 ||
+      quant_a->zero_point() == nullptr || quant_b->zero_point() == nullptr) {
+    return false;
+  }
+  return quant_a->scale()->Get(0) == quant_b->scale()->Get(0) &&
+         quant_a->zero_point()->Get(0) == quant_b->zero_point()->Get(0);
+}
+
+bool GraphFuser::HaveSameShape(int tensor_a, int tensor_b) const {
+  const TfLiteIntArray* dims_a = eval_tensors_[tensor_a].dims;
+  const TfLiteIntArray* dims_b = eval_tensors_[tensor_b].dims;
+  if (dims_a->size != dims_b->size) {
+    return false;
+  }
+  for (int i = 0; i < dims_a->size; ++i) {
+    if (dims_a->data[i] != dims_b->data[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t GraphFuser::BytesOf(int tensor_index) const {
+  size_t bytes = 0;
+  if (TfLiteEvalTensorByteLength(&eval_tensors_[tensor_index], &bytes) !=
+      kTfLiteOk) {
+    return 0;
+  }
+  return bytes;
+}
+
+TfLiteIntArray* GraphFuser::CopyIntArray(const TfLiteIntArray* source,
+                                         int extra) {
+  const int size = source->size + extra;
+  TfLiteIntArray* array = reinterpret_cast<TfLiteIntArray*>(
+      allocator_->AllocatePersistentBuffer(TfLiteIntArrayGetSizeInBytes(size)));
+  if (array == nullptr) {
+    TF_LITE_REPORT_ERROR(error_reporter_,
+                         "Failed to allocate %d bytes for a fused node",
+                         TfLiteIntArrayGetSizeInBytes(size));
+    return nullptr;
+  }
+  array->size = size;
+  for (int i = 0; i < source->size; ++i) {
+    array->data[i] = source->data[i];
+  }
+  return array;
+}
+
+void GraphFuser::MarkFused(int node_index, size_t bytes_saved) {
+  nodes_[node_index].node.inputs = &kFusedNodeIntArray;
+  nodes_[node_index].node.outputs = &kFusedNodeIntArray;
+  stats_->fused_nodes++;
+  stats_->bytes_saved += bytes_saved;
+}
+
+// DEQUANTIZE(q1) -> f -> QUANTIZE(f) -> q2 with q1/q2 sharing type, scale and
+// zero point: the consumers of q2 read q1 directly. The float round trip is
+// exact for 8 and 16 bit values, so nothing observable changes.
+TfLiteStatus GraphFuser::CancelDequantizeQuantize() {
+  for (int q = 0; q < nodes_size_; ++q) {
+    if (!IsLive(q) || BuiltinCode(q) != BuiltinOperator_QUANTIZE) continue;
+    const TfLiteNode& quantize = nodes_[q].node;
+    if (quantize.inputs->size != 1 || quantize.outputs->size != 1) continue;
+    const int f = quantize.inputs->data[0];
+    const int q2 = quantize.outputs->data[0];
+
+    const int d = FindProducer(f);
+    if (d < 0 || BuiltinCode(d) != BuiltinOperator_DEQUANTIZE) continue;
+    const TfLiteNode& dequantize = nodes_[d].node;
+    if (dequantize.inputs->size != 1 || dequantize.outputs->size != 1) continue;
+    const int q1 = dequantize.inputs->data[0];
+
+    const TfLiteType type = eval_tensors_[q1].type;
+    if (type != kTfLiteInt8 && type != kTfLiteUInt8 && type != kTfLiteInt16) {
+      continue;
+    }
+    int consumer;
+    if (CountConsumers(f, &consumer) != 1 || IsGraphOutput(f) ||
+        IsGraphOutput(q2) || !HaveSameTypeAndQuantization(q1, q2)) {
+      continue;
+    }
+
+    for (int i = 0; i < nodes_size_; ++i) {
+      if (!IsLive(i) || i == q) continue;
+      TfLiteNode* node = &nodes_[i].node;
+      TfLiteIntArray* inputs = nullptr;
+      for (int n = 0; n < node->inputs->size; ++n) {
+        if (node->inputs->data[n] != q2) continue;
+        // Node inputs may still point into the (read-only) flatbuffer.
+        if (inputs == nullptr) {
+          inputs = CopyIntArray(node->inputs, 0);
+          if (inputs == nullptr) return kTfLiteError;
+        }
+        inputs->data[n] = q1;
+      }
+      if (inputs != nullptr) {
+        node->inputs = inputs;
+      }
+    }
+
+    MarkFused(d, BytesOf(q1) + BytesOf(f));
+    MarkFused(q, BytesOf(f) + BytesOf(q2));
+  }
+  return kTfLiteOk;
+}
+
+// PAD(x) -> p -> CONV_2D(p): the convolution reads x and skips the padded
+// border itself. Only spatial padding with the zero point (the value the
+// convolution implicitly uses) is folded.
+TfLiteStatus GraphFuser::FusePadIntoConv() {
+  for (int pad = 0; pad < nodes_size_; ++pad) {
+    if (!IsLive(pad) || BuiltinCode(pad) != BuiltinOperator_PAD) continue;
+    const TfLiteNode& pad_node = nodes_[pad].node;
+    if (pad_node.inputs->size != 2 || pad_node.outputs->size != 1) continue;
+    const int x = pad_node.inputs->data[kPadInputTensor];
+    const int paddings = pad_node.inputs->data[kPadPaddingsTensor];
+    const int p = pad_node.outputs->data[0];
+
+    const TfLiteType type = eval_tensors_[x].type;
+    if (type != kTfLiteFloat32 && type != kTfLiteInt8) continue;
+    if (eval_tensors_[x].dims->size != 4 || !IsConstant(paddings) ||
+        eval_tensors_[paddings].type != kTfLiteInt32 ||
+        ElementCount(*eval_tensors_[paddings].dims) != 8) {
+      continue;
+    }
+    const int32_t* pads = eval_tensors_[paddings].data.i32;
+    if (pads[0] != 0 || pads[1] != 0 || pads[6] != 0 || pads[7] != 0 ||
+        pads[2] < 0 || pads[3] < 0 || pads[4] < 0 || pads[5] < 0) {
+      continue;
+    }
+
+    int conv;
+    if (CountConsumers(p, &conv) != 1 || IsGraphOutput(p) ||
+        BuiltinCode(conv) != BuiltinOperator_CONV_2D ||
+        !HaveSameTypeAndQuantization(x, p)) {
+      continue;
+    }
+    TfLiteNode* conv_node = &nodes_[conv].node;
+    if (conv_node->inputs->size > kConvPaddingsTensor ||
+        conv_node->inputs->data[kConvInputTensor] != p) {
+      continue;
+    }
+
+    TfLiteIntArray* inputs = CopyIntArray(
+        conv_node->inputs, kConvPaddingsTensor + 1 - conv_node->inputs->size);
+    if (inputs == nullptr) return kTfLiteError;
+    inputs->data[kConvInputTensor] = x;
+    if (conv_node->inputs->size <= kConvBiasTensor) {
+      inputs->data[kConvBiasTensor] = kTfLiteOptionalTensor;
+    }
+    inputs->data[kConvPaddingsTensor] = paddings;
+    conv_node->inputs = inputs;
+
+    // The convolution reads x instead of p; PAD reads x and writes p.
+    MarkFused(pad, BytesOf(x) + BytesOf(p));
+  }
+  return kTfLiteOk;
+}
+
+// PRODUCER(...) -> c -> RELU/RELU6(c) -> y: the producer writes y with the
+// matching fused activation. With c and y sharing quantization parameters the
+// clamp bounds computed by the producer equal the ones applied by the
+// standalone activation kernel.
+TfLiteStatus GraphFuser::FuseActivations() {
+  for (int act = 0; act < nodes_size_; ++act) {
+    if (!IsLive(act)) continue;
+    TfLiteFusedActivation activation;
+    switch (BuiltinCode(act)) {
+      case BuiltinOperator_RELU:
+        activation = kTfLiteActRelu;
+        break;
+      case BuiltinOperator_RELU6:
+        activation = kTfLiteActRelu6;
+        break;
+      default:
+        continue;
+    }
+    const TfLiteNode& act_node = nodes_[act].node;
+    if (act_node.inputs->size != 1 || act_node.outputs->size != 1) continue;
+    const int c = act_node.inputs->data[0];
+    const int y = act_node.outputs->data[0];
+
+    const TfLiteType type = eval_tensors_[c].type;
+    if (type != kTfLiteFloat32 && type != kTfLiteInt8) continue;
+
+    const int producer = FindProducer(c);
+    if (producer < 0) continue;
+    TfLiteNode* producer_node = &nodes_[producer].node;
+    if (producer_node->outputs->size != 1 ||
+        producer_node->builtin_data == nullptr) {
+      continue;
+    }
+
+    TfLiteFusedActivation* fused_activation = nullptr;
+    switch (BuiltinCode(producer)) {
+      case BuiltinOperator_CONV_2D:
+        fused_activation =
+            &static_cast<TfLiteConvParams*>(producer_node->builtin_data)
+                 ->activation;
+        break;
+      case BuiltinOperator_DEPTHWISE_CONV_2D:
+        fused_activation = &static_cast<TfLiteDepthwiseConvParams*>(
+                                producer_node->builtin_data)
+                                ->activation;
+        break;
+      case BuiltinOperator_FULLY_CONNECTED:
+        fused_activation = &static_cast<TfLiteFullyConnectedParams*>(
+                                producer_node->builtin_data)
+                                ->activation;
+        break;
+      case BuiltinOperator_ADD:
+        fused_activation =
+            &static_cast<TfLiteAddParams*>(producer_node->builtin_data)
+                 ->activation;
+        break;
+      default:
+        continue;
+    }
+
+    int consumer;
+    if (*fused_activation != kTfLiteActNone ||
+        CountConsumers(c, &consumer) != 1 || IsGraphOutput(c) ||
+        !HaveSameTypeAndQuantization(c, y) || !HaveSameShape(c, y)) {
+      continue;
+    }
+
+    TfLiteIntArray* outputs = CopyIntArray(producer_node->outputs, 0);
+    if (outputs == nullptr) return kTfLiteError;
+    outputs->data[0] = y;
+    producer_node->outputs = outputs;
+    // Builtin data lives in the arena tail and is owned by the node.
+    *fused_activation = activation;
+
+    MarkFused(act, BytesOf(c) + BytesOf(y));
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TfLiteStatus FuseGraphNodes(const Model* model, TfLiteEvalTensor* eval_tensors,
+                            NodeAndRegistration* node_and_registrations,
+                            MicroAllocator* allocator,
+                            ErrorReporter* error_reporter,
+                            MicroGraphFusionStats* stats) {
+  TFLITE_DCHECK(model != nullptr);
+  TFLITE_DCHECK(eval_tensors != nullptr);
+  TFLITE_DCHECK(node_and_registrations != nullptr);
+  TFLITE_DCHECK(stats != nullptr);
+
+  *stats = MicroGraphFusionStats();
+
+  // Offline planned offsets were computed for the unmodified graph.
+  if (HasOfflineMemoryPlan(model) || model->subgraphs()->size() != 1) {
+    return kTfLiteOk;
+  }
+
+  GraphFuser fuser((*model->subgraphs())[0], eval_tensors,
+                   node_and_registrations, allocator, error_reporter, stats);
+  TF_LITE_ENSURE_STATUS(fuser.CancelDequantizeQuantize());
+  TF_LITE_ENSURE_STATUS(fuser.FusePadIntoConv());
+  TF_LITE_ENSURE_STATUS(fuser.FuseActivations());
+  return kTfLiteOk;
+}
+
+}  // namespace tflite
@@ -0,0 +1,64 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_MICRO_MICRO_GRAPH_FUSION_H_
+#define TENSORFLOW_LITE_MICRO_MICRO_GRAPH_FUSION_H_
+
+#include <cstddef>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/core/api/error_reporter.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+// Outcome of a graph fusion pass.
+struct MicroGraphFusionStats {
+  // Number of nodes removed from the execution plan.
+  int fused_nodes = 0;
+  // Number of activation bytes that the removed nodes would have read and
+  // written on every Invoke().
+  size_t bytes_saved = 0;
+};
+
+// Returns true if the node has been folded into a neighbour by
+// FuseGraphNodes(). Such a node is neither initialized, prepared nor invoked.
+inline bool IsFusedNode(const TfLiteNode& node) {
+  return node.outputs != nullptr && node.outputs->size == 0;
+}
+
+// Rewrites the node graph built by MicroAllocator::StartModelAllocation()
+// before the kernels are initialized. Only rewrites that leave the model
+// outputs bit-exact are applied:
+//  - a RELU/RELU6 consuming the sole output of a CONV_2D, DEPTHWISE_CONV_2D,
+//    FULLY_CONNECTED or ADD node with no fused activation becomes the fused
+//    activation of that node, provided both tensors share type and
+//    quantization parameters;
+//  - a PAD that only pads the spatial dimensions with the zero point and
+//    feeds a single CONV_2D is folded into the convolution padding. The
+//    paddings tensor is appended as a fourth convolution input;
+//  - a DEQUANTIZE followed by a QUANTIZE back to identical quantization
+//    parameters is removed.
+// Tensors that are no longer referenced are not allocated by the memory
+// planner. Models carrying an offline memory plan are left untouched.
+TfLiteStatus FuseGraphNodes(const Model* model, TfLiteEvalTensor* eval_tensors,
+                            NodeAndRegistration* node_and_registrations,
+                            MicroAllocator* allocator,
+                            ErrorReporter* error_reporter,
+                            MicroGraphFusionStats* stats);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_MICRO_GRAPH_FUSION_H_
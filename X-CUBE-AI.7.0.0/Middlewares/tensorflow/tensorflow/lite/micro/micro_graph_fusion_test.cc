@@ -0,0 +1,115 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/micro_graph_fusion.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/micro/all_ops_resolver.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+namespace tflite {
+namespace testing {
+namespace {
+
+constexpr size_t kArenaSize = 64 * 1024;
+constexpr int kOutputSize = 8 * 8 * 8;
+
+// Runs the model on a fixed input and copies its output. Returns the number
+// of nodes removed by the graph fusion pass.
+int RunConvChainModel(const Model* model, bool fusion, int8_t* output,
+                      NodeAndRegistration* conv) {
+  alignas(16) static uint8_t arena[kArenaSize];
+  const AllOpsResolver resolver;
+  MicroInterpreter interpreter(model, resolver, arena, kArenaSize,
+                               GetMicroErrorReporter());
+  interpreter.SetGraphFusionEnabled(fusion);
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, interpreter.AllocateTensors());
+
+  TfLiteTensor* input = interpreter.input(0);
+  TF_LITE_MICRO_EXPECT(input != nullptr);
+  for (size_t i = 0; i < input->bytes; ++i) {
+    input->data.int8[i] = static_cast<int8_t>((i * 97 + 11) % 256);
+  }
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, interpreter.Invoke());
+  TF_LITE_MICRO_EXPECT_EQ(static_cast<size_t>(kOutputSize),
+                          interpreter.output(0)->bytes);
+  std::memcpy(output, interpreter.output(0)->data.int8, kOutputSize);
+
+  for (size_t i = 0; i < interpreter.operators_size(); ++i) {
+    const NodeAndRegistration node = interpreter.node_and_registration(i);
+    if (node.registration->builtin_code == BuiltinOperator_CONV_2D) {
+      *conv = node;
+    }
+  }
+  return interpreter.graph_fusion_stats().fused_nodes;
+}
+
+void TestPadFusedIntoConv(bool with_bias) {
+  const Model* model = GetConvChainModel(/*with_pad=*/true, with_bias);
+  int8_t expected[kOutputSize];
+  int8_t output[kOutputSize];
+  NodeAndRegistration conv;
+
+  TF_LITE_MICRO_EXPECT_EQ(0, RunConvChainModel(model, false, expected, &conv));
+  TF_LITE_MICRO_EXPECT_EQ(with_bias ? 3 : 2, conv.node.inputs->size);
+
+  // PAD and RELU are folded into CONV_2D.
+  TF_LITE_MICRO_EXPECT_EQ(2, RunConvChainModel(model, true, output, &conv));
+  TF_LITE_MICRO_EXPECT_EQ(4, conv.node.inputs->size);
+  TF_LITE_MICRO_EXPECT_EQ(with_bias, conv.node.inputs->data[2] !=
+                                         kTfLiteOptionalTensor);
+  for (int i = 0; i < kOutputSize; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(expected[i], output[i]);
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace tflite
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(PadFusedIntoConvWithBias) {
+  tflite::testing::TestPadFusedIntoConv(/*with_bias=*/true);
+}
+
+TF_LITE_MICRO_TEST(PadFusedIntoConvWithoutBias) {
+  tflite::testing::TestPadFusedIntoConv(/*with_bias=*/false);
+}
+
+TF_LITE_MICRO_TEST(ReluFusedIntoConvWithoutPad) {
+  const tflite::Model* model =
+      tflite::testing::GetConvChainModel(/*with_pad=*/false,
+                                         /*with_bias=*/true);
+  int8_t expected[tflite::testing::kOutputSize];
+  int8_t output[tflite::testing::kOutputSize];
+  tflite::NodeAndRegistration conv;
+
+  TF_LITE_MICRO_EXPECT_EQ(
+      0, tflite::testing::RunConvChainModel(model, false, expected, &conv));
+  TF_LITE_MICRO_EXPECT_EQ(
+      1, tflite::testing::RunConvChainModel(model, true, output, &conv));
+  TF_LITE_MICRO_EXPECT_EQ(3, conv.node.inputs->size);
+  for (int i = 0; i < tflite::testing::kOutputSize; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(expected[i], output[i]);
+  }
+}
+
+TF_LITE_MICRO_TESTS_END
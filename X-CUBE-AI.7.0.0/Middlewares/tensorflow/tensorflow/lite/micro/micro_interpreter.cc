@@ -17,6 +17,7 @@ limitations under the License.
 #include <cstdarg>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/c/common.h"
@@ -25,7 +26,9 @@ limitations under the License.
 #include "tensorflow/lite/micro/memory_helpers.h"
 #include "tensorflow/lite/micro/micro_allocator.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_graph_fusion.h"
 #include "tensorflow/lite/micro/micro_op_resolver.h"
+#include "tensorflow/lite/micro/micro_patch_execution.h"
 #include "tensorflow/lite/micro/micro_profiler.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
@@ -195,6 +198,18 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
   context_helper_.SetTfLiteEvalTensors(eval_tensors_);
   context_.tensors_size = subgraph_->tensors()->size();
 
+  // Graph rewrites must happen before any kernel sees its node.
+  if (graph_fusion_enabled_) {
+    TF_LITE_ENSURE_STATUS(
+        FuseGraphNodes(model_, eval_tensors_, node_and_registrations_,
+                       &allocator_, error_reporter_, &graph_fusion_stats_));
+    if (context_.profiler != nullptr) {
+      reinterpret_cast<MicroProfiler*>(context_.profiler)
+          ->SetGraphFusionInfo(graph_fusion_stats_.fused_nodes,
+                               graph_fusion_stats_.bytes_saved);
+    }
+  }
+
   // Only allow AllocatePersistentBuffer in Init stage.
   context_.AllocatePersistentBuffer = context_helper_.AllocatePersistentBuffer;
   context_.RequestScratchBufferInArena = nullptr;
@@ -203,6 +218,9 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
   for (size_t i = 0; i < subgraph_->operators()->size(); ++i) {
     auto* node = &(node_and_registrations_[i].node);
     auto* registration = node_and_registrations_[i].registration;
+    if (IsFusedNode(*node)) {
+      continue;
+    }
     size_t init_data_size;
     const char* init_data;
     if (registration->builtin_code == BuiltinOperator_CUSTOM) {
@@ -225,7 +243,7 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
   for (size_t i = 0; i < subgraph_->operators()->size(); ++i) {
     auto* node = &(node_and_registrations_[i].node);
     auto* registration = node_and_registrations_[i].registration;
-    if (registration->prepare) {
+    if (registration->prepare && !IsFusedNode(*node)) {
       TfLiteStatus prepare_status = registration->prepare(&context_, node);
       if (prepare_status != kTfLiteOk) {
         TF_LITE_REPORT_ERROR(
@@ -238,6 +256,15 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
     allocator_.FinishPrepareNodeAllocations(/*node_id=*/i);
   }
 
+  // The kernels have been prepared with the whole tensors, only the memory
+  // plan sees the patches.
+  if (patch_node_count_ > 0) {
+    TF_LITE_ENSURE_STATUS(PlanPatchExecution(
+        model_, eval_tensors_, node_and_registrations_, patch_node_count_,
+        patches_h_, patches_w_, &allocator_, error_reporter_, &patch_plan_,
+        &patch_stats_));
+  }
+
   // Prepare is done, we're ready for Invoke. Memory allocation is no longer
   // allowed. Kernels can only fetch scratch buffers via GetScratchBuffer.
   context_.AllocatePersistentBuffer = nullptr;
@@ -320,6 +347,29 @@ TfLiteStatus MicroInterpreter::Invoke() {
   for (size_t i = 0; i < subgraph_->operators()->size(); ++i) {
     auto* node = &(node_and_registrations_[i].node);
     auto* registration = node_and_registrations_[i].registration;
+    if (IsFusedNode(*node)) {
+      continue;
+    }
+
+    if (patch_plan_ != nullptr && static_cast<int>(i) == patch_plan_->nodes[0]) {
+      // The chain is profiled as its last node.
+      const int last_node = patch_plan_->nodes[patch_plan_->node_count - 1];
+      TfLiteStatus invoke_status;
+      {
+#if !defined(TF_LITE_STRIP_ERROR_STRINGS)
+        ScopedMicroProfiler scoped_profiler(
+            OpNameFromRegistration(
+                node_and_registrations_[last_node].registration),
+            reinterpret_cast<MicroProfiler*>(context_.profiler));
+#endif
+        invoke_status = InvokePatches();
+      }
+      if (invoke_status != kTfLiteOk) {
+        return invoke_status;
+      }
+      i = last_node;
+      continue;
+    }
 
 // This ifdef is needed (even though ScopedMicroProfiler itself is a no-op with
 // -DTF_LITE_STRIP_ERROR_STRINGS) because the function OpNameFromRegistration is
@@ -353,6 +403,91 @@ TfLiteStatus MicroInterpreter::Invoke() {
   return kTfLiteOk;
 }
 
+TfLiteStatus MicroInterpreter::InvokePatches() {
+  const MicroPatchPlan& plan = *patch_plan_;
+  const int n = plan.node_count;
+  TfLiteEvalTensor* input = &eval_tensors_[plan.tensors[0]];
+  TfLiteEvalTensor* output = &eval_tensors_[plan.tensors[n]];
+  TfLiteIntArray* input_dims = input->dims;
+  TfLiteIntArray* output_dims = output->dims;
+  const uint8_t* input_data = static_cast<const uint8_t*>(input->data.data);
+  uint8_t* output_data = static_cast<uint8_t*>(output->data.data);
+  uint8_t* input_patch = scratch_buffer_handles_[plan.input_buffer_index].data;
+  uint8_t* output_patch =
+      scratch_buffer_handles_[plan.output_buffer_index].data;
+  const size_t input_row_bytes = plan.sizes[1][0] * plan.input_pixel_bytes;
+  const size_t output_row_bytes = plan.sizes[1][n] * plan.output_pixel_bytes;
+
+  MicroPatchExtent rows;
+  MicroPatchExtent cols;
+  for (int patch_y = 0; patch_y < plan.patches[0]; ++patch_y) {
+    ComputePatchExtent(plan, 0, patch_y, &rows);
+    for (int patch_x = 0; patch_x < plan.patches[1]; ++patch_x) {
+      ComputePatchExtent(plan, 1, patch_x, &cols);
+      for (int t = 0; t <= n; ++t) {
+        plan.patch_dims[t]->data[1] = rows.end[t] - rows.begin[t];
+        plan.patch_dims[t]->data[2] = cols.end[t] - cols.begin[t];
+      }
+
+      // Gather the patch of the input.
+      const size_t input_patch_row_bytes =
+          plan.patch_dims[0]->data[2] * plan.input_pixel_bytes;
+      for (int y = rows.begin[0]; y < rows.end[0]; ++y) {
+        memcpy(input_patch + (y - rows.begin[0]) * input_patch_row_bytes,
+               input_data + y * input_row_bytes +
+                   cols.begin[0] * plan.input_pixel_bytes,
+               input_patch_row_bytes);
+      }
+
+      input->dims = plan.patch_dims[0];
+      input->data.data = input_patch;
+      output->dims = plan.patch_dims[n];
+      output->data.data = output_patch;
+      TfLiteStatus invoke_status = kTfLiteOk;
+      for (int k = 0; k < n && invoke_status == kTfLiteOk; ++k) {
+        auto* node = &(node_and_registrations_[plan.nodes[k]].node);
+        auto* registration = node_and_registrations_[plan.nodes[k]].registration;
+        invoke_status = registration->invoke(&context_, node);
+        allocator_.ResetTempAllocations();
+        if (invoke_status == kTfLiteError) {
+          TF_LITE_REPORT_ERROR(
+              error_reporter_,
+              "Node %s (number %d) failed to invoke with status %d",
+              OpNameFromRegistration(registration), plan.nodes[k],
+              invoke_status);
+        }
+      }
+      input->dims = input_dims;
+      input->data.data = const_cast<uint8_t*>(input_data);
+      output->dims = output_dims;
+      output->data.data = output_data;
+      if (invoke_status != kTfLiteOk) {
+        return invoke_status;
+      }
+
+      // Scatter the valid part of the patch of the output.
+      const size_t output_patch_row_bytes =
+          plan.patch_dims[n]->data[2] * plan.output_pixel_bytes;
+      const size_t valid_row_bytes =
+          (cols.end[n] - cols.valid_begin) * plan.output_pixel_bytes;
+      for (int y = rows.valid_begin; y < rows.end[n]; ++y) {
+        memcpy(output_data + y * output_row_bytes +
+                   cols.valid_begin * plan.output_pixel_bytes,
+               output_patch + (y - rows.begin[n]) * output_patch_row_bytes +
+                   (cols.valid_begin - cols.begin[n]) *
+                       plan.output_pixel_bytes,
+               valid_row_bytes);
+      }
+    }
+  }
+  return kTfLiteOk;
+}
+
+bool MicroInterpreter::is_patched_node(int node_index) const {
+  return patch_plan_ != nullptr && node_index >= patch_plan_->nodes[0] &&
+         node_index < patch_plan_->nodes[patch_plan_->node_count - 1];
+}
+
 TfLiteTensor* MicroInterpreter::input(size_t index) {
   const size_t length = inputs_size();
   if (index >= length) {
@@ -23,6 +23,8 @@ limitations under the License.
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_graph_fusion.h"
+#include "tensorflow/lite/micro/micro_patch_execution.h"
 #include "tensorflow/lite/micro/micro_op_resolver.h"
 #include "tensorflow/lite/micro/micro_profiler.h"
 #include "tensorflow/lite/portable_type_to_tflitetype.h"
@@ -103,6 +105,33 @@ class MicroInterpreter {
   // intermediate tensors.
   TfLiteStatus AllocateTensors();
 
+  // Enables the graph fusion pass (see micro_graph_fusion.h) run by
+  // AllocateTensors() before the kernels are initialized. Disabled by default.
+  // Has no effect once the tensors have been allocated.
+  void SetGraphFusionEnabled(bool enabled) { graph_fusion_enabled_ = enabled; }
+
+  // Returns the outcome of the graph fusion pass, only meaningful after
+  // `AllocateTensors` has been called.
+  const MicroGraphFusionStats& graph_fusion_stats() const {
+    return graph_fusion_stats_;
+  }
+
+  // Runs the first `node_count` nodes of the model patch by patch (see
+  // micro_patch_execution.h): their last output is computed in `patches_h` x
+  // `patches_w` spatial patches, so only one patch of the intermediate tensors
+  // is allocated. Disabled (0) by default. If the nodes can't be run patch by
+  // patch, the model is run layer by layer. Has no effect once the tensors
+  // have been allocated.
+  void SetPatchExecution(int node_count, int patches_h, int patches_w) {
+    patch_node_count_ = node_count;
+    patches_h_ = patches_h;
+    patches_w_ = patches_w;
+  }
+
+  // Returns the outcome of the planning of the patch-based execution, only
+  // meaningful after `AllocateTensors` has been called.
+  const MicroPatchStats& patch_stats() const { return patch_stats_; }
+
   // In order to support partial graph runs for strided models, this can return
   // values other than kTfLiteOk and kTfLiteError.
   // TODO(b/149795762): Add this to the TfLiteStatus enum.
@@ -164,6 +193,17 @@ class MicroInterpreter {
     return node_and_registrations_[node_index];
   }
 
+  // Returns true if the node has been folded into a neighbour by the graph
+  // fusion pass and is skipped by Invoke().
+  bool is_fused_node(int node_index) const {
+    return IsFusedNode(node_and_registrations_[node_index].node);
+  }
+
+  // Returns true if the node is run patch by patch with the next nodes, they
+  // are reported as the last node of the chain. The intermediate tensors of
+  // the chain only hold the last patch.
+  bool is_patched_node(int node_index) const;
+
   // For debugging only.
   // Returns the actual used arena in bytes. This method gives the optimal arena
   // size. It's only available after `AllocateTensors` has been called.
@@ -181,6 +221,9 @@ class MicroInterpreter {
   // error reporting during initialization.
   void Init(MicroProfiler* profiler);
 
+  // Invokes the nodes of the patch plan for all the patches.
+  TfLiteStatus InvokePatches();
+
   NodeAndRegistration* node_and_registrations_ = nullptr;
 
   const Model* model_;
@@ -192,6 +235,15 @@ class MicroInterpreter {
 
   TfLiteStatus initialization_status_;
 
+  bool graph_fusion_enabled_ = false;
+  MicroGraphFusionStats graph_fusion_stats_;
+
+  int patch_node_count_ = 0;
+  int patches_h_ = 0;
+  int patches_w_ = 0;
+  MicroPatchStats patch_stats_;
+  MicroPatchPlan* patch_plan_ = nullptr;
+
   const SubGraph* subgraph_ = nullptr;
   TfLiteEvalTensor* eval_tensors_ = nullptr;
   ScratchBufferHandle* scratch_buffer_handles_ = nullptr;
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_MICRO_MICRO_MUTABLE_OP_RESOLVER_H_
 #define TENSORFLOW_LITE_MICRO_MICRO_MUTABLE_OP_RESOLVER_H_
 
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 
@@ -33,24 +34,25 @@ limitations under the License.
 namespace tflite {
 TfLiteRegistration* Register_DETECTION_POSTPROCESS();
 
+// Builtin operators are looked up in constant time through a table indexed by
+// the BuiltinOperator code, which costs one byte per builtin code.
 template <unsigned int tOpCount>
 class MicroMutableOpResolver : public MicroOpResolver {
  public:
   TF_LITE_REMOVE_VIRTUAL_DELETE
 
+  static_assert(tOpCount < 0xFF, "Too many operators for the builtin index.");
+
   explicit MicroMutableOpResolver(ErrorReporter* error_reporter = nullptr)
-      : error_reporter_(error_reporter) {}
+      : error_reporter_(error_reporter) {
+    memset(builtin_index_, kNoBuiltinIndex, sizeof(builtin_index_));
+  }
 
   const TfLiteRegistration* FindOp(tflite::BuiltinOperator op) const override {
     if (op == BuiltinOperator_CUSTOM) return nullptr;
 
-    for (unsigned int i = 0; i < registrations_len_; ++i) {
-      const TfLiteRegistration& registration = registrations_[i];
-      if (registration.builtin_code == op) {
-        return &registration;
-      }
-    }
-    return nullptr;
+    const unsigned int index = BuiltinIndex(op);
+    return (index != kNoBuiltinIndex) ? &registrations_[index] : nullptr;
   }
 
   const TfLiteRegistration* FindOp(const char* op) const override {
@@ -66,11 +68,10 @@ class MicroMutableOpResolver : public MicroOpResolver {
 
   MicroOpResolver::BuiltinParseFunction GetOpDataParser(
       BuiltinOperator op) const override {
-    TFLITE_DCHECK(num_buitin_ops_ <= tOpCount);
-    for (unsigned int i = 0; i < num_buitin_ops_; ++i) {
-      if (builtin_codes_[i] == op) return builtin_parsers_[i];
-    }
-    return nullptr;
+    if (op == BuiltinOperator_CUSTOM) return nullptr;
+
+    const unsigned int index = BuiltinIndex(op);
+    return (index != kNoBuiltinIndex) ? builtin_parsers_[index] : nullptr;
   }
 
   // Registers a Custom Operator with the MicroOpResolver.
@@ -484,6 +485,15 @@ class MicroMutableOpResolver : public MicroOpResolver {
   unsigned int GetRegistrationLength() { return registrations_len_; }
 
  private:
+  static constexpr uint8_t kNoBuiltinIndex = 0xFF;
+
+  unsigned int BuiltinIndex(tflite::BuiltinOperator op) const {
+    if (op < BuiltinOperator_MIN || op > BuiltinOperator_MAX) {
+      return kNoBuiltinIndex;
+    }
+    return builtin_index_[op - BuiltinOperator_MIN];
+  }
+
   TfLiteStatus AddBuiltin(tflite::BuiltinOperator op,
                           const TfLiteRegistration& registration,
                           MicroOpResolver::BuiltinParseFunction parser) {
@@ -496,6 +506,15 @@ class MicroMutableOpResolver : public MicroOpResolver {
       return kTfLiteError;
     }
 
+    if (op < BuiltinOperator_MIN || op > BuiltinOperator_MAX) {
+      if (error_reporter_ != nullptr) {
+        TF_LITE_REPORT_ERROR(error_reporter_,
+                             "Invalid builtin op #%d passed to AddBuiltin.",
+                             op);
+      }
+      return kTfLiteError;
+    }
+
     if (FindOp(op) != nullptr) {
       if (error_reporter_ != nullptr) {
         TF_LITE_REPORT_ERROR(error_reporter_,
@@ -520,23 +539,24 @@ class MicroMutableOpResolver : public MicroOpResolver {
     // Strictly speaking, the builtin_code is not necessary for TFLM but filling
     // it in regardless.
     registrations_[registrations_len_].builtin_code = op;
+    builtin_parsers_[registrations_len_] = parser;
+    builtin_index_[op - BuiltinOperator_MIN] =
+        static_cast<uint8_t>(registrations_len_);
     registrations_len_++;
 
-    builtin_codes_[num_buitin_ops_] = op;
-    builtin_parsers_[num_buitin_ops_] = parser;
-    num_buitin_ops_++;
-
     return kTfLiteOk;
   }
 
   TfLiteRegistration registrations_[tOpCount];
   unsigned int registrations_len_ = 0;
 
-  // Arrays (and counter) to store the builtin codes and their corresponding
-  // parse functions as these are registered with the Op Resolver.
-  BuiltinOperator builtin_codes_[tOpCount];
+  // Parse functions of the builtin operators, stored at the index of their
+  // registration.
   MicroOpResolver::BuiltinParseFunction builtin_parsers_[tOpCount];
-  unsigned int num_buitin_ops_ = 0;
+
+  // Index in registrations_ of each builtin operator, kNoBuiltinIndex if the
+  // operator has not been added.
+  uint8_t builtin_index_[BuiltinOperator_MAX - BuiltinOperator_MIN + 1];
 
   ErrorReporter* error_reporter_;
 };
@@ -0,0 +1,484 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/micro_patch_execution.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/core/api/error_reporter.h"
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/kernels/padding.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/micro_graph_fusion.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+namespace {
+
+constexpr char kOfflineMemAllocMetadata[] = "OfflineMemoryAllocation";
+
+// Input layout of the nodes handled by the planner.
+constexpr int kInputTensor = 0;
+constexpr int kFilterTensor = 1;
+constexpr int kConvPaddingsTensor = 3;
+
+bool HasOfflineMemoryPlan(const Model* model) {
+  if (model->metadata() == nullptr) {
+    return false;
+  }
+  for (size_t i = 0; i < model->metadata()->size(); ++i) {
+    auto metadata = model->metadata()->Get(i);
+    if (strncmp(metadata->name()->c_str(), kOfflineMemAllocMetadata,
+                strlen(kOfflineMemAllocMetadata)) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IsSubgraphTensor(const flatbuffers::Vector<int32_t>* tensors,
+                      int tensor_index) {
+  for (size_t i = 0; i < tensors->size(); ++i) {
+    if (tensors->Get(i) == tensor_index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Elementwise operators: the output element `o` is computed from the input
+// element `o`.
+bool IsElementwiseOperator(int32_t builtin_code) {
+  switch (builtin_code) {
+    case BuiltinOperator_RELU:
+    case BuiltinOperator_RELU6:
+    case BuiltinOperator_LOGISTIC:
+    case BuiltinOperator_TANH:
+    case BuiltinOperator_QUANTIZE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+class PatchPlanner {
+ public:
+  PatchPlanner(const SubGraph* subgraph, TfLiteEvalTensor* eval_tensors,
+               NodeAndRegistration* node_and_registrations,
+               ErrorReporter* error_reporter, MicroPatchPlan* plan)
+      : subgraph_(subgraph),
+        eval_tensors_(eval_tensors),
+        nodes_(node_and_registrations),
+        nodes_size_(subgraph->operators()->size()),
+        error_reporter_(error_reporter),
+        plan_(plan) {}
+
+  // Builds the chain of the first `node_count` nodes, returns false (reported)
+  // if it can't be run patch by patch.
+  bool BuildChain(int node_count, int patches_h, int patches_w);
+
+ private:
+  bool IsLive(int node_index) const {
+    return !IsFusedNode(nodes_[node_index].node);
+  }
+
+  // 4D tensor (NHWC) with a single batch.
+  bool IsImageTensor(int tensor_index) const {
+    const TfLiteIntArray* dims = eval_tensors_[tensor_index].dims;
+    return dims->size == 4 && dims->data[0] == 1;
+  }
+
+  // Returns the number of live node inputs referencing the tensor.
+  int CountConsumers(int tensor_index) const;
+
+  // Sets the windows of the node, returns false if the operator isn't
+  // supported.
+  bool SetWindows(int node_index, MicroPatchWindow* rows,
+                  MicroPatchWindow* cols) const;
+
+  const SubGraph* subgraph_;
+  TfLiteEvalTensor* eval_tensors_;
+  NodeAndRegistration* nodes_;
+  const int nodes_size_;
+  ErrorReporter* error_reporter_;
+  MicroPatchPlan* plan_;
+};
+
+int PatchPlanner::CountConsumers(int tensor_index) const {
+  int count = 0;
+  for (int i = 0; i < nodes_size_; ++i) {
+    if (!IsLive(i)) continue;
+    const TfLiteIntArray* inputs = nodes_[i].node.inputs;
+    for (int n = 0; n < inputs->size; ++n) {
+      if (inputs->data[n] == tensor_index) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+bool PatchPlanner::SetWindows(int node_index, MicroPatchWindow* rows,
+                              MicroPatchWindow* cols) const {
+  const TfLiteNode& node = nodes_[node_index].node;
+  const int32_t builtin_code = nodes_[node_index].registration->builtin_code;
+  const TfLiteIntArray* input_dims = eval_tensors_[node.inputs->data[0]].dims;
+  int height = input_dims->data[1];
+  int width = input_dims->data[2];
+  int out_height;
+  int out_width;
+  TfLitePaddingValues padding;
+
+  if (IsElementwiseOperator(builtin_code)) {
+    *rows = {/*stride=*/1, /*kernel=*/1, /*padding=*/0};
+    *cols = {/*stride=*/1, /*kernel=*/1, /*padding=*/0};
+    return true;
+  }
+
+  if (builtin_code == BuiltinOperator_CONV_2D ||
+      builtin_code == BuiltinOperator_DEPTHWISE_CONV_2D) {
+    if (node.inputs->size < 2) return false;
+    const TfLiteIntArray* filter_dims =
+        eval_tensors_[node.inputs->data[kFilterTensor]].dims;
+    if (filter_dims->size != 4) return false;
+    int stride_h, stride_w, dilation_h, dilation_w;
+    TfLitePadding type;
+    if (builtin_code == BuiltinOperator_CONV_2D) {
+      const auto* params =
+          reinterpret_cast<const TfLiteConvParams*>(node.builtin_data);
+      stride_h = params->stride_height;
+      stride_w = params->stride_width;
+      dilation_h = params->dilation_height_factor;
+      dilation_w = params->dilation_width_factor;
+      type = params->padding;
+    } else {
+      const auto* params =
+          reinterpret_cast<const TfLiteDepthwiseConvParams*>(
+              node.builtin_data);
+      stride_h = params->stride_height;
+      stride_w = params->stride_width;
+      dilation_h = params->dilation_height_factor;
+      dilation_w = params->dilation_width_factor;
+      type = params->padding;
+    }
+    // A PAD folded by the graph fusion pass (see conv_common.cc).
+    int pad_top = 0;
+    int pad_left = 0;
+    if (builtin_code == BuiltinOperator_CONV_2D && node.inputs->size == 4) {
+      const int32_t* pads =
+          eval_tensors_[node.inputs->data[kConvPaddingsTensor]].data.i32;
+      pad_top = pads[2];
+      pad_left = pads[4];
+      height += pads[2] + pads[3];
+      width += pads[4] + pads[5];
+    }
+    const int filter_h = filter_dims->data[1];
+    const int filter_w = filter_dims->data[2];
+    padding = ComputePaddingHeightWidth(stride_h, stride_w, dilation_h,
+                                        dilation_w, height, width, filter_h,
+                                        filter_w, type, &out_height,
+                                        &out_width);
+    *rows = {stride_h, (filter_h - 1) * dilation_h + 1,
+             padding.height + pad_top};
+    *cols = {stride_w, (filter_w - 1) * dilation_w + 1,
+             padding.width + pad_left};
+  } else if (builtin_code == BuiltinOperator_MAX_POOL_2D ||
+             builtin_code == BuiltinOperator_AVERAGE_POOL_2D) {
+    const auto* params =
+        reinterpret_cast<const TfLitePoolParams*>(node.builtin_data);
+    padding = ComputePaddingHeightWidth(
+        params->stride_height, params->stride_width, 1, 1, height, width,
+        params->filter_height, params->filter_width, params->padding,
+        &out_height, &out_width);
+    *rows = {params->stride_height, params->filter_height, padding.height};
+    *cols = {params->stride_width, params->filter_width, padding.width};
+  } else {
+    return false;
+  }
+
+  // Windows matching the shape computed at Prepare.
+  const TfLiteIntArray* output_dims = eval_tensors_[node.outputs->data[0]].dims;
+  return output_dims->data[1] == out_height &&
+         output_dims->data[2] == out_width;
+}
+
+bool PatchPlanner::BuildChain(int node_count, int patches_h, int patches_w) {
+  if (node_count > nodes_size_ || patches_h < 1 || patches_w < 1) {
+    TF_LITE_REPORT_ERROR(error_reporter_,
+                         "Patch-based execution: invalid configuration "
+                         "(%d nodes, %dx%d patches)",
+                         node_count, patches_h, patches_w);
+    return false;
+  }
+  plan_->node_count = 0;
+  plan_->patches[0] = patches_h;
+  plan_->patches[1] = patches_w;
+
+  for (int i = 0; i < node_count; ++i) {
+    if (!IsLive(i)) continue;
+    const TfLiteNode& node = nodes_[i].node;
+    const int n = plan_->node_count;
+    if (n == kMaxPatchNodes) {
+      TF_LITE_REPORT_ERROR(error_reporter_,
+                           "Patch-based execution: more than %d nodes",
+                           kMaxPatchNodes);
+      return false;
+    }
+    if (node.inputs->size < 1 || node.outputs->size != 1) {
+      TF_LITE_REPORT_ERROR(error_reporter_,
+                           "Patch-based execution: node %d not supported", i);
+      return false;
+    }
+
+    const int input_index = node.inputs->data[kInputTensor];
+    const int output_index = node.outputs->data[0];
+    if (n == 0) {
+      if (!IsSubgraphTensor(subgraph_->inputs(), input_index) ||
+          !IsImageTensor(input_index)) {
+        TF_LITE_REPORT_ERROR(error_reporter_,
+                             "Patch-based execution: the input of node %d is "
+                             "not a 4D input of the model",
+                             i);
+        return false;
+      }
+      plan_->tensors[0] = input_index;
+    } else if (input_index != plan_->tensors[n] ||
+               CountConsumers(input_index) != 1 ||
+               IsSubgraphTensor(subgraph_->outputs(), input_index)) {
+      TF_LITE_REPORT_ERROR(error_reporter_,
+                           "Patch-based execution: node %d doesn't only read "
+                           "the output of the previous node",
+                           i);
+      return false;
+    }
+    // The other inputs are weights.
+    for (int m = 1; m < node.inputs->size; ++m) {
+      const int index = node.inputs->data[m];
+      if (index >= 0 && eval_tensors_[index].data.data == nullptr) {
+        TF_LITE_REPORT_ERROR(error_reporter_,
+                             "Patch-based execution: node %d has a variable "
+                             "input %d",
+                             i, m);
+        return false;
+      }
+    }
+    if (!IsImageTensor(output_index) ||
+        subgraph_->tensors()->Get(output_index)->is_variable() ||
+        !SetWindows(i, &plan_->windows[0][n], &plan_->windows[1][n])) {
+      TF_LITE_REPORT_ERROR(error_reporter_,
+                           "Patch-based execution: node %d (%s) not supported",
+                           i,
+                           EnumNameBuiltinOperator(static_cast<BuiltinOperator>(
+                               nodes_[i].registration->builtin_code)));
+      return false;
+    }
+    plan_->nodes[n] = i;
+    plan_->tensors[n + 1] = output_index;
+    plan_->node_count++;
+  }
+
+  const int n = plan_->node_count;
+  if (n == 0) {
+    TF_LITE_REPORT_ERROR(error_reporter_, "Patch-based execution: no node");
+    return false;
+  }
+  for (int i = 0; i <= n; ++i) {
+    const TfLiteIntArray* dims = eval_tensors_[plan_->tensors[i]].dims;
+    plan_->sizes[0][i] = dims->data[1];
+    plan_->sizes[1][i] = dims->data[2];
+  }
+  if (plan_->sizes[0][n] < patches_h || plan_->sizes[1][n] < patches_w) {
+    TF_LITE_REPORT_ERROR(error_reporter_,
+                         "Patch-based execution: output of %dx%d for %dx%d "
+                         "patches",
+                         plan_->sizes[0][n], plan_->sizes[1][n], patches_h,
+                         patches_w);
+    return false;
+  }
+  return true;
+}
+
+// Largest patch of the tensors of the chain along the dimension `dim`, and
+// sum of the patches of the output of the nodes.
+void MeasurePatches(const MicroPatchPlan& plan, int dim, int* max_size,
+                    int* sum_size) {
+  for (int i = 0; i <= plan.node_count; ++i) {
+    max_size[i] = 0;
+    sum_size[i] = 0;
+  }
+  MicroPatchExtent extent;
+  for (int patch = 0; patch < plan.patches[dim]; ++patch) {
+    ComputePatchExtent(plan, dim, patch, &extent);
+    for (int i = 0; i <= plan.node_count; ++i) {
+      const int size = extent.end[i] - extent.begin[i];
+      if (size > max_size[i]) {
+        max_size[i] = size;
+      }
+      sum_size[i] += size;
+    }
+  }
+}
+
+}  // namespace
+
+void ComputePatchExtent(const MicroPatchPlan& plan, int dim, int patch,
+                        MicroPatchExtent* extent) {
+  const int n = plan.node_count;
+  const MicroPatchWindow* windows = plan.windows[dim];
+  const int* sizes = plan.sizes[dim];
+
+  // Backward: elements needed by the patch of the output.
+  int needed_begin[kMaxPatchNodes + 1];
+  needed_begin[n] = patch * sizes[n] / plan.patches[dim];
+  extent->end[n] = (patch + 1) * sizes[n] / plan.patches[dim];
+  for (int i = n - 1; i >= 0; --i) {
+    const MicroPatchWindow& window = windows[i];
+    const int begin = needed_begin[i + 1] * window.stride - window.padding;
+    const int end = (extent->end[i + 1] - 1) * window.stride -
+                    window.padding + window.kernel;
+    needed_begin[i] = (begin > 0) ? begin : 0;
+    extent->end[i] = (end < sizes[i]) ? end : sizes[i];
+  }
+
+  // Forward: the patch of the input starts on a multiple of the strides, the
+  // elements of a patch of a tensor are then strided from the elements of
+  // the patch of its input (same padding as the whole tensors). The leading
+  // elements before the needed ones read a partial window.
+  int stride = 1;
+  for (int i = 0; i < n; ++i) {
+    stride *= windows[i].stride;
+  }
+  extent->begin[0] = (needed_begin[0] / stride) * stride;
+  for (int i = 0; i < n; ++i) {
+    extent->begin[i + 1] = extent->begin[i] / windows[i].stride;
+  }
+  extent->valid_begin = needed_begin[n];
+}
+
+TfLiteStatus PlanPatchExecution(const Model* model,
+                                TfLiteEvalTensor* eval_tensors,
+                                NodeAndRegistration* node_and_registrations,
+                                int node_count, int patches_h, int patches_w,
+                                MicroAllocator* allocator,
+                                ErrorReporter* error_reporter,
+                                MicroPatchPlan** plan, MicroPatchStats* stats) {
+  TFLITE_DCHECK(model != nullptr);
+  TFLITE_DCHECK(eval_tensors != nullptr);
+  TFLITE_DCHECK(node_and_registrations != nullptr);
+  TFLITE_DCHECK(plan != nullptr);
+  TFLITE_DCHECK(stats != nullptr);
+
+  *plan = nullptr;
+  *stats = MicroPatchStats();
+
+  // The lifetimes of an offline plan can't be extended.
+  if (HasOfflineMemoryPlan(model) || model->subgraphs()->size() != 1) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "Patch-based execution: offline memory plan");
+    return kTfLiteOk;
+  }
+
+  MicroPatchPlan chain;
+  PatchPlanner planner((*model->subgraphs())[0], eval_tensors,
+                       node_and_registrations, error_reporter, &chain);
+  if (!planner.BuildChain(node_count, patches_h, patches_w)) {
+    return kTfLiteOk;
+  }
+  MicroPatchPlan* current = reinterpret_cast<MicroPatchPlan*>(
+      allocator->AllocatePersistentBuffer(sizeof(MicroPatchPlan)));
+  if (current == nullptr) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "Failed to allocate %d bytes for the patch plan",
+                         sizeof(MicroPatchPlan));
+    return kTfLiteError;
+  }
+  *current = chain;
+
+  const int n = current->node_count;
+  int max_rows[kMaxPatchNodes + 1];
+  int sum_rows[kMaxPatchNodes + 1];
+  int max_cols[kMaxPatchNodes + 1];
+  int sum_cols[kMaxPatchNodes + 1];
+  MeasurePatches(*current, 0, max_rows, sum_rows);
+  MeasurePatches(*current, 1, max_cols, sum_cols);
+
+  // Shape of the patches, the intermediate tensors are planned with the
+  // largest one.
+  for (int i = 0; i <= n; ++i) {
+    TfLiteEvalTensor* tensor = &eval_tensors[current->tensors[i]];
+    TfLiteIntArray* dims = reinterpret_cast<TfLiteIntArray*>(
+        allocator->AllocatePersistentBuffer(TfLiteIntArrayGetSizeInBytes(4)));
+    if (dims == nullptr) {
+      TF_LITE_REPORT_ERROR(error_reporter,
+                           "Failed to allocate %d bytes for a patch shape",
+                           TfLiteIntArrayGetSizeInBytes(4));
+      return kTfLiteError;
+    }
+    dims->size = 4;
+    dims->data[0] = 1;
+    dims->data[1] = max_rows[i];
+    dims->data[2] = max_cols[i];
+    dims->data[3] = tensor->dims->data[3];
+    current->patch_dims[i] = dims;
+  }
+
+  size_t bytes;
+  TF_LITE_ENSURE_STATUS(TfLiteEvalTensorByteLength(
+      &eval_tensors[current->tensors[0]], &bytes));
+  current->input_pixel_bytes = bytes / (current->sizes[0][0] *
+                                        current->sizes[1][0]);
+  TF_LITE_ENSURE_STATUS(TfLiteEvalTensorByteLength(
+      &eval_tensors[current->tensors[n]], &bytes));
+  current->output_pixel_bytes = bytes / (current->sizes[0][n] *
+                                         current->sizes[1][n]);
+
+  // The patch of the input is only read by the first node, the patch of the
+  // output is only written by the last node.
+  TF_LITE_ENSURE_STATUS(allocator->RequestScratchBufferInArena(
+      max_rows[0] * max_cols[0] * current->input_pixel_bytes,
+      &current->input_buffer_index));
+  TF_LITE_ENSURE_STATUS(
+      allocator->FinishPrepareNodeAllocations(current->nodes[0]));
+  TF_LITE_ENSURE_STATUS(allocator->RequestScratchBufferInArena(
+      max_rows[n] * max_cols[n] * current->output_pixel_bytes,
+      &current->output_buffer_index));
+  TF_LITE_ENSURE_STATUS(
+      allocator->FinishPrepareNodeAllocations(current->nodes[n - 1]));
+
+  // Whole tensors are read and written by all the patches.
+  TF_LITE_ENSURE_STATUS(allocator->ExtendTensorLifetime(
+      current->tensors[0], current->nodes[0], current->nodes[n - 1]));
+  TF_LITE_ENSURE_STATUS(allocator->ExtendTensorLifetime(
+      current->tensors[n], current->nodes[0], current->nodes[n - 1]));
+  for (int i = 1; i < n; ++i) {
+    eval_tensors[current->tensors[i]].dims = current->patch_dims[i];
+  }
+
+  stats->patched_nodes = n;
+  stats->patches = patches_h * patches_w;
+  for (int i = 1; i <= n; ++i) {
+    stats->computed_pixels += static_cast<size_t>(sum_rows[i]) * sum_cols[i];
+    stats->pixels +=
+        static_cast<size_t>(current->sizes[0][i]) * current->sizes[1][i];
+  }
+  *plan = current;
+  return kTfLiteOk;
+}
+
+}  // namespace tflite
@@ -0,0 +1,116 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_MICRO_MICRO_PATCH_EXECUTION_H_
+#define TENSORFLOW_LITE_MICRO_MICRO_PATCH_EXECUTION_H_
+
+#include <cstddef>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/core/api/error_reporter.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+// Maximum number of nodes run patch by patch.
+constexpr int kMaxPatchNodes = 8;
+
+// Outcome of the planning of the patch-based execution.
+struct MicroPatchStats {
+  // Number of nodes run patch by patch (0: layer by layer execution).
+  int patched_nodes = 0;
+  // Number of patches.
+  int patches = 0;
+  // Output elements (rows x columns) computed by the patched nodes for all
+  // the patches, and for the whole tensors. The difference is the cost of
+  // the overlapping input windows (halos).
+  size_t computed_pixels = 0;
+  size_t pixels = 0;
+};
+
+// Window of a node along a spatial dimension: the output element `o` is
+// computed from the input elements [o * stride - padding,
+// o * stride - padding + kernel).
+struct MicroPatchWindow {
+  int stride;
+  int kernel;  // Dilated.
+  int padding;
+};
+
+// Extent of a patch along a spatial dimension. The tensor `i` of the chain
+// holds the elements [begin[i], end[i]) of the whole tensor. The leading
+// output elements [begin[node_count], valid_begin) are computed from a
+// partial window and are dropped.
+struct MicroPatchExtent {
+  int begin[kMaxPatchNodes + 1];
+  int end[kMaxPatchNodes + 1];
+  int valid_begin;
+};
+
+// Chain of nodes run patch by patch. Node `nodes[i]` reads the tensor
+// `tensors[i]` and writes `tensors[i + 1]`. The input of the chain and its
+// output are whole tensors, the intermediate tensors hold one patch.
+struct MicroPatchPlan {
+  int node_count;
+  int nodes[kMaxPatchNodes];
+  int tensors[kMaxPatchNodes + 1];
+  // Spatial dimension 0: height, 1: width.
+  int patches[2];
+  MicroPatchWindow windows[2][kMaxPatchNodes];
+  int sizes[2][kMaxPatchNodes + 1];
+  // Bytes of an element (all the channels) of the input and the output.
+  size_t input_pixel_bytes;
+  size_t output_pixel_bytes;
+  // Shape of a patch of the tensors of the chain.
+  TfLiteIntArray* patch_dims[kMaxPatchNodes + 1];
+  // Scratch buffers holding a patch of the input and of the output.
+  int input_buffer_index;
+  int output_buffer_index;
+};
+
+// Returns the nodes of the chain to run patch by patch: the first
+// `node_count` nodes of the model (nodes removed by the graph fusion pass are
+// skipped), split in `patches_h` x `patches_w` patches of their last output.
+// Each node reads the output of the previous one, which no other node reads:
+//  - CONV_2D (including a folded PAD), DEPTHWISE_CONV_2D, MAX_POOL_2D and
+//    AVERAGE_POOL_2D with constant weights;
+//  - RELU, RELU6, LOGISTIC, TANH and QUANTIZE.
+// The tensors are 4D (NHWC) with a single batch, the input of the chain is
+// an input of the model and the intermediate tensors are not outputs of the
+// model. The shape of the intermediate tensors is set to the largest patch,
+// the memory planner then only allocates one patch. The buffers of the input
+// and of the output of the chain are kept alive by all the nodes of the
+// chain, the patches are copied from/to them through two scratch buffers.
+//
+// `plan` is set to nullptr (the model is run layer by layer) when the nodes
+// can't be run patch by patch. Must be called once the kernels are prepared
+// (they see the whole tensors), before
+// MicroAllocator::FinishModelAllocation().
+TfLiteStatus PlanPatchExecution(const Model* model,
+                                TfLiteEvalTensor* eval_tensors,
+                                NodeAndRegistration* node_and_registrations,
+                                int node_count, int patches_h, int patches_w,
+                                MicroAllocator* allocator,
+                                ErrorReporter* error_reporter,
+                                MicroPatchPlan** plan, MicroPatchStats* stats);
+
+// Computes the extent of the patch `patch` along the spatial dimension `dim`
+// (0: height, 1: width) for all the tensors of the chain.
+void ComputePatchExtent(const MicroPatchPlan& plan, int dim, int patch,
+                        MicroPatchExtent* extent);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_MICRO_PATCH_EXECUTION_H_
@@ -0,0 +1,155 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/micro_patch_execution.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/micro/all_ops_resolver.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/test_helpers.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+namespace tflite {
+namespace testing {
+namespace {
+
+constexpr size_t kArenaSize = 64 * 1024;
+constexpr int kOutputSize = 8 * 8 * 8;
+
+struct PatchRun {
+  int8_t output[kOutputSize];
+  size_t arena_used_bytes;
+  MicroPatchStats stats;
+};
+
+// Runs the model twice on a fixed input, so that a patch left over from the
+// first Invoke() can't hide a wrong halo in the second one.
+void RunConvChainModel(const Model* model, bool fusion, int node_count,
+                       int patches_h, int patches_w, PatchRun* run) {
+  alignas(16) static uint8_t arena[kArenaSize];
+  std::memset(arena, 0x55, kArenaSize);
+  const AllOpsResolver resolver;
+  MicroInterpreter interpreter(model, resolver, arena, kArenaSize,
+                               GetMicroErrorReporter());
+  interpreter.SetGraphFusionEnabled(fusion);
+  interpreter.SetPatchExecution(node_count, patches_h, patches_w);
+  TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, interpreter.AllocateTensors());
+
+  for (int i = 0; i < 2; ++i) {
+    TfLiteTensor* input = interpreter.input(0);
+    for (size_t j = 0; j < input->bytes; ++j) {
+      input->data.int8[j] = static_cast<int8_t>((j * 97 + 11 + i) % 256);
+    }
+    TF_LITE_MICRO_EXPECT_EQ(kTfLiteOk, interpreter.Invoke());
+  }
+  TF_LITE_MICRO_EXPECT_EQ(static_cast<size_t>(kOutputSize),
+                          interpreter.output(0)->bytes);
+  std::memcpy(run->output, interpreter.output(0)->data.int8, kOutputSize);
+  run->arena_used_bytes = interpreter.arena_used_bytes();
+  run->stats = interpreter.patch_stats();
+}
+
+// Runs the first 2 to `node_count` nodes of the model patch by patch with
+// several grids, including uneven splits and patches smaller than the
+// receptive field, and checks the outputs against the layer by layer
+// execution. `fused_nodes` is the number of nodes fused among the first ones.
+// Returns the smallest arena use.
+size_t TestPatchesMatchLayerByLayer(const Model* model, bool fusion,
+                                    int node_count, const int* fused_nodes,
+                                    size_t* reference_bytes) {
+  constexpr int kGrids[][2] = {{1, 1}, {2, 2}, {3, 3}, {1, 3},
+                               {3, 1}, {2, 3}, {4, 4}};
+  PatchRun reference;
+  RunConvChainModel(model, fusion, 0, 0, 0, &reference);
+  TF_LITE_MICRO_EXPECT_EQ(0, reference.stats.patched_nodes);
+  *reference_bytes = reference.arena_used_bytes;
+
+  size_t min_bytes = reference.arena_used_bytes;
+  for (int nodes = 2; nodes <= node_count; ++nodes) {
+    for (const auto& grid : kGrids) {
+      PatchRun run;
+      RunConvChainModel(model, fusion, nodes, grid[0], grid[1], &run);
+      TF_LITE_MICRO_EXPECT_EQ(nodes - fused_nodes[nodes],
+                              run.stats.patched_nodes);
+      TF_LITE_MICRO_EXPECT_EQ(grid[0] * grid[1], run.stats.patches);
+      TF_LITE_MICRO_EXPECT_GE(run.stats.computed_pixels, run.stats.pixels);
+      for (int i = 0; i < kOutputSize; ++i) {
+        TF_LITE_MICRO_EXPECT_EQ(reference.output[i], run.output[i]);
+      }
+      if (run.arena_used_bytes < min_bytes) {
+        min_bytes = run.arena_used_bytes;
+      }
+    }
+  }
+  return min_bytes;
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace tflite
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(PatchedConvChainMatchesLayerByLayer) {
+  // CONV_2D -> RELU -> DEPTHWISE_CONV_2D -> MAX_POOL_2D.
+  const tflite::Model* model =
+      tflite::testing::GetConvChainModel(/*with_pad=*/false,
+                                         /*with_bias=*/true);
+  const int fused_nodes[] = {0, 0, 0, 0, 0};
+  size_t reference_bytes;
+  const size_t min_bytes = tflite::testing::TestPatchesMatchLayerByLayer(
+      model, /*fusion=*/false, 4, fused_nodes, &reference_bytes);
+  MicroPrintf("Arena use: %d bytes layer by layer, %d bytes patched",
+              static_cast<int>(reference_bytes), static_cast<int>(min_bytes));
+  TF_LITE_MICRO_EXPECT_LT(min_bytes, reference_bytes);
+}
+
+TF_LITE_MICRO_TEST(PatchedFusedConvChainMatchesLayerByLayer) {
+  // PAD and RELU are fused: CONV_2D -> DEPTHWISE_CONV_2D -> MAX_POOL_2D, the
+  // CONV_2D reads the unpadded input. The fused nodes still count in the
+  // node count given to SetPatchExecution().
+  const tflite::Model* model =
+      tflite::testing::GetConvChainModel(/*with_pad=*/true,
+                                         /*with_bias=*/true);
+  const int fused_nodes[] = {0, 1, 1, 2, 2, 2};
+  size_t reference_bytes;
+  const size_t min_bytes = tflite::testing::TestPatchesMatchLayerByLayer(
+      model, /*fusion=*/true, 5, fused_nodes, &reference_bytes);
+  MicroPrintf("Arena use: %d bytes layer by layer, %d bytes patched",
+              static_cast<int>(reference_bytes), static_cast<int>(min_bytes));
+  TF_LITE_MICRO_EXPECT_LT(min_bytes, reference_bytes);
+}
+
+TF_LITE_MICRO_TEST(UnsupportedChainRunsLayerByLayer) {
+  // Without graph fusion the chain starts with a PAD, which can't be run
+  // patch by patch.
+  const tflite::Model* model =
+      tflite::testing::GetConvChainModel(/*with_pad=*/true,
+                                         /*with_bias=*/true);
+  tflite::testing::PatchRun reference;
+  tflite::testing::PatchRun run;
+  tflite::testing::RunConvChainModel(model, false, 0, 0, 0, &reference);
+  tflite::testing::RunConvChainModel(model, false, 3, 2, 2, &run);
+  TF_LITE_MICRO_EXPECT_EQ(0, run.stats.patched_nodes);
+  TF_LITE_MICRO_EXPECT_EQ(reference.arena_used_bytes, run.arena_used_bytes);
+  for (int i = 0; i < tflite::testing::kOutputSize; ++i) {
+    TF_LITE_MICRO_EXPECT_EQ(reference.output[i], run.output[i]);
+  }
+}
+
+TF_LITE_MICRO_TESTS_END
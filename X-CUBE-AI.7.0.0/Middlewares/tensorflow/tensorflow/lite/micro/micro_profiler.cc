@@ -52,6 +52,10 @@ void MicroProfiler::Log() const {
     int32_t ticks = end_ticks_[i] - start_ticks_[i];
     MicroPrintf("%s took %d ticks (%d ms).", tags_[i], ticks, TicksToMs(ticks));
   }
+  if (fused_nodes_ > 0) {
+    MicroPrintf("%d nodes fused, %d bytes of memory traffic saved per invoke.",
+                fused_nodes_, static_cast<int>(fusion_bytes_saved_));
+  }
 #endif
 }
 
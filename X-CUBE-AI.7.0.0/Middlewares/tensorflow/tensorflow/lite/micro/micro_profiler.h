@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_MICRO_MICRO_PROFILER_H_
 #define TENSORFLOW_LITE_MICRO_MICRO_PROFILER_H_
 
+#include <cstddef>
 #include <cstdint>
 
 #include "tensorflow/lite/micro/compatibility.h"
@@ -53,6 +54,17 @@ class MicroProfiler {
   // event[i] <= start time of event[i+1]).
   int32_t GetTotalTicks() const;
 
+  // Records the outcome of the graph fusion pass run by the MicroInterpreter
+  // when allocating tensors: the number of nodes removed from the execution
+  // plan and the activation bytes they would have moved on every invoke.
+  virtual void SetGraphFusionInfo(int fused_nodes, size_t bytes_saved) {
+    fused_nodes_ = fused_nodes;
+    fusion_bytes_saved_ = bytes_saved;
+  }
+
+  int fused_nodes() const { return fused_nodes_; }
+  size_t fusion_bytes_saved() const { return fusion_bytes_saved_; }
+
   // Prints the profiling information of each of the events.
   void Log() const;
 
@@ -67,6 +79,9 @@ class MicroProfiler {
   int32_t end_ticks_[kMaxEvents];
   int num_events_ = 0;
 
+  int fused_nodes_ = 0;
+  size_t fusion_bytes_saved_ = 0;
+
   TF_LITE_REMOVE_VIRTUAL_DELETE;
 };
 
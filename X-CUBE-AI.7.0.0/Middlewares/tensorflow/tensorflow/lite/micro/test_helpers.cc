@@ -638,6 +638,457 @@ const Model* BuildSimpleMultipleInputsModel() {
   return model;
 }
 
+// int8 [PAD ->] CONV_2D -> RELU -> DEPTHWISE_CONV_2D -> MAX_POOL_2D, see
+// GetConvChainModel().
+const Model* BuildConvChainModel(bool with_pad, bool with_bias) {
+  using flatbuffers::Offset;
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+
+  constexpr int kChannels = 8;
+  constexpr size_t conv_filter_size = kChannels * 3 * 3 * 3;
+  int8_t conv_filter[conv_filter_size];
+  for (size_t i = 0; i < conv_filter_size; ++i) {
+    conv_filter[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+  }
+  constexpr size_t dw_filter_size = 3 * 3 * kChannels;
+  int8_t dw_filter[dw_filter_size];
+  for (size_t i = 0; i < dw_filter_size; ++i) {
+    dw_filter[i] = static_cast<int8_t>((i * 53) % 255 - 127);
+  }
+  int32_t conv_bias[kChannels];
+  int32_t dw_bias[kChannels];
+  for (int i = 0; i < kChannels; ++i) {
+    conv_bias[i] = (i * 389) % 2000 - 1000;
+    dw_bias[i] = (i * 211) % 800 - 400;
+  }
+  constexpr size_t paddings_size = 8;
+  const int32_t paddings[paddings_size] = {0, 0, 1, 1, 1, 1, 0, 0};
+
+  // The buffers of the constant tensors are kept aligned for the kernels.
+  auto create_buffer = [builder](const void* data, size_t size) {
+    builder->ForceVectorAlignment(size, 1, 16);
+    return CreateBuffer(*builder,
+                        builder->CreateVector(
+                            reinterpret_cast<const uint8_t*>(data), size));
+  };
+  constexpr size_t buffers_size = 6;
+  const Offset<Buffer> buffers[buffers_size] = {
+      CreateBuffer(*builder),
+      create_buffer(conv_filter, sizeof(conv_filter)),
+      create_buffer(conv_bias, sizeof(conv_bias)),
+      create_buffer(dw_filter, sizeof(dw_filter)),
+      create_buffer(dw_bias, sizeof(dw_bias)),
+      create_buffer(paddings, sizeof(paddings)),
+  };
+
+  auto create_tensor = [builder](std::initializer_list<int32_t> shape,
+                                 TensorType type, uint32_t buffer, float scale,
+                                 int64_t zero_point, int quantized_dimension,
+                                 const char* name) {
+    const Offset<QuantizationParameters> quantization =
+        CreateQuantizationParameters(
+            *builder, 0, 0, builder->CreateVector(&scale, 1),
+            builder->CreateVector(&zero_point, 1), QuantizationDetails_NONE, 0,
+            quantized_dimension);
+    return CreateTensor(*builder,
+                        builder->CreateVector(shape.begin(), shape.size()),
+                        type, buffer, builder->CreateString(name),
+                        quantization, false);
+  };
+  // The PAD tensors come last so that the model without PAD has none.
+  constexpr size_t tensors_size = 11;
+  const Offset<Tensor> tensors[tensors_size] = {
+      create_tensor({1, 32, 32, 3}, TensorType_INT8, 0, 0.02f, -3, 0,
+                    "input"),
+      create_tensor({kChannels, 3, 3, 3}, TensorType_INT8, 1, 0.01f, 0, 0,
+                    "conv_filter"),
+      create_tensor({kChannels}, TensorType_INT32, 2, 0.0002f, 0, 0,
+                    "conv_bias"),
+      create_tensor({1, 32, 32, kChannels}, TensorType_INT8, 0, 0.05f, -10, 0,
+                    "conv_output"),
+      create_tensor({1, 32, 32, kChannels}, TensorType_INT8, 0, 0.05f, -10, 0,
+                    "relu_output"),
+      create_tensor({1, 3, 3, kChannels}, TensorType_INT8, 3, 0.01f, 0, 3,
+                    "dw_filter"),
+      create_tensor({kChannels}, TensorType_INT32, 4, 0.0005f, 0, 0,
+                    "dw_bias"),
+      create_tensor({1, 16, 16, kChannels}, TensorType_INT8, 0, 0.05f, -128, 0,
+                    "dw_output"),
+      create_tensor({1, 8, 8, kChannels}, TensorType_INT8, 0, 0.05f, -128, 0,
+                    "output"),
+      create_tensor({4, 2}, TensorType_INT32, 5, 0.0f, 0, 0, "paddings"),
+      create_tensor({1, 34, 34, 3}, TensorType_INT8, 0, 0.02f, -3, 0,
+                    "pad_output"),
+  };
+
+  const int32_t pad_inputs[] = {0, 9};
+  const int32_t pad_outputs[] = {10};
+  const int32_t conv_inputs[] = {with_pad ? 10 : 0, 1, 2};
+  const int32_t conv_outputs[] = {3};
+  const int32_t relu_inputs[] = {3};
+  const int32_t relu_outputs[] = {4};
+  const int32_t dw_inputs[] = {4, 5, 6};
+  const int32_t dw_outputs[] = {7};
+  const int32_t pool_inputs[] = {7};
+  const int32_t pool_outputs[] = {8};
+  constexpr size_t operators_size = 5;
+  const Offset<Operator> operators[operators_size] = {
+      CreateOperator(*builder, 0, builder->CreateVector(pad_inputs, 2),
+                     builder->CreateVector(pad_outputs, 1),
+                     BuiltinOptions_PadOptions,
+                     CreatePadOptions(*builder).Union()),
+      CreateOperator(
+          *builder, 1, builder->CreateVector(conv_inputs, with_bias ? 3 : 2),
+          builder->CreateVector(conv_outputs, 1),
+          BuiltinOptions_Conv2DOptions,
+          CreateConv2DOptions(*builder,
+                              with_pad ? Padding_VALID : Padding_SAME, 1, 1,
+                              ActivationFunctionType_NONE)
+              .Union()),
+      CreateOperator(*builder, 2, builder->CreateVector(relu_inputs, 1),
+                     builder->CreateVector(relu_outputs, 1)),
+      CreateOperator(
+          *builder, 3, builder->CreateVector(dw_inputs, 3),
+          builder->CreateVector(dw_outputs, 1),
+          BuiltinOptions_DepthwiseConv2DOptions,
+          CreateDepthwiseConv2DOptions(*builder, Padding_SAME, 2, 2, 1,
+                                       ActivationFunctionType_RELU)
+              .Union()),
+      CreateOperator(*builder, 4, builder->CreateVector(pool_inputs, 1),
+                     builder->CreateVector(pool_outputs, 1),
+                     BuiltinOptions_Pool2DOptions,
+                     CreatePool2DOptions(*builder, Padding_VALID, 2, 2, 2, 2)
+                         .Union()),
+  };
+  const int32_t inputs[] = {0};
+  const int32_t outputs[] = {8};
+  const size_t first_operator = with_pad ? 0 : 1;
+  constexpr size_t subgraphs_size = 1;
+  const Offset<SubGraph> subgraphs[subgraphs_size] = {CreateSubGraph(
+      *builder,
+      builder->CreateVector(tensors, with_pad ? tensors_size : tensors_size - 2),
+      builder->CreateVector(inputs, 1), builder->CreateVector(outputs, 1),
+      builder->CreateVector(operators + first_operator,
+                            operators_size - first_operator),
+      builder->CreateString("test_subgraph"))};
+  constexpr size_t operator_codes_size = 5;
+  const Offset<OperatorCode> operator_codes[operator_codes_size] = {
+      CreateOperatorCode(*builder, BuiltinOperator_PAD, 0, 1,
+                         BuiltinOperator_PAD),
+      CreateOperatorCode(*builder, BuiltinOperator_CONV_2D, 0, 1,
+                         BuiltinOperator_CONV_2D),
+      CreateOperatorCode(*builder, BuiltinOperator_RELU, 0, 1,
+                         BuiltinOperator_RELU),
+      CreateOperatorCode(*builder, BuiltinOperator_DEPTHWISE_CONV_2D, 0, 1,
+                         BuiltinOperator_DEPTHWISE_CONV_2D),
+      CreateOperatorCode(*builder, BuiltinOperator_MAX_POOL_2D, 0, 1,
+                         BuiltinOperator_MAX_POOL_2D),
+  };
+  const Offset<Model> model_offset = CreateModel(
+      *builder, 3, builder->CreateVector(operator_codes, operator_codes_size),
+      builder->CreateVector(subgraphs, subgraphs_size),
+      builder->CreateString("test_model"),
+      builder->CreateVector(buffers, with_pad ? buffers_size
+                                              : buffers_size - 1));
+  FinishModelBuffer(*builder, model_offset);
+  void* model_pointer = builder->GetBufferPointer();
+  const Model* model = flatbuffers::GetRoot<Model>(model_pointer);
+  return model;
+}
+
+// float MAX_POOL_2D -> MAX_POOL_2D -> MAX_POOL_2D -> PAD -> PAD, see
+// GetPoolingChainModel().
+const Model* BuildPoolingChainModel() {
+  using flatbuffers::Offset;
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+
+  constexpr size_t paddings_size = 8;
+  const int32_t pad_paddings[paddings_size] = {0, 0, 0, 1, 0, 0, 0, 0};
+  const int32_t output_paddings[paddings_size] = {0, 0, 4, 4, 4, 4, 0, 0};
+  constexpr size_t buffers_size = 3;
+  const Offset<Buffer> buffers[buffers_size] = {
+      CreateBuffer(*builder),
+      CreateBuffer(*builder,
+                   builder->CreateVector(
+                       reinterpret_cast<const uint8_t*>(pad_paddings),
+                       sizeof(pad_paddings))),
+      CreateBuffer(*builder,
+                   builder->CreateVector(
+                       reinterpret_cast<const uint8_t*>(output_paddings),
+                       sizeof(output_paddings))),
+  };
+
+  auto create_tensor = [builder](std::initializer_list<int32_t> shape,
+                                 TensorType type, uint32_t buffer,
+                                 const char* name) {
+    return CreateTensor(*builder,
+                        builder->CreateVector(shape.begin(), shape.size()),
+                        type, buffer, builder->CreateString(name), 0, false);
+  };
+  constexpr size_t tensors_size = 8;
+  const Offset<Tensor> tensors[tensors_size] = {
+      create_tensor({1, 8, 8, 1}, TensorType_FLOAT32, 0, "input"),
+      create_tensor({1, 4, 4, 1}, TensorType_FLOAT32, 0, "pool_output"),
+      create_tensor({1, 3, 4, 1}, TensorType_FLOAT32, 0, "row_pool_output"),
+      create_tensor({1, 3, 4, 1}, TensorType_FLOAT32, 0, "copy_output"),
+      create_tensor({1, 4, 4, 1}, TensorType_FLOAT32, 0, "pad_output"),
+      create_tensor({1, 12, 12, 1}, TensorType_FLOAT32, 0, "output"),
+      create_tensor({4, 2}, TensorType_INT32, 1, "pad_paddings"),
+      create_tensor({4, 2}, TensorType_INT32, 2, "output_paddings"),
+  };
+
+  auto create_pool = [builder](int32_t input, int32_t output, int stride,
+                               int filter_width, int filter_height) {
+    return CreateOperator(
+        *builder, 0, builder->CreateVector(&input, 1),
+        builder->CreateVector(&output, 1), BuiltinOptions_Pool2DOptions,
+        CreatePool2DOptions(*builder, Padding_VALID, stride, stride,
+                            filter_width, filter_height)
+            .Union());
+  };
+  const int32_t pad_inputs[] = {3, 6};
+  const int32_t pad_outputs[] = {4};
+  const int32_t output_pad_inputs[] = {4, 7};
+  const int32_t output_pad_outputs[] = {5};
+  constexpr size_t operators_size = 5;
+  const Offset<Operator> operators[operators_size] = {
+      create_pool(0, 1, 2, 2, 2),
+      create_pool(1, 2, 1, 1, 2),
+      create_pool(2, 3, 1, 1, 1),
+      CreateOperator(*builder, 1, builder->CreateVector(pad_inputs, 2),
+                     builder->CreateVector(pad_outputs, 1),
+                     BuiltinOptions_PadOptions,
+                     CreatePadOptions(*builder).Union()),
+      CreateOperator(*builder, 1, builder->CreateVector(output_pad_inputs, 2),
+                     builder->CreateVector(output_pad_outputs, 1),
+                     BuiltinOptions_PadOptions,
+                     CreatePadOptions(*builder).Union()),
+  };
+  const int32_t inputs[] = {0};
+  const int32_t outputs[] = {5};
+  constexpr size_t subgraphs_size = 1;
+  const Offset<SubGraph> subgraphs[subgraphs_size] = {CreateSubGraph(
+      *builder, builder->CreateVector(tensors, tensors_size),
+      builder->CreateVector(inputs, 1), builder->CreateVector(outputs, 1),
+      builder->CreateVector(operators, operators_size),
+      builder->CreateString("test_subgraph"))};
+  constexpr size_t operator_codes_size = 2;
+  const Offset<OperatorCode> operator_codes[operator_codes_size] = {
+      CreateOperatorCode(*builder, BuiltinOperator_MAX_POOL_2D, 0, 1,
+                         BuiltinOperator_MAX_POOL_2D),
+      CreateOperatorCode(*builder, BuiltinOperator_PAD, 0, 1,
+                         BuiltinOperator_PAD),
+  };
+  const Offset<Model> model_offset = CreateModel(
+      *builder, 3, builder->CreateVector(operator_codes, operator_codes_size),
+      builder->CreateVector(subgraphs, subgraphs_size),
+      builder->CreateString("test_model"),
+      builder->CreateVector(buffers, buffers_size));
+  FinishModelBuffer(*builder, model_offset);
+  void* model_pointer = builder->GetBufferPointer();
+  const Model* model = flatbuffers::GetRoot<Model>(model_pointer);
+  return model;
+}
+
+// Helpers of the aliasing test models: the tensors are not quantized, the
+// constant ones are int32 tensors in `buffer`.
+flatbuffers::Offset<Tensor> CreateAliasingTestTensor(
+    std::initializer_list<int32_t> shape, TensorType type, uint32_t buffer,
+    const char* name) {
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+  return CreateTensor(*builder,
+                      builder->CreateVector(shape.begin(), shape.size()), type,
+                      buffer, builder->CreateString(name), 0, false);
+}
+
+flatbuffers::Offset<Buffer> CreateAliasingTestBuffer(
+    std::initializer_list<int32_t> values) {
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+  const size_t size = values.size() * sizeof(int32_t);
+  builder->ForceVectorAlignment(size, 1, 16);
+  return CreateBuffer(
+      *builder, builder->CreateVector(
+                    reinterpret_cast<const uint8_t*>(values.begin()), size));
+}
+
+flatbuffers::Offset<Operator> CreateAliasingTestOperator(
+    uint32_t opcode_index, std::initializer_list<int32_t> inputs,
+    std::initializer_list<int32_t> outputs,
+    BuiltinOptions builtin_options_type = BuiltinOptions_NONE,
+    flatbuffers::Offset<void> builtin_options = 0) {
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+  return CreateOperator(*builder, opcode_index,
+                        builder->CreateVector(inputs.begin(), inputs.size()),
+                        builder->CreateVector(outputs.begin(), outputs.size()),
+                        builtin_options_type, builtin_options);
+}
+
+const Model* FinishAliasingTestModel(
+    std::initializer_list<BuiltinOperator> operator_codes,
+    std::initializer_list<flatbuffers::Offset<Buffer>> buffers,
+    std::initializer_list<flatbuffers::Offset<Tensor>> tensors,
+    std::initializer_list<flatbuffers::Offset<Operator>> operators,
+    std::initializer_list<int32_t> inputs,
+    std::initializer_list<int32_t> outputs) {
+  using flatbuffers::Offset;
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+  constexpr size_t max_operator_codes_size = 8;
+  TFLITE_DCHECK(operator_codes.size() <= max_operator_codes_size);
+  Offset<OperatorCode> operator_code_offsets[max_operator_codes_size];
+  size_t operator_codes_size = 0;
+  for (BuiltinOperator code : operator_codes) {
+    operator_code_offsets[operator_codes_size++] =
+        CreateOperatorCode(*builder, code, 0, 1, code);
+  }
+  constexpr size_t subgraphs_size = 1;
+  const Offset<SubGraph> subgraphs[subgraphs_size] = {CreateSubGraph(
+      *builder, builder->CreateVector(tensors.begin(), tensors.size()),
+      builder->CreateVector(inputs.begin(), inputs.size()),
+      builder->CreateVector(outputs.begin(), outputs.size()),
+      builder->CreateVector(operators.begin(), operators.size()),
+      builder->CreateString("test_subgraph"))};
+  const Offset<Model> model_offset = CreateModel(
+      *builder, 3,
+      builder->CreateVector(operator_code_offsets, operator_codes_size),
+      builder->CreateVector(subgraphs, subgraphs_size),
+      builder->CreateString("test_model"),
+      builder->CreateVector(buffers.begin(), buffers.size()));
+  FinishModelBuffer(*builder, model_offset);
+  void* model_pointer = builder->GetBufferPointer();
+  const Model* model = flatbuffers::GetRoot<Model>(model_pointer);
+  return model;
+}
+
+// float LOGISTIC -> RELU -> RESHAPE -> EXPAND_DIMS -> SQUEEZE, see
+// GetViewChainModel().
+const Model* BuildViewChainModel() {
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+  const int32_t squeeze_dims[] = {0};
+  return FinishAliasingTestModel(
+      {BuiltinOperator_LOGISTIC, BuiltinOperator_RELU, BuiltinOperator_RESHAPE,
+       BuiltinOperator_EXPAND_DIMS, BuiltinOperator_SQUEEZE},
+      {CreateBuffer(*builder), CreateAliasingTestBuffer({0})},
+      {
+          CreateAliasingTestTensor({1, 16}, TensorType_FLOAT32, 0, "input"),
+          CreateAliasingTestTensor({1, 16}, TensorType_FLOAT32, 0,
+                                   "logistic_output"),
+          CreateAliasingTestTensor({1, 16}, TensorType_FLOAT32, 0,
+                                   "relu_output"),
+          CreateAliasingTestTensor({4, 4}, TensorType_FLOAT32, 0,
+                                   "reshape_output"),
+          CreateAliasingTestTensor({1}, TensorType_INT32, 1,
+                                   "expand_dims_axis"),
+          CreateAliasingTestTensor({1, 4, 4}, TensorType_FLOAT32, 0,
+                                   "expand_dims_output"),
+          CreateAliasingTestTensor({4, 4}, TensorType_FLOAT32, 0, "output"),
+      },
+      {
+          CreateAliasingTestOperator(0, {0}, {1}),
+          CreateAliasingTestOperator(1, {1}, {2}),
+          CreateAliasingTestOperator(2, {2}, {3}),
+          CreateAliasingTestOperator(3, {3, 4}, {5}),
+          CreateAliasingTestOperator(
+              4, {5}, {6}, BuiltinOptions_SqueezeOptions,
+              CreateSqueezeOptions(*builder,
+                                   builder->CreateVector(squeeze_dims, 1))
+                  .Union()),
+      },
+      {0}, {6});
+}
+
+// float model where no tensor shares a buffer, see GetAliasRefusalModel().
+const Model* BuildAliasRefusalModel() {
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+  return FinishAliasingTestModel(
+      {BuiltinOperator_TANH, BuiltinOperator_RELU,
+       BuiltinOperator_CONCATENATION, BuiltinOperator_RELU6},
+      {CreateBuffer(*builder)},
+      {
+          CreateAliasingTestTensor({2, 4}, TensorType_FLOAT32, 0, "input"),
+          CreateAliasingTestTensor({2, 4}, TensorType_FLOAT32, 0,
+                                   "tanh_output"),
+          CreateAliasingTestTensor({2, 4}, TensorType_FLOAT32, 0,
+                                   "relu_output"),
+          CreateAliasingTestTensor({2, 8}, TensorType_FLOAT32, 0,
+                                   "concat_output"),
+          CreateAliasingTestTensor({4, 4}, TensorType_FLOAT32, 0,
+                                   "input_concat_output"),
+          CreateAliasingTestTensor({2, 8}, TensorType_FLOAT32, 0,
+                                   "relu6_output"),
+      },
+      {
+          CreateAliasingTestOperator(0, {0}, {1}),
+          CreateAliasingTestOperator(1, {1}, {2}),
+          CreateAliasingTestOperator(
+              2, {1, 2}, {3}, BuiltinOptions_ConcatenationOptions,
+              CreateConcatenationOptions(*builder, 1).Union()),
+          CreateAliasingTestOperator(
+              2, {0, 0}, {4}, BuiltinOptions_ConcatenationOptions,
+              CreateConcatenationOptions(*builder, 0).Union()),
+          CreateAliasingTestOperator(3, {3}, {5}),
+      },
+      {0}, {3, 4, 5});
+}
+
+// float SPLIT -> LOGISTIC, TANH -> CONCATENATION -> UNPACK -> SPLIT_V ->
+// CONCATENATION, see GetSliceModel().
+const Model* BuildSliceModel() {
+  flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
+  auto concatenation = [builder](std::initializer_list<int32_t> inputs,
+                                 int32_t output) {
+    return CreateAliasingTestOperator(
+        3, inputs, {output}, BuiltinOptions_ConcatenationOptions,
+        CreateConcatenationOptions(*builder, 0).Union());
+  };
+  return FinishAliasingTestModel(
+      {BuiltinOperator_SPLIT, BuiltinOperator_LOGISTIC, BuiltinOperator_TANH,
+       BuiltinOperator_CONCATENATION, BuiltinOperator_UNPACK,
+       BuiltinOperator_SPLIT_V},
+      {CreateBuffer(*builder), CreateAliasingTestBuffer({0}),
+       CreateAliasingTestBuffer({4, 4})},
+      {
+          CreateAliasingTestTensor({2, 8}, TensorType_FLOAT32, 0, "input"),
+          CreateAliasingTestTensor({}, TensorType_INT32, 1, "axis"),
+          CreateAliasingTestTensor({1, 8}, TensorType_FLOAT32, 0,
+                                   "split_output_0"),
+          CreateAliasingTestTensor({1, 8}, TensorType_FLOAT32, 0,
+                                   "split_output_1"),
+          CreateAliasingTestTensor({1, 8}, TensorType_FLOAT32, 0,
+                                   "logistic_output"),
+          CreateAliasingTestTensor({1, 8}, TensorType_FLOAT32, 0,
+                                   "tanh_output"),
+          CreateAliasingTestTensor({2, 8}, TensorType_FLOAT32, 0,
+                                   "concat_output"),
+          CreateAliasingTestTensor({8}, TensorType_FLOAT32, 0,
+                                   "unpack_output_0"),
+          CreateAliasingTestTensor({8}, TensorType_FLOAT32, 0,
+                                   "unpack_output_1"),
+          CreateAliasingTestTensor({2}, TensorType_INT32, 2,
+                                   "size_splits"),
+          CreateAliasingTestTensor({4}, TensorType_FLOAT32, 0,
+                                   "split_v_output_0"),
+          CreateAliasingTestTensor({4}, TensorType_FLOAT32, 0,
+                                   "split_v_output_1"),
+          CreateAliasingTestTensor({16}, TensorType_FLOAT32, 0, "output"),
+      },
+      {
+          CreateAliasingTestOperator(
+              0, {1, 0}, {2, 3}, BuiltinOptions_SplitOptions,
+              CreateSplitOptions(*builder, 2).Union()),
+          CreateAliasingTestOperator(1, {2}, {4}),
+          CreateAliasingTestOperator(2, {3}, {5}),
+          concatenation({4, 5}, 6),
+          CreateAliasingTestOperator(
+              4, {6}, {7, 8}, BuiltinOptions_UnpackOptions,
+              CreateUnpackOptions(*builder, 2, 0).Union()),
+          CreateAliasingTestOperator(
+              5, {7, 9, 1}, {10, 11}, BuiltinOptions_SplitVOptions,
+              CreateSplitVOptions(*builder, 2).Union()),
+          concatenation({10, 11, 8}, 12),
+      },
+      {0}, {12});
+}
+
 }  // namespace
 
 const TfLiteRegistration* SimpleStatefulOp::getRegistration() {
@@ -885,6 +1336,47 @@ const Model* GetSimpleStatefulModel() {
   return model;
 }
 
+const Model* GetConvChainModel(bool with_pad, bool with_bias) {
+  static Model* models[2][2] = {};
+  Model*& model = models[with_pad][with_bias];
+  if (!model) {
+    model = const_cast<Model*>(BuildConvChainModel(with_pad, with_bias));
+  }
+  return model;
+}
+
+const Model* GetPoolingChainModel() {
+  static Model* model = nullptr;
+  if (!model) {
+    model = const_cast<Model*>(BuildPoolingChainModel());
+  }
+  return model;
+}
+
+const Model* GetViewChainModel() {
+  static Model* model = nullptr;
+  if (!model) {
+    model = const_cast<Model*>(BuildViewChainModel());
+  }
+  return model;
+}
+
+const Model* GetAliasRefusalModel() {
+  static Model* model = nullptr;
+  if (!model) {
+    model = const_cast<Model*>(BuildAliasRefusalModel());
+  }
+  return model;
+}
+
+const Model* GetSliceModel() {
+  static Model* model = nullptr;
+  if (!model) {
+    model = const_cast<Model*>(BuildSliceModel());
+  }
+  return model;
+}
+
 const Tensor* Create1dFlatbufferTensor(int size, bool is_variable) {
   using flatbuffers::Offset;
   flatbuffers::FlatBufferBuilder* builder = BuilderInstance();
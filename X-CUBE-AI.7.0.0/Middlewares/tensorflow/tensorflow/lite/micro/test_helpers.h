@@ -129,6 +129,46 @@ const Model* GetModelWithOfflinePlanning(int num_tensors,
 // Returns a flatbuffer model with `simple_stateful_op`
 const Model* GetSimpleStatefulModel();
 
+// Returns an int8 flatbuffer model with 1 input and 1 output running
+// [PAD ->] CONV_2D -> RELU -> DEPTHWISE_CONV_2D -> MAX_POOL_2D on a 32x32x3
+// input. The optional PAD pads H and W by one with the zero point, the
+// CONV_2D has a bias when `with_bias` is true. The PAD and the RELU can be
+// fused (see micro_graph_fusion.h).
+const Model* GetConvChainModel(bool with_pad, bool with_bias);
+
+// Returns a float flatbuffer model with 1 input and 1 output running
+// MAX_POOL_2D -> MAX_POOL_2D -> MAX_POOL_2D -> PAD -> PAD on an 8x8x1 input.
+// The four intermediate tensors take 64, 48, 48 and 64 bytes, and their
+// lifetimes follow each other. No more than 112 bytes are ever alive, but the
+// greedy planner needs 160 bytes to place them.
+const Model* GetPoolingChainModel();
+
+// Returns a float flatbuffer model with 1 input and 1 output running
+// LOGISTIC -> RELU -> RESHAPE -> EXPAND_DIMS -> SQUEEZE on a 1x16 input. With
+// the buffer aliasing, the outputs of the RELU and of the views share the
+// buffer of the LOGISTIC output (tensor 1). The LOGISTIC does not run in place
+// over the model input.
+const Model* GetViewChainModel();
+
+// Returns a float flatbuffer model with 1 input (tensor 0, 2x4) and 3 outputs
+// (tensors 3, 4 and 5) where none of the tensors can share a buffer:
+//  - TANH (0 -> 1) would write over the model input;
+//  - RELU (1 -> 2) would write over a tensor read after it;
+//  - CONCATENATION (1, 2 -> 3) is on the inner axis;
+//  - CONCATENATION (0, 0 -> 4) has the model input, twice, as input;
+//  - RELU6 (3 -> 5) would write over a model output.
+const Model* GetAliasRefusalModel();
+
+// Returns a float flatbuffer model with 1 input (tensor 0, 2x8) and 1 output
+// (tensor 12) running a SPLIT, a LOGISTIC and a TANH on the two rows, their
+// CONCATENATION, an UNPACK, a SPLIT_V of the first row and a CONCATENATION of
+// the slices. With the buffer aliasing, the SPLIT outputs (2, 3) are slices of
+// the input, and the LOGISTIC and TANH outputs (4, 5), the UNPACK outputs
+// (7, 8) and the SPLIT_V outputs (10, 11) are slices of the concatenation
+// output (6). The last CONCATENATION copies its inputs, which are slices
+// already.
+const Model* GetSliceModel();
+
 // Builds a one-dimensional flatbuffer tensor of the given size.
 const Tensor* Create1dFlatbufferTensor(int size, bool is_variable = false);
 
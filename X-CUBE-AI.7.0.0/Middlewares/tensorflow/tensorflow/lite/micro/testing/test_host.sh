@@ -0,0 +1,129 @@
+#!/bin/sh
+# Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+#
+# Builds the TFLM library of this tree, with the CMSIS-NN kernels (portable C
+# code, no DSP extension), for the host and runs tests or benchmarks linked
+# against it. A *_test.cc passes when it prints "~~~ALL TESTS PASSED~~~", the
+# other sources (benchmarks) pass when they exit with 0.
+#
+# Usage (from any directory):
+#   tensorflow/lite/micro/testing/test_host.sh [-D<flag>...] <source.cc>...
+#
+# The -D flags are used for the library and for the sources, for example
+# -DTF_LITE_MICRO_CONV_WINOGRAD. The objects are kept in $TFLM_HOST_BUILD_DIR
+# (default /tmp/tflm_host_build), one directory per set of flags, and rebuilt
+# by make when a source or a header changes.
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../../../.." && pwd)
+L=${ROOT}/tensorflow/lite
+N=${ROOT}/third_party/cmsis/CMSIS/NN/Source
+
+DEFINES=""
+SOURCES=""
+for arg in "$@"; do
+  case "${arg}" in
+    -D*) DEFINES="${DEFINES} ${arg}" ;;
+    *) SOURCES="${SOURCES} $(cd "$(dirname "${arg}")" && pwd)/$(basename "${arg}")" ;;
+  esac
+done
+if [ -z "${SOURCES}" ]; then
+  echo "Usage: $0 [-D<flag>...] <source.cc>..."
+  exit 1
+fi
+
+FLAGS_ID=$(echo "${DEFINES}" | cksum | cut -d ' ' -f 1)
+BUILD_DIR=${TFLM_HOST_BUILD_DIR:-/tmp/tflm_host_build}/${FLAGS_ID}
+mkdir -p "${BUILD_DIR}"
+
+INCLUDES="-I${ROOT} \
+  -I${ROOT}/third_party/flatbuffers/include \
+  -I${ROOT}/third_party/gemmlowp \
+  -I${ROOT}/third_party/ruy \
+  -I${ROOT}/third_party/cmsis \
+  -I${ROOT}/third_party/cmsis/CMSIS/NN/Include \
+  -I${ROOT}/third_party/cmsis/CMSIS/DSP/Include \
+  -I${ROOT}/third_party/cmsis/CMSIS/Core/Include"
+COMMON_FLAGS="-O2 -MMD -fno-exceptions -DTF_LITE_STATIC_MEMORY \
+  -DTF_LITE_USE_CTIME -DCMSIS_NN ${DEFINES} ${INCLUDES}"
+
+# The host has no DebugLog(), the logs go to stderr.
+if [ ! -f "${BUILD_DIR}/debug_log.cc" ]; then
+  cat > "${BUILD_DIR}/debug_log.cc" << EOF
+#include <cstdio>
+#include "tensorflow/lite/micro/debug_log.h"
+extern "C" void DebugLog(const char* s) { fputs(s, stderr); }
+EOF
+fi
+
+LIB_SOURCES=$(ls ${L}/micro/*.cc ${L}/micro/memory_planner/*.cc \
+  ${L}/micro/kernels/*.cc ${L}/micro/kernels/cmsis_nn/*.cc \
+  ${L}/core/api/*.cc ${L}/kernels/*.cc ${L}/kernels/internal/*.cc \
+  ${L}/schema/*.cc ${L}/c/common.c ${N}/*/*.c | grep -v "_test\.cc$")
+
+{
+  echo "CXXFLAGS := -std=c++11 -fno-rtti -include limits ${COMMON_FLAGS}"
+  echo "CFLAGS := -std=c99 ${COMMON_FLAGS}"
+  echo "OBJS :="
+  for src in ${LIB_SOURCES} ${BUILD_DIR}/debug_log.cc; do
+    obj=obj/$(echo "${src}" | sed "s|^${ROOT}/||; s|^${BUILD_DIR}/||; s|/|_|g").o
+    echo "OBJS += ${obj}"
+    echo "${obj}: ${src}"
+    case "${src}" in
+      *.c) echo "	@mkdir -p obj && \$(CC) \$(CFLAGS) -c \$< -o \$@" ;;
+      *) echo "	@mkdir -p obj && \$(CXX) \$(CXXFLAGS) -c \$< -o \$@" ;;
+    esac
+  done
+  echo "libtflm.a: \$(OBJS)"
+  echo "	@rm -f \$@ && ar rcs \$@ \$(OBJS)"
+  for src in ${SOURCES}; do
+    bin=bin/$(basename "${src}" .cc)
+    echo "${bin}: ${src} libtflm.a"
+    echo "	@mkdir -p bin && \$(CXX) \$(CXXFLAGS) \$< libtflm.a -lm -o \$@"
+    echo "all: ${bin}"
+  done
+  echo "-include obj/*.d bin/*.d"
+} > "${BUILD_DIR}/Makefile"
+
+make -s -C "${BUILD_DIR}" -j"$(nproc 2>/dev/null || echo 4)" all
+
+STATUS=0
+for src in ${SOURCES}; do
+  name=$(basename "${src}" .cc)
+  echo "--- ${name}"
+  case "${name}" in
+    *_test)
+      "${BUILD_DIR}/bin/${name}" > "${BUILD_DIR}/${name}.log" 2>&1 || true
+      cat "${BUILD_DIR}/${name}.log"
+      if grep -q "~~~ALL TESTS PASSED~~~" "${BUILD_DIR}/${name}.log"; then
+        echo "${name}: PASS"
+      else
+        echo "${name}: FAIL"
+        STATUS=1
+      fi
+      ;;
+    *)
+      if "${BUILD_DIR}/bin/${name}"; then
+        echo "${name}: PASS"
+      else
+        echo "${name}: FAIL"
+        STATUS=1
+      fi
+      ;;
+  esac
+done
+exit ${STATUS}
@@ -591,6 +591,24 @@ extern "C"
      */
     int32_t arm_convolve_1x1_s8_fast_get_buffer_size(const cmsis_nn_dims *input_dims);
 
+    /**
+     * @brief Fold the input offset into the bias of arm_convolve_1x1_s8_fast
+     *
+     * @param[in]       conv_params           Convolution parameters (input_offset)
+     * @param[in]       filter_dims           Filter tensor dimensions. Format: [C_OUT, 1, 1, C_IN]
+     * @param[in]       filter_data           Filter data pointer. Data type: int8
+     * @param[in]       bias_data             Optional bias data pointer. Data type: int32
+     * @param[out]      folded_bias           Output buffer of C_OUT values. Data type: int32
+     *
+     * @details arm_convolve_1x1_s8_fast called with the folded bias and an input offset of 0 gives the same result
+     *          without summing the filter on each call.
+     */
+    void arm_convolve_1x1_s8_fast_fold_bias(const cmsis_nn_conv_params *conv_params,
+                                            const cmsis_nn_dims *filter_dims,
+                                            const q7_t *filter_data,
+                                            const int32_t *bias_data,
+                                            int32_t *folded_bias);
+
     /**
      * @brief 1xn convolution
      *
@@ -650,6 +668,219 @@ extern "C"
      */
     int32_t arm_convolve_1_x_n_s8_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims);
 
+    /**
+     * @brief 3x3 stride 1 s8 convolution using the Winograd F(2x2, 3x3) transform
+     *
+     * @param[in, out] ctx             Function context that contains the additional buffer.
+                                       arm_convolve_winograd_s8_get_buffer_size will return the buffer_size
+     * @param[in]      conv_params     Convolution parameters (e.g. strides, dilations, pads,...).
+     *                                 Range of conv_params->input_offset  : [-127, 128]
+     *                                 Range of conv_params->output_offset : [-128, 127]
+     * @param[in]      quant_params    Per-channel quantization info.
+     *                                 It contains the multiplier and shift values to be applied to each output channel
+     * @param[in]      input_dims      Input (activation) tensor dimensions. Format: [N, H, W, C_IN]
+     * @param[in]      input_data      Input (activation) data pointer. Data type: int8
+     * @param[in]      filter_dims     Filter tensor dimensions. Format: [C_OUT, 3, 3, C_IN]
+     * @param[in]      transformed_filter_data Filter transformed by arm_convolve_winograd_s8_transform_filter.
+     *                                 Data type: int16
+     * @param[in]      bias_dims       Bias tensor dimensions. Format: [C_OUT]
+     * @param[in]      bias_data       Optional bias data pointer. Data type: int32
+     * @param[in]      output_dims     Output tensor dimensions. Format: [N, H, W, C_OUT]
+     * @param[out]     output_data     Output data pointer. Data type: int8
+     *
+     * @return     The function returns either
+     *                  <code>ARM_MATH_SIZE_MISMATCH</code> if argument constraints fail. or,
+     *                  <code>ARM_MATH_SUCCESS</code> on successful completion.
+     *
+     * @details
+     *   - Supported framework : TensorFlow Lite Micro
+     *   - Each 2x2 output tile is computed with 16 multiplications per input channel instead of 36. The
+     *     result is bit-exact with arm_convolve_s8.
+     *   - The following constrains on the arguments apply
+     *      -# filter_dims->h and filter_dims->w equal 3
+     *      -# conv_params->stride.h and conv_params->stride.w equal 1
+     *      -# conv_params->dilation.h and conv_params->dilation.w equal 1
+     *      -# input_dims->c is at most 1024
+     *
+     */
+    arm_status arm_convolve_winograd_s8(const cmsis_nn_context *ctx,
+                                        const cmsis_nn_conv_params *conv_params,
+                                        const cmsis_nn_per_channel_quant_params *quant_params,
+                                        const cmsis_nn_dims *input_dims,
+                                        const q7_t *input_data,
+                                        const cmsis_nn_dims *filter_dims,
+                                        const q15_t *transformed_filter_data,
+                                        const cmsis_nn_dims *bias_dims,
+                                        const int32_t *bias_data,
+                                        const cmsis_nn_dims *output_dims,
+                                        q7_t *output_data);
+
+    /**
+     * @brief Get the required additional buffer size for arm_convolve_winograd_s8
+     *
+     * @param[in]       input_dims            Input (activation) tensor dimensions. Format: [N, H, W, C_IN]
+     * @return          The function returns  required buffer size(bytes)
+     *
+     */
+    int32_t arm_convolve_winograd_s8_get_buffer_size(const cmsis_nn_dims *input_dims);
+
+    /**
+     * @brief Get the size of the filter transformed for arm_convolve_winograd_s8
+     *
+     * @param[in]       filter_dims           Filter tensor dimensions. Format: [C_OUT, 3, 3, C_IN]
+     * @return          The function returns  required buffer size(bytes)
+     *
+     */
+    int32_t arm_convolve_winograd_s8_get_filter_size(const cmsis_nn_dims *filter_dims);
+
+    /**
+     * @brief Transform a 3x3 s8 filter to the Winograd domain used by arm_convolve_winograd_s8
+     *
+     * @param[in]       filter_dims             Filter tensor dimensions. Format: [C_OUT, 3, 3, C_IN]
+     * @param[in]       filter_data             Filter data pointer. Data type: int8
+     * @param[out]      transformed_filter_data Output buffer of arm_convolve_winograd_s8_get_filter_size bytes.
+     *                                          Format: [C_OUT, 16, C_IN]. Data type: int16
+     * @return     The function returns either
+     *                  <code>ARM_MATH_SIZE_MISMATCH</code> if the filter is not 3x3. or,
+     *                  <code>ARM_MATH_SUCCESS</code> on successful completion.
+     *
+     */
+    arm_status arm_convolve_winograd_s8_transform_filter(const cmsis_nn_dims *filter_dims,
+                                                         const q7_t *filter_data,
+                                                         q15_t *transformed_filter_data);
+
+    /**
+     * @brief s8 convolution with an im2col buffer bounded by a number of filter rows
+     *
+     * @param[in, out] ctx             Function context that contains the additional buffer.
+                                       arm_convolve_row_tiled_s8_get_buffer_size will return the buffer_size
+     * @param[in]      conv_params     Convolution parameters (e.g. strides, dilations, pads,...).
+     *                                 Range of conv_params->input_offset  : [-127, 128]
+     *                                 Range of conv_params->output_offset : [-128, 127]
+     * @param[in]      quant_params    Per-channel quantization info.
+     *                                 It contains the multiplier and shift values to be applied to each output channel
+     * @param[in]      input_dims      Input (activation) tensor dimensions. Format: [N, H, W, C_IN]
+     * @param[in]      input_data      Input (activation) data pointer. Data type: int8
+     * @param[in]      filter_dims     Filter tensor dimensions. Format: [C_OUT, HK, WK, C_IN]
+     * @param[in]      filter_data     Filter data pointer. Data type: int8
+     * @param[in]      bias_dims       Bias tensor dimensions. Format: [C_OUT]
+     * @param[in]      bias_data       Optional bias data pointer. Data type: int32
+     * @param[in]      output_dims     Output tensor dimensions. Format: [N, H, W, C_OUT]
+     * @param[out]     output_data     Output data pointer. Data type: int8
+     * @param[in]      filter_rows     Number of filter rows of the im2col buffer, from 1 to HK
+     *
+     * @return     The function returns either
+     *                  <code>ARM_MATH_SIZE_MISMATCH</code> if argument constraints fail. or,
+     *                  <code>ARM_MATH_SUCCESS</code> on successful completion.
+     *
+     * @details
+     *   - Supported framework : TensorFlow Lite Micro
+     *   - The output pixels are computed one at a time, the receptive field being expanded filter_rows rows
+     *     at a time. The buffer size no longer grows with the whole filter, at the cost of a lower throughput
+     *     than arm_convolve_s8. The result is bit-exact with arm_convolve_s8.
+     *   - The following constrains on the arguments apply
+     *      -# conv_params->dilation.h and conv_params->dilation.w equal 1
+     *
+     */
+    arm_status arm_convolve_row_tiled_s8(const cmsis_nn_context *ctx,
+                                         const cmsis_nn_conv_params *conv_params,
+                                         const cmsis_nn_per_channel_quant_params *quant_params,
+                                         const cmsis_nn_dims *input_dims,
+                                         const q7_t *input_data,
+                                         const cmsis_nn_dims *filter_dims,
+                                         const q7_t *filter_data,
+                                         const cmsis_nn_dims *bias_dims,
+                                         const int32_t *bias_data,
+                                         const cmsis_nn_dims *output_dims,
+                                         q7_t *output_data,
+                                         const int32_t filter_rows);
+
+    /**
+     * @brief Get the required additional buffer size for arm_convolve_row_tiled_s8
+     *
+     * @param[in]       filter_dims           Filter tensor dimensions. Format: [C_OUT, HK, WK, C_IN]
+     * @param[in]       filter_rows           Number of filter rows of the im2col buffer
+     * @return          The function returns  required buffer size(bytes)
+     *
+     */
+    int32_t arm_convolve_row_tiled_s8_get_buffer_size(const cmsis_nn_dims *filter_dims, const int32_t filter_rows);
+
+    /**
+     * @brief s8 convolution with a filter packed by arm_convolve_packed_s8_pack_filter
+     *
+     * @param[in, out] ctx             Function context that contains the additional buffer.
+                                       arm_convolve_packed_s8_get_buffer_size will return the buffer_size
+     * @param[in]      conv_params     Convolution parameters (e.g. strides, dilations, pads,...).
+     *                                 Range of conv_params->input_offset  : [-127, 128]
+     *                                 Range of conv_params->output_offset : [-128, 127]
+     * @param[in]      quant_params    Per-channel quantization info.
+     *                                 It contains the multiplier and shift values to be applied to each output channel
+     * @param[in]      input_dims      Input (activation) tensor dimensions. Format: [N, H, W, C_IN]
+     * @param[in]      input_data      Input (activation) data pointer. Data type: int8
+     * @param[in]      filter_dims     Filter tensor dimensions. Format: [C_OUT, HK, WK, C_IN]
+     * @param[in]      packed_filter_data Filter packed by arm_convolve_packed_s8_pack_filter. Data type: int16
+     * @param[in]      bias_dims       Bias tensor dimensions. Format: [C_OUT]
+     * @param[in]      bias_data       Optional bias data pointer. Data type: int32
+     * @param[in]      output_dims     Output tensor dimensions. Format: [N, H, W, C_OUT]
+     * @param[out]     output_data     Output data pointer. Data type: int8
+     *
+     * @return     The function returns either
+     *                  <code>ARM_MATH_SIZE_MISMATCH</code> if argument constraints fail. or,
+     *                  <code>ARM_MATH_SUCCESS</code> on successful completion.
+     *
+     * @details
+     *   - Supported framework : TensorFlow Lite Micro
+     *   - The filter is read linearly and is not expanded from s8 by each call, at the cost of a filter copy
+     *     twice the size of the original one. The result is bit-exact with arm_convolve_s8.
+     *   - The following constrains on the arguments apply
+     *      -# conv_params->dilation.h and conv_params->dilation.w equal 1
+     *
+     */
+    arm_status arm_convolve_packed_s8(const cmsis_nn_context *ctx,
+                                      const cmsis_nn_conv_params *conv_params,
+                                      const cmsis_nn_per_channel_quant_params *quant_params,
+                                      const cmsis_nn_dims *input_dims,
+                                      const q7_t *input_data,
+                                      const cmsis_nn_dims *filter_dims,
+                                      const q15_t *packed_filter_data,
+                                      const cmsis_nn_dims *bias_dims,
+                                      const int32_t *bias_data,
+                                      const cmsis_nn_dims *output_dims,
+                                      q7_t *output_data);
+
+    /**
+     * @brief Get the required additional buffer size for arm_convolve_packed_s8
+     *
+     * @param[in]       input_dims            Input (activation) tensor dimensions. Format: [N, H, W, C_IN]
+     * @param[in]       filter_dims           Filter tensor dimensions. Format: [C_OUT, HK, WK, C_IN]
+     * @return          The function returns  required buffer size(bytes)
+     *
+     */
+    int32_t arm_convolve_packed_s8_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims);
+
+    /**
+     * @brief Get the size of the filter packed for arm_convolve_packed_s8
+     *
+     * @param[in]       filter_dims           Filter tensor dimensions. Format: [C_OUT, HK, WK, C_IN]
+     * @return          The function returns  required buffer size(bytes)
+     *
+     */
+    int32_t arm_convolve_packed_s8_get_filter_size(const cmsis_nn_dims *filter_dims);
+
+    /**
+     * @brief Pack a s8 filter for arm_convolve_packed_s8
+     *
+     * @param[in]       filter_dims           Filter tensor dimensions. Format: [C_OUT, HK, WK, C_IN]
+     * @param[in]       filter_data           Filter data pointer. Data type: int8
+     * @param[out]      packed_filter_data    Output buffer of arm_convolve_packed_s8_get_filter_size bytes.
+     *                                        Data type: int16
+     * @return          The function returns  <code>ARM_MATH_SUCCESS</code>
+     *
+     */
+    arm_status arm_convolve_packed_s8_pack_filter(const cmsis_nn_dims *filter_dims,
+                                                  const q7_t *filter_data,
+                                                  q15_t *packed_filter_data);
+
     /**
      * @brief Q7 version of convolution for RGB image
      * @param[in]       Im_in       pointer to input tensor
@@ -1171,6 +1402,140 @@ extern "C"
      */
     int32_t arm_fully_connected_s8_get_buffer_size(const cmsis_nn_dims *filter_dims);
 
+    /**
+     * @brief s8 Fully Connected function with weights packed by arm_fully_connected_packed_s8_pack_weights
+     *
+     * @param[in, out] ctx            Function context that contains the additional buffer.
+     *                                arm_fully_connected_packed_s8_get_buffer_size will return the buffer_size
+     * @param[in]      fc_params      Fully Connected layer parameters. fc_params->filter_offset is applied when
+     *                                the weights are packed.
+     *                                Range of fc_params->input_offset  : [-127, 128]
+     *                                Range of fc_params->output_offset : [-128, 127]
+     * @param[in]      quant_params   Per-tensor quantization info.
+     *                                It contains the multiplier and shift values to be applied to the output tensor.
+     * @param[in]      input_dims     Input (activation) tensor dimensions. Format: [N, H, W, C_IN]
+     *                                Input dimension is taken as Nx(H * W * C_IN)
+     * @param[in]      input_data     Input (activation) data pointer. Data type: int8
+     * @param[in]      filter_dims    Two dimensional filter dimensions. Format: [N, C]
+     *                                N : accumulation depth and equals (H * W * C_IN) from input_dims
+     *                                C : output depth and equals C_OUT in output_dims
+     * @param[in]      packed_kernel  Weights packed by arm_fully_connected_packed_s8_pack_weights. Data type: int16
+     * @param[in]      bias_dims      Bias tensor dimensions. Format: [C_OUT]
+     * @param[in]      bias_data      Bias data pointer. Data type: int32
+     * @param[in]      output_dims    Output tensor dimensions. Format: [N, C_OUT]
+     * @param[in, out] output_data    Output data pointer. Data type: int8
+     * @return     The function returns either
+     *                  <code>ARM_MATH_ARGUMENT_ERROR</code> if the buffer is missing. or,
+     *                  <code>ARM_MATH_SUCCESS</code> on successful completion.
+     *
+     * @details
+     *    - Supported framework: TensorFlow Lite
+     *    - The weights are read linearly and are not expanded from s8 by each call, at the cost of a copy
+     *      twice the size of the original weights. The result is bit-exact with arm_fully_connected_s8.
+     */
+    arm_status arm_fully_connected_packed_s8(const cmsis_nn_context *ctx,
+                                             const cmsis_nn_fc_params *fc_params,
+                                             const cmsis_nn_per_tensor_quant_params *quant_params,
+                                             const cmsis_nn_dims *input_dims,
+                                             const q7_t *input_data,
+                                             const cmsis_nn_dims *filter_dims,
+                                             const q15_t *packed_kernel,
+                                             const cmsis_nn_dims *bias_dims,
+                                             const int32_t *bias_data,
+                                             const cmsis_nn_dims *output_dims,
+                                             q7_t *output_data);
+
+    /**
+     * @brief Get the required buffer size for arm_fully_connected_packed_s8
+     * @param[in]      input_dims              dimension of input
+     * @param[in]      filter_dims             dimension of filter
+     * @return         The function returns    required buffer size in bytes
+     *
+     */
+    int32_t arm_fully_connected_packed_s8_get_buffer_size(const cmsis_nn_dims *input_dims,
+                                                          const cmsis_nn_dims *filter_dims);
+
+    /**
+     * @brief Get the size of the weights packed for arm_fully_connected_packed_s8
+     * @param[in]      filter_dims             dimension of filter
+     * @return         The function returns    required buffer size in bytes
+     *
+     */
+    int32_t arm_fully_connected_packed_s8_get_weights_size(const cmsis_nn_dims *filter_dims);
+
+    /**
+     * @brief Pack s8 weights for arm_fully_connected_packed_s8
+     * @param[in]      fc_params               Fully Connected layer parameters (filter_offset)
+     * @param[in]      filter_dims             dimension of filter
+     * @param[in]      filter_data             Filter data pointer. Data type: int8
+     * @param[out]     packed_kernel           Output buffer of arm_fully_connected_packed_s8_get_weights_size
+     *                                         bytes. Data type: int16
+     * @return         The function returns    <code>ARM_MATH_SUCCESS</code>
+     *
+     */
+    arm_status arm_fully_connected_packed_s8_pack_weights(const cmsis_nn_fc_params *fc_params,
+                                                          const cmsis_nn_dims *filter_dims,
+                                                          const q7_t *filter_data,
+                                                          q15_t *packed_kernel);
+
+    /**
+     * @brief s8 Fully Connected function with the input offset folded into the bias by
+     *        arm_fully_connected_folded_s8_fold_bias
+     *
+     * @param[in, out] ctx            Function context (e.g. temporary buffer). Not used.
+     * @param[in]      fc_params      Fully Connected layer parameters. fc_params->input_offset is applied when
+     *                                the bias is folded, fc_params->filter_offset must be 0.
+     *                                Range of fc_params->output_offset : [-128, 127]
+     * @param[in]      quant_params   Per-tensor quantization info.
+     *                                It contains the multiplier and shift values to be applied to the output tensor.
+     * @param[in]      input_dims     Input (activation) tensor dimensions. Format: [N, H, W, C_IN]
+     *                                Input dimension is taken as Nx(H * W * C_IN)
+     * @param[in]      input_data     Input (activation) data pointer. Data type: int8
+     * @param[in]      filter_dims    Two dimensional filter dimensions. Format: [N, C]
+     *                                N : accumulation depth and equals (H * W * C_IN) from input_dims
+     *                                C : output depth and equals C_OUT in output_dims
+     * @param[in]      filter_data    Filter data pointer. Data type: int8
+     * @param[in]      bias_dims      Bias tensor dimensions. Format: [C_OUT]
+     * @param[in]      folded_bias    Bias folded by arm_fully_connected_folded_s8_fold_bias. Data type: int32
+     * @param[in]      output_dims    Output tensor dimensions. Format: [N, C_OUT]
+     * @param[in, out] output_data    Output data pointer. Data type: int8
+     * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+     *
+     * @details
+     *    - Supported framework: TensorFlow Lite
+     *    - The inner loop does not add the input offset to each value. The result is bit-exact with
+     *      arm_fully_connected_s8.
+     */
+    arm_status arm_fully_connected_folded_s8(const cmsis_nn_context *ctx,
+                                             const cmsis_nn_fc_params *fc_params,
+                                             const cmsis_nn_per_tensor_quant_params *quant_params,
+                                             const cmsis_nn_dims *input_dims,
+                                             const q7_t *input_data,
+                                             const cmsis_nn_dims *filter_dims,
+                                             const q7_t *filter_data,
+                                             const cmsis_nn_dims *bias_dims,
+                                             const int32_t *folded_bias,
+                                             const cmsis_nn_dims *output_dims,
+                                             q7_t *output_data);
+
+    /**
+     * @brief Fold the input offset into the bias for arm_fully_connected_folded_s8
+     * @param[in]      fc_params               Fully Connected layer parameters (input_offset, filter_offset)
+     * @param[in]      filter_dims             dimension of filter
+     * @param[in]      filter_data             Filter data pointer. Data type: int8
+     * @param[in]      bias_data               Optional bias data pointer. Data type: int32
+     * @param[out]     folded_bias             Output buffer of filter_dims->c values. Data type: int32
+     * @return         The function returns either
+     *                  <code>ARM_MATH_ARGUMENT_ERROR</code> if the filter offset is not 0 or,
+     *                  <code>ARM_MATH_SUCCESS</code> on successful completion.
+     *
+     */
+    arm_status arm_fully_connected_folded_s8_fold_bias(const cmsis_nn_fc_params *fc_params,
+                                                       const cmsis_nn_dims *filter_dims,
+                                                       const q7_t *filter_data,
+                                                       const int32_t *bias_data,
+                                                       int32_t *folded_bias);
+
     /**
      * @brief Q7 opt fully-connected layer function
      * @param[in]       pV          pointer to input vector
@@ -2093,6 +2458,61 @@ extern "C"
                            const cmsis_nn_dims *output_dims,
                            q7_t *output_data);
 
+    /**
+     * @brief s8 SVDF function with a ring-buffered state tensor
+     *
+     * @param[in]   input_ctx Temporary scratch buffer
+     * @param[in]   output_ctx Temporary output scratch buffer
+     * @param[in]   svdf_params SVDF Parameters
+     *              Range of svdf_params->input_offset  : [-128, 127]
+     *              Range of svdf_params->output_offset  : [-128, 127]
+     * @param[in]   input_quant_params Input quantization parameters
+     * @param[in]   output_quant_params Output quantization parameters
+     * @param[in]   input_dims Input tensor dimensions
+     * @param[in]   input_data Pointer to input tensor
+     * @param[in]   state_dims State tensor dimensions
+     * @param[in]   state_data Pointer to state tensor
+     * @param[in]   state_head Column of the state tensor that receives the current activation.
+     *              Range of state_head : [0, weights_time_dims->h - 1]
+     * @param[in]   weights_feature_dims Weights (feature) tensor dimensions
+     * @param[in]   weights_feature_data Pointer to the weights (feature) tensor
+     * @param[in]   weights_time_dims Weights (time) tensor dimensions
+     * @param[in]   weights_time_data Pointer to the weights (time) tensor
+     * @param[in]   bias_dims Bias tensor dimensions
+     * @param[in]   bias_data Pointer to bias tensor
+     * @param[in]   output_dims Output tensor dimensions
+     * @param[out]  output_data Pointer to the output tensor
+     *
+     * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+     *
+     * @details
+     *    1. Supported framework: TensorFlow Lite micro
+     *    2. The state tensor is not shifted. The current activation overwrites column state_head and the oldest
+     *       activation is read from column (state_head + 1) % time_batches. The caller advances state_head by one
+     *       (modulo time_batches) after each call. Results are bit-exact with arm_svdf_s8().
+     *    3. arm_svdf_s8() is equivalent to a left shift of the state followed by this function with
+     *       state_head = time_batches - 1.
+     *
+     */
+    arm_status arm_svdf_ring_s8(const cmsis_nn_context *input_ctx,
+                                const cmsis_nn_context *output_ctx,
+                                const cmsis_nn_svdf_params *svdf_params,
+                                const cmsis_nn_per_tensor_quant_params *input_quant_params,
+                                const cmsis_nn_per_tensor_quant_params *output_quant_params,
+                                const cmsis_nn_dims *input_dims,
+                                const q7_t *input_data,
+                                const cmsis_nn_dims *state_dims,
+                                q15_t *state_data,
+                                const int32_t state_head,
+                                const cmsis_nn_dims *weights_feature_dims,
+                                const q7_t *weights_feature_data,
+                                const cmsis_nn_dims *weights_time_dims,
+                                const q15_t *weights_time_data,
+                                const cmsis_nn_dims *bias_dims,
+                                const q31_t *bias_data,
+                                const cmsis_nn_dims *output_dims,
+                                q7_t *output_data);
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,6 +47,22 @@ extern "C" {
 #define MIN(A, B) ((A) < (B) ? (A) : (B))
 #define CLAMP(x, h, l) MAX(MIN((x), (h)), (l))
 
+/**
+ * @brief Scoped labels of the intra-kernel phases (im2col, MAC loops,
+ *        requantization), forwarded to the profiler hooks of the application
+ *        when RUY_PROFILER_LITE is defined, compiled out otherwise.
+ *        The label should be a literal string.
+ */
+#if defined(RUY_PROFILER_LITE)
+void ruy_profiler_lite_push(const char *label);
+void ruy_profiler_lite_pop(void);
+#define ARM_NN_PROFILE_BEGIN(label) ruy_profiler_lite_push(label)
+#define ARM_NN_PROFILE_END() ruy_profiler_lite_pop()
+#else
+#define ARM_NN_PROFILE_BEGIN(label)
+#define ARM_NN_PROFILE_END()
+#endif
+
 /**
  * @brief Union for SIMD access of q31/q15/q7 types
  */
@@ -368,6 +384,109 @@ arm_status arm_nn_vec_mat_mult_t_s8(const q7_t *lhs,
                                     const int32_t activation_min,
                                     const int32_t activation_max);
 
+/**
+ * @brief Fold the contribution of a lhs offset into the bias: lhs_offset * sum(rhs[r]) + bias[r]
+ *
+ * @param[in]      rhs             Right-hand side matrix (transposed), i.e. the weights. Format: [rows, cols]
+ * @param[in]      bias            Optional bias. Format: [rhs_rows]
+ * @param[in]      rhs_rows        Number of rows in the right-hand side matrix
+ * @param[in]      rhs_cols        Number of columns in the right-hand side matrix
+ * @param[in]      lhs_offset      Offset to be added to the input values of the left-hand side. Range: -127 to 128
+ * @param[out]     folded_bias     Folded bias. Format: [rhs_rows]
+ *
+ */
+void arm_nn_fold_lhs_offset_s8(const q7_t *rhs,
+                               const q31_t *bias,
+                               const int32_t rhs_rows,
+                               const int32_t rhs_cols,
+                               const int32_t lhs_offset,
+                               q31_t *folded_bias);
+
+/**
+ * @brief s8 Vector by Matrix (transposed) multiplication with the lhs offset folded into the bias
+ *
+ * @param[in]      lhs             Input left-hand side vector
+ * @param[in]      rhs             Input right-hand side matrix (transposed)
+ * @param[in]      folded_bias     Bias computed by arm_nn_fold_lhs_offset_s8. Format: [rhs_rows]
+ * @param[out]     dst             Output vector
+ * @param[in]      dst_offset      Offset to be added to the output values. Range: -127 to 128
+ * @param[in]      dst_multiplier  Output multiplier
+ * @param[in]      dst_shift       Output shift
+ * @param[in]      rhs_cols        Number of columns in the right-hand side input matrix
+ * @param[in]      rhs_rows        Number of rows in the right-hand side input matrix
+ * @param[in]      activation_min  Minimum value to clamp the output to. Range: int8
+ * @param[in]      activation_max  Maximum value to clamp the output to. Range: int8
+ *
+ * @return         The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details Same result as arm_nn_vec_mat_mult_t_s8 with a rhs offset of 0, the inner loop has no offset to add.
+ *
+ */
+arm_status arm_nn_vec_mat_mult_t_folded_s8(const q7_t *lhs,
+                                           const q7_t *rhs,
+                                           const q31_t *folded_bias,
+                                           q7_t *dst,
+                                           const int32_t dst_offset,
+                                           const int32_t dst_multiplier,
+                                           const int32_t dst_shift,
+                                           const int32_t rhs_cols,
+                                           const int32_t rhs_rows,
+                                           const int32_t activation_min,
+                                           const int32_t activation_max);
+
+/**
+ * @brief Pack a s8 matrix for arm_nn_mat_mult_packed_s16
+ *
+ * @param[in]      rhs             Right-hand side matrix (transposed), i.e. the weights. Format: [rows, cols]
+ * @param[in]      rhs_rows        Number of rows in the right-hand side matrix
+ * @param[in]      rhs_cols        Number of columns in the right-hand side matrix
+ * @param[in]      rhs_offset      Offset added to the values of the right-hand side matrix. Range: -127 to 128
+ * @param[out]     dst             Packed matrix, rhs_rows * rhs_cols values. Data type: int16
+ *
+ * @details The values are widened to 16 bits and the rows are interleaved by pairs so that
+ *          arm_nn_mat_mult_packed_s16 reads them linearly, one SMLAD operand per word.
+ *
+ */
+void arm_nn_pack_weights_s8_s16(const q7_t *rhs,
+                                const int32_t rhs_rows,
+                                const int32_t rhs_cols,
+                                const int32_t rhs_offset,
+                                q15_t *dst);
+
+/**
+ * @brief Matrix multiplication of one or two q15 vectors by a matrix packed by arm_nn_pack_weights_s8_s16
+ *
+ * @param[in]      lhs             Left-hand side vectors, contiguous. Format: [lhs_rows, rhs_cols]
+ * @param[in]      lhs_rows        Number of left-hand side vectors, 1 or 2
+ * @param[in]      packed_rhs      Packed right-hand side matrix
+ * @param[in]      rhs_rows        Number of rows in the right-hand side matrix
+ * @param[in]      rhs_cols        Number of columns in the right-hand side matrix
+ * @param[in]      bias            Optional bias. Format: [rhs_rows]
+ * @param[in]      dst_multipliers Output multipliers, one per row if per_channel is set, else one
+ * @param[in]      dst_shifts      Output shifts, one per row if per_channel is set, else one
+ * @param[in]      per_channel     Per row (1) or per tensor (0) requantization
+ * @param[in]      dst_offset      Offset to be added to the output values. Range: -127 to 128
+ * @param[in]      activation_min  Minimum value to clamp the output to. Range: int8
+ * @param[in]      activation_max  Maximum value to clamp the output to. Range: int8
+ * @param[out]     dst             Output. Format: [lhs_rows, rhs_rows]
+ *
+ * @return         The incremented output pointer
+ *
+ */
+q7_t *arm_nn_mat_mult_packed_s16(const q15_t *lhs,
+                                 const int32_t lhs_rows,
+                                 const q15_t *packed_rhs,
+                                 const int32_t rhs_rows,
+                                 const int32_t rhs_cols,
+                                 const int32_t *bias,
+                                 const int32_t *dst_multipliers,
+                                 const int32_t *dst_shifts,
+                                 const int32_t per_channel,
+                                 const int32_t dst_offset,
+                                 const int32_t activation_min,
+                                 const int32_t activation_max,
+                                 q7_t *dst);
+
 /**
  * @brief Depthwise convolution of transposed rhs matrix with 4 lhs matrices. To be used in padded cases where
  *        the padding is -lhs_offset(Range: int8). Dimensions are the same for lhs and rhs.
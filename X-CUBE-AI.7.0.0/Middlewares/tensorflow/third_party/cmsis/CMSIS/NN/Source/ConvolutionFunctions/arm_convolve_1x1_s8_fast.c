@@ -176,6 +176,16 @@ int32_t arm_convolve_1x1_s8_fast_get_buffer_size(const cmsis_nn_dims *input_dims
     return 0;
 }
 
+void arm_convolve_1x1_s8_fast_fold_bias(const cmsis_nn_conv_params *conv_params,
+                                        const cmsis_nn_dims *filter_dims,
+                                        const q7_t *filter_data,
+                                        const int32_t *bias_data,
+                                        int32_t *folded_bias)
+{
+    arm_nn_fold_lhs_offset_s8(
+        filter_data, bias_data, filter_dims->n, filter_dims->c, conv_params->input_offset, folded_bias);
+}
+
 /**
  * @} end of NNConv group
  */
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_convolve_packed_s8.c
+ * Description:  s8 convolution with a filter packed at initialization.
+ *
+ * $Date:        19. October 2026
+ * $Revision:    V.1.0.0
+ *
+ * Target Processor:  Cortex-M cores
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv
+ * @{
+ */
+
+/*
+ * The filter is widened to q15 and interleaved by pairs of output channels
+ * once, by arm_convolve_packed_s8_pack_filter, instead of being expanded
+ * from s8 by every call. Two im2col columns are then multiplied with the
+ * packed filter, read linearly. The result is bit-exact with arm_convolve_s8.
+ */
+
+int32_t arm_convolve_packed_s8_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims)
+{
+    return 2 * input_dims->c * filter_dims->w * filter_dims->h * (int32_t)sizeof(q15_t);
+}
+
+int32_t arm_convolve_packed_s8_get_filter_size(const cmsis_nn_dims *filter_dims)
+{
+    return filter_dims->n * filter_dims->h * filter_dims->w * filter_dims->c * (int32_t)sizeof(q15_t);
+}
+
+arm_status arm_convolve_packed_s8_pack_filter(const cmsis_nn_dims *filter_dims,
+                                              const q7_t *filter_data,
+                                              q15_t *packed_filter_data)
+{
+    arm_nn_pack_weights_s8_s16(filter_data,
+                               filter_dims->n,
+                               filter_dims->h * filter_dims->w * filter_dims->c,
+                               0,
+                               packed_filter_data);
+    return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_convolve_packed_s8(const cmsis_nn_context *ctx,
+                                  const cmsis_nn_conv_params *conv_params,
+                                  const cmsis_nn_per_channel_quant_params *quant_params,
+                                  const cmsis_nn_dims *input_dims,
+                                  const q7_t *input_data,
+                                  const cmsis_nn_dims *filter_dims,
+                                  const q15_t *packed_filter_data,
+                                  const cmsis_nn_dims *bias_dims,
+                                  const int32_t *bias_data,
+                                  const cmsis_nn_dims *output_dims,
+                                  q7_t *output_data)
+{
+    (void)bias_dims;
+    q15_t *buffer_a = (q15_t *)ctx->buf;
+
+    const int32_t input_batches = input_dims->n;
+    const int32_t input_x = input_dims->w;
+    const int32_t input_y = input_dims->h;
+    const int32_t input_ch = input_dims->c;
+    const int32_t kernel_x = filter_dims->w;
+    const int32_t kernel_y = filter_dims->h;
+    const int32_t output_x = output_dims->w;
+    const int32_t output_y = output_dims->h;
+    const int32_t output_ch = output_dims->c;
+
+    const int32_t pad_x = conv_params->padding.w;
+    const int32_t pad_y = conv_params->padding.h;
+    const int32_t stride_x = conv_params->stride.w;
+    const int32_t stride_y = conv_params->stride.h;
+
+    const int32_t input_offset = conv_params->input_offset;
+    const int32_t out_offset = conv_params->output_offset;
+    const int32_t out_activation_min = conv_params->activation.min;
+    const int32_t out_activation_max = conv_params->activation.max;
+
+    const int32_t num_elem = kernel_x * kernel_y * input_ch;
+    int32_t i_batch, i_out_y, i_out_x, i_ker_y, i_ker_x;
+
+    if (buffer_a == NULL || conv_params->dilation.h != 1 || conv_params->dilation.w != 1)
+    {
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    for (i_batch = 0; i_batch < input_batches; i_batch++)
+    {
+        /* Generate two columns from the input tensor a GEMM computation */
+        q15_t *two_column_buf = buffer_a;
+        q7_t *out = output_data;
+
+        /* This part implements the im2col function */
+        for (i_out_y = 0; i_out_y < output_y; i_out_y++)
+        {
+            for (i_out_x = 0; i_out_x < output_x; i_out_x++)
+            {
+                for (i_ker_y = i_out_y * stride_y - pad_y; i_ker_y < i_out_y * stride_y - pad_y + kernel_y; i_ker_y++)
+                {
+                    for (i_ker_x = i_out_x * stride_x - pad_x; i_ker_x < i_out_x * stride_x - pad_x + kernel_x;
+                         i_ker_x++)
+                    {
+                        if (i_ker_y < 0 || i_ker_y >= input_y || i_ker_x < 0 || i_ker_x >= input_x)
+                        {
+                            /* Filling 0 for out-of-bound paddings */
+                            memset(two_column_buf, 0, sizeof(q15_t) * input_ch);
+                        }
+                        else
+                        {
+                            /* Copying the pixel data to column */
+                            arm_q7_to_q15_with_offset(input_data + (i_ker_y * input_x + i_ker_x) * input_ch,
+                                                      two_column_buf,
+                                                      input_ch,
+                                                      (q15_t)input_offset);
+                        }
+                        two_column_buf += input_ch;
+                    }
+                }
+
+                /* Computation is filed for every 2 columns */
+                if (two_column_buf == buffer_a + 2 * num_elem)
+                {
+                    out = arm_nn_mat_mult_packed_s16(buffer_a,
+                                                     2,
+                                                     packed_filter_data,
+                                                     output_ch,
+                                                     num_elem,
+                                                     bias_data,
+                                                     quant_params->multiplier,
+                                                     quant_params->shift,
+                                                     1,
+                                                     out_offset,
+                                                     out_activation_min,
+                                                     out_activation_max,
+                                                     out);
+
+                    /* counter reset */
+                    two_column_buf = buffer_a;
+                }
+            }
+        }
+
+        /* left-over because odd number of output pixels */
+        if (two_column_buf != buffer_a)
+        {
+            (void)arm_nn_mat_mult_packed_s16(buffer_a,
+                                             1,
+                                             packed_filter_data,
+                                             output_ch,
+                                             num_elem,
+                                             bias_data,
+                                             quant_params->multiplier,
+                                             quant_params->shift,
+                                             1,
+                                             out_offset,
+                                             out_activation_min,
+                                             out_activation_max,
+                                             out);
+        }
+
+        /* Advance to the next batch */
+        input_data += (input_x * input_y * input_ch);
+        output_data += (output_x * output_y * output_ch);
+    }
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @} end of NNConv group
+ */
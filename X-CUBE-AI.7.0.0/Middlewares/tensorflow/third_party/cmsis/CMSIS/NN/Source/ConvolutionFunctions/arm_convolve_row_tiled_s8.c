@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_convolve_row_tiled_s8.c
+ * Description:  s8 convolution with an im2col buffer holding a few rows of
+ *               the filter.
+ *
+ * $Date:        19. October 2026
+ * $Revision:    V.1.0.0
+ *
+ * Target Processor:  Cortex-M cores
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv
+ * @{
+ */
+
+/*
+ * The buffer holds the accumulators of one output pixel for all the output
+ * channels (int32) followed by the im2col column of filter_rows rows of its
+ * receptive field (int16, input offset added). The accumulators are integer,
+ * so summing the filter rows block by block gives the same result as
+ * arm_convolve_s8.
+ */
+
+int32_t arm_convolve_row_tiled_s8_get_buffer_size(const cmsis_nn_dims *filter_dims, const int32_t filter_rows)
+{
+    return filter_dims->n * sizeof(int32_t) + filter_rows * filter_dims->w * filter_dims->c * sizeof(q15_t);
+}
+
+arm_status arm_convolve_row_tiled_s8(const cmsis_nn_context *ctx,
+                                     const cmsis_nn_conv_params *conv_params,
+                                     const cmsis_nn_per_channel_quant_params *quant_params,
+                                     const cmsis_nn_dims *input_dims,
+                                     const q7_t *input_data,
+                                     const cmsis_nn_dims *filter_dims,
+                                     const q7_t *filter_data,
+                                     const cmsis_nn_dims *bias_dims,
+                                     const int32_t *bias_data,
+                                     const cmsis_nn_dims *output_dims,
+                                     q7_t *output_data,
+                                     const int32_t filter_rows)
+{
+    (void)bias_dims;
+
+    const int32_t input_batches = input_dims->n;
+    const int32_t input_x = input_dims->w;
+    const int32_t input_y = input_dims->h;
+    const int32_t input_ch = input_dims->c;
+    const int32_t kernel_x = filter_dims->w;
+    const int32_t kernel_y = filter_dims->h;
+    const int32_t output_x = output_dims->w;
+    const int32_t output_y = output_dims->h;
+    const int32_t output_ch = output_dims->c;
+
+    const int32_t pad_x = conv_params->padding.w;
+    const int32_t pad_y = conv_params->padding.h;
+    const int32_t stride_x = conv_params->stride.w;
+    const int32_t stride_y = conv_params->stride.h;
+
+    const int32_t input_offset = conv_params->input_offset;
+    const int32_t out_offset = conv_params->output_offset;
+    const int32_t out_activation_min = conv_params->activation.min;
+    const int32_t out_activation_max = conv_params->activation.max;
+    const int32_t *output_mult = quant_params->multiplier;
+    const int32_t *output_shift = quant_params->shift;
+
+    const int32_t row_size = kernel_x * input_ch;
+    const int32_t patch_size = kernel_y * row_size;
+    int32_t *acc_buf = (int32_t *)ctx->buf;
+    q15_t *col_buf = (q15_t *)(acc_buf + output_ch);
+
+    int32_t i_batch, i_out_y, i_out_x, i_ker_y, i_ker_x, i_out_ch;
+
+    if (acc_buf == NULL || filter_rows < 1 || filter_rows > kernel_y || conv_params->dilation.h != 1 ||
+        conv_params->dilation.w != 1)
+    {
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    for (i_batch = 0; i_batch < input_batches; i_batch++)
+    {
+        for (i_out_y = 0; i_out_y < output_y; i_out_y++)
+        {
+            const int32_t base_y = i_out_y * stride_y - pad_y;
+            for (i_out_x = 0; i_out_x < output_x; i_out_x++)
+            {
+                const int32_t base_x = i_out_x * stride_x - pad_x;
+
+                for (i_out_ch = 0; i_out_ch < output_ch; i_out_ch++)
+                {
+                    acc_buf[i_out_ch] = bias_data ? bias_data[i_out_ch] : 0;
+                }
+
+                for (i_ker_y = 0; i_ker_y < kernel_y; i_ker_y += filter_rows)
+                {
+                    const int32_t rows = MIN(filter_rows, kernel_y - i_ker_y);
+                    const int32_t col_size = rows * row_size;
+                    q15_t *col = col_buf;
+                    int32_t i_row;
+
+                    /* im2col of the filter rows [i_ker_y, i_ker_y + rows) */
+                    for (i_row = i_ker_y; i_row < i_ker_y + rows; i_row++)
+                    {
+                        const int32_t in_y = base_y + i_row;
+                        for (i_ker_x = 0; i_ker_x < kernel_x; i_ker_x++)
+                        {
+                            const int32_t in_x = base_x + i_ker_x;
+                            if (in_y < 0 || in_y >= input_y || in_x < 0 || in_x >= input_x)
+                            {
+                                /* Filling 0 for out-of-bound paddings */
+                                memset(col, 0, sizeof(q15_t) * input_ch);
+                            }
+                            else
+                            {
+                                arm_q7_to_q15_with_offset(input_data + (in_y * input_x + in_x) * input_ch,
+                                                          col,
+                                                          input_ch,
+                                                          (q15_t)input_offset);
+                            }
+                            col += input_ch;
+                        }
+                    }
+
+                    for (i_out_ch = 0; i_out_ch < output_ch; i_out_ch++)
+                    {
+                        const q7_t *ker_p = filter_data + i_out_ch * patch_size + i_ker_y * row_size;
+                        const q15_t *col_p = col_buf;
+                        int32_t sum = acc_buf[i_out_ch];
+                        int32_t col_count = col_size;
+#if defined(ARM_MATH_DSP)
+                        col_count = col_size >> 2;
+                        while (col_count)
+                        {
+                            q31_t ker_a1, ker_a2;
+                            ker_p = read_and_pad(ker_p, &ker_a1, &ker_a2);
+                            sum = __SMLAD(ker_a1, arm_nn_read_q15x2_ia(&col_p), sum);
+                            sum = __SMLAD(ker_a2, arm_nn_read_q15x2_ia(&col_p), sum);
+                            col_count--;
+                        }
+                        col_count = col_size & 0x3;
+#endif
+                        while (col_count)
+                        {
+                            sum += (*ker_p++) * (*col_p++);
+                            col_count--;
+                        }
+                        acc_buf[i_out_ch] = sum;
+                    }
+                }
+
+                for (i_out_ch = 0; i_out_ch < output_ch; i_out_ch++)
+                {
+                    int32_t acc = arm_nn_requantize(acc_buf[i_out_ch], output_mult[i_out_ch], output_shift[i_out_ch]);
+                    acc += out_offset;
+                    acc = MAX(acc, out_activation_min);
+                    acc = MIN(acc, out_activation_max);
+                    output_data[(i_out_y * output_x + i_out_x) * output_ch + i_out_ch] = (q7_t)acc;
+                }
+            }
+        }
+        /* Advance to the next batch */
+        input_data += (input_x * input_y * input_ch);
+        output_data += (output_x * output_y * output_ch);
+    }
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @} end of NNConv group
+ */
@@ -85,6 +85,8 @@ arm_status arm_convolve_s8(const cmsis_nn_context *ctx,
     int32_t *output_mult = quant_params->multiplier;
     int32_t *output_shift = quant_params->shift;
 
+    ARM_NN_PROFILE_BEGIN("arm_convolve_s8");
+
     int i_batch;
     for (i_batch = 0; i_batch < input_batches; i_batch++)
     {
@@ -101,6 +103,7 @@ arm_status arm_convolve_s8(const cmsis_nn_context *ctx,
         {
             for (int i_out_x = 0; i_out_x < output_x; i_out_x++)
             {
+                ARM_NN_PROFILE_BEGIN("arm_convolve_s8/im2col");
                 for (int i_ker_y = i_out_y * stride_y - pad_y; i_ker_y < i_out_y * stride_y - pad_y + kernel_y;
                      i_ker_y++)
                 {
@@ -119,6 +122,7 @@ arm_status arm_convolve_s8(const cmsis_nn_context *ctx,
                         im2col_buf += input_ch;
                     }
                 }
+                ARM_NN_PROFILE_END();
 
                 buffer_fill_cnt++;
 
@@ -209,6 +213,7 @@ arm_status arm_convolve_s8(const cmsis_nn_context *ctx,
         {
             for (i_out_x = 0; i_out_x < output_x; i_out_x++)
             {
+                ARM_NN_PROFILE_BEGIN("arm_convolve_s8/im2col");
                 for (i_ker_y = i_out_y * stride_y - pad_y; i_ker_y < i_out_y * stride_y - pad_y + kernel_y; i_ker_y++)
                 {
                     for (i_ker_x = i_out_x * stride_x - pad_x; i_ker_x < i_out_x * stride_x - pad_x + kernel_x;
@@ -230,6 +235,7 @@ arm_status arm_convolve_s8(const cmsis_nn_context *ctx,
                         two_column_buf += input_ch;
                     }
                 }
+                ARM_NN_PROFILE_END();
 
                 /* Computation is filed for every 2 columns */
                 if (two_column_buf == buffer_a + 2 * input_ch * kernel_y * kernel_x)
@@ -360,6 +366,8 @@ arm_status arm_convolve_s8(const cmsis_nn_context *ctx,
         output_data += (output_x * output_y * output_ch);
     }
 
+    ARM_NN_PROFILE_END();
+
     /* Return to application */
     return ARM_MATH_SUCCESS;
 }
@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_convolve_winograd_s8.c
+ * Description:  s8 3x3 stride 1 convolution using the Winograd F(2x2, 3x3)
+ *               transform.
+ *
+ * $Date:        18. October 2026
+ * $Revision:    V.1.0.0
+ *
+ * Target Processor:  Cortex-M cores
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv
+ * @{
+ */
+
+#define WINOGRAD_TILE (4)
+#define WINOGRAD_TILE_SIZE (WINOGRAD_TILE * WINOGRAD_TILE)
+#define WINOGRAD_MAX_INPUT_CH (1024)
+
+/*
+ * The filter is transformed with 2G (G scaled by two to stay in integers), so
+ * the Winograd domain products sum up to four times the direct convolution
+ * accumulator. All the transforms only use additions and subtractions.
+ *
+ * The Winograd domain values can exceed the int32 range while the final
+ * accumulator cannot, so the output transform is computed modulo 2^32.
+ */
+
+/* t = B^T d for the 4 columns of a 4x4 tile stored row major. */
+static void arm_winograd_input_transform_rows(const int32_t *d, int32_t *t)
+{
+    int i;
+    for (i = 0; i < WINOGRAD_TILE; i++)
+    {
+        t[0 * WINOGRAD_TILE + i] = d[0 * WINOGRAD_TILE + i] - d[2 * WINOGRAD_TILE + i];
+        t[1 * WINOGRAD_TILE + i] = d[1 * WINOGRAD_TILE + i] + d[2 * WINOGRAD_TILE + i];
+        t[2 * WINOGRAD_TILE + i] = d[2 * WINOGRAD_TILE + i] - d[1 * WINOGRAD_TILE + i];
+        t[3 * WINOGRAD_TILE + i] = d[1 * WINOGRAD_TILE + i] - d[3 * WINOGRAD_TILE + i];
+    }
+}
+
+int32_t arm_convolve_winograd_s8_get_buffer_size(const cmsis_nn_dims *input_dims)
+{
+    return WINOGRAD_TILE_SIZE * input_dims->c * sizeof(q15_t);
+}
+
+int32_t arm_convolve_winograd_s8_get_filter_size(const cmsis_nn_dims *filter_dims)
+{
+    return WINOGRAD_TILE_SIZE * filter_dims->n * filter_dims->c * sizeof(q15_t);
+}
+
+arm_status arm_convolve_winograd_s8_transform_filter(const cmsis_nn_dims *filter_dims,
+                                                     const q7_t *filter_data,
+                                                     q15_t *transformed_filter_data)
+{
+    const int32_t output_ch = filter_dims->n;
+    const int32_t input_ch = filter_dims->c;
+    int32_t i_out_ch, i_in_ch, i;
+
+    if (filter_dims->h != 3 || filter_dims->w != 3)
+    {
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    for (i_out_ch = 0; i_out_ch < output_ch; i_out_ch++)
+    {
+        const q7_t *ker = filter_data + i_out_ch * 9 * input_ch;
+        q15_t *dst = transformed_filter_data + i_out_ch * WINOGRAD_TILE_SIZE * input_ch;
+
+        for (i_in_ch = 0; i_in_ch < input_ch; i_in_ch++)
+        {
+            int32_t g[9];
+            int32_t t[12];
+
+            for (i = 0; i < 9; i++)
+            {
+                g[i] = ker[i * input_ch + i_in_ch];
+            }
+            /* t = (2G) g, 4x3 */
+            for (i = 0; i < 3; i++)
+            {
+                t[0 * 3 + i] = 2 * g[0 * 3 + i];
+                t[1 * 3 + i] = g[0 * 3 + i] + g[1 * 3 + i] + g[2 * 3 + i];
+                t[2 * 3 + i] = g[0 * 3 + i] - g[1 * 3 + i] + g[2 * 3 + i];
+                t[3 * 3 + i] = 2 * g[2 * 3 + i];
+            }
+            /* U = t (2G)^T, 4x4 */
+            for (i = 0; i < WINOGRAD_TILE; i++)
+            {
+                const int32_t *row = &t[i * 3];
+                dst[(i * WINOGRAD_TILE + 0) * input_ch + i_in_ch] = (q15_t)(2 * row[0]);
+                dst[(i * WINOGRAD_TILE + 1) * input_ch + i_in_ch] = (q15_t)(row[0] + row[1] + row[2]);
+                dst[(i * WINOGRAD_TILE + 2) * input_ch + i_in_ch] = (q15_t)(row[0] - row[1] + row[2]);
+                dst[(i * WINOGRAD_TILE + 3) * input_ch + i_in_ch] = (q15_t)(2 * row[2]);
+            }
+        }
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_convolve_winograd_s8(const cmsis_nn_context *ctx,
+                                    const cmsis_nn_conv_params *conv_params,
+                                    const cmsis_nn_per_channel_quant_params *quant_params,
+                                    const cmsis_nn_dims *input_dims,
+                                    const q7_t *input_data,
+                                    const cmsis_nn_dims *filter_dims,
+                                    const q15_t *transformed_filter_data,
+                                    const cmsis_nn_dims *bias_dims,
+                                    const int32_t *bias_data,
+                                    const cmsis_nn_dims *output_dims,
+                                    q7_t *output_data)
+{
+    (void)bias_dims;
+    q15_t *buffer_v = (q15_t *)ctx->buf;
+
+    const int32_t input_batches = input_dims->n;
+    const int32_t input_x = input_dims->w;
+    const int32_t input_y = input_dims->h;
+    const int32_t input_ch = input_dims->c;
+    const int32_t output_x = output_dims->w;
+    const int32_t output_y = output_dims->h;
+    const int32_t output_ch = output_dims->c;
+
+    const int32_t pad_x = conv_params->padding.w;
+    const int32_t pad_y = conv_params->padding.h;
+    const int32_t input_offset = conv_params->input_offset;
+    const int32_t out_offset = conv_params->output_offset;
+    const int32_t out_activation_min = conv_params->activation.min;
+    const int32_t out_activation_max = conv_params->activation.max;
+    const int32_t *output_mult = quant_params->multiplier;
+    const int32_t *output_shift = quant_params->shift;
+
+    int32_t i_batch, i_tile_y, i_tile_x, i_in_ch, i_out_ch, i;
+
+    if (filter_dims->h != 3 || filter_dims->w != 3 || conv_params->stride.h != 1 || conv_params->stride.w != 1 ||
+        conv_params->dilation.h != 1 || conv_params->dilation.w != 1 || input_ch > WINOGRAD_MAX_INPUT_CH ||
+        buffer_v == NULL)
+    {
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    for (i_batch = 0; i_batch < input_batches; i_batch++)
+    {
+        for (i_tile_y = 0; i_tile_y < output_y; i_tile_y += 2)
+        {
+            const int32_t base_y = i_tile_y - pad_y;
+            for (i_tile_x = 0; i_tile_x < output_x; i_tile_x += 2)
+            {
+                const int32_t base_x = i_tile_x - pad_x;
+
+                /* V = B^T d B for every input channel, stored as [16][input_ch] */
+                for (i_in_ch = 0; i_in_ch < input_ch; i_in_ch++)
+                {
+                    int32_t d[WINOGRAD_TILE_SIZE];
+                    int32_t t[WINOGRAD_TILE_SIZE];
+                    int32_t k_y, k_x;
+
+                    for (k_y = 0; k_y < WINOGRAD_TILE; k_y++)
+                    {
+                        const int32_t in_y = base_y + k_y;
+                        for (k_x = 0; k_x < WINOGRAD_TILE; k_x++)
+                        {
+                            const int32_t in_x = base_x + k_x;
+                            if (in_y < 0 || in_y >= input_y || in_x < 0 || in_x >= input_x)
+                            {
+                                d[k_y * WINOGRAD_TILE + k_x] = 0;
+                            }
+                            else
+                            {
+                                d[k_y * WINOGRAD_TILE + k_x] =
+                                    input_data[(in_y * input_x + in_x) * input_ch + i_in_ch] + input_offset;
+                            }
+                        }
+                    }
+                    arm_winograd_input_transform_rows(d, t);
+                    for (k_y = 0; k_y < WINOGRAD_TILE; k_y++)
+                    {
+                        const int32_t *row = &t[k_y * WINOGRAD_TILE];
+                        buffer_v[(k_y * WINOGRAD_TILE + 0) * input_ch + i_in_ch] = (q15_t)(row[0] - row[2]);
+                        buffer_v[(k_y * WINOGRAD_TILE + 1) * input_ch + i_in_ch] = (q15_t)(row[1] + row[2]);
+                        buffer_v[(k_y * WINOGRAD_TILE + 2) * input_ch + i_in_ch] = (q15_t)(row[2] - row[1]);
+                        buffer_v[(k_y * WINOGRAD_TILE + 3) * input_ch + i_in_ch] = (q15_t)(row[1] - row[3]);
+                    }
+                }
+
+                for (i_out_ch = 0; i_out_ch < output_ch; i_out_ch++)
+                {
+                    const q15_t *ker = transformed_filter_data + i_out_ch * WINOGRAD_TILE_SIZE * input_ch;
+                    uint32_t m[WINOGRAD_TILE_SIZE];
+                    uint32_t t[2 * WINOGRAD_TILE];
+
+                    /* M = U . V, element-wise over the tile and reduced over the input channels */
+                    for (i = 0; i < WINOGRAD_TILE_SIZE; i++)
+                    {
+                        const q15_t *ker_p = ker + i * input_ch;
+                        const q15_t *v_p = buffer_v + i * input_ch;
+                        int32_t sum = 0;
+                        int32_t col_count = input_ch;
+#if defined(ARM_MATH_DSP)
+                        col_count = input_ch >> 1;
+                        while (col_count)
+                        {
+                            const q31_t ker_q15x2 = arm_nn_read_q15x2_ia(&ker_p);
+                            const q31_t v_q15x2 = arm_nn_read_q15x2_ia(&v_p);
+                            sum = __SMLAD(ker_q15x2, v_q15x2, sum);
+                            col_count--;
+                        }
+                        col_count = input_ch & 0x1;
+#endif
+                        while (col_count)
+                        {
+                            sum += (*ker_p++) * (*v_p++);
+                            col_count--;
+                        }
+                        m[i] = (uint32_t)sum;
+                    }
+
+                    /* Y = A^T M A, computed modulo 2^32 */
+                    for (i = 0; i < WINOGRAD_TILE; i++)
+                    {
+                        t[0 * WINOGRAD_TILE + i] = m[0 * WINOGRAD_TILE + i] + m[1 * WINOGRAD_TILE + i] +
+                            m[2 * WINOGRAD_TILE + i];
+                        t[1 * WINOGRAD_TILE + i] = m[1 * WINOGRAD_TILE + i] - m[2 * WINOGRAD_TILE + i] -
+                            m[3 * WINOGRAD_TILE + i];
+                    }
+                    for (i = 0; i < 2; i++)
+                    {
+                        const uint32_t *row = &t[i * WINOGRAD_TILE];
+                        const int32_t out_y = i_tile_y + i;
+                        int32_t y[2];
+                        int32_t j;
+
+                        if (out_y >= output_y)
+                        {
+                            break;
+                        }
+                        y[0] = (int32_t)(row[0] + row[1] + row[2]) / 4;
+                        y[1] = (int32_t)(row[1] - row[2] - row[3]) / 4;
+
+                        for (j = 0; j < 2; j++)
+                        {
+                            const int32_t out_x = i_tile_x + j;
+                            int32_t acc = y[j];
+
+                            if (out_x >= output_x)
+                            {
+                                break;
+                            }
+                            if (bias_data)
+                            {
+                                acc += bias_data[i_out_ch];
+                            }
+                            acc = arm_nn_requantize(acc, output_mult[i_out_ch], output_shift[i_out_ch]);
+                            acc += out_offset;
+                            acc = MAX(acc, out_activation_min);
+                            acc = MIN(acc, out_activation_max);
+                            output_data[(out_y * output_x + out_x) * output_ch + i_out_ch] = (q7_t)acc;
+                        }
+                    }
+                }
+            }
+        }
+        /* Advance to the next batch */
+        input_data += (input_x * input_y * input_ch);
+        output_data += (output_x * output_y * output_ch);
+    }
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @} end of NNConv group
+ */
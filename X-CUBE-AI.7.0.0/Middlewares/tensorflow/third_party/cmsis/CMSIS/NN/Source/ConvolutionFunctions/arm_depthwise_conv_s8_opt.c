@@ -88,6 +88,8 @@ arm_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
     const int32_t output_activation_max = dw_conv_params->activation.max;
     q15_t *buffer_a = (q15_t *)ctx->buf;
 
+    ARM_NN_PROFILE_BEGIN("arm_depthwise_conv_s8_opt");
+
 #ifdef ARM_MATH_MVEI
     (void)bias_dims;
     /* Generate two columns from the input tensor */
@@ -223,6 +225,8 @@ arm_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
         {
             const int16_t base_idx_x = (i_out_x * stride_x) - pad_x;
 
+            ARM_NN_PROFILE_BEGIN("arm_depthwise_conv_s8_opt/im2col");
+
             /* Out of bounds is only considered for the y axis as it provides a contiguous zero'ing opportunity than
                along the x axis */
             const int ker_y_start = MAX(0, -base_idx_y);
@@ -263,6 +267,7 @@ arm_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
             {
                 memset(&col_buffer[index], 0, (kernel_x * input_ch) * diff * sizeof(q15_t));
             }
+            ARM_NN_PROFILE_END();
 
             row_count = output_ch / 4;
             row_shift = 0;
@@ -337,6 +342,8 @@ arm_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
 
                     col_count--;
                 }
+
+                ARM_NN_PROFILE_BEGIN("arm_depthwise_conv_s8_opt/requantize");
                 sum = arm_nn_requantize(sum, *output_mult++, *output_shift++);
                 sum += output_offset;
                 sum = MAX(sum, output_activation_min);
@@ -359,6 +366,7 @@ arm_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
                 sum_4 = MAX(sum_4, output_activation_min);
                 sum_4 = MIN(sum_4, output_activation_max);
                 *output++ = (q7_t)sum_4;
+                ARM_NN_PROFILE_END();
 
                 row_count--;
             }
@@ -376,11 +384,13 @@ arm_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
                 {
                     sum += row_pos[i * input_ch] * col_pos[i * input_ch];
                 }
+                ARM_NN_PROFILE_BEGIN("arm_depthwise_conv_s8_opt/requantize");
                 sum = arm_nn_requantize(sum, *output_mult++, *output_shift++);
                 sum += output_offset;
                 sum = MAX(sum, output_activation_min);
                 sum = MIN(sum, output_activation_max);
                 *output++ = (q7_t)sum;
+                ARM_NN_PROFILE_END();
 
                 row_count--;
             }
@@ -390,6 +400,7 @@ arm_status arm_depthwise_conv_s8_opt(const cmsis_nn_context *ctx,
         }
     }
 #endif
+    ARM_NN_PROFILE_END();
 #else
     /* Run the following code as reference implementation for Cortex-M0 and Cortex-M3 */
     return arm_depthwise_conv_s8(ctx,
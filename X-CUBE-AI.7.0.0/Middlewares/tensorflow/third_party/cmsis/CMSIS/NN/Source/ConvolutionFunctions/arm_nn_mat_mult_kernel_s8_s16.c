@@ -217,6 +217,8 @@ q7_t *arm_nn_mat_mult_kernel_s8_s16(const q7_t *input_a,
     return out_1;
 
 #elif defined(ARM_MATH_DSP)
+    ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_kernel_s8_s16");
+
     /* set up the second output pointers */
     q7_t *out_1 = out_0 + output_ch;
     const int32_t *bias = output_bias;
@@ -280,6 +282,7 @@ q7_t *arm_nn_mat_mult_kernel_s8_s16(const q7_t *input_a,
             col_count--;
         } /* while over col_count */
 
+        ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_kernel_s8_s16/requantize");
         ch_0_out_0 = arm_nn_requantize(ch_0_out_0, *out_mult, *out_shift);
         ch_0_out_0 += out_offset;
         ch_0_out_0 = MAX(ch_0_out_0, activation_min);
@@ -307,6 +310,7 @@ q7_t *arm_nn_mat_mult_kernel_s8_s16(const q7_t *input_a,
         *out_1++ = (q7_t)ch_1_out_1;
         out_mult++;
         out_shift++;
+        ARM_NN_PROFILE_END();
 
         /* skip row */
         ip_a0 += num_col_a;
@@ -354,6 +358,7 @@ q7_t *arm_nn_mat_mult_kernel_s8_s16(const q7_t *input_a,
             ch_0_out_1 += a0 * b1;
             col_count--;
         }
+        ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_kernel_s8_s16/requantize");
         ch_0_out_0 = arm_nn_requantize(ch_0_out_0, *out_mult, *out_shift);
         ch_0_out_0 += out_offset;
         ch_0_out_0 = MAX(ch_0_out_0, activation_min);
@@ -367,10 +372,13 @@ q7_t *arm_nn_mat_mult_kernel_s8_s16(const q7_t *input_a,
         *out_1++ = (q7_t)ch_0_out_1;
         out_mult++;
         out_shift++;
+        ARM_NN_PROFILE_END();
     }
 
     out_0 += output_ch;
 
+    ARM_NN_PROFILE_END();
+
     /* return the new output pointer with offset */
     return out_0;
 #else
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_fully_connected_folded_s8.c
+ * Description:  s8 fully-connected layer with the input offset folded into
+ *               the bias at initialization.
+ *
+ * $Date:        19. October 2026
+ * $Revision:    V.1.0.0
+ *
+ * Target Processor:  Cortex-M cores
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup FC
+ * @{
+ */
+
+/*
+ * The contribution of the input offset, input_offset * sum(kernel[r]), is
+ * constant per output channel. arm_fully_connected_folded_s8_fold_bias adds
+ * it to the bias once, each call only multiplies the raw values. The result
+ * is bit-exact with arm_fully_connected_s8.
+ */
+
+arm_status arm_fully_connected_folded_s8_fold_bias(const cmsis_nn_fc_params *fc_params,
+                                                   const cmsis_nn_dims *filter_dims,
+                                                   const q7_t *kernel,
+                                                   const int32_t *bias,
+                                                   int32_t *folded_bias)
+{
+    if (fc_params->filter_offset != 0)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    arm_nn_fold_lhs_offset_s8(kernel, bias, filter_dims->c, filter_dims->n, fc_params->input_offset, folded_bias);
+    return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_fully_connected_folded_s8(const cmsis_nn_context *ctx,
+                                         const cmsis_nn_fc_params *fc_params,
+                                         const cmsis_nn_per_tensor_quant_params *quant_params,
+                                         const cmsis_nn_dims *input_dims,
+                                         const q7_t *input,
+                                         const cmsis_nn_dims *filter_dims,
+                                         const q7_t *kernel,
+                                         const cmsis_nn_dims *bias_dims,
+                                         const int32_t *folded_bias,
+                                         const cmsis_nn_dims *output_dims,
+                                         q7_t *output)
+{
+    (void)bias_dims;
+    (void)ctx;
+    int32_t batch_cnt = input_dims->n;
+
+    while (batch_cnt)
+    {
+        arm_nn_vec_mat_mult_t_folded_s8(input,
+                                        kernel,
+                                        folded_bias,
+                                        output,
+                                        fc_params->output_offset,
+                                        quant_params->multiplier,
+                                        quant_params->shift,
+                                        filter_dims->n, /* col_dim or accum_depth */
+                                        output_dims->c, /* row_dim or output_depth */
+                                        fc_params->activation.min,
+                                        fc_params->activation.max);
+        input += filter_dims->n;
+        output += output_dims->c;
+        batch_cnt--;
+    }
+    return (ARM_MATH_SUCCESS);
+}
+
+/**
+ * @} end of FC group
+ */
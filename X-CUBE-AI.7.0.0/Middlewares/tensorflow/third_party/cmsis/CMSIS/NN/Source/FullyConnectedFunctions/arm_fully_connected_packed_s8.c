@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_fully_connected_packed_s8.c
+ * Description:  s8 fully-connected layer with weights packed at
+ *               initialization.
+ *
+ * $Date:        19. October 2026
+ * $Revision:    V.1.0.0
+ *
+ * Target Processor:  Cortex-M cores
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup FC
+ * @{
+ */
+
+/*
+ * The weights are widened to q15 and interleaved by pairs of rows once, by
+ * arm_fully_connected_packed_s8_pack_weights. Each call widens the input
+ * vectors (two batches at a time) and multiplies them with the packed
+ * weights, read linearly. The result is bit-exact with
+ * arm_fully_connected_s8.
+ */
+
+int32_t arm_fully_connected_packed_s8_get_buffer_size(const cmsis_nn_dims *input_dims,
+                                                      const cmsis_nn_dims *filter_dims)
+{
+    return MIN(input_dims->n, 2) * filter_dims->n * (int32_t)sizeof(q15_t);
+}
+
+int32_t arm_fully_connected_packed_s8_get_weights_size(const cmsis_nn_dims *filter_dims)
+{
+    return filter_dims->n * filter_dims->c * (int32_t)sizeof(q15_t);
+}
+
+arm_status arm_fully_connected_packed_s8_pack_weights(const cmsis_nn_fc_params *fc_params,
+                                                      const cmsis_nn_dims *filter_dims,
+                                                      const q7_t *kernel,
+                                                      q15_t *packed_kernel)
+{
+    arm_nn_pack_weights_s8_s16(kernel, filter_dims->c, filter_dims->n, fc_params->filter_offset, packed_kernel);
+    return ARM_MATH_SUCCESS;
+}
+
+arm_status arm_fully_connected_packed_s8(const cmsis_nn_context *ctx,
+                                         const cmsis_nn_fc_params *fc_params,
+                                         const cmsis_nn_per_tensor_quant_params *quant_params,
+                                         const cmsis_nn_dims *input_dims,
+                                         const q7_t *input,
+                                         const cmsis_nn_dims *filter_dims,
+                                         const q15_t *packed_kernel,
+                                         const cmsis_nn_dims *bias_dims,
+                                         const int32_t *bias,
+                                         const cmsis_nn_dims *output_dims,
+                                         q7_t *output)
+{
+    (void)bias_dims;
+    q15_t *buffer = (q15_t *)ctx->buf;
+    const int32_t accum_depth = filter_dims->n;
+    int32_t batch_cnt = input_dims->n;
+
+    if (buffer == NULL)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    while (batch_cnt)
+    {
+        const int32_t vectors = MIN(batch_cnt, 2);
+        arm_q7_to_q15_with_offset(input, buffer, vectors * accum_depth, (q15_t)fc_params->input_offset);
+        output = arm_nn_mat_mult_packed_s16(buffer,
+                                            vectors,
+                                            packed_kernel,
+                                            output_dims->c,
+                                            accum_depth,
+                                            bias,
+                                            &quant_params->multiplier,
+                                            &quant_params->shift,
+                                            0,
+                                            fc_params->output_offset,
+                                            fc_params->activation.min,
+                                            fc_params->activation.max,
+                                            output);
+        input += vectors * accum_depth;
+        batch_cnt -= vectors;
+    }
+    return (ARM_MATH_SUCCESS);
+}
+
+/**
+ * @} end of FC group
+ */
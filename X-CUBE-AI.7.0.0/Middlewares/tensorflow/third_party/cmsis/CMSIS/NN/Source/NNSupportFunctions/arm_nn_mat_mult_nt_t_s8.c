@@ -59,6 +59,8 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
                                    const int32_t activation_min,
                                    const int32_t activation_max)
 {
+    ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_nt_t_s8");
+
 #if defined(ARM_MATH_DSP)
     const int32_t off0 = rhs_cols - 4;
 
@@ -70,14 +72,18 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
         q31_t lhs_offset_contribution0 = 0;
         q31_t lhs_offset_contribution1 = 0;
 
-        for (int32_t x = 0; x < rhs_cols; ++x)
+        // Skipped when the offset is folded into the bias
+        if (lhs_offset != 0)
         {
-            lhs_offset_contribution0 += rhs[x];
-            lhs_offset_contribution1 += rhs[x + rhs_cols];
-        }
+            for (int32_t x = 0; x < rhs_cols; ++x)
+            {
+                lhs_offset_contribution0 += rhs[x];
+                lhs_offset_contribution1 += rhs[x + rhs_cols];
+            }
 
-        lhs_offset_contribution0 *= lhs_offset;
-        lhs_offset_contribution1 *= lhs_offset;
+            lhs_offset_contribution0 *= lhs_offset;
+            lhs_offset_contribution1 *= lhs_offset;
+        }
         if (bias)
         {
             lhs_offset_contribution0 += bias[rhs_rows_idx];
@@ -219,6 +225,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
                 ++lhs_ptr;
             }
 
+            ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_nt_t_s8/requantize");
             // Quantize down
             res00 = arm_nn_requantize(res00, dst_multipliers[rhs_rows_idx], dst_shifts[rhs_rows_idx]);
             res01 = arm_nn_requantize(res01, dst_multipliers[rhs_rows_idx + 1], dst_shifts[rhs_rows_idx + 1]);
@@ -247,6 +254,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
             dst_ptr[0] = (q7_t)res10;
             dst_ptr[1] = (q7_t)res11;
             dst_ptr += rhs_rows;
+            ARM_NN_PROFILE_END();
 
             lhs_ptr += rhs_cols;
 
@@ -345,6 +353,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
                 ++lhs_ptr;
             }
 
+            ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_nt_t_s8/requantize");
             // Quantize down
             res00 = arm_nn_requantize(res00, dst_multipliers[rhs_rows_idx], dst_shifts[rhs_rows_idx]);
             res01 = arm_nn_requantize(res01, dst_multipliers[rhs_rows_idx + 1], dst_shifts[rhs_rows_idx + 1]);
@@ -361,6 +370,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
 
             dst_ptr[0] = (q7_t)res00;
             dst_ptr[1] = (q7_t)res01;
+            ARM_NN_PROFILE_END();
         }
 
         rhs += 2 * rhs_cols;
@@ -392,6 +402,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
                 ++lhs_ptr;
             }
 
+            ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_nt_t_s8/requantize");
             // Quantize down
             res00 = arm_nn_requantize(res00, dst_multipliers[rhs_rows - 1], dst_shifts[rhs_rows - 1]);
 
@@ -404,6 +415,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
 
             dst_ptr[0] = (q7_t)res00;
             dst_ptr += rhs_rows;
+            ARM_NN_PROFILE_END();
         }
     }
 #else
@@ -415,14 +427,18 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
         q31_t lhs_offset_contribution0 = 0;
         q31_t lhs_offset_contribution1 = 0;
 
-        for (int32_t x = 0; x < rhs_cols; ++x)
+        // Skipped when the offset is folded into the bias
+        if (lhs_offset != 0)
         {
-            lhs_offset_contribution0 += rhs[x];
-            lhs_offset_contribution1 += rhs[x + rhs_cols];
-        }
+            for (int32_t x = 0; x < rhs_cols; ++x)
+            {
+                lhs_offset_contribution0 += rhs[x];
+                lhs_offset_contribution1 += rhs[x + rhs_cols];
+            }
 
-        lhs_offset_contribution0 *= lhs_offset;
-        lhs_offset_contribution1 *= lhs_offset;
+            lhs_offset_contribution0 *= lhs_offset;
+            lhs_offset_contribution1 *= lhs_offset;
+        }
         if (bias)
         {
             lhs_offset_contribution0 += bias[rhs_rows_idx];
@@ -457,6 +473,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
                 ++lhs_ptr;
             }
 
+            ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_nt_t_s8/requantize");
             // Quantize down
             res00 = arm_nn_requantize(res00, dst_multipliers[rhs_rows_idx], dst_shifts[rhs_rows_idx]);
             res01 = arm_nn_requantize(res01, dst_multipliers[rhs_rows_idx + 1], dst_shifts[rhs_rows_idx + 1]);
@@ -485,6 +502,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
             dst_ptr[0] = (q7_t)res10;
             dst_ptr[1] = (q7_t)res11;
             dst_ptr += rhs_rows;
+            ARM_NN_PROFILE_END();
 
             lhs_ptr += rhs_cols;
 
@@ -512,6 +530,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
                 ++lhs_ptr;
             }
 
+            ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_nt_t_s8/requantize");
             // Quantize down
             res00 = arm_nn_requantize(res00, dst_multipliers[rhs_rows_idx], dst_shifts[rhs_rows_idx]);
             res01 = arm_nn_requantize(res01, dst_multipliers[rhs_rows_idx + 1], dst_shifts[rhs_rows_idx + 1]);
@@ -528,6 +547,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
 
             dst_ptr[0] = (q7_t)res00;
             dst_ptr[1] = (q7_t)res01;
+            ARM_NN_PROFILE_END();
         }
 
         rhs += 2 * rhs_cols;
@@ -559,6 +579,7 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
                 ++lhs_ptr;
             }
 
+            ARM_NN_PROFILE_BEGIN("arm_nn_mat_mult_nt_t_s8/requantize");
             // Quantize down
             res00 = arm_nn_requantize(res00, dst_multipliers[rhs_rows - 1], dst_shifts[rhs_rows - 1]);
 
@@ -571,9 +592,12 @@ arm_status arm_nn_mat_mult_nt_t_s8(const q7_t *lhs,
 
             dst_ptr[0] = (q7_t)res00;
             dst_ptr += rhs_rows;
+            ARM_NN_PROFILE_END();
         }
     }
 #endif
+    ARM_NN_PROFILE_END();
+
     return ARM_MATH_SUCCESS;
 }
 
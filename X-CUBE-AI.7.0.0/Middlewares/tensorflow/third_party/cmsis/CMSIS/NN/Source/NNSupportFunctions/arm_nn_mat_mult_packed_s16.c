@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_nn_mat_mult_packed_s16.c
+ * Description:  Matrix multiplication of one or two q15 vectors with a
+ *               pre-packed q15 weight matrix
+ *
+ * $Date:        19. October 2026
+ * $Revision:    V.1.0.0
+ *
+ * Target Processor:  Cortex-M cores
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnsupportfunctions.h"
+
+/**
+ * @ingroup groupSupport
+ */
+
+/**
+ * @addtogroup NNBasicMath
+ * @{
+ */
+
+/*
+ * Packed layout: the rows are taken by pairs (r, r + 1) and their columns are
+ * interleaved two by two, { r[c], r[c + 1], (r + 1)[c], (r + 1)[c + 1] }, so
+ * that each SMLAD operand is one aligned word and the matrix is read linearly.
+ * The last column of an odd number of columns is stored as
+ * { r[c], (r + 1)[c] }. The last row of an odd number of rows is stored as is.
+ */
+
+void arm_nn_pack_weights_s8_s16(const q7_t *rhs,
+                                const int32_t rhs_rows,
+                                const int32_t rhs_cols,
+                                const int32_t rhs_offset,
+                                q15_t *dst)
+{
+    int32_t i_row, i_col;
+
+    for (i_row = 0; i_row + 1 < rhs_rows; i_row += 2)
+    {
+        const q7_t *row_0 = rhs + i_row * rhs_cols;
+        const q7_t *row_1 = row_0 + rhs_cols;
+        for (i_col = 0; i_col + 1 < rhs_cols; i_col += 2)
+        {
+            *dst++ = (q15_t)(row_0[i_col] + rhs_offset);
+            *dst++ = (q15_t)(row_0[i_col + 1] + rhs_offset);
+            *dst++ = (q15_t)(row_1[i_col] + rhs_offset);
+            *dst++ = (q15_t)(row_1[i_col + 1] + rhs_offset);
+        }
+        if (rhs_cols & 0x1)
+        {
+            *dst++ = (q15_t)(row_0[rhs_cols - 1] + rhs_offset);
+            *dst++ = (q15_t)(row_1[rhs_cols - 1] + rhs_offset);
+        }
+    }
+    if (rhs_rows & 0x1)
+    {
+        const q7_t *row_0 = rhs + (rhs_rows - 1) * rhs_cols;
+        for (i_col = 0; i_col < rhs_cols; i_col++)
+        {
+            *dst++ = (q15_t)(row_0[i_col] + rhs_offset);
+        }
+    }
+}
+
+static q7_t arm_nn_packed_requantize(const int32_t sum,
+                                     const int32_t multiplier,
+                                     const int32_t shift,
+                                     const int32_t dst_offset,
+                                     const int32_t activation_min,
+                                     const int32_t activation_max)
+{
+    int32_t acc = arm_nn_requantize(sum, multiplier, shift);
+    acc += dst_offset;
+    acc = MAX(acc, activation_min);
+    acc = MIN(acc, activation_max);
+    return (q7_t)acc;
+}
+
+q7_t *arm_nn_mat_mult_packed_s16(const q15_t *lhs,
+                                 const int32_t lhs_rows,
+                                 const q15_t *packed_rhs,
+                                 const int32_t rhs_rows,
+                                 const int32_t rhs_cols,
+                                 const int32_t *bias,
+                                 const int32_t *dst_multipliers,
+                                 const int32_t *dst_shifts,
+                                 const int32_t per_channel,
+                                 const int32_t dst_offset,
+                                 const int32_t activation_min,
+                                 const int32_t activation_max,
+                                 q7_t *dst)
+{
+    const q15_t *rhs = packed_rhs;
+    int32_t i_row;
+
+    for (i_row = 0; i_row + 1 < rhs_rows; i_row += 2)
+    {
+        const q15_t *lhs_0 = lhs;
+        const q15_t *lhs_1 = lhs + rhs_cols;
+        const int32_t q_0 = per_channel ? i_row : 0;
+        const int32_t q_1 = per_channel ? i_row + 1 : 0;
+        int32_t sum_00 = bias ? bias[i_row] : 0;
+        int32_t sum_01 = bias ? bias[i_row + 1] : 0;
+        int32_t sum_10 = sum_00;
+        int32_t sum_11 = sum_01;
+        int32_t col_count = rhs_cols >> 1;
+
+        if (lhs_rows == 2)
+        {
+            while (col_count)
+            {
+#if defined(ARM_MATH_DSP)
+                const q31_t rhs_0 = arm_nn_read_q15x2_ia(&rhs);
+                const q31_t rhs_1 = arm_nn_read_q15x2_ia(&rhs);
+                const q31_t in_0 = arm_nn_read_q15x2_ia(&lhs_0);
+                const q31_t in_1 = arm_nn_read_q15x2_ia(&lhs_1);
+                sum_00 = __SMLAD(in_0, rhs_0, sum_00);
+                sum_01 = __SMLAD(in_0, rhs_1, sum_01);
+                sum_10 = __SMLAD(in_1, rhs_0, sum_10);
+                sum_11 = __SMLAD(in_1, rhs_1, sum_11);
+#else
+                sum_00 += lhs_0[0] * rhs[0] + lhs_0[1] * rhs[1];
+                sum_01 += lhs_0[0] * rhs[2] + lhs_0[1] * rhs[3];
+                sum_10 += lhs_1[0] * rhs[0] + lhs_1[1] * rhs[1];
+                sum_11 += lhs_1[0] * rhs[2] + lhs_1[1] * rhs[3];
+                rhs += 4;
+                lhs_0 += 2;
+                lhs_1 += 2;
+#endif
+                col_count--;
+            }
+            if (rhs_cols & 0x1)
+            {
+                sum_00 += lhs_0[0] * rhs[0];
+                sum_01 += lhs_0[0] * rhs[1];
+                sum_10 += lhs_1[0] * rhs[0];
+                sum_11 += lhs_1[0] * rhs[1];
+                rhs += 2;
+            }
+            dst[rhs_rows + i_row] = arm_nn_packed_requantize(
+                sum_10, dst_multipliers[q_0], dst_shifts[q_0], dst_offset, activation_min, activation_max);
+            dst[rhs_rows + i_row + 1] = arm_nn_packed_requantize(
+                sum_11, dst_multipliers[q_1], dst_shifts[q_1], dst_offset, activation_min, activation_max);
+        }
+        else
+        {
+            while (col_count)
+            {
+#if defined(ARM_MATH_DSP)
+                const q31_t rhs_0 = arm_nn_read_q15x2_ia(&rhs);
+                const q31_t rhs_1 = arm_nn_read_q15x2_ia(&rhs);
+                const q31_t in_0 = arm_nn_read_q15x2_ia(&lhs_0);
+                sum_00 = __SMLAD(in_0, rhs_0, sum_00);
+                sum_01 = __SMLAD(in_0, rhs_1, sum_01);
+#else
+                sum_00 += lhs_0[0] * rhs[0] + lhs_0[1] * rhs[1];
+                sum_01 += lhs_0[0] * rhs[2] + lhs_0[1] * rhs[3];
+                rhs += 4;
+                lhs_0 += 2;
+#endif
+                col_count--;
+            }
+            if (rhs_cols & 0x1)
+            {
+                sum_00 += lhs_0[0] * rhs[0];
+                sum_01 += lhs_0[0] * rhs[1];
+                rhs += 2;
+            }
+        }
+        dst[i_row] = arm_nn_packed_requantize(
+            sum_00, dst_multipliers[q_0], dst_shifts[q_0], dst_offset, activation_min, activation_max);
+        dst[i_row + 1] = arm_nn_packed_requantize(
+            sum_01, dst_multipliers[q_1], dst_shifts[q_1], dst_offset, activation_min, activation_max);
+    }
+
+    if (rhs_rows & 0x1)
+    {
+        const int32_t q_0 = per_channel ? i_row : 0;
+        int32_t i_lhs;
+
+        for (i_lhs = 0; i_lhs < lhs_rows; i_lhs++)
+        {
+            const q15_t *lhs_0 = lhs + i_lhs * rhs_cols;
+            const q15_t *rhs_0 = rhs;
+            int32_t sum = bias ? bias[i_row] : 0;
+            int32_t col_count = rhs_cols;
+#if defined(ARM_MATH_DSP)
+            col_count = rhs_cols >> 1;
+            while (col_count)
+            {
+                sum = __SMLAD(arm_nn_read_q15x2_ia(&lhs_0), arm_nn_read_q15x2_ia(&rhs_0), sum);
+                col_count--;
+            }
+            col_count = rhs_cols & 0x1;
+#endif
+            while (col_count)
+            {
+                sum += (*lhs_0++) * (*rhs_0++);
+                col_count--;
+            }
+            dst[i_lhs * rhs_rows + i_row] = arm_nn_packed_requantize(
+                sum, dst_multipliers[q_0], dst_shifts[q_0], dst_offset, activation_min, activation_max);
+        }
+    }
+
+    return dst + lhs_rows * rhs_rows;
+}
+
+/**
+ * @} end of NNBasicMath group
+ */
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2010-2021 Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library
+ * Title:        arm_nn_vec_mat_mult_t_folded_s8.c
+ * Description:  s8 vector by matrix (transposed) multiplication with the
+ *               lhs offset folded into the bias
+ *
+ * $Date:        19. October 2026
+ * $Revision:    V.1.0.0
+ *
+ * Target Processor:  Cortex-M cores
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnsupportfunctions.h"
+
+/**
+ * @ingroup groupSupport
+ */
+
+/**
+ * @addtogroup NNBasicMath
+ * @{
+ */
+
+/*
+ * sum((lhs[c] + lhs_offset) * rhs[r][c]) = sum(lhs[c] * rhs[r][c]) + lhs_offset * sum(rhs[r][c]),
+ * the second term only depends on the weights and is added once to the bias.
+ *
+ * Refer header file for details.
+ *
+ */
+void arm_nn_fold_lhs_offset_s8(const q7_t *rhs,
+                               const q31_t *bias,
+                               const int32_t rhs_rows,
+                               const int32_t rhs_cols,
+                               const int32_t lhs_offset,
+                               q31_t *folded_bias)
+{
+    for (int32_t i_row = 0; i_row < rhs_rows; i_row++)
+    {
+        q31_t sum = 0;
+        for (int32_t i_col = 0; i_col < rhs_cols; i_col++)
+        {
+            sum += *rhs++;
+        }
+        folded_bias[i_row] = lhs_offset * sum + (bias ? bias[i_row] : 0);
+    }
+}
+
+arm_status arm_nn_vec_mat_mult_t_folded_s8(const q7_t *lhs,
+                                           const q7_t *rhs,
+                                           const q31_t *folded_bias,
+                                           q7_t *dst,
+                                           const int32_t dst_offset,
+                                           const int32_t dst_multiplier,
+                                           const int32_t dst_shift,
+                                           const int32_t rhs_cols,
+                                           const int32_t rhs_rows,
+                                           const int32_t activation_min,
+                                           const int32_t activation_max)
+{
+#if defined(ARM_MATH_MVEI)
+    // Unlike arm_nn_vec_mat_mult_t_s8, no sums of the rows and of the vector are needed
+    const int32_t col_loop_cnt = (rhs_cols + 15) / 16;
+    int32_t i_row = 0;
+
+    for (; i_row <= (rhs_rows - 4); i_row += 4)
+    {
+        int32_t acc_0 = 0;
+        int32_t acc_1 = 0;
+        int32_t acc_2 = 0;
+        int32_t acc_3 = 0;
+
+        const int8_t *lhs_vec = lhs;
+        const int8_t *rhs_0 = rhs;
+        const int8_t *rhs_1 = rhs + rhs_cols;
+        const int8_t *rhs_2 = rhs + 2 * rhs_cols;
+        const int8_t *rhs_3 = rhs + 3 * rhs_cols;
+        uint32_t col_cnt = (uint32_t)rhs_cols;
+
+        for (int i = 0; i < col_loop_cnt; i++)
+        {
+            mve_pred16_t p = vctp8q(col_cnt);
+            col_cnt -= 16;
+
+            const int8x16_t input = vldrbq_z_s8(lhs_vec, p);
+            acc_0 = vmladavaq_p_s8(acc_0, vldrbq_z_s8(rhs_0, p), input, p);
+            acc_1 = vmladavaq_p_s8(acc_1, vldrbq_z_s8(rhs_1, p), input, p);
+            acc_2 = vmladavaq_p_s8(acc_2, vldrbq_z_s8(rhs_2, p), input, p);
+            acc_3 = vmladavaq_p_s8(acc_3, vldrbq_z_s8(rhs_3, p), input, p);
+
+            lhs_vec += 16;
+            rhs_0 += 16;
+            rhs_1 += 16;
+            rhs_2 += 16;
+            rhs_3 += 16;
+        }
+        rhs += 4 * rhs_cols;
+
+        int32x4_t acc = {acc_0, acc_1, acc_2, acc_3};
+        acc = vaddq_s32(acc, vldrwq_s32(folded_bias));
+        folded_bias += 4;
+
+        acc = arm_requantize_mve(acc, dst_multiplier, dst_shift);
+        acc = vaddq_s32(acc, vdupq_n_s32(dst_offset));
+        acc = vmaxq_s32(acc, vdupq_n_s32(activation_min));
+        acc = vminq_s32(acc, vdupq_n_s32(activation_max));
+        vstrbq_s32(dst, acc);
+        dst += 4;
+    }
+
+    for (; i_row < rhs_rows; i_row++)
+    {
+        int32_t acc_0 = 0;
+        const int8_t *lhs_vec = lhs;
+        const int8_t *rhs_0 = rhs;
+        uint32_t col_cnt = (uint32_t)rhs_cols;
+
+        for (int i = 0; i < col_loop_cnt; i++)
+        {
+            mve_pred16_t p = vctp8q(col_cnt);
+            col_cnt -= 16;
+
+            acc_0 = vmladavaq_p_s8(acc_0, vldrbq_z_s8(rhs_0, p), vldrbq_z_s8(lhs_vec, p), p);
+
+            lhs_vec += 16;
+            rhs_0 += 16;
+        }
+        rhs += rhs_cols;
+
+        acc_0 += *folded_bias++;
+        acc_0 = arm_nn_requantize(acc_0, dst_multiplier, dst_shift);
+        acc_0 += dst_offset;
+
+        // Clamp the result
+        acc_0 = MAX(acc_0, activation_min);
+        *dst++ = MIN(acc_0, activation_max);
+    }
+#else
+    for (int32_t i_row = 0; i_row <= (rhs_rows - 2); i_row += 2)
+    {
+        const q7_t *lhs_ptr = &lhs[0];
+        const q7_t *rhs_ptr = &rhs[0];
+
+        q31_t res00 = *folded_bias++;
+        q31_t res01 = *folded_bias++;
+
+        int32_t i_col = 0;
+#if defined(ARM_MATH_DSP)
+        for (; i_col <= (rhs_cols - 8); i_col += 8)
+        {
+            q31_t lhs_val, lhs_a, lhs_b, rhs_val;
+
+            // Read 4 x int8 values from the LHS vector and from both RHS rows
+            lhs_val = arm_nn_read_q7x4_ia(&lhs_ptr);
+            lhs_a = __SXTB16(lhs_val);
+            lhs_b = __SXTB16(__ROR(lhs_val, 8));
+            rhs_val = arm_nn_read_q7x4((const q7_t *)rhs_ptr + rhs_cols);
+            res01 = __SMLAD(lhs_a, __SXTB16(rhs_val), res01);
+            res01 = __SMLAD(lhs_b, __SXTB16(__ROR(rhs_val, 8)), res01);
+            rhs_val = arm_nn_read_q7x4_ia(&rhs_ptr);
+            res00 = __SMLAD(lhs_a, __SXTB16(rhs_val), res00);
+            res00 = __SMLAD(lhs_b, __SXTB16(__ROR(rhs_val, 8)), res00);
+
+            lhs_val = arm_nn_read_q7x4_ia(&lhs_ptr);
+            lhs_a = __SXTB16(lhs_val);
+            lhs_b = __SXTB16(__ROR(lhs_val, 8));
+            rhs_val = arm_nn_read_q7x4((const q7_t *)rhs_ptr + rhs_cols);
+            res01 = __SMLAD(lhs_a, __SXTB16(rhs_val), res01);
+            res01 = __SMLAD(lhs_b, __SXTB16(__ROR(rhs_val, 8)), res01);
+            rhs_val = arm_nn_read_q7x4_ia(&rhs_ptr);
+            res00 = __SMLAD(lhs_a, __SXTB16(rhs_val), res00);
+            res00 = __SMLAD(lhs_b, __SXTB16(__ROR(rhs_val, 8)), res00);
+        }
+#endif
+        for (; i_col < rhs_cols; ++i_col)
+        {
+            const q31_t lhs_value = lhs_ptr[0];
+
+            res00 += lhs_value * rhs_ptr[0];
+            res01 += lhs_value * rhs_ptr[rhs_cols];
+
+            ++rhs_ptr;
+            ++lhs_ptr;
+        }
+
+        // Quantize down
+        res00 = arm_nn_requantize(res00, dst_multiplier, dst_shift);
+        res01 = arm_nn_requantize(res01, dst_multiplier, dst_shift);
+
+        // Add offset
+        res00 += dst_offset;
+        res01 += dst_offset;
+
+        // Clamp the result
+        res00 = MAX(res00, activation_min);
+        res00 = MIN(res00, activation_max);
+        res01 = MAX(res01, activation_min);
+        res01 = MIN(res01, activation_max);
+
+        *dst++ = (q7_t)res00;
+        *dst++ = (q7_t)res01;
+
+        rhs += 2 * rhs_cols;
+    }
+
+    if (rhs_rows % 2)
+    {
+        const q7_t *lhs_ptr = &lhs[0];
+        const q7_t *rhs_ptr = &rhs[0];
+
+        q31_t res00 = *folded_bias;
+
+        int32_t i_col = 0;
+#if defined(ARM_MATH_DSP)
+        for (; i_col <= (rhs_cols - 4); i_col += 4)
+        {
+            const q31_t lhs_val = arm_nn_read_q7x4_ia(&lhs_ptr);
+            const q31_t rhs_val = arm_nn_read_q7x4_ia(&rhs_ptr);
+
+            res00 = __SMLAD(__SXTB16(lhs_val), __SXTB16(rhs_val), res00);
+            res00 = __SMLAD(__SXTB16(__ROR(lhs_val, 8)), __SXTB16(__ROR(rhs_val, 8)), res00);
+        }
+#endif
+        for (; i_col < rhs_cols; ++i_col)
+        {
+            res00 += (q31_t)*lhs_ptr++ * *rhs_ptr++;
+        }
+
+        // Quantize down
+        res00 = arm_nn_requantize(res00, dst_multiplier, dst_shift);
+
+        // Add offset
+        res00 += dst_offset;
+
+        // Clamp the result
+        res00 = MAX(res00, activation_min);
+        res00 = MIN(res00, activation_max);
+
+        *dst = (q7_t)res00;
+    }
+#endif
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @} end of NNBasicMath group
+ */
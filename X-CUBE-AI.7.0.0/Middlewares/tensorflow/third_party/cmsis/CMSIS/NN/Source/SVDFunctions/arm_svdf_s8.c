@@ -21,8 +21,8 @@
  * Title:        arm_svdf_s8.c
  * Description:  S8 basic SVDF layer function
  *
- * $Date:        09. October 2020
- * $Revision:    V.1.0.1
+ * $Date:        18. October 2026
+ * $Revision:    V.1.1.0
  *
  * Target Processor:  Cortex-M processors
  *
@@ -40,6 +40,41 @@
  * @{
  */
 
+static int32_t arm_svdf_time_dot_s16(const q15_t **weights, const q15_t *state, const int32_t length, int32_t sum)
+{
+    const q15_t *v1 = *weights;
+    const q15_t *v2 = state;
+#if defined(ARM_MATH_DSP)
+    int j = 0;
+    int32_t block_count = length >> 1;
+    for (int i = 0; i < block_count; i++)
+    {
+        j += 2;
+        q31_t r1 = arm_nn_read_q15x2_ia(&v1);
+        q31_t r2 = arm_nn_read_q15x2_ia(&v2);
+
+        sum = __SMLAD(r1, r2, sum);
+    }
+
+    // Process the remaining data
+    for (; j < length; j++)
+    {
+        sum += *v1 * *v2;
+        v1++;
+        v2++;
+    }
+#else
+    for (int j = 0; j < length; j++)
+    {
+        sum += *v1 * *v2;
+        v1++;
+        v2++;
+    }
+#endif
+    *weights = v1;
+    return sum;
+}
+
 /*
  * S8 SVDF layer function for TensorFlow Lite
  *
@@ -64,6 +99,58 @@ arm_status arm_svdf_s8(const cmsis_nn_context *input_ctx,
                        const q31_t *bias_data,
                        const cmsis_nn_dims *output_dims,
                        q7_t *output_data)
+{
+    const int32_t time_batches = weights_time_dims->h;
+
+    memmove((q15_t *)state_data,
+            (q15_t *)state_data + 1,
+            (size_t)(input_dims->n * weights_feature_dims->n * time_batches * (int32_t)sizeof(int16_t)));
+
+    return arm_svdf_ring_s8(input_ctx,
+                            output_ctx,
+                            svdf_params,
+                            input_quant_params,
+                            output_quant_params,
+                            input_dims,
+                            input_data,
+                            state_dims,
+                            state_data,
+                            time_batches - 1,
+                            weights_feature_dims,
+                            weights_feature_data,
+                            weights_time_dims,
+                            weights_time_data,
+                            bias_dims,
+                            bias_data,
+                            output_dims,
+                            output_data);
+}
+
+/*
+ * S8 SVDF layer function for TensorFlow Lite with a ring-buffered state
+ *
+ * Refer to header file for details.
+ *
+ */
+
+arm_status arm_svdf_ring_s8(const cmsis_nn_context *input_ctx,
+                            const cmsis_nn_context *output_ctx,
+                            const cmsis_nn_svdf_params *svdf_params,
+                            const cmsis_nn_per_tensor_quant_params *input_quant_params,
+                            const cmsis_nn_per_tensor_quant_params *output_quant_params,
+                            const cmsis_nn_dims *input_dims,
+                            const q7_t *input_data,
+                            const cmsis_nn_dims *state_dims,
+                            q15_t *state_data,
+                            const int32_t state_head,
+                            const cmsis_nn_dims *weights_feature_dims,
+                            const q7_t *weights_feature_data,
+                            const cmsis_nn_dims *weights_time_dims,
+                            const q15_t *weights_time_data,
+                            const cmsis_nn_dims *bias_dims,
+                            const q31_t *bias_data,
+                            const cmsis_nn_dims *output_dims,
+                            q7_t *output_data)
 {
     (void)bias_dims;
     (void)state_dims;
@@ -92,11 +179,10 @@ arm_status arm_svdf_s8(const cmsis_nn_context *input_ctx,
     q31_t *buffer_a = (q31_t *)input_ctx->buf;
     q31_t *buffer_b = (q31_t *)output_ctx->buf;
 
-    memmove((q15_t *)state_data,
-            (q15_t *)state_data + 1,
-            (size_t)(input_batches * feature_batches * time_batches * (int32_t)sizeof(int16_t)));
+    /* Oldest entry of each state row, read first by the time dot product */
+    const int32_t state_tail = (state_head + 1 == time_batches) ? 0 : state_head + 1;
 
-    q15_t *res_ptr = state_data + (time_batches - 1);
+    q15_t *res_ptr = state_data + state_head;
     for (int i_batch = 0; i_batch < input_batches; i_batch++)
     {
         const q7_t *buffer_1 = weights_feature_data;
@@ -158,33 +244,9 @@ arm_status arm_svdf_s8(const cmsis_nn_context *input_ctx,
             *ptr_a = 0;
 
             int32_t sum = 0;
-#if defined(ARM_MATH_DSP)
-            int j = 0;
-            int32_t block_count = time_batches >> 1;
-            for (int i = 0; i < block_count; i++)
-            {
-                j += 2;
-                q31_t r1 = arm_nn_read_q15x2_ia(&v1);
-                q31_t r2 = arm_nn_read_q15x2_ia(&v2);
-
-                sum = __SMLAD(r1, r2, sum);
-            }
-
-            // Process the remaining data
-            for (; j < time_batches; j++)
-            {
-                sum += *v1 * *v2;
-                v1++;
-                v2++;
-            }
-#else
-            for (int j = 0; j < time_batches; j++)
-            {
-                sum += *v1 * *v2;
-                v1++;
-                v2++;
-            }
-#endif
+            sum = arm_svdf_time_dot_s16(&v1, v2 + state_tail, time_batches - state_tail, sum);
+            sum = arm_svdf_time_dot_s16(&v1, v2, state_tail, sum);
+            v2 += time_batches;
 
             *ptr_a = sum;
             ptr_a++;
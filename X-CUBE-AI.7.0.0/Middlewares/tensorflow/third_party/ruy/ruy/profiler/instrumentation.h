@@ -20,6 +20,12 @@ limitations under the License.
 #include <cstdio>
 #include <mutex>
 #include <vector>
+#elif defined(RUY_PROFILER_LITE)
+// Hooks of the lightweight profiler, provided by the application.
+extern "C" {
+void ruy_profiler_lite_push(const char* label);
+void ruy_profiler_lite_pop(void);
+}
 #endif
 
 namespace ruy {
@@ -183,6 +189,26 @@ class ScopeLabel {
   detail::ThreadStack* thread_stack_;
 };
 
+#elif defined(RUY_PROFILER_LITE)
+
+// Lightweight variant for the bare-metal targets (no thread, no mutex, no
+// allocation): the label is forwarded to the hooks which accumulate the
+// cycles by label. The integer arguments are ignored, the format string is
+// expected to be a literal string.
+class ScopeLabel {
+ public:
+  template <typename... Args>
+  explicit ScopeLabel(const char* format, Args...) {
+    ruy_profiler_lite_push(format);
+  }
+
+  ~ScopeLabel() { ruy_profiler_lite_pop(); }
+
+ private:
+  ScopeLabel(const ScopeLabel&) = delete;
+  ScopeLabel& operator=(const ScopeLabel&) = delete;
+};
+
 #else  // no RUY_PROFILER
 
 class ScopeLabel {
@@ -0,0 +1,172 @@
+# coding=utf-8
+'''
+@ Summary: convert the trace of the system performance application to the
+            Chrome trace-event JSON format (chrome://tracing, Perfetto UI)
+            1. read the binary trace (host application: -t <file>) or the
+               "#trace" lines of a target log (AI_TEST_TRACE=1)
+            2. write the JSON file, one row by network (inferences and
+               nodes) and by application track
+@ Update:
+
+@ file:    gen_chrome_trace.py
+@ version: 1.0.0
+
+@ Date:    2026/10/18
+'''
+import sys
+import json
+import struct
+import logging
+import argparse
+from pathlib import Path
+
+
+TRACE_MAGIC = 0x52544941  # "AITR"
+TRACE_VERSION = 1
+
+# record types, see aiTestTrace.h
+REC_NAME = 1
+REC_INFERENCE = 2
+REC_NODE = 3
+REC_BEGIN = 4
+REC_END = 5
+REC_INSTANT = 6
+
+APP_TRACK = 128
+TRACK_ID = 0xFFFF
+
+HEADER = struct.Struct("<IHHII")
+RECORD = struct.Struct("<BBHIQII")
+
+
+def read_trace(trace):
+    """ Read the binary trace
+
+    Args:
+        trace: binary file or log file with "#trace" lines, str
+
+    Returns:
+        the content of the trace buffer, bytes
+    """
+    buf = Path(trace).read_bytes()
+    if buf[:4] == struct.pack("<I", TRACE_MAGIC):
+        return buf
+
+    # target log, the last trace is used
+    lines = list()
+    for line in buf.decode("latin1").splitlines():
+        line = line.strip()
+        if not line.startswith("#trace "):
+            continue
+        data = line[len("#trace "):]
+        if data == "end":
+            continue
+        if data.startswith("52544941"):
+            lines = list()
+        lines.append(data)
+    if not lines:
+        raise IOError("No trace in '{}'...".format(trace))
+    return bytes.fromhex("".join(lines))
+
+
+def parse_trace(buf):
+    """ Decode the records
+
+    Returns:
+        clock: core clock (Hz), int
+        dropped: number of dropped records, int
+        records: list of (type, track, id, dur, ts, arg0, arg1, name)
+    """
+    magic, version, rec_size, clock, dropped = HEADER.unpack_from(buf, 0)
+    if magic != TRACE_MAGIC or version != TRACE_VERSION or \
+            rec_size != RECORD.size:
+        raise IOError("Invalid trace (magic/version/record size)...")
+
+    records = list()
+    pos = (HEADER.size + 7) & ~7
+    while pos + RECORD.size <= len(buf):
+        rec = RECORD.unpack_from(buf, pos)
+        pos += RECORD.size
+        name = None
+        if rec[0] == REC_NAME:
+            length = rec[3]
+            name = buf[pos:pos + length].split(b"\0")[0].decode("utf-8", "replace")
+            pos += (length + 7) & ~7
+        records.append(rec + (name,))
+    return clock, dropped, records
+
+
+def to_chrome(clock, records):
+    """ Chrome trace events, timestamps in us """
+    def us(cycles):
+        return cycles * 1e6 / clock
+
+    names = dict()
+    for rec in records:
+        if rec[0] == REC_NAME:
+            names[(rec[1], rec[2])] = rec[7]
+
+    events = list()
+    tracks = sorted({rec[1] for rec in records})
+    for track in tracks:
+        app = track >= APP_TRACK
+        default = "app {}".format(track - APP_TRACK) if app else \
+            "network {}".format(track)
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": track,
+                       "args": {"name": names.get((track, TRACK_ID), default)}})
+
+    for type_, track, id_, dur, ts, arg0, arg1, _ in records:
+        event = {"pid": 1, "tid": track, "ts": us(ts)}
+        if type_ == REC_INFERENCE:
+            event.update({"name": "inference #{}".format(id_), "cat": "inference",
+                          "ph": "X", "dur": us(dur)})
+        elif type_ == REC_NODE:
+            event.update({"name": names.get((track, id_), "node {}".format(id_)),
+                          "cat": "node", "ph": "X", "dur": us(dur),
+                          "args": {"idx": id_, "op": arg0, "output bytes": arg1}})
+        elif type_ in (REC_BEGIN, REC_END, REC_INSTANT):
+            event.update({"name": names.get((track, id_), "event {}".format(id_)),
+                          "cat": "app"})
+            event["ph"] = {REC_BEGIN: "B", REC_END: "E", REC_INSTANT: "i"}[type_]
+            if type_ == REC_INSTANT:
+                event["s"] = "t"
+        else:
+            continue
+        events.append(event)
+    return events
+
+
+def gen_chrome_trace(trace, output):
+    """ Write the Chrome trace-event JSON file
+
+    Args:
+        trace: binary trace or target log, str
+        output: JSON file, str
+
+    Returns:
+        the generated file path, Path
+    """
+    clock, dropped, records = parse_trace(read_trace(trace))
+    if dropped:
+        logging.warning("{} records have been dropped (trace buffer full), "
+                        "AI_TEST_TRACE_SIZE should be increased".format(dropped))
+
+    events = to_chrome(clock, records)
+    output = Path(output)
+    output.write_text(json.dumps({"traceEvents": events,
+                                  "displayTimeUnit": "ns"}, indent=1))
+    logging.info("Generate {} with {} events successfully...".format(
+        output, len(events)))
+    return output
+
+
+if __name__ == "__main__":
+    logging.getLogger().setLevel(logging.INFO)
+
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("trace", help="binary trace or target log")
+    parser.add_argument("-o", "--output", default="trace.json",
+                        help="Chrome trace-event JSON file")
+    opt = parser.parse_args()
+    gen_chrome_trace(opt.trace, opt.output)
+    sys.exit(0)
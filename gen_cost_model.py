@@ -0,0 +1,332 @@
+# coding=utf-8
+'''
+@ Summary: static cost model and roofline report by layer of a .tflite model
+            1. walk the operators of the model, compute by node the MACC,
+               the weight bytes, the activation bytes read and written and
+               the arithmetic intensity (MACC/byte)
+            2. optionally, combine them with the measured cycles by node
+               (trace or log of the system performance application) to
+               flag the memory-bound and the compute-bound layers and how
+               far each layer is from its roof
+@ Update:
+
+@ file:    gen_cost_model.py
+@ version: 1.0.0
+
+@ Date:    2026/10/18
+'''
+import re
+import sys
+import struct
+import logging
+import argparse
+from pathlib import Path
+
+try:
+    from platforms.plugin_stm32.gen_tflm_op_resolver import FlatTable, \
+        BUILTIN_OPS, BUILTIN_CUSTOM
+    from platforms.plugin_stm32.gen_chrome_trace import read_trace, \
+        parse_trace, REC_NODE
+except ImportError:
+    from gen_tflm_op_resolver import FlatTable, BUILTIN_OPS, BUILTIN_CUSTOM
+    from gen_chrome_trace import read_trace, parse_trace, REC_NODE
+
+
+# default roof, Cortex-M4/M7 with the DSP extension: 2 16-bit MACs/cycle
+# (SMLAD), one 32-bit word/cycle
+MACC_PER_CYCLE = 2.0
+BYTES_PER_CYCLE = 4.0
+
+# tflite TensorType --> size in bytes
+TYPE_SIZES = {0: 4, 1: 2, 2: 4, 3: 1, 4: 8, 6: 1, 7: 2, 8: 8, 9: 1, 10: 8}
+
+# BuiltinOperator codes with a specific cost
+CONV_2D = 3
+DEPTHWISE_CONV_2D = 4
+FULLY_CONNECTED = 9
+SVDF = 27
+TRANSPOSE_CONV = 67
+POOLS = (1, 12, 17)             # AVERAGE_POOL_2D, L2_POOL_2D, MAX_POOL_2D
+NO_COMPUTE = (22, 43, 70, 77)   # RESHAPE, SQUEEZE, EXPAND_DIMS, SHAPE
+
+
+class TensorInfo(object):
+    """ Shape, type and size of a tensor, const if it has a buffer """
+    def __init__(self, tensor, buffers):
+        self.shape = tensor.vector(0, "i")
+        self.type = tensor.scalar(1, "b")
+        buffer = tensor.scalar(2, "I")
+        self.const = buffer < len(buffers) and buffers[buffer].vector_len(0) > 0
+        self.elems = 1
+        for dim in self.shape:
+            self.elems *= max(dim, 1)
+        self.bytes = self.elems * TYPE_SIZES.get(self.type, 1)
+
+
+class NodeCost(object):
+    """ Static cost of a node """
+    def __init__(self, idx, name):
+        self.idx = idx
+        self.name = name
+        self.macc = 0
+        self.weights = 0
+        self.act_in = 0
+        self.act_out = 0
+        self.cycles = None
+
+    def bytes(self):
+        return self.weights + self.act_in + self.act_out
+
+    def intensity(self):
+        return self.macc / self.bytes() if self.bytes() else 0.0
+
+
+def op_name(code, custom):
+    """ CamelCase name of the operator (from the op resolver method) """
+    if code == BUILTIN_CUSTOM:
+        return custom or "Custom"
+    return BUILTIN_OPS.get(code, "Op{}".format(code))[len("Add"):]
+
+
+def node_macc(code, inputs, outputs, options):
+    """ MACC of a node, the other operations count for one MACC by output
+    element (pooling: by element of the window) """
+    out = outputs[0].elems if outputs else 0
+    if code == CONV_2D:
+        # filter: [out_ch, kh, kw, in_ch]
+        _, kh, kw, in_ch = inputs[1].shape
+        return out * kh * kw * in_ch
+    if code == DEPTHWISE_CONV_2D:
+        # filter: [1, kh, kw, out_ch]
+        return out * inputs[1].shape[1] * inputs[1].shape[2]
+    if code == FULLY_CONNECTED:
+        # weights: [units, in]
+        return out * inputs[1].shape[-1]
+    if code == TRANSPOSE_CONV:
+        # inputs: output shape, filter [out_ch, kh, kw, in_ch], input
+        out_ch, kh, kw, _ = inputs[1].shape
+        return inputs[2].elems * kh * kw * out_ch
+    if code == SVDF:
+        # input [batch, in], weights_feature [filters, in], weights_time
+        # [filters, memory]
+        batch = inputs[0].shape[0]
+        filters, memory = inputs[2].shape
+        return batch * filters * (inputs[1].shape[1] + memory)
+    if code in POOLS:
+        # Pool2DOptions: filter_width, filter_height
+        fw, fh = (options.scalar(3, "i"), options.scalar(4, "i")) \
+            if options else (1, 1)
+        return out * fw * fh
+    if code in NO_COMPUTE:
+        return 0
+    return out
+
+
+def read_cost_model(model):
+    """ Static cost of the nodes of the first subgraph
+
+    Args:
+        model: .tflite model path, str
+
+    Returns:
+        list of NodeCost, indexed as the c-nodes of the TFLM runtime
+
+    Raise:
+        the file is not a tflite flatbuffer
+    """
+    buf = Path(model).read_bytes()
+    if len(buf) < 8 or buf[4:8] != b"TFL3":
+        raise IOError("'{}' is not a tflite model...".format(model))
+
+    root = FlatTable(buf, struct.unpack_from("<I", buf, 0)[0])
+    # Model: operator_codes, subgraphs, buffers
+    codes = [(max(c.scalar(0, "b"), c.scalar(3, "i")), c.string(1))
+             for c in root.tables(1)]
+    buffers = root.tables(4)
+    subgraph = root.tables(2)[0]
+    tensors = [TensorInfo(t, buffers) for t in subgraph.tables(0)]
+
+    nodes = list()
+    for idx, op in enumerate(subgraph.tables(3)):
+        # Operator: opcode_index, inputs, outputs, builtin_options_type,
+        # builtin_options
+        code, custom = codes[op.scalar(0, "I")]
+        inputs = [tensors[i] if i >= 0 else None for i in op.vector(1, "i")]
+        outputs = [tensors[i] for i in op.vector(2, "i") if i >= 0]
+
+        node = NodeCost(idx, op_name(code, custom))
+        node.macc = node_macc(code, inputs, outputs, op.table(4))
+        for tensor in inputs:
+            if tensor is None:
+                continue
+            if tensor.const:
+                node.weights += tensor.bytes
+            else:
+                node.act_in += tensor.bytes
+        node.act_out = sum(tensor.bytes for tensor in outputs)
+        nodes.append(node)
+    return nodes
+
+
+def read_log_cycles(log):
+    """ Cycles by node from the "Inference time by c-node" table of the
+    log of the TFLM system performance application
+
+    Returns:
+        clock: core clock (Hz), int
+        cycles: average cycles by node index, dict
+    """
+    clock, cycles, section = 0, dict(), False
+    row = re.compile(r"^\s*(\d+)\s+\S+\s+(\d+)\.(\d{3})\s+[\d.]+\s*%")
+    for line in Path(log).read_text(errors="replace").splitlines():
+        match = re.search(r"inferences @(\d+)MHz", line)
+        if match:
+            clock = int(match.group(1)) * 1000000
+        if "Inference time by c-node" in line:
+            section, cycles = True, dict()
+        elif section and "Stack and heap" in line:
+            section = False
+        elif section:
+            match = row.match(line)
+            if match:
+                us = int(match.group(2)) * 1000 + int(match.group(3))
+                cycles[int(match.group(1))] = us
+    if not clock or not cycles:
+        raise IOError("No cycles by c-node in '{}'...".format(log))
+    return clock, {idx: us * clock / 1e6 for idx, us in cycles.items()}
+
+
+def read_cycles(measure):
+    """ Average cycles by node of the first network
+
+    Args:
+        measure: binary trace, or log of the application with a trace
+                 ("#trace" lines) or with the cycles by c-node, str
+
+    Returns:
+        clock: core clock (Hz), int
+        cycles: average cycles by node index, dict
+    """
+    try:
+        clock, _, records = parse_trace(read_trace(measure))
+    except IOError:
+        return read_log_cycles(measure)
+
+    total, count = dict(), dict()
+    for rec in records:
+        if rec[0] == REC_NODE and rec[1] == 0:
+            total[rec[2]] = total.get(rec[2], 0) + rec[3]
+            count[rec[2]] = count.get(rec[2], 0) + 1
+    return clock, {idx: total[idx] / count[idx] for idx in total}
+
+
+def roofline(nodes, macc_per_cycle=MACC_PER_CYCLE,
+             bytes_per_cycle=BYTES_PER_CYCLE):
+    """ Report by node (text)
+
+    The bound is the static one: memory if the arithmetic intensity is not
+    above the ridge point of the roof. The bytes are the compulsory ones
+    (each tensor read/written once), the re-reads of a kernel only lower
+    the measured efficiency (roof %).
+    """
+    ridge = macc_per_cycle / bytes_per_cycle
+    measured = any(node.cycles is not None for node in nodes)
+    total_cycles = sum(node.cycles or 0 for node in nodes)
+
+    lines = list()
+    lines.append("Roofline: {} MACC/cycle, {} bytes/cycle, ridge point "
+                 "{:.2f} MACC/byte".format(macc_per_cycle, bytes_per_cycle, ridge))
+    lines.append("")
+    header = " {:<4} {:<18} {:>10} {:>9} {:>9} {:>9} {:>7} {:<8}".format(
+        "idx", "op", "MACC", "weights", "act.in", "act.out", "MACC/B", "bound")
+    if measured:
+        header += " {:>10} {:>8} {:>6} {:>6}".format(
+            "cycles", "MACC/cyc", "roof", "share")
+    lines.append(header)
+    lines.append(" " + "-" * (len(header) - 1))
+
+    for node in nodes:
+        bound = "-" if not node.macc else \
+            ("memory" if node.intensity() <= ridge else "compute")
+        line = " {:<4} {:<18} {:>10} {:>9} {:>9} {:>9} {:>7.2f} {:<8}".format(
+            node.idx, node.name[:18], node.macc, node.weights, node.act_in,
+            node.act_out, node.intensity(), bound)
+        if node.cycles is not None and not node.cycles:
+            # below the resolution of the log
+            line += " {:>10}".format(0)
+        elif node.cycles:
+            achieved = node.macc / node.cycles
+            roof = min(macc_per_cycle, node.intensity() * bytes_per_cycle)
+            line += " {:>10.0f} {:>8.3f} {:>5.1f}% {:>5.1f}%".format(
+                node.cycles, achieved, achieved * 100.0 / roof if roof else 0.0,
+                node.cycles * 100.0 / total_cycles)
+        elif measured:
+            line += " {:>10}".format("n.a.")
+        lines.append(line)
+
+    lines.append(" " + "-" * (len(header) - 1))
+    lines.append(" {:<23} {:>10} {:>9} {:>9} {:>9}".format(
+        "total", sum(n.macc for n in nodes), sum(n.weights for n in nodes),
+        sum(n.act_in for n in nodes), sum(n.act_out for n in nodes)))
+
+    if measured:
+        lines.append("")
+        lines.append(" {:.0f} cycles by inference, {:.3f} MACC/cycle".format(
+            total_cycles, sum(n.macc for n in nodes) / total_cycles))
+        lines.append("")
+        lines.append(" Hot spots (share of the cycles, distance to the roof)")
+        hot = sorted((n for n in nodes if n.cycles), key=lambda n: -n.cycles)
+        for node in hot[:5]:
+            roof = min(macc_per_cycle, node.intensity() * bytes_per_cycle)
+            gain = node.cycles - node.macc / roof if roof else 0.0
+            lines.append("  {:<4} {:<18} {:>5.1f}%  up to {:.0f} cycles to "
+                         "gain".format(node.idx, node.name[:18],
+                                       node.cycles * 100.0 / total_cycles,
+                                       max(gain, 0.0)))
+    return "\n".join(lines)
+
+
+def gen_cost_model(model, measure=None, output=None,
+                   macc_per_cycle=MACC_PER_CYCLE, bytes_per_cycle=BYTES_PER_CYCLE):
+    """ Print (and optionally write) the roofline report of a model
+
+    Args:
+        model: .tflite model path, str
+        measure: trace or log of the system performance application, see
+                 read_cycles(), str
+        output: report file, str
+        macc_per_cycle, bytes_per_cycle: roof of the target, float
+
+    Returns:
+        list of NodeCost
+    """
+    nodes = read_cost_model(model)
+    if measure:
+        _, cycles = read_cycles(measure)
+        for node in nodes:
+            node.cycles = cycles.get(node.idx)
+
+    report = roofline(nodes, macc_per_cycle, bytes_per_cycle)
+    print(report)
+    if output:
+        Path(output).write_text(report + "\n")
+        logging.info("Generate {} successfully...".format(output))
+    return nodes
+
+
+if __name__ == "__main__":
+    logging.getLogger().setLevel(logging.INFO)
+
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("model", help=".tflite model")
+    parser.add_argument("-m", "--measure",
+                        help="trace or log of the system performance application")
+    parser.add_argument("-o", "--output", help="report file")
+    parser.add_argument("--macc_per_cycle", type=float, default=MACC_PER_CYCLE,
+                        help="peak MACC/cycle of the target")
+    parser.add_argument("--bytes_per_cycle", type=float, default=BYTES_PER_CYCLE,
+                        help="memory bandwidth of the target (bytes/cycle)")
+    opt = parser.parse_args()
+    gen_cost_model(opt.model, opt.measure, opt.output,
+                   opt.macc_per_cycle, opt.bytes_per_cycle)
+    sys.exit(0)
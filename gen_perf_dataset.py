@@ -0,0 +1,219 @@
+# coding=utf-8
+'''
+@ Summary: generate the dataset linked with the system performance application
+            1. read the input samples (and the labels) of a .npz/.npy file
+            2. write ai_test_dataset.c to <stm_out>/X-CUBE-AI/App, the
+               samples are used as inputs instead of random values when
+               the application is built with AI_TEST_DATASET=1
+@ Update:
+
+@ file:    gen_perf_dataset.py
+@ version: 1.0.0
+
+@ Date:    2026/10/18
+'''
+import ast
+import struct
+import zipfile
+import logging
+from pathlib import Path
+
+
+# Generated file, defines g_ai_test_dataset (see aiTestDataset.h)
+DATASET_FILE_NAME = "ai_test_dataset.c"
+
+DATASET_MAGIC = 0x53444941  # "AIDS"
+DATASET_VERSION = 1
+
+# the blob is stored in the flash, keep it small by default
+MAX_SAMPLES = 32
+
+# npy dtype --> struct format, used to read the labels
+LABEL_FORMATS = {
+    "i1": "b", "u1": "B", "i2": "h", "u2": "H", "i4": "i", "u4": "I",
+    "i8": "q", "u8": "Q", "f4": "f", "f8": "d", "b1": "?",
+}
+
+
+class NpyArray(object):
+    """ Raw content of a .npy array (C order, little-endian) """
+    def __init__(self, buf, name=""):
+        if buf[:6] != b"\x93NUMPY":
+            raise IOError("'{}' is not a npy array...".format(name))
+        major = buf[6]
+        if major == 1:
+            hlen, start = struct.unpack_from("<H", buf, 8)[0], 10
+        else:
+            hlen, start = struct.unpack_from("<I", buf, 8)[0], 12
+        header = ast.literal_eval(buf[start:start + hlen].decode("latin1"))
+        descr = header["descr"]
+        if not isinstance(descr, str) or descr[0] == ">" or header["fortran_order"]:
+            raise IOError("'{}': only little-endian C-ordered arrays "
+                          "are supported...".format(name))
+        self.dtype = descr[1:]
+        self.itemsize = int(self.dtype[1:])
+        self.shape = tuple(header["shape"])
+        self.data = buf[start + hlen:]
+
+    def __len__(self):
+        return self.shape[0] if self.shape else 1
+
+    def sample_size(self):
+        """ size in bytes of shape[1:] """
+        size = self.itemsize
+        for dim in self.shape[1:]:
+            size *= dim
+        return size
+
+    def sample(self, idx):
+        size = self.sample_size()
+        return self.data[idx * size:(idx + 1) * size]
+
+
+def read_labels(array):
+    """ class index of each sample, argmax if the labels are one-hot encoded """
+    if array.dtype not in LABEL_FORMATS:
+        raise IOError("Unsupported label type: {}".format(array.dtype))
+    fmt = "<{}" + LABEL_FORMATS[array.dtype]
+    labels = list()
+    for idx in range(len(array)):
+        values = struct.unpack(fmt.format(array.sample_size() // array.itemsize),
+                               array.sample(idx))
+        if len(values) > 1:
+            labels.append(max(range(len(values)), key=lambda i: values[i]))
+        else:
+            labels.append(int(values[0]))
+    return labels
+
+
+def read_dataset(data):
+    """ Read the input samples and the labels
+
+    Args:
+        data: .npy (inputs only) or .npz file, str. The .npz file contains
+              the inputs "x" (or "x0", "x1".. with several inputs) and
+              optionally the labels "y" (class index or one-hot encoded)
+
+    Returns:
+        inputs: list of NpyArray
+        labels: class index of each sample, list of int
+
+    Raise:
+        unknown file format, missing inputs or incoherent number of samples
+    """
+    data = Path(data)
+    if data.suffix == ".npy":
+        arrays = {"x": NpyArray(data.read_bytes(), data.name)}
+    elif data.suffix == ".npz":
+        with zipfile.ZipFile(str(data)) as npz:
+            arrays = {Path(name).stem: NpyArray(npz.read(name), name)
+                      for name in npz.namelist() if name.endswith(".npy")}
+    else:
+        raise IOError("'{}' is not a .npy/.npz file...".format(data))
+
+    if "x" in arrays:
+        inputs = [arrays["x"]]
+    else:
+        inputs = list()
+        while "x{}".format(len(inputs)) in arrays:
+            inputs.append(arrays["x{}".format(len(inputs))])
+    if not inputs:
+        raise IOError("No input samples ('x') in '{}'...".format(data))
+
+    n_samples = len(inputs[0])
+    if not n_samples or any(len(array) != n_samples for array in inputs):
+        raise IOError("Incoherent number of samples in '{}'...".format(data))
+
+    labels = read_labels(arrays["y"]) if "y" in arrays else [0] * n_samples
+    if len(labels) != n_samples:
+        raise IOError("Incoherent number of labels in '{}'...".format(data))
+    return inputs, labels
+
+
+def build_blob(data, max_samples=MAX_SAMPLES):
+    """ Build the blob of the samples (format, see aiTestDataset.h)
+
+    The samples are copied as is, their type and shape should be the ones
+    of the model inputs (i.e. int8 values for a quantized model), it is
+    checked by the application (size only).
+
+    Args:
+        data: .npz/.npy file, see read_dataset(), str
+        max_samples: maximum number of samples, the first ones are used, int
+
+    Returns:
+        blob: bytearray
+        desc: "<n> samples, <n> inputs, <n> classes", str
+    """
+    inputs, labels = read_dataset(data)
+    n_samples = min(len(labels), max_samples)
+    n_classes = max(labels[:n_samples]) + 1
+
+    blob = bytearray(struct.pack("<5I", DATASET_MAGIC, DATASET_VERSION,
+                                 n_samples, len(inputs), n_classes))
+    blob += struct.pack("<{}I".format(len(inputs)),
+                        *[array.sample_size() for array in inputs])
+    for idx in range(n_samples):
+        blob += struct.pack("<I", labels[idx])
+        for array in inputs:
+            blob += array.sample(idx)
+
+    return blob, "{} samples, {} inputs, {} classes".format(
+        n_samples, len(inputs), n_classes)
+
+
+def gen_dataset(data, output, max_samples=MAX_SAMPLES):
+    """ Write <output>/ai_test_dataset.c from a .npz/.npy file
+
+    Args:
+        data: .npz/.npy file, see read_dataset(), str
+        output: output directory, usually <stm_out>/X-CUBE-AI/App, str
+        max_samples: maximum number of samples, the first ones are used, int
+
+    Returns:
+        the generated file path, Path
+    """
+    blob, desc = build_blob(data, max_samples)
+
+    lines = list()
+    lines.append("/* Generated by RT-AK from '{}', do not edit. */".format(
+        Path(data).name))
+    lines.append("#include <stdint.h>")
+    lines.append("")
+    lines.append("/* {} */".format(desc))
+    lines.append("static const uint8_t ai_test_dataset_data[{}] = {{".format(
+        len(blob)))
+    for pos in range(0, len(blob), 16):
+        lines.append("  " + ", ".join("0x{:02x}".format(b)
+                                      for b in blob[pos:pos + 16]) + ",")
+    lines.append("};")
+    lines.append("")
+    lines.append("const uint8_t *g_ai_test_dataset = ai_test_dataset_data;")
+    lines.append("uint32_t g_ai_test_dataset_len = sizeof(ai_test_dataset_data);")
+
+    output = Path(output)
+    output.mkdir(parents=True, exist_ok=True)
+    dataset_file = output / DATASET_FILE_NAME
+    dataset_file.write_text("\n".join(lines) + "\n")
+
+    logging.info("Generate {} ({}) successfully...".format(
+        DATASET_FILE_NAME, desc))
+    return dataset_file
+
+
+def write_blob(data, blob_file, max_samples=MAX_SAMPLES):
+    """ Write the raw blob, loaded by the host application
+    (aisystemperf_host -i <blob_file>) """
+    blob, desc = build_blob(data, max_samples)
+    Path(blob_file).write_bytes(bytes(blob))
+    logging.info("Generate {} ({}) successfully...".format(blob_file, desc))
+    return Path(blob_file)
+
+
+if __name__ == "__main__":
+    logging.getLogger().setLevel(logging.INFO)
+
+    data = "../../Model/val_data.npz"
+    output = "tmp_cwd/X-CUBE-AI/App"
+    gen_dataset(data, output)
+    print("u a right...")
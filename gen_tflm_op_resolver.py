@@ -0,0 +1,256 @@
+# coding=utf-8
+'''
+@ Summary: generate a model specific TFLite Micro op resolver
+            1. read the operator codes of the .tflite model
+            2. write tflm_c_model_ops.h to <stm_out>/X-CUBE-AI/App, which
+               registers only these operators when tflm_c.cc is built with
+               TFLM_RUNTIME_USE_MODEL_OPERATORS=1
+@ Update:
+
+@ file:    gen_tflm_op_resolver.py
+@ version: 1.0.0
+
+@ Date:    2026/10/18
+'''
+import struct
+import logging
+from pathlib import Path
+
+
+# Generated header, included by tflm_c.cc
+RESOLVER_FILE_NAME = "tflm_c_model_ops.h"
+
+# tflite schema: BuiltinOperator code --> MicroMutableOpResolver method
+BUILTIN_OPS = {
+    0: "AddAdd",
+    1: "AddAveragePool2D",
+    2: "AddConcatenation",
+    3: "AddConv2D",
+    4: "AddDepthwiseConv2D",
+    6: "AddDequantize",
+    8: "AddFloor",
+    9: "AddFullyConnected",
+    11: "AddL2Normalization",
+    12: "AddL2Pool2D",
+    14: "AddLogistic",
+    17: "AddMaxPool2D",
+    18: "AddMul",
+    19: "AddRelu",
+    21: "AddRelu6",
+    22: "AddReshape",
+    25: "AddSoftmax",
+    27: "AddSvdf",
+    28: "AddTanh",
+    34: "AddPad",
+    37: "AddBatchToSpaceNd",
+    38: "AddSpaceToBatchNd",
+    40: "AddMean",
+    41: "AddSub",
+    42: "AddDiv",
+    43: "AddSqueeze",
+    45: "AddStridedSlice",
+    47: "AddExp",
+    49: "AddSplit",
+    53: "AddCast",
+    54: "AddPrelu",
+    55: "AddMaximum",
+    56: "AddArgMax",
+    57: "AddMinimum",
+    58: "AddLess",
+    59: "AddNeg",
+    60: "AddPadV2",
+    61: "AddGreater",
+    62: "AddGreaterEqual",
+    63: "AddLessEqual",
+    66: "AddSin",
+    67: "AddTransposeConv",
+    70: "AddExpandDims",
+    71: "AddEqual",
+    72: "AddNotEqual",
+    73: "AddLog",
+    75: "AddSqrt",
+    76: "AddRsqrt",
+    77: "AddShape",
+    79: "AddArgMin",
+    82: "AddReduceMax",
+    83: "AddPack",
+    84: "AddLogicalOr",
+    86: "AddLogicalAnd",
+    87: "AddLogicalNot",
+    88: "AddUnpack",
+    92: "AddSquare",
+    93: "AddZerosLike",
+    97: "AddResizeNearestNeighbor",
+    98: "AddLeakyRelu",
+    101: "AddAbs",
+    102: "AddSplitV",
+    104: "AddCeil",
+    106: "AddAddN",
+    108: "AddCos",
+    111: "AddElu",
+    114: "AddQuantize",
+    116: "AddRound",
+    117: "AddHardSwish",
+}
+
+# custom operator name --> MicroMutableOpResolver method
+CUSTOM_OPS = {
+    "CIRCULAR_BUFFER": "AddCircularBuffer",
+    "TFLite_Detection_PostProcess": "AddDetectionPostprocess",
+    "ethos-u": "AddEthosU",
+}
+
+BUILTIN_CUSTOM = 32  # BuiltinOperator_CUSTOM
+
+
+class FlatTable(object):
+    """ Minimal read-only accessor of a flatbuffers table """
+    def __init__(self, buf, pos):
+        self.buf = buf
+        self.pos = pos
+        vtable = pos - struct.unpack_from("<i", buf, pos)[0]
+        self.vtable = vtable
+        self.vtable_size = struct.unpack_from("<H", buf, vtable)[0]
+
+    def _field(self, index):
+        """ absolute position of field <index>, 0 if absent """
+        entry = 4 + 2 * index
+        if entry >= self.vtable_size:
+            return 0
+        offset = struct.unpack_from("<H", self.buf, self.vtable + entry)[0]
+        return self.pos + offset if offset else 0
+
+    def scalar(self, index, fmt, default=0):
+        pos = self._field(index)
+        return struct.unpack_from("<" + fmt, self.buf, pos)[0] if pos else default
+
+    def _indirect(self, pos):
+        return pos + struct.unpack_from("<I", self.buf, pos)[0]
+
+    def string(self, index):
+        pos = self._field(index)
+        if not pos:
+            return None
+        pos = self._indirect(pos)
+        length = struct.unpack_from("<I", self.buf, pos)[0]
+        return self.buf[pos + 4:pos + 4 + length].decode("utf-8")
+
+    def table(self, index):
+        """ sub-table (or union value), None if absent """
+        pos = self._field(index)
+        return FlatTable(self.buf, self._indirect(pos)) if pos else None
+
+    def tables(self, index):
+        """ vector of tables """
+        pos = self._field(index)
+        if not pos:
+            return list()
+        pos = self._indirect(pos)
+        length = struct.unpack_from("<I", self.buf, pos)[0]
+        return [FlatTable(self.buf, self._indirect(pos + 4 + 4 * i))
+                for i in range(length)]
+
+    def vector_len(self, index):
+        """ number of elements of a vector, 0 if absent """
+        pos = self._field(index)
+        return struct.unpack_from("<I", self.buf, self._indirect(pos))[0] if pos else 0
+
+    def vector(self, index, fmt):
+        """ vector of scalars """
+        pos = self._field(index)
+        if not pos:
+            return list()
+        pos = self._indirect(pos)
+        length = struct.unpack_from("<I", self.buf, pos)[0]
+        return list(struct.unpack_from("<{}{}".format(length, fmt), self.buf, pos + 4))
+
+
+def read_operator_codes(model):
+    """ Read the operator codes of a .tflite model
+
+    Args:
+        model: .tflite model path, str
+
+    Returns:
+        builtins: builtin operator codes, sorted list of int
+        customs: custom operator names, sorted list of str
+
+    Raise:
+        the file is not a tflite flatbuffer
+    """
+    buf = Path(model).read_bytes()
+    if len(buf) < 8 or buf[4:8] != b"TFL3":
+        raise IOError("'{}' is not a tflite model...".format(model))
+
+    root = FlatTable(buf, struct.unpack_from("<I", buf, 0)[0])
+    builtins, customs = set(), set()
+    # Model.operator_codes
+    for code in root.tables(1):
+        # OperatorCode: deprecated_builtin_code(int8), custom_code, version,
+        # builtin_code(int32). The real code is the largest of both fields.
+        op = max(code.scalar(0, "b"), code.scalar(3, "i"))
+        if op == BUILTIN_CUSTOM:
+            customs.add(code.string(1))
+        else:
+            builtins.add(op)
+    return sorted(builtins), sorted(customs)
+
+
+def gen_op_resolver(model, output, model_name="network"):
+    """ Write <output>/tflm_c_model_ops.h for a .tflite model
+
+    Args:
+        model: .tflite model path, str
+        output: output directory, usually <stm_out>/X-CUBE-AI/App, str
+        model_name: c model name, only used in the generated comment, str
+
+    Returns:
+        the generated file path, Path
+
+    Raise:
+        the model uses operators unknown to TFLite Micro
+    """
+    builtins, customs = read_operator_codes(model)
+
+    unknown = [str(op) for op in builtins if op not in BUILTIN_OPS]
+    unknown += [op for op in customs if op not in CUSTOM_OPS]
+    if unknown:
+        raise Exception("Operators not supported by TFLite Micro: {}".format(
+            ", ".join(unknown)))
+
+    methods = [BUILTIN_OPS[op] for op in builtins]
+    methods += [CUSTOM_OPS[op] for op in customs]
+
+    lines = list()
+    lines.append("/* Generated by RT-AK from '{}' ({}), do not edit. */".format(
+        Path(model).name, model_name))
+    lines.append("#ifndef TFLM_C_MODEL_OPS_H")
+    lines.append("#define TFLM_C_MODEL_OPS_H")
+    lines.append("")
+    lines.append("#define TFLM_MODEL_OPS_COUNT ({})".format(len(methods)))
+    lines.append("")
+    lines.append("#define TFLM_MODEL_OPS_REGISTER(resolver) \\")
+    lines.append("  do { \\")
+    for method in methods:
+        lines.append("    (resolver).{}(); \\".format(method))
+    lines.append("  } while (0)")
+    lines.append("")
+    lines.append("#endif /* TFLM_C_MODEL_OPS_H */")
+
+    output = Path(output)
+    output.mkdir(parents=True, exist_ok=True)
+    resolver_file = output / RESOLVER_FILE_NAME
+    resolver_file.write_text("\n".join(lines) + "\n")
+
+    logging.info("Generate {} with {} operators successfully...".format(
+        RESOLVER_FILE_NAME, len(methods)))
+    return resolver_file
+
+
+if __name__ == "__main__":
+    logging.getLogger().setLevel(logging.INFO)
+
+    model = "../../Model/network.tflite"
+    output = "tmp_cwd/X-CUBE-AI/App"
+    gen_op_resolver(model, output)
+    print("u a right...")
@@ -28,6 +28,13 @@
 @ Update:   1. move self.model_path to abspath
             2. fix model_name lower.
 @ Date:     2021/08/02
+
+@ Update:   generate the model specific TFLite Micro op resolver for .tflite
+@ Date:     2026/10/18
+
+@ Update:   generate the dataset of the system performance application from
+            the val_data samples
+@ Date:     2026/10/18
 '''
 import os
 import sys
@@ -47,6 +54,8 @@ from platforms.plugin_stm32 import plugin_init
 from platforms.plugin_stm32 import run_x_cube_ai
 from platforms.plugin_stm32 import generate_rt_ai_model_h
 from platforms.plugin_stm32 import gen_rt_ai_model_c
+from platforms.plugin_stm32 import gen_tflm_op_resolver
+from platforms.plugin_stm32 import gen_perf_dataset
 
 
 def readonly_handler(func, path):
@@ -79,6 +88,7 @@ class Plugin(object):
         self.network = opt.network  # default network name in sample files
         self.enable_rt_lib = opt.enable_rt_lib  # enable stm32 in <pro>/rtconfig.h
         self.clear = opt.clear
+        self.val_data = opt.val_data  # input samples of the system performance app
 
         # x-cube-ai:stm32ai fixed parameters
         self.stm32_ai_fixed_params = [opt.workspace, opt.compress, opt.batches, opt.mode, opt.val_data]
@@ -268,6 +278,19 @@ class Plugin(object):
         _ = gen_rt_ai_model_c.load_rt_ai_example(self.project, self.rt_ai_example, self.platform,
                                                  self.network, self.c_model_name)
 
+        # 3.3 generate tflm_c_model_ops.h, only the operators of the model are
+        # registered by the TFLite Micro runtime
+        if Path(self.model_path).suffix in self.sup_models["tflite"]:
+            _ = gen_tflm_op_resolver.gen_op_resolver(self.model_path,
+                                                     Path(self.stm_out) / "X-CUBE-AI/App",
+                                                     self.c_model_name)
+
+        # 3.4 generate ai_test_dataset.c, the system performance application
+        # uses these samples instead of random inputs
+        if self.val_data:
+            _ = gen_perf_dataset.gen_dataset(self.val_data,
+                                             Path(self.stm_out) / "X-CUBE-AI/App")
+
         # 4. load lib from <cube_ai> to <stm_out>
         # copy lib files from stm to current dir
         self.load_lib(self.stm_out, self.cube_ai, self.cpu)
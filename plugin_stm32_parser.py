@@ -21,8 +21,8 @@ def platform_parameters(parser):
     parser.add_argument("--workspace", type=str, default="stm32ai_ws",
                         help="indicates a working/temporary directory for the intermediate/temporary files")
     parser.add_argument("--val_data", type=str, default="",
-                        help="indicates the custom test data set which must be used,"
-                             "now is not supported")
+                        help="indicates the custom test data set (.npz/.npy) which must be used,"
+                             "linked with the system performance application (see gen_perf_dataset.py)")
     parser.add_argument("--compress", type=int, default=1,
                         help="indicates the expected global factor of compression which will be applied."
                              "1|4|8")